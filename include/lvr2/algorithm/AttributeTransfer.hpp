@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * AttributeTransfer.hpp
+ *
+ * Transfer of point cloud attributes to mesh elements.
+ */
+
+#ifndef LVR2_ALGORITHM_ATTRIBUTETRANSFER_H_
+#define LVR2_ALGORITHM_ATTRIBUTETRANSFER_H_
+
+#include <string>
+#include <vector>
+
+#include "lvr2/reconstruction/PointsetSurface.hpp"
+
+namespace lvr2
+{
+
+/**
+ * @brief How the values of the k nearest points are combined
+ */
+enum class TransferWeighting
+{
+    /// Value of the nearest point only
+    NEAREST,
+
+    /// Mean of the k nearest points
+    AVERAGE,
+
+    /// Mean of the k nearest points, weighted by their inverse distance
+    INVERSE_DISTANCE
+};
+
+/**
+ * @class AttributeTransfer
+ * @brief Interpolates point cloud channels at arbitrary positions
+ *
+ * All positions are processed in one parallel pass over blocks of positions.
+ * For each position, the k nearest points are searched once and all requested
+ * channels are interpolated from them. Float and unsigned char channels of any
+ * width are supported, e.g. "colors", "intensities" or "normals".
+ *
+ * The results are handed to a callback together with the index of the position.
+ * Since every index is passed exactly once, the callback can write into
+ * preallocated storage (like a vector or a dense attribute map that already
+ * contains all keys) without any locking.
+ */
+template<typename BaseVecT>
+class AttributeTransfer
+{
+public:
+
+    /**
+     * @brief Constructor
+     *
+     * @param surface   The point cloud
+     * @param k         Number of nearest points used for each position
+     * @param weighting How the values of the nearest points are combined
+     */
+    AttributeTransfer(
+        const PointsetSurface<BaseVecT>& surface,
+        int k = 1,
+        TransferWeighting weighting = TransferWeighting::AVERAGE
+    );
+
+    /**
+     * @brief Adds a channel of the point buffer that should be transferred
+     *
+     * @return False if the point buffer has no float or unsigned char channel
+     *         with this name
+     */
+    bool addChannel(const std::string& name);
+
+    /// Number of values per position of the i-th added channel
+    size_t channelWidth(size_t channel) const;
+
+    /**
+     * @brief Interpolates all added channels at the given positions
+     *
+     * @param positions The positions
+     * @param store     Called as store(index, channel, values) for each position
+     *                  and added channel, with channelWidth(channel) interpolated
+     *                  values. It is called from several threads concurrently,
+     *                  but never twice for the same index and channel.
+     *                  Positions without any neighbour get zero values.
+     * @return          The number of positions for which no neighbour was found
+     */
+    template<typename StoreFunc>
+    size_t transfer(const std::vector<BaseVecT>& positions, StoreFunc store) const;
+
+private:
+
+    /// Raw data of a channel that should be transferred
+    struct ChannelData
+    {
+        const float* floatData;
+        const unsigned char* ucharData;
+        size_t width;
+    };
+
+    /// The point cloud
+    const PointsetSurface<BaseVecT>& m_surface;
+
+    /// Number of nearest points
+    int m_k;
+
+    /// How the nearest points are weighted
+    TransferWeighting m_weighting;
+
+    /// The channels to transfer
+    std::vector<ChannelData> m_channels;
+
+    /// Keeps the channel data alive
+    std::vector<FloatChannel> m_floatChannels;
+    std::vector<UCharChannel> m_ucharChannels;
+};
+
+} // namespace lvr2
+
+#include "lvr2/algorithm/AttributeTransfer.tcc"
+
+#endif /* LVR2_ALGORITHM_ATTRIBUTETRANSFER_H_ */
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * AttributeTransfer.tcc
+ */
+
+#include <algorithm>
+#include <cmath>
+
+namespace lvr2
+{
+
+template<typename BaseVecT>
+AttributeTransfer<BaseVecT>::AttributeTransfer(
+    const PointsetSurface<BaseVecT>& surface,
+    int k,
+    TransferWeighting weighting
+) :
+    m_surface(surface),
+    m_k(std::max(1, k)),
+    m_weighting(weighting)
+{
+    if (m_weighting == TransferWeighting::NEAREST)
+    {
+        m_k = 1;
+    }
+}
+
+template<typename BaseVecT>
+bool AttributeTransfer<BaseVecT>::addChannel(const std::string& name)
+{
+    PointBufferPtr buffer = m_surface.pointBuffer();
+
+    if (FloatChannelOptional channel = buffer->getFloatChannel(name))
+    {
+        m_floatChannels.push_back(*channel);
+        m_channels.push_back({m_floatChannels.back().dataPtr().get(), nullptr, channel->width()});
+        return true;
+    }
+
+    if (UCharChannelOptional channel = buffer->getUCharChannel(name))
+    {
+        m_ucharChannels.push_back(*channel);
+        m_channels.push_back({nullptr, m_ucharChannels.back().dataPtr().get(), channel->width()});
+        return true;
+    }
+
+    return false;
+}
+
+template<typename BaseVecT>
+size_t AttributeTransfer<BaseVecT>::channelWidth(size_t channel) const
+{
+    return m_channels[channel].width;
+}
+
+template<typename BaseVecT>
+template<typename StoreFunc>
+size_t AttributeTransfer<BaseVecT>::transfer(const std::vector<BaseVecT>& positions, StoreFunc store) const
+{
+    using CoordT = typename BaseVecT::CoordType;
+
+    size_t numPoints = m_surface.pointBuffer()->numPoints();
+    if (numPoints == 0)
+    {
+        return positions.size();
+    }
+    if (positions.empty() || m_channels.empty())
+    {
+        return 0;
+    }
+
+    const int k = std::min<size_t>(m_k, numPoints);
+
+    size_t maxWidth = 0;
+    for (const ChannelData& channel : m_channels)
+    {
+        maxWidth = std::max(maxWidth, channel.width);
+    }
+
+    // Positions are handed out in blocks, so that every thread works on
+    // neighbouring mesh elements and reuses its search buffers
+    const size_t blockSize = 256;
+    const size_t numBlocks = (positions.size() + blockSize - 1) / blockSize;
+
+    size_t notFound = 0;
+
+    #pragma omp parallel reduction(+:notFound)
+    {
+        std::vector<size_t> indices;
+        std::vector<CoordT> distances;
+        std::vector<float> weights(k);
+        std::vector<float> values(maxWidth);
+
+        #pragma omp for schedule(dynamic)
+        for (long block = 0; block < (long)numBlocks; block++)
+        {
+            size_t end = std::min((block + 1) * blockSize, positions.size());
+            for (size_t i = block * blockSize; i < end; i++)
+            {
+                int found = m_surface.searchTree()->kSearch(positions[i], k, indices, distances);
+                found = std::min<int>(found, indices.size());
+                if (found <= 0)
+                {
+                    notFound++;
+                }
+
+                // Weights of the found neighbours, normalized to a sum of 1
+                float weightSum = 0;
+                for (int j = 0; j < found; j++)
+                {
+                    if (m_weighting == TransferWeighting::INVERSE_DISTANCE)
+                    {
+                        // The search tree returns squared distances
+                        weights[j] = 1.0f / (std::sqrt((float)distances[j]) + 1e-6f);
+                    }
+                    else
+                    {
+                        weights[j] = 1.0f;
+                    }
+                    weightSum += weights[j];
+                }
+
+                for (size_t c = 0; c < m_channels.size(); c++)
+                {
+                    const ChannelData& channel = m_channels[c];
+                    std::fill(values.begin(), values.begin() + channel.width, 0.0f);
+
+                    for (int j = 0; j < found; j++)
+                    {
+                        float w = weights[j] / weightSum;
+                        size_t offset = indices[j] * channel.width;
+                        for (size_t d = 0; d < channel.width; d++)
+                        {
+                            values[d] += w * (channel.floatData
+                                              ? channel.floatData[offset + d]
+                                              : (float)channel.ucharData[offset + d]);
+                        }
+                    }
+
+                    store(i, c, values.data());
+                }
+            }
+        }
+    }
+
+    return notFound;
+}
+
+} // namespace lvr2
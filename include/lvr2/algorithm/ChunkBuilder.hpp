@@ -106,6 +106,25 @@ class ChunkBuilder : public std::enable_shared_from_this<ChunkBuilder>
               std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitVertices,
               std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitFaces) const;
 
+    /**
+     * @brief buildMesh builds a chunk like buildMesh above, but reuses the given buffer to map
+     * vertex indices of the original mesh to vertex indices of the chunk
+     *
+     * The buffer is grown on demand and all entries touched while building the chunk are reset
+     * before returning, so a single buffer can be used for all chunks built by one thread.
+     *
+     * @param attributedMesh original mesh that contains attributes
+     * @param splitVertices map from new vertex indices to old vertex indices for cut faces
+     * @param splitFaces map from new face indices to old face indices for cut faces
+     * @param vertexIndices reusable index buffer (initially empty)
+     * @return mesh of the newly created chunk
+     */
+    MeshBufferPtr
+    buildMesh(MeshBufferPtr attributedMesh,
+              std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitVertices,
+              std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitFaces,
+              std::vector<unsigned int>& vertexIndices) const;
+
     /**
      * @brief numFaces delivers the number of faces for the chunk
      *
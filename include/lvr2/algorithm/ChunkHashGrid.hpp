@@ -40,7 +40,14 @@
 #include "lvr2/io/hdf5/HDF5FeatureBase.hpp"
 #include "lvr2/io/hdf5/ChunkIO.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <ctpl.h>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace lvr2
@@ -64,6 +71,57 @@ class ChunkGeomtryChannelVisitor : public boost::static_visitor<FloatChannelOpti
     }
 };
 
+/**
+ * @brief visitor that returns the number of bytes held by the channels of a chunk
+ */
+class ChunkMemoryVisitor : public boost::static_visitor<size_t>
+{
+  public:
+    template <typename U>
+    size_t operator()(const Channel<U>& channel) const
+    {
+        return channel.numElements() * channel.width() * sizeof(U);
+    }
+
+    template <typename BufferPtr>
+    size_t operator()(const BufferPtr buffer) const
+    {
+        size_t bytes = 0;
+        if (buffer)
+        {
+            for (auto elem : *buffer)
+            {
+                bytes += boost::apply_visitor(*this, elem.second);
+            }
+        }
+        return bytes;
+    }
+};
+
+/**
+ * @brief statistics of the chunk cache of a ChunkHashGrid
+ */
+struct ChunkCacheStatistics
+{
+    // number of requested chunks that were found in the cache
+    size_t hits = 0;
+
+    // number of requested chunks that had to be loaded from persistent storage
+    size_t misses = 0;
+
+    // number of chunks that were removed from the cache to respect its limits
+    size_t evictions = 0;
+
+    // number of chunks that were loaded by prefetch requests
+    size_t prefetched = 0;
+
+    // number of chunks that are currently cached
+    size_t numChunks = 0;
+
+    // estimated memory used by the cached chunks in bytes
+    size_t usedMemory = 0;
+};
+
 class ChunkHashGrid
 {
   public:
@@ -88,6 +146,11 @@ class ChunkHashGrid
                   BoundingBox<BaseVector<float>> boundingBox,
                   float chunkSize);
 
+    /**
+     * @brief waits for pending prefetch requests before closing the HDF5 file
+     */
+    ~ChunkHashGrid();
+
     /**
      * @brief sets a chunk of a given layer in hashgrid
      *
@@ -162,6 +225,72 @@ class ChunkHashGrid
      */
     bool isChunkLoaded(std::string layer, int x, int y, int z);
 
+    /**
+     * @brief loads all chunks of a layer that intersect the given area in the background
+     *
+     * The chunks are loaded by a small pool of prefetch threads and added to the cache, so that
+     * later calls to getChunk for this area do not have to wait for the persistent storage.
+     * Chunks that are already cached or that do not exist are skipped. The call returns
+     * immediately.
+     *
+     * @tparam T type of the chunks in the layer
+     * @param layer layer of the chunks
+     * @param area area in world coordinates
+     * @param margin number of additional chunks to load around the area in each direction
+     */
+    template <typename T>
+    void prefetch(std::string layer, const BoundingBox<BaseVector<float>>& area, int margin = 0);
+
+    /**
+     * @brief blocks until all pending prefetch requests have been processed
+     */
+    void waitForPrefetch();
+
+    /**
+     * @brief sets the memory budget of the chunk cache
+     *
+     * Chunks are evicted in least recently used order as soon as the estimated size of the
+     * cached chunks exceeds the budget. The budget is applied in addition to the maximum number
+     * of chunks given in the constructor.
+     *
+     * @param bytes memory budget in bytes, 0 disables the budget
+     */
+    void setCacheMemoryBudget(size_t bytes);
+
+    /**
+     * @brief returns the memory budget of the chunk cache in bytes (0 if unlimited)
+     */
+    size_t getCacheMemoryBudget() const
+    {
+        return m_cacheMemoryBudget;
+    }
+
+    /**
+     * @brief returns the hit, miss and eviction counters and the current usage of the cache
+     */
+    ChunkCacheStatistics getCacheStatistics();
+
+    /**
+     * @brief resets the hit, miss, eviction and prefetch counters
+     */
+    void resetCacheStatistics();
+
+    /**
+     * @brief stores the indices of the scan positions whose tsdf values are fused into a layer
+     *
+     * @param layer tsdf layer
+     * @param scans indices of the fused scan positions
+     */
+    void saveFusedScans(const std::string& layer, const std::vector<size_t>& scans);
+
+    /**
+     * @brief loads the indices of the scan positions whose tsdf values are fused into a layer
+     *
+     * @param layer tsdf layer
+     * @return indices of the fused scan positions or an empty vector if none were stored
+     */
+    std::vector<size_t> loadFusedScans(const std::string& layer);
+
     /**
      * @brief Calculates the hash value for the given index triple
      *
@@ -260,6 +389,41 @@ class ChunkHashGrid
      */
     void loadChunk(std::string layer, int x, int y, int z, const val_type& data);
 
+    /**
+     * @brief returns the cached content of a chunk and marks it as most recently used
+     *
+     * The caller has to hold m_cacheMutex.
+     *
+     * @param layer layer of chunk
+     * @param hashValue hash of the chunk coordinate
+     *
+     * @return pointer to the chunk content or nullptr if the chunk is not cached
+     */
+    val_type* touchChunk(const std::string& layer, std::size_t hashValue);
+
+    /**
+     * @brief removes least recently used chunks until the cache respects its limits
+     *
+     * The caller has to hold m_cacheMutex.
+     */
+    void evictChunks();
+
+    /**
+     * @brief stores the geometric error of every level of detail of a layer
+     *
+     * @param layer layer whose levels of detail are described
+     * @param errors geometric error per level, starting with the layer itself at level 0
+     */
+    void saveLODErrors(const std::string& layer, const std::vector<float>& errors);
+
+    /**
+     * @brief loads the geometric error of every level of detail of a layer
+     *
+     * @param layer layer whose levels of detail are requested
+     * @return geometric error per level or an empty vector if no levels of detail were built
+     */
+    std::vector<float> loadLODErrors(const std::string& layer);
+
     /**
      * @brief sets chunk size in this container and in persistent storage
      *
@@ -286,17 +450,56 @@ class ChunkHashGrid
                                  const BaseVector<std::size_t>& chunkIndexOffset);
 
   private:
+    // entry of the chunk cache
+    struct CacheEntry
+    {
+        // content of the chunk
+        val_type data;
+
+        // position of the chunk in the lru list
+        std::list<std::pair<std::string, size_t>>::iterator lruPosition;
+
+        // estimated size of the chunk in bytes
+        size_t bytes;
+    };
+
     // chunkIO for the HDF5 file-IO
     io m_io;
 
+    // guards m_io, the HDF5 library may not be used from several threads at once
+    std::recursive_mutex m_ioMutex;
+
+    // guards the cache and the chunk layout; always acquired after m_ioMutex
+    std::recursive_mutex m_cacheMutex;
+
     // number of chunks that will be cached before deleting old chunks
     size_t m_cacheSize;
 
+    // maximum size of all cached chunks in bytes, 0 if unlimited
+    size_t m_cacheMemoryBudget = 0;
+
+    // estimated size of all cached chunks in bytes
+    size_t m_cacheMemory = 0;
+
     // ordered list to save recently used hashValues for the lru cache
     std::list<std::pair<std::string, size_t>> m_items;
 
     // hash map containing chunked meshes
-    std::unordered_map<std::string, std::unordered_map<size_t, val_type>> m_hashGrid;
+    std::unordered_map<std::string, std::unordered_map<size_t, CacheEntry>> m_hashGrid;
+
+    // cache statistics
+    std::atomic<size_t> m_cacheHits{0};
+    std::atomic<size_t> m_cacheMisses{0};
+    std::atomic<size_t> m_cacheEvictions{0};
+    std::atomic<size_t> m_prefetched{0};
+
+    // number of prefetch requests that have not been processed yet
+    size_t m_pendingPrefetches = 0;
+    std::mutex m_prefetchMutex;
+    std::condition_variable m_prefetchDone;
+
+    // threads that load prefetched chunks, created on the first prefetch request
+    std::unique_ptr<ctpl::thread_pool> m_prefetchPool;
 
     // size of chunks
     float m_chunkSize;
@@ -4,6 +4,9 @@ namespace lvr2
 template <typename T>
 void ChunkHashGrid::setGeometryChunk(std::string layer, int x, int y, int z, T data)
 {
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
     // store chunk persistently
     m_io.saveChunk<T>(data, layer, x, y, z);
 
@@ -17,6 +20,9 @@ void ChunkHashGrid::setGeometryChunk(std::string layer, int x, int y, int z, T d
 template <typename T>
 void ChunkHashGrid::setChunk(std::string layer, int x, int y, int z, T data)
 {
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
     // store chunk persistently
     m_io.saveChunk<T>(data, layer, x, y, z);
 
@@ -36,34 +42,56 @@ void ChunkHashGrid::setChunk(std::string layer, int x, int y, int z, T data)
 template <typename T>
 boost::optional<T> ChunkHashGrid::getChunk(std::string layer, int x, int y, int z)
 {
-    // skip if the Coordinates are too large or too negative
-    if(x > getChunkMaxChunkIndex().x || y > getChunkMaxChunkIndex().y || z > getChunkMaxChunkIndex().z ||
-        x < getChunkMinChunkIndex().x || y < getChunkMinChunkIndex().y || z < getChunkMinChunkIndex().z)
     {
-        return boost::optional<T>{};
-    }
-    std::size_t chunkHash = hashValue(x, y, z);
+        std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
+        // skip if the Coordinates are too large or too negative
+        if(x > getChunkMaxChunkIndex().x || y > getChunkMaxChunkIndex().y || z > getChunkMaxChunkIndex().z ||
+            x < getChunkMinChunkIndex().x || y < getChunkMinChunkIndex().y || z < getChunkMinChunkIndex().z)
+        {
+            return boost::optional<T>{};
+        }
 
-    if (isChunkLoaded(layer, chunkHash))
-    {
         // move chunk to the front of the cache queue
-        m_items.remove({layer, chunkHash});
-        m_items.push_front({layer, chunkHash});
+        val_type* chunk = touchChunk(layer, hashValue(x, y, z));
+        if (chunk != nullptr)
+        {
+            m_cacheHits++;
+            return boost::get<T>(*chunk);
+        }
+    }
 
-        return boost::get<T>(m_hashGrid[layer][chunkHash]);
+    // The cache lock is released while loading, so other threads can still be served from the
+    // cache. Requests for the same chunk wait for the first one and find it in the cache.
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    {
+        std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+        val_type* chunk = touchChunk(layer, hashValue(x, y, z));
+        if (chunk != nullptr)
+        {
+            m_cacheHits++;
+            return boost::get<T>(*chunk);
+        }
     }
 
-    if (loadChunk<T>(layer, x, y, z))
+    m_cacheMisses++;
+
+    T data = m_io.loadChunk<T>(layer, x, y, z);
+    if (data == nullptr)
     {
-        return boost::get<T>(m_hashGrid[layer][chunkHash]);
+        return boost::optional<T>{};
     }
 
-    return boost::optional<T>{};
+    loadChunk(layer, x, y, z, data);
+
+    return data;
 }
 
 template <typename T>
 bool ChunkHashGrid::loadChunk(std::string layer, int x, int y, int z)
 {
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+
     if (isChunkLoaded(layer, x, y, z))
     {
         return true;
@@ -80,4 +108,78 @@ bool ChunkHashGrid::loadChunk(std::string layer, int x, int y, int z)
     return true;
 }
 
+template <typename T>
+void ChunkHashGrid::prefetch(std::string layer, const BoundingBox<BaseVector<float>>& area, int margin)
+{
+    // collect all chunks of the area that are not cached yet; the indices are rounded outwards
+    // so the chunks are found regardless of the rounding used when they were created
+    std::vector<BaseVector<int>> chunks;
+    {
+        std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
+        BaseVector<int> minIndex = getChunkMinChunkIndex();
+        BaseVector<int> maxIndex = getChunkMaxChunkIndex();
+
+        BaseVector<int> from(std::floor(area.getMin().x / m_chunkSize) - margin,
+                             std::floor(area.getMin().y / m_chunkSize) - margin,
+                             std::floor(area.getMin().z / m_chunkSize) - margin);
+        BaseVector<int> to(std::ceil(area.getMax().x / m_chunkSize) + margin,
+                           std::ceil(area.getMax().y / m_chunkSize) + margin,
+                           std::ceil(area.getMax().z / m_chunkSize) + margin);
+
+        for (int i = std::max(from.x, minIndex.x); i <= std::min(to.x, maxIndex.x); i++)
+        {
+            for (int j = std::max(from.y, minIndex.y); j <= std::min(to.y, maxIndex.y); j++)
+            {
+                for (int k = std::max(from.z, minIndex.z); k <= std::min(to.z, maxIndex.z); k++)
+                {
+                    if (!isChunkLoaded(layer, i, j, k))
+                    {
+                        chunks.push_back(BaseVector<int>(i, j, k));
+                    }
+                }
+            }
+        }
+    }
+
+    if (chunks.empty())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> prefetchLock(m_prefetchMutex);
+    if (!m_prefetchPool)
+    {
+        m_prefetchPool.reset(new ctpl::thread_pool(2));
+    }
+
+    m_pendingPrefetches += chunks.size();
+    for (const BaseVector<int>& chunk : chunks)
+    {
+        m_prefetchPool->push([this, layer, chunk](int) {
+            try
+            {
+                bool loaded;
+                {
+                    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+                    loaded = !isChunkLoaded(layer, chunk.x, chunk.y, chunk.z)
+                             && loadChunk<T>(layer, chunk.x, chunk.y, chunk.z);
+                }
+                if (loaded)
+                {
+                    m_prefetched++;
+                }
+            }
+            catch (...)
+            {
+                // a failed prefetch is not an error, the chunk will be loaded on request
+            }
+
+            std::lock_guard<std::mutex> lock(m_prefetchMutex);
+            m_pendingPrefetches--;
+            m_prefetchDone.notify_all();
+        });
+    }
+}
+
 } // namespace lvr2
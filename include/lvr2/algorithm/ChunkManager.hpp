@@ -52,6 +52,24 @@ class ChunkManager : public ChunkHashGrid
   public:
     using FilterFunction = std::function<bool(MultiChannelMap::val_type, size_t)>;
 
+    /**
+     * @brief level of detail that was selected for a single chunk
+     */
+    struct ChunkLOD
+    {
+        /// chunk coordinates
+        BaseVector<int> index;
+
+        /// selected level, 0 is the original mesh
+        size_t level;
+
+        /// name of the layer that stores the chunk at the selected level
+        std::string layer;
+
+        /// geometric error of the selected level projected to the screen
+        float error;
+    };
+
     /**
      * @brief ChunkManager creates chunks from an original mesh
      *
@@ -64,13 +82,15 @@ class ChunkManager : public ChunkHashGrid
      * Larger triangles will be cut
      * @param savePath JUST FOR TESTING - REMOVE LATER ON
      * @param cacheSize maximum number of chunks loaded in the ChunkHashGrid
+     * @param numLODs number of simplified levels of detail that are built for every chunk
      */
     ChunkManager(MeshBufferPtr meshes,
                  float chunksize,
                  float maxChunkOverlap,
                  std::string savePath,
                  std::string layer = std::string("mesh"),
-                 size_t cacheSize = 200
+                 size_t cacheSize = 200,
+                 size_t numLODs = 0
                  );
 
 
@@ -79,7 +99,8 @@ class ChunkManager : public ChunkHashGrid
                  float maxChunkOverlap,
                  std::string savePath,
                  std::vector<std::string> layers,
-                 size_t cacheSize = 200);
+                 size_t cacheSize = 200,
+                 size_t numLODs = 0);
 
     /**
      * @brief ChunkManager loads a ChunkManager from a given HDF5-file
@@ -108,12 +129,69 @@ class ChunkManager : public ChunkHashGrid
      *
      * Creates chunks from an original mesh and initializes the initial chunk structure
      *
+     * If numLODs is larger than 0, every chunk is additionally simplified to numLODs levels of
+     * detail, each with about a quarter of the faces of the previous one. The levels are stored
+     * in the layers returned by getLODLayer. Vertices on the border of a chunk are never moved
+     * by the simplification, so chunks of different levels still fit together without cracks.
+     *
+     * If building or writing a chunk fails, the first exception is rethrown after all chunk
+     * tasks have finished.
+     *
      * @param mesh mesh which is being chunked
      * @param maxChunkOverlap maximum allowed overlap between chunks relative to the chunk size.
      * Larger triangles will be cut
      * @param savePath UST FOR TESTING - REMOVE LATER ON
+     * @param numLODs number of simplified levels of detail that are built for every chunk
+     */
+    void buildChunks(MeshBufferPtr mesh,
+                     float maxChunkOverlap,
+                     std::string savePath,
+                     std::string layer = std::string("mesh"),
+                     size_t numLODs = 0);
+
+    /**
+     * @brief returns the name of the layer that stores the given level of detail of a layer
+     *
+     * @param layer layer of the original mesh
+     * @param level level of detail, 0 is the original mesh
+     */
+    static std::string getLODLayer(const std::string& layer, size_t level);
+
+    /**
+     * @brief returns the number of levels of detail of a layer including the original mesh
      */
-    void buildChunks(MeshBufferPtr mesh, float maxChunkOverlap, std::string savePath, std::string layer = std::string("mesh"));
+    size_t getNumLODs(std::string layer = std::string("mesh"));
+
+    /**
+     * @brief selects a level of detail for every chunk in the given area
+     *
+     * The geometric error of a level is the mean edge length of its triangles. It is projected
+     * to the screen with the distance between the camera and the chunk and the coarsest level
+     * whose projected error does not exceed maxError is selected. Only the stored metadata is
+     * used, so the call does not wait for any chunk to be loaded. The result is sorted from
+     * near to far and may contain empty chunks, for which getChunk will not return a mesh.
+     *
+     * @param area area of the chunks to select
+     * @param camera position of the camera
+     * @param projectionFactor screen height in pixels divided by 2 * tan(fov / 2)
+     * @param maxError maximum allowed projected error in pixels
+     * @param layer layer of the original mesh
+     * @return selected level of detail per chunk
+     */
+    std::vector<ChunkLOD> selectLODs(const BoundingBox<BaseVector<float>>& area,
+                                     const BaseVector<float>& camera,
+                                     float projectionFactor,
+                                     float maxError,
+                                     std::string layer = std::string("mesh"));
+
+    /**
+     * @brief loads the selected chunks in the background
+     *
+     * Later calls to getChunk for the selected layers will find the chunks in the cache.
+     *
+     * @param lods chunks selected by selectLODs
+     */
+    void prefetchLODs(const std::vector<ChunkLOD>& lods);
 
     /**
      * @brief extractArea creates and returns MeshBufferPtr of merged chunks for given area.
@@ -225,6 +303,13 @@ class ChunkManager : public ChunkHashGrid
      * @return the grid coordinates as a BaseVector
      */
     BaseVector<int> getCellCoordinates(const BaseVector<float>& vec) const;
+
+    /**
+     * @brief returns the geometric error of every level of detail of a layer
+     *
+     * The errors are loaded from the HDF5 file once and cached afterwards.
+     */
+    std::vector<float> getLODErrors(const std::string& layer);
     
     /**
      * @brief reads and combines a channel of multiple chunks
@@ -266,6 +351,10 @@ class ChunkManager : public ChunkHashGrid
                        const size_t numFaces,
                        const MeshBufferPtr meshBuffer,
                        const MultiChannelMap::val_type& originalChannel) const;
+
+    // geometric error per level of detail for each layer that has been queried
+    std::unordered_map<std::string, std::vector<float>> m_lodErrors;
+    std::mutex m_lodErrorsMutex;
 };
 
 } /* namespace lvr2 */
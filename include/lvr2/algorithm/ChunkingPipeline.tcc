@@ -253,6 +253,16 @@ bool ChunkingPipeline<BaseVecT>::start(const boost::filesystem::path& scanDir)
     lsr.mpiChunkAndReconstruct(m_scanProject, newChunksBB, m_chunkManager);
     std::cout << timestamp << "Finished large scale reconstruction!" << std::endl;
 
+    if (!newChunksBB.isValid())
+    {
+        // incremental fusion didn't change any chunk enough to be re-meshed
+        std::cout << timestamp << "No chunks to re-mesh!" << std::endl;
+        std::cout << timestamp << "Finished chunking pipeline!" << std::endl;
+
+        m_running = false;
+        return true;
+    }
+
     for (auto layer : m_lsrOptions.voxelSizes)
     {
         std::string voxelSizeStr = "[Layer " + std::to_string(layer) + "] ";
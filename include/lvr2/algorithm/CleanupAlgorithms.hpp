@@ -43,6 +43,9 @@ namespace lvr2
  * Faces which have 2 or 3 adjacent boundary edges, are removed. If the face
  * is adjacent to only one boundary edge, it is deleted if the face's area is
  * smaller than `areaThreshold`.
+ *
+ * Each of the `iterations` sweeps visits the faces in handle order, but only
+ * those that are at the boundary (first sweep) or next to a removed face.
  */
 template<typename BaseVecT>
 void cleanContours(BaseMesh<BaseVecT>& mesh, int iterations, float areaThreshold);
@@ -58,6 +61,9 @@ void cleanContours(BaseMesh<BaseVecT>& mesh, int iterations, float areaThreshold
  * has only three edges left). If the remaining hole has only three edges after
  * the previous step, it is filled by simply inserting a triangle.
  *
+ * The contours of all parts are searched in parallel, the holes are filled
+ * serially afterwards.
+ *
  * Important: this algorithm assumes that the mesh doesn't contain any lonely
  * edges.
  *
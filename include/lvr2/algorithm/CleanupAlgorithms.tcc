@@ -34,47 +34,161 @@
 #include "lvr2/attrmaps/AttrMaps.hpp"
 #include "lvr2/io/Timestamp.hpp"
 
+#include <algorithm>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace lvr2
 {
 
 template<typename BaseVecT>
 void cleanContours(BaseMesh<BaseVecT>& mesh, int iterations, float areaThreshold)
 {
-    for (int i = 0; i < iterations; i++)
+    // Decides whether the face should be removed in its current state
+    auto shouldRemove = [&](FaceHandle fH)
     {
-        for (const auto fH: mesh.faces())
+        // For each face, we want to count the number of boundary edges
+        // adjacent to that face. This can be a number between 0 and 3.
+        int boundaryEdgeCount = 0;
+        for (const auto eH: mesh.getEdgesOfFace(fH))
         {
-            // For each face, we want to count the number of boundary edges
-            // adjacent to that face. This can be a number between 0 and 3.
-            int boundaryEdgeCount = 0;
-            for (const auto eH: mesh.getEdgesOfFace(fH))
+            // For both (optional) faces of the edge...
+            for (const auto neighborFaceH: mesh.getFacesOfEdge(eH))
             {
-                // For both (optional) faces of the edge...
-                for (const auto neighborFaceH: mesh.getFacesOfEdge(eH))
+                // ... we will count one up if there is no face on that
+                // side. Note that this correctly ignores our own face.
+                if (!neighborFaceH)
                 {
-                    // ... we will count one up if there is no face on that
-                    // side. Note that this correctly ignores our own face.
-                    if (!neighborFaceH)
-                    {
-                        boundaryEdgeCount += 1;
-                    }
+                    boundaryEdgeCount += 1;
                 }
             }
+        }
+
+        // Now, given the number of boundary edges, we decide what to do
+        // with the face.
+        return boundaryEdgeCount >= 2
+            || (boundaryEdgeCount == 1 && mesh.calcFaceArea(fH) < areaThreshold);
+    };
+
+    // Only faces at the boundary can be removed, so the first sweep starts
+    // with all of them. They are searched in parallel.
+    vector<FaceHandle> faces;
+    faces.reserve(mesh.numFaces());
+    for (const auto fH: mesh.faces())
+    {
+        faces.push_back(fH);
+    }
 
-            // Now, given the number of boundary edges, we decide what to do
-            // with the face.
-            if (boundaryEdgeCount >= 2)
+    vector<char> atBoundary(faces.size(), 0);
+    #pragma omp parallel for
+    for (long i = 0; i < (long)faces.size(); i++)
+    {
+        for (const auto eH: mesh.getEdgesOfFace(faces[i]))
+        {
+            if (mesh.numAdjacentFaces(eH) < 2)
             {
-                mesh.removeFace(fH);
+                atBoundary[i] = 1;
+            }
+        }
+    }
+
+    vector<FaceHandle> candidates;
+    for (size_t i = 0; i < faces.size(); i++)
+    {
+        if (atBoundary[i])
+        {
+            candidates.push_back(faces[i]);
+        }
+    }
+
+    // Each sweep visits its candidates in increasing handle order, just like
+    // a sweep over all faces would. If a face is removed, its neighbours with
+    // a larger handle are visited later in the same sweep, the others in the
+    // next one. Faces without a removed neighbour keep their state and need
+    // not be visited again.
+    auto greater = [](FaceHandle a, FaceHandle b) { return b < a; };
+    vector<FaceHandle> neighbours;
+    for (int i = 0; i < iterations && !candidates.empty(); i++)
+    {
+        std::priority_queue<FaceHandle, vector<FaceHandle>, decltype(greater)> queue(
+            greater, std::move(candidates));
+        candidates.clear();
+
+        OptionalFaceHandle lastH;
+        while (!queue.empty())
+        {
+            FaceHandle fH = queue.top();
+            queue.pop();
+
+            // Faces can be queued more than once
+            if ((lastH && lastH.unwrap() == fH) || !mesh.containsFace(fH))
+            {
+                continue;
             }
-            else if (boundaryEdgeCount == 1 && mesh.calcFaceArea(fH) < areaThreshold)
+            lastH = fH;
+
+            if (shouldRemove(fH))
             {
+                neighbours.clear();
+                mesh.getNeighboursOfFace(fH, neighbours);
                 mesh.removeFace(fH);
+
+                for (auto neighbourH: neighbours)
+                {
+                    if (fH < neighbourH)
+                    {
+                        queue.push(neighbourH);
+                    }
+                    else
+                    {
+                        candidates.push_back(neighbourH);
+                    }
+                }
             }
         }
     }
 }
 
+/**
+ * @brief Collects all boundary contours of the given faces, in the order in
+ *        which a sweep over the faces and their edges finds them.
+ */
+template<typename BaseVecT>
+void collectContours(
+    const BaseMesh<BaseVecT>& mesh,
+    const vector<FaceHandle>& faces,
+    vector<vector<EdgeHandle>>& contours
+)
+{
+    std::unordered_set<EdgeHandle> visited;
+    vector<EdgeHandle> contourEdges;
+
+    for (auto faceH: faces)
+    {
+        // Faces removed by edge collapses are skipped
+        if (!mesh.containsFace(faceH))
+        {
+            continue;
+        }
+
+        for (auto eH: mesh.getEdgesOfFace(faceH))
+        {
+            // We are only interested in boundary edges of contours we did
+            // not walk yet
+            if (mesh.numAdjacentFaces(eH) != 1 || visited.count(eH))
+            {
+                continue;
+            }
+
+            // Get full contour and store it in our list
+            contourEdges.clear();
+            calcContourEdges(mesh, eH, contourEdges);
+            contours.emplace_back(contourEdges);
+            visited.insert(contourEdges.begin(), contourEdges.end());
+        }
+    }
+}
 
 template<typename BaseVecT>
 size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collapseOnly)
@@ -101,51 +215,76 @@ size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collap
     // has many non-collapsable edges.
     size_t failedToFillCount = 0;
 
-    // This is only used later but created here to avoid useless heap
-    // allocations.
-    vector<vector<EdgeHandle>> contours;
-
     // We execute the algorithm for each connected part of the mesh
     string comment = timestamp.getElapsedTime() + "Trying to remove all holes ";
-
     ProgressBar progress(subMeshes.numCluster(), comment);
+
+    // The contours of all parts are searched in parallel before the mesh is
+    // changed. The holes are filled serially afterwards.
+    vector<ClusterHandle> parts;
     for (auto clusterH: subMeshes)
     {
-        if(!timestamp.isQuiet())
-            ++progress;
-        contours.clear();
-
-        // We only use this within the loop, but create it here to avoid
-        // useless heap allocations.
-        vector<EdgeHandle> contourEdges;
+        parts.push_back(clusterH);
+    }
 
-        for (auto faceH: subMeshes[clusterH])
+    vector<vector<vector<EdgeHandle>>> partContours(parts.size());
+    vector<vector<VertexHandle>> partContourVertices(parts.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < (long)parts.size(); i++)
+    {
+        collectContours(mesh, subMeshes[parts[i]].handles, partContours[i]);
+        for (auto& contour: partContours[i])
         {
-            for (auto eH: mesh.getEdgesOfFace(faceH))
+            for (auto edgeH: contour)
             {
-                // Skip already visited edges and mark edge as visited
-                if (visitedEdges[eH])
-                {
-                    continue;
-                }
-                visitedEdges[eH] = true;
+                auto vertices = mesh.getVerticesOfEdge(edgeH);
+                partContourVertices[i].push_back(vertices[0]);
+                partContourVertices[i].push_back(vertices[1]);
+            }
+        }
+    }
 
-                // We are only interested in boundary edges
-                if (mesh.numAdjacentFaces(eH) != 1)
-                {
-                    continue;
-                }
+    // Vertices of faces that were changed while filling holes. Parts whose
+    // contours touch one of them (which can only happen if parts share
+    // vertices) search their contours again.
+    DenseVertexMap<bool> touched(mesh.nextVertexIndex(), false);
+    auto touch = [&](FaceHandle faceH)
+    {
+        for (auto vH: mesh.getVerticesOfFace(faceH))
+        {
+            touched[vH] = true;
+        }
+    };
+
+    for (size_t partIdx = 0; partIdx < parts.size(); partIdx++)
+    {
+        auto clusterH = parts[partIdx];
+        if(!timestamp.isQuiet())
+            ++progress;
 
-                // Get full contour and store it in our list
-                contourEdges.clear();
-                calcContourEdges(mesh, eH, contourEdges);
-                contours.emplace_back(contourEdges);
+        auto& contours = partContours[partIdx];
+        bool outdated = false;
+        for (auto vH: partContourVertices[partIdx])
+        {
+            outdated |= touched[vH];
+        }
+        if (outdated)
+        {
+            contours.clear();
+            collectContours(mesh, subMeshes[clusterH].handles, contours);
+        }
 
-                // Mark all edges in the contour we just added as visited
-                for (auto edgeH: contours.back())
-                {
-                    visitedEdges[edgeH] = true;
-                }
+        // Skip contours that were already found in another part and mark
+        // the edges of the others as visited
+        contours.erase(std::remove_if(contours.begin(), contours.end(), [&](auto& contour)
+        {
+            return visitedEdges[contour.front()];
+        }), contours.end());
+        for (auto& contour: contours)
+        {
+            for (auto edgeH: contour)
+            {
+                visitedEdges[edgeH] = true;
             }
         }
 
@@ -172,6 +311,17 @@ size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collap
         }
         contours.erase(contours.begin() + maxIdx);
 
+        // Index of the contour each edge belongs to, to fix the contours
+        // after edge collapses without searching all of them
+        std::unordered_map<EdgeHandle, size_t> contourOfEdge;
+        for (size_t i = 0; i < contours.size(); i++)
+        {
+            for (auto edgeH: contours[i])
+            {
+                contourOfEdge[edgeH] = i;
+            }
+        }
+
         // We assume that all remaining contours are holes we could fill. (And
         // yes, we need the index later and can't use a range based for loop).
         for (size_t contourIdx = 0; contourIdx < contours.size(); contourIdx++)
@@ -200,6 +350,13 @@ size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collap
                 }
 
                 // Collapse edge and remove it from the list of contours
+                for (auto faceH: mesh.getFacesOfEdge(*collapsableEdge))
+                {
+                    if (faceH)
+                    {
+                        touch(faceH.unwrap());
+                    }
+                }
                 auto collapseResult = mesh.collapseEdge(*collapsableEdge);
                 contour.erase(collapsableEdge);
 
@@ -222,30 +379,29 @@ size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collap
                 {
                     for (auto removedEdgeH: removedNeighbor.removedEdges)
                     {
-                        for (size_t i = contourIdx; i < contours.size(); i++)
+                        // Each edge is only part of one contour
+                        auto contourIt = contourOfEdge.find(removedEdgeH);
+                        if (contourIt == contourOfEdge.end() || contourIt->second < contourIdx)
+                        {
+                            continue;
+                        }
+
+                        size_t i = contourIt->second;
+                        auto& contourToFix = contours[i];
+                        auto it = std::find(contourToFix.begin(), contourToFix.end(), removedEdgeH);
+                        if (it != contourToFix.end())
                         {
-                            auto& contourToFix = contours[i];
-                            auto it = std::find(contourToFix.begin(), contourToFix.end(), removedEdgeH);
-                            if (it != contourToFix.end())
-                            {
-                                // We replace the handle with the new one
-                                *it = removedNeighbor.newEdge;
-
-                                // We can stop here, because each edge is only
-                                // part of one contour.
-                                break;
-                            }
+                            // We replace the handle with the new one
+                            *it = removedNeighbor.newEdge;
+                            contourOfEdge.erase(contourIt);
+                            contourOfEdge[removedNeighbor.newEdge] = i;
                         }
                     }
                 }
 
-                // If the removed face belongs to a cluster different from the
-                // current one, we also have to remove the face there.
-                auto clusterH = subMeshes.getClusterOf(removedNeighbor.removedFace);
-                if (clusterH)
-                {
-                    subMeshes.removeFromCluster(clusterH.unwrap(), removedNeighbor.removedFace);
-                }
+                // The removed face stays in its cluster, contours are only
+                // searched again in faces that still exist (removing it from
+                // the cluster is linear in the cluster size).
             }
 
             if (collapseOnly)
@@ -262,7 +418,7 @@ size_t naiveFillSmallHoles(BaseMesh<BaseVecT>& mesh, size_t maxSize, bool collap
                 auto v0 = mesh.getVertexBetween(contour[0], contour[1]).unwrap();
                 auto v1 = mesh.getVertexBetween(contour[1], contour[2]).unwrap();
                 auto v2 = mesh.getVertexBetween(contour[2], contour[0]).unwrap();
-                mesh.addFace(v0, v1, v2);
+                touch(mesh.addFace(v0, v1, v2));
             }
             else
             {
@@ -157,6 +157,44 @@ BoundingRectangle<typename BaseVecT::CoordType> calculateBoundingRectangle(
 template<typename BaseVecT, typename Pred>
 ClusterBiMap<FaceHandle> clusterGrowing(const BaseMesh<BaseVecT>& mesh, Pred pred);
 
+/**
+ * @brief Labels the connected components of the mesh in parallel.
+ *
+ * Two neighbouring faces belong to the same component if `connected(faceA, faceB)` returns true. The components are
+ * found with a concurrent union-find over the face adjacency. They are numbered from 0 in the order of their first
+ * face in `mesh.faces()`, i.e. in the same order as the clusters created by clusterGrowing().
+ *
+ * @tparam Pred a predicate with the parameters (FaceHandle faceA, FaceHandle faceB) which decides whether the two
+ *         neighbouring faces are connected. It has to be symmetric and is called from several threads concurrently.
+ * @param mesh the mesh
+ * @param labels filled with the component id of each face
+ * @param connected the predicate
+ * @return the number of components
+ */
+template<typename BaseVecT, typename Pred>
+size_t labelComponents(const BaseMesh<BaseVecT>& mesh, DenseFaceMap<size_t>& labels, Pred connected);
+
+/**
+ * @brief Labels the connected components of the mesh in parallel, where all neighbouring faces are connected.
+ *
+ * @see labelComponents(const BaseMesh<BaseVecT>&, DenseFaceMap<size_t>&, Pred)
+ */
+template<typename BaseVecT>
+size_t labelComponents(const BaseMesh<BaseVecT>& mesh, DenseFaceMap<size_t>& labels);
+
+/**
+ * @brief Parallel alternative to clusterGrowing() for predicates which only depend on two neighbouring faces.
+ *
+ * clusterGrowing() compares each face with the first face of its cluster. This function instead puts two
+ * neighbouring faces into the same cluster if `connected(faceA, faceB)` returns true, using labelComponents(). For
+ * predicates which always return true, both functions create the same clusters in the same order.
+ *
+ * @tparam Pred a symmetric predicate with the parameters (FaceHandle faceA, FaceHandle faceB), which is called from
+ *         several threads concurrently
+ */
+template<typename BaseVecT, typename Pred>
+ClusterBiMap<FaceHandle> componentClusterGrowing(const BaseMesh<BaseVecT>& mesh, Pred connected);
+
 /**
  * @brief Algorithm which generates plane clusters from the given mesh.
  * @param minSinAngle `1 - minSinAngle` is the allowed difference between the sin of the angle of the starting
@@ -46,6 +46,7 @@
 #include "lvr2/io/Timestamp.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <complex>
 #include <sstream>
 #include <cmath>
@@ -62,22 +63,25 @@ namespace lvr2
 template<typename BaseVecT>
 void removeDanglingCluster(BaseMesh<BaseVecT>& mesh, size_t sizeThreshold)
 {
-    // Do cluster growing without a predicate, so cluster will consist of connected faces
-    auto clusterSet = clusterGrowing(mesh, [](auto referenceFaceH, auto currentFaceH)
+    // Label the connected parts of the mesh and count their faces
+    DenseFaceMap<size_t> labels;
+    size_t numComponents = labelComponents(mesh, labels);
+
+    vector<size_t> componentSize(numComponents, 0);
+    vector<FaceHandle> faces;
+    faces.reserve(mesh.numFaces());
+    for (auto faceH: mesh.faces())
     {
-        return true;
-    });
+        componentSize[labels[faceH]]++;
+        faces.push_back(faceH);
+    }
 
     // Remove all faces in too small clusters
-    for (auto clusterH: clusterSet)
+    for (auto faceH: faces)
     {
-        auto cluster = clusterSet.getCluster(clusterH);
-        if (cluster.handles.size() < sizeThreshold)
+        if (componentSize[labels[faceH]] < sizeThreshold)
         {
-            for (auto faceH: cluster.handles)
-            {
-                mesh.removeFace(faceH);
-            }
+            mesh.removeFace(faceH);
         }
     }
 }
@@ -432,6 +436,152 @@ ClusterBiMap<FaceHandle> clusterGrowing(const BaseMesh<BaseVecT>& mesh, Pred pre
     return clusters;
 }
 
+template<typename BaseVecT, typename Pred>
+size_t labelComponents(const BaseMesh<BaseVecT>& mesh, DenseFaceMap<size_t>& labels, Pred connected)
+{
+    vector<FaceHandle> faces;
+    faces.reserve(mesh.numFaces());
+    for (auto faceH: mesh.faces())
+    {
+        faces.push_back(faceH);
+    }
+
+    // Union-find forest over the face indices. Roots are always linked below
+    // the smaller root, so the root of each component is its smallest face.
+    size_t numIndices = mesh.nextFaceIndex();
+    vector<std::atomic<Index>> parent(numIndices);
+
+    #pragma omp parallel for
+    for (long i = 0; i < (long)numIndices; i++)
+    {
+        parent[i].store(i, std::memory_order_relaxed);
+    }
+
+    // Find with path halving. Concurrent finds may overwrite each other's
+    // shortcuts, which is harmless as every shortcut points to an ancestor.
+    auto find = [&](Index x)
+    {
+        while (true)
+        {
+            Index p = parent[x].load(std::memory_order_relaxed);
+            if (p == x)
+            {
+                return x;
+            }
+            Index gp = parent[p].load(std::memory_order_relaxed);
+            if (p != gp)
+            {
+                parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+            }
+            x = gp;
+        }
+    };
+
+    auto unite = [&](Index a, Index b)
+    {
+        while (true)
+        {
+            a = find(a);
+            b = find(b);
+            if (a == b)
+            {
+                return;
+            }
+            if (a < b)
+            {
+                std::swap(a, b);
+            }
+
+            // Only succeeds if a is still a root
+            Index expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    };
+
+    #pragma omp parallel
+    {
+        vector<FaceHandle> faceNeighbours;
+
+        #pragma omp for schedule(dynamic, 1024)
+        for (long i = 0; i < (long)faces.size(); i++)
+        {
+            auto faceH = faces[i];
+            faceNeighbours.clear();
+            mesh.getNeighboursOfFace(faceH, faceNeighbours);
+            for (auto neighbour: faceNeighbours)
+            {
+                // Each pair of faces is only looked at once
+                if (faceH < neighbour && connected(faceH, neighbour))
+                {
+                    unite(faceH.idx(), neighbour.idx());
+                }
+            }
+        }
+    }
+
+    vector<Index> roots(faces.size());
+    #pragma omp parallel for
+    for (long i = 0; i < (long)faces.size(); i++)
+    {
+        roots[i] = find(faces[i].idx());
+    }
+
+    // The faces are sorted by their handles, so components get their ids in
+    // the order of their first face
+    vector<size_t> componentOfRoot(numIndices, 0);
+    size_t numComponents = 0;
+    for (size_t i = 0; i < faces.size(); i++)
+    {
+        if (roots[i] == faces[i].idx())
+        {
+            componentOfRoot[roots[i]] = numComponents++;
+        }
+    }
+
+    labels.clear();
+    labels.reserve(numIndices);
+    for (size_t i = 0; i < faces.size(); i++)
+    {
+        labels.insert(faces[i], componentOfRoot[roots[i]]);
+    }
+
+    return numComponents;
+}
+
+template<typename BaseVecT>
+size_t labelComponents(const BaseMesh<BaseVecT>& mesh, DenseFaceMap<size_t>& labels)
+{
+    return labelComponents(mesh, labels, [](auto faceA, auto faceB)
+    {
+        return true;
+    });
+}
+
+template<typename BaseVecT, typename Pred>
+ClusterBiMap<FaceHandle> componentClusterGrowing(const BaseMesh<BaseVecT>& mesh, Pred connected)
+{
+    DenseFaceMap<size_t> labels;
+    size_t numComponents = labelComponents(mesh, labels, connected);
+
+    ClusterBiMap<FaceHandle> clusters;
+    vector<ClusterHandle> clusterOfComponent;
+    clusterOfComponent.reserve(numComponents);
+    for (size_t i = 0; i < numComponents; i++)
+    {
+        clusterOfComponent.push_back(clusters.createCluster());
+    }
+
+    for (auto faceH: mesh.faces())
+    {
+        clusters.addToCluster(clusterOfComponent[labels[faceH]], faceH);
+    }
+
+    return clusters;
+}
+
 template<typename BaseVecT>
 ClusterBiMap<FaceHandle> planarClusterGrowing(
     const BaseMesh<BaseVecT>& mesh,
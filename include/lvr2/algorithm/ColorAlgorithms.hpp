@@ -47,6 +47,7 @@
 #include "lvr2/geometry/BaseMesh.hpp"
 #include "lvr2/reconstruction/PointsetSurface.hpp"
 #include "lvr2/attrmaps/AttrMaps.hpp"
+#include "lvr2/algorithm/AttributeTransfer.hpp"
 
 namespace lvr2
 {
@@ -57,17 +58,21 @@ using Rgb8Color = std::array<uint8_t, 3>;
  * @brief   Calculates the color of each vertex from the point cloud
  *
  * For each vertex, its color is calculated from the rgb color information in
- * the meshes surface.
+ * the meshes surface. All vertices are colored in one parallel pass.
  *
- * @param   mesh    The mesh
- * @param   surface The surface of the mesh
+ * @param   mesh      The mesh
+ * @param   surface   The surface of the mesh
+ * @param   k         Number of nearest points that are averaged
+ * @param   weighting How the colors of the nearest points are weighted
  *
  * @return  Optional of a DenseVertexMap with a Rgb8Color for each vertex
  */
 template<typename BaseVecT>
 boost::optional<DenseVertexMap<Rgb8Color>> calcColorFromPointCloud(
     const BaseMesh<BaseVecT>& mesh,
-    const PointsetSurfacePtr<BaseVecT> surface
+    const PointsetSurfacePtr<BaseVecT> surface,
+    int k = 1,
+    TransferWeighting weighting = TransferWeighting::AVERAGE
 );
 
 /**
@@ -115,6 +120,25 @@ Rgb8Color calcColorForFaceCentroid(
     FaceHandle faceH
 );
 
+/**
+ * @brief    Calculate the colors for the centroids of many faces at once
+ *
+ *           Gives the same colors as calcColorForFaceCentroid(), but searches
+ *           the nearest points of all centroids in one parallel pass.
+ *
+ * @param    mesh     The mesh
+ * @param    surface  The surface of the mesh
+ * @param    faces    The faces to color
+ *
+ * @return   Map with the Rgb8Color of the centroid of each given face
+ */
+template<typename BaseVecT>
+DenseFaceMap<Rgb8Color> calcColorsForFaceCentroids(
+    const BaseMesh<BaseVecT>& mesh,
+    const PointsetSurface<BaseVecT>& surface,
+    const vector<FaceHandle>& faces
+);
+
 } // namespace lvr2
 
 #include "lvr2/algorithm/ColorAlgorithms.tcc"
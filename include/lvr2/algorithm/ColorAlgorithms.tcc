@@ -43,7 +43,9 @@ namespace lvr2
 template <typename BaseVecT>
 boost::optional<DenseVertexMap<Rgb8Color>> calcColorFromPointCloud(
     const BaseMesh<BaseVecT>& mesh,
-    const PointsetSurfacePtr<BaseVecT> surface
+    const PointsetSurfacePtr<BaseVecT> surface,
+    int k,
+    TransferWeighting weighting
 )
 {
     if (!surface->pointBuffer()->hasColors())
@@ -52,42 +54,32 @@ boost::optional<DenseVertexMap<Rgb8Color>> calcColorFromPointCloud(
         return boost::none;
     }
 
+    // Insert all keys first, so that the map can be filled in parallel
     DenseVertexMap<Rgb8Color> vertexMap;
-    vertexMap.reserve(mesh.numVertices());
+    vertexMap.reserve(mesh.nextVertexIndex());
 
-    // k-nearest-neighbors
-    const int k = 1;
-
-    UCharChannel colors = *(surface->pointBuffer()->getUCharChannel("colors"));
-
-    vector<size_t> cv;
+    vector<VertexHandle> handles;
+    vector<BaseVecT> positions;
+    handles.reserve(mesh.numVertices());
+    positions.reserve(mesh.numVertices());
     for (auto vertexH: mesh.vertices())
     {
-        cv.clear();
-        auto p = mesh.getVertexPosition(vertexH);
-        surface->searchTree()->kSearch(p, k, cv);
-
-        float r = 0.0f, g = 0.0f, b = 0.0f;
-
-        for (size_t pointIdx : cv)
-        {
-            auto color = colors[pointIdx];
-            r += color[0];
-            g += color[1];
-            b += color[2];
-        }
-
-        r /= k;
-        g /= k;
-        b /= k;
-
-        vertexMap.insert(vertexH, {
-            static_cast<uint8_t>(r),
-            static_cast<uint8_t>(g),
-            static_cast<uint8_t>(b)
-        });
+        handles.push_back(vertexH);
+        positions.push_back(mesh.getVertexPosition(vertexH));
+        vertexMap.insert(vertexH, {0, 0, 0});
     }
 
+    AttributeTransfer<BaseVecT> transfer(*surface, k, weighting);
+    transfer.addChannel("colors");
+    transfer.transfer(positions, [&](size_t i, size_t, const float* color)
+    {
+        vertexMap[handles[i]] = {
+            static_cast<uint8_t>(color[0]),
+            static_cast<uint8_t>(color[1]),
+            static_cast<uint8_t>(color[2])
+        };
+    });
+
     return vertexMap;
 }
 
@@ -200,4 +192,45 @@ Rgb8Color calcColorForFaceCentroid(
     }
 }
 
+template<typename BaseVecT>
+DenseFaceMap<Rgb8Color> calcColorsForFaceCentroids(
+    const BaseMesh<BaseVecT>& mesh,
+    const PointsetSurface<BaseVecT>& surface,
+    const vector<FaceHandle>& faces
+)
+{
+    // Insert all keys first, so that the map can be filled in parallel
+    DenseFaceMap<Rgb8Color> colorMap;
+    colorMap.reserve(mesh.nextFaceIndex());
+
+    vector<BaseVecT> centroids;
+    centroids.reserve(faces.size());
+    for (auto faceH : faces)
+    {
+        centroids.push_back(mesh.calcFaceCentroid(faceH));
+        colorMap.insert(faceH, {0, 0, 0});
+    }
+
+    if (!surface.pointBuffer()->hasColors())
+    {
+        return colorMap;
+    }
+
+    AttributeTransfer<BaseVecT> transfer(surface, 1, TransferWeighting::NEAREST);
+    transfer.addChannel("colors");
+    transfer.transfer(centroids, [&](size_t i, size_t, const float* color)
+    {
+        uint8_t r = color[0], g = color[1], b = color[2];
+
+        // Same rounding as in calcColorForFaceCentroid()
+        colorMap[faces[i]] = {
+            static_cast<uint8_t>((floor((((float)r)/255.0)*100.0+0.5)/100.0) * 255.0),
+            static_cast<uint8_t>((floor((((float)g)/255.0)*100.0+0.5)/100.0) * 255.0),
+            static_cast<uint8_t>((floor((((float)b)/255.0)*100.0+0.5)/100.0) * 255.0)
+        };
+    });
+
+    return colorMap;
+}
+
 } // namespace lvr2
@@ -154,6 +154,24 @@ public:
      */
     void setTexturizer(Texturizer<BaseVecT>& texturizer);
 
+    /**
+     * @brief Enables or disables the computation of AKAZE keypoints for the textures
+     *
+     * @param extractFeatures Whether keypoints should be computed (default: true)
+     */
+    void setFeatureExtraction(bool extractFeatures);
+
+    /**
+     * @brief Lets clusters with near identical textures share one texture
+     *
+     * Two textures are considered identical if they have the same size, similar mean
+     * colors and their perceptual hashes differ in at most maxHashDistance bits.
+     *
+     * @param maxHashDistance Maximum hamming distance of the hashes, a negative
+     *                        value disables the deduplication (default)
+     */
+    void setTextureDeduplication(int maxHashDistance);
+
     /**
      * @brief Generates materials
      *
@@ -169,6 +187,10 @@ public:
      * the texturizer generate a texture using the bounding rectangle.
      * Then calculate AKAZE keypoints for the texture image and texture coordinates for each vertex in the cluster.
      *
+     * The textured clusters are processed in batches. Within a batch, the bounding rectangles, textures and
+     * keypoints are computed in parallel, the results are stored in cluster order afterwards.
+     * If deduplication is enabled, a cluster whose texture looks like an already stored one reuses that texture.
+     *
      * @return The materializer result, that contains materials and optional texture data
      */
     MaterializerResult<BaseVecT> generateMaterials();
@@ -192,6 +214,12 @@ private:
     /// Texturizer
     boost::optional<Texturizer<BaseVecT>&> m_texturizer;
 
+    /// Whether AKAZE keypoints are computed for the textures
+    bool m_extractFeatures;
+
+    /// Maximum hash distance of shared textures, negative if disabled
+    int m_maxHashDistance;
+
 };
 
 } // namespace lvr2
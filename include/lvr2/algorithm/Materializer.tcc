@@ -35,8 +35,14 @@
 
 #include "lvr2/algorithm/ClusterAlgorithms.hpp"
 #include "lvr2/algorithm/FinalizeAlgorithms.hpp"
+#include "lvr2/config/lvropenmp.hpp"
+#include "lvr2/io/StageTimer.hpp"
+#include "lvr2/texture/TextureHash.hpp"
 #include <opencv2/features2d.hpp>
 
+#include <algorithm>
+#include <map>
+
 
 namespace lvr2
 {
@@ -51,7 +57,9 @@ Materializer<BaseVecT>::Materializer(
     m_mesh(mesh),
     m_cluster(cluster),
     m_normals(normals),
-    m_surface(surface)
+    m_surface(surface),
+    m_extractFeatures(true),
+    m_maxHashDistance(-1)
 {
 }
 
@@ -70,9 +78,23 @@ void Materializer<BaseVecT>::saveTextures()
     }
 }
 
+template<typename BaseVecT>
+void Materializer<BaseVecT>::setFeatureExtraction(bool extractFeatures)
+{
+    m_extractFeatures = extractFeatures;
+}
+
+template<typename BaseVecT>
+void Materializer<BaseVecT>::setTextureDeduplication(int maxHashDistance)
+{
+    m_maxHashDistance = maxHashDistance;
+}
+
 template<typename BaseVecT>
 MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
 {
+    StageTimer stage("materials");
+
     string msg = timestamp.getElapsedTime() + "Generating materials ";
     ProgressBar progress(m_cluster.numCluster(), msg);
 
@@ -86,18 +108,14 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
     int numClustersTooSmall = 0;
     int numClustersTooLarge = 0;
     int textureCount = 0;
-    int clusterCount = 0;
+    int numSharedTextures = 0;
 
-    // For all clusters ...
+    // Sort the clusters into plain color and textured clusters
+    std::vector<ClusterHandle> colorClusters;
+    std::vector<ClusterHandle> textureClusters;
     for (auto clusterH : m_cluster)
     {
-        ++progress;
-
-
-        // Get number of faces in cluster
-        const Cluster<FaceHandle>& cluster = m_cluster.getCluster(clusterH);
-        int numFacesInCluster = cluster.handles.size();
-
+        int numFacesInCluster = m_cluster.getCluster(clusterH).handles.size();
 
         if (!m_texturizer
             || (m_texturizer && numFacesInCluster < m_texturizer.get().m_texMinClusterSize
@@ -122,95 +140,206 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
                     numClustersTooLarge++;
                 }
             }
+            colorClusters.push_back(clusterH);
+        }
+        else
+        {
+            textureClusters.push_back(clusterH);
+        }
+    }
 
+    // Plain color materials, the centroid colors of all their faces are looked up at once
+    std::vector<FaceHandle> colorFaces;
+    for (auto clusterH : colorClusters)
+    {
+        const Cluster<FaceHandle>& cluster = m_cluster.getCluster(clusterH);
+        colorFaces.insert(colorFaces.end(), cluster.handles.begin(), cluster.handles.end());
+    }
+    const DenseFaceMap<Rgb8Color> faceColors = calcColorsForFaceCentroids(m_mesh, m_surface, colorFaces);
 
-            // Calculate (a sorta-kinda not really) median value
-            std::map<Rgb8Color, int> colorMap;
-            int maxColorCount = 0;
-            Rgb8Color mostUsedColor;
+    std::vector<Rgb8Color> clusterColors(colorClusters.size());
 
-            // For each face ...
-            for (auto faceH : cluster.handles)
+    #pragma omp parallel for schedule(dynamic)
+    for (long i = 0; i < (long)colorClusters.size(); i++)
+    {
+        const Cluster<FaceHandle>& cluster = m_cluster.getCluster(colorClusters[i]);
+
+        // Calculate (a sorta-kinda not really) median value
+        std::map<Rgb8Color, int> colorMap;
+        int maxColorCount = 0;
+        Rgb8Color mostUsedColor;
+
+        // For each face ...
+        for (auto faceH : cluster.handles)
+        {
+            // Calculate color of centroid
+            const Rgb8Color& color = faceColors[faceH];
+            if (colorMap.count(color))
             {
-                // Calculate color of centroid
-                Rgb8Color color = calcColorForFaceCentroid(m_mesh, m_surface, faceH);
-                if (colorMap.count(color))
-                {
-                    colorMap[color]++;
-                }
-                else
-                {
-                    colorMap[color] = 1;
-                }
-                if (colorMap[color] > maxColorCount)
-                {
-                    mostUsedColor = color;
-                }
+                colorMap[color]++;
+            }
+            else
+            {
+                colorMap[color] = 1;
+            }
+            if (colorMap[color] > maxColorCount)
+            {
+                mostUsedColor = color;
             }
+        }
+        clusterColors[i] = mostUsedColor;
 
-            // Create material and save in map
-            Material material;
-            std::array<unsigned char, 3> arr = {
-                static_cast<uint8_t>(mostUsedColor[0]),
-                static_cast<uint8_t>(mostUsedColor[1]),
-                static_cast<uint8_t>(mostUsedColor[2])
-            };
+        ++progress;
+    }
 
-            material.m_color =  std::move(arr);
-              clusterMaterials.insert(clusterH, material);
+    for (size_t i = 0; i < colorClusters.size(); i++)
+    {
+        // Create material and save in map
+        Material material;
+        std::array<unsigned char, 3> arr = {
+            static_cast<uint8_t>(clusterColors[i][0]),
+            static_cast<uint8_t>(clusterColors[i][1]),
+            static_cast<uint8_t>(clusterColors[i][2])
+        };
+
+        material.m_color =  std::move(arr);
+        clusterMaterials.insert(colorClusters[i], material);
+    }
 
-        }
-        else
+    // Textured clusters are processed in batches, so that only a bounded
+    // number of textures and feature descriptors is held in memory at once.
+    // Each batch runs the stages geometry -> texture -> features in parallel,
+    // the results are then stored serially in cluster order.
+    struct TextureJob
+    {
+        boost::optional<BoundingRectangle<typename BaseVecT::CoordType>> boundingRect;
+        Texture texture;
+        TextureHash hash;
+        std::vector<BaseVecT> features3d;
+        cv::Mat descriptors;
+    };
+
+    // Time spent in each stage, summed over all batches
+    double geometryTime = 0, textureTime = 0, featureTime = 0, assemblyTime = 0;
+
+    // Already stored textures for deduplication, grouped by their size
+    std::map<std::pair<unsigned short, unsigned short>,
+             std::vector<std::pair<TextureHash, TextureHandle>>> storedHashes;
+
+    const size_t batchSize = 4 * std::max(1, OpenMPConfig::getNumThreads());
+    for (size_t batchStart = 0; batchStart < textureClusters.size(); batchStart += batchSize)
+    {
+        const size_t batchEnd = std::min(batchStart + batchSize, textureClusters.size());
+        std::vector<TextureJob> jobs(batchEnd - batchStart);
+
+        // Contour and bounding rectangle
+        Timestamp stageTime;
+        #pragma omp parallel for schedule(dynamic)
+        for (long i = 0; i < (long)jobs.size(); i++)
         {
-            // Textures
+            TextureJob& job = jobs[i];
+            ClusterHandle clusterH = textureClusters[batchStart + i];
 
-            // Contour
             std::vector<VertexHandle> contour = calculateClusterContourVertices(
                 clusterH,
                 m_mesh,
                 m_cluster
             );
 
-            // Bounding rectangle
-            BoundingRectangle<typename BaseVecT::CoordType> boundingRect = calculateBoundingRectangle(
+            job.boundingRect.emplace(calculateBoundingRectangle(
                 contour,
                 m_mesh,
-                cluster,
+                m_cluster.getCluster(clusterH),
                 m_normals,
                 m_texturizer.get().m_texelSize,
                 clusterH
-            );
+            ));
+        }
+        geometryTime += stageTime.getElapsedTimeInS();
 
-            cout << "Generate Texture..." << endl;
-            // Create texture
-            TextureHandle texH = m_texturizer.get().generateTexture(
-                textureCount,
-                m_surface,
-                boundingRect
-            );
+        // Textures and their hashes
+        stageTime.resetTimer();
+        #pragma omp parallel for schedule(dynamic)
+        for (long i = 0; i < (long)jobs.size(); i++)
+        {
+            TextureJob& job = jobs[i];
+            job.texture = m_texturizer.get().createTexture(0, m_surface, job.boundingRect.get());
+            if (m_maxHashDistance >= 0)
+            {
+                job.hash = computeTextureHash(job.texture);
+            }
+        }
+        textureTime += stageTime.getElapsedTimeInS();
 
-            std::vector<cv::KeyPoint> keypoints;
-            cv::Mat descriptors;
-            cv::Ptr<cv::AKAZE> detector = cv::AKAZE::create();
-            m_texturizer.get().findKeyPointsInTexture(texH,
-                    boundingRect, detector, keypoints, descriptors);
-            std::vector<BaseVecT> features3d =
-                m_texturizer.get().keypoints23d(keypoints, boundingRect, texH);
+        // AKAZE keypoints
+        stageTime.resetTimer();
+        if (m_extractFeatures)
+        {
+            #pragma omp parallel for schedule(dynamic)
+            for (long i = 0; i < (long)jobs.size(); i++)
+            {
+                TextureJob& job = jobs[i];
+                std::vector<cv::KeyPoint> keypoints;
+                cv::Ptr<cv::AKAZE> detector = cv::AKAZE::create();
+                m_texturizer.get().findKeyPointsInTexture(job.texture,
+                        detector, keypoints, job.descriptors);
+                job.features3d = m_texturizer.get().keypoints23d(keypoints, job.boundingRect.get(), job.texture);
+            }
+        }
+        featureTime += stageTime.getElapsedTimeInS();
+
+        // Store textures, materials and texture coordinates
+        stageTime.resetTimer();
+        for (size_t i = 0; i < jobs.size(); i++)
+        {
+            TextureJob& job = jobs[i];
+            ClusterHandle clusterH = textureClusters[batchStart + i];
+            const Cluster<FaceHandle>& cluster = m_cluster.getCluster(clusterH);
+
+            // Look for a stored texture that looks the same
+            boost::optional<TextureHandle> texH;
+            if (m_maxHashDistance >= 0)
+            {
+                auto& candidates = storedHashes[std::make_pair(job.texture.m_width, job.texture.m_height)];
+                for (auto& candidate : candidates)
+                {
+                    if (isDuplicate(job.hash, candidate.first, m_maxHashDistance))
+                    {
+                        texH = candidate.second;
+                        numSharedTextures++;
+                        break;
+                    }
+                }
+
+                if (!texH)
+                {
+                    job.texture.m_index = textureCount;
+                    texH = m_texturizer.get().addTexture(std::move(job.texture));
+                    candidates.push_back(std::make_pair(job.hash, texH.get()));
+                    textureCount++;
+                }
+            }
+            else
+            {
+                job.texture.m_index = textureCount;
+                texH = m_texturizer.get().addTexture(std::move(job.texture));
+                textureCount++;
+            }
 
             // Transform descriptor from matrix row to float vector
-            for (unsigned int row = 0; row < features3d.size(); ++row)
+            for (unsigned int row = 0; row < job.features3d.size(); ++row)
             {
-                keypoints_map[features3d[row]] =
-                    std::vector<float>(descriptors.ptr(row), descriptors.ptr(row) + descriptors.cols);
+                keypoints_map[job.features3d[row]] =
+                    std::vector<float>(job.descriptors.ptr(row), job.descriptors.ptr(row) + job.descriptors.cols);
             }
 
             // Create material with default color and insert into face map
             Material material;
-            material.m_texture = texH;
+            material.m_texture = texH.get();
             std::array<unsigned char, 3> arr = {255, 255, 255};
 
-            material.m_color = std::move(arr);            
-              clusterMaterials.insert(clusterH, material);
+            material.m_color = std::move(arr);
+            clusterMaterials.insert(clusterH, material);
 
             // Calculate tex coords
             // Insert material into face map for each face
@@ -229,8 +358,8 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
             {
                 // Calculate tex coords
                 TexCoords texCoords = m_texturizer.get().calculateTexCoords(
-                    texH,
-                    boundingRect,
+                    texH.get(),
+                    job.boundingRect.get(),
                     m_mesh.getVertexPosition(vertexH)
                 );
 
@@ -247,11 +376,13 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
                 }
             }
 
-            textureCount++;
+            ++progress;
         }
+        assemblyTime += stageTime.getElapsedTimeInS();
     }
 
     cout << endl;
+    stage.stop();
 
     // Write result
     if (m_texturizer)
@@ -265,6 +396,14 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
 
         cout << timestamp << "Generated " << textureCount << " textures" << endl;
 
+        if (m_maxHashDistance >= 0)
+        {
+            cout << timestamp << numSharedTextures << " clusters share a texture with another cluster" << endl;
+        }
+
+        cout << timestamp << "Texture stages: geometry " << geometryTime << " s, textures "
+             << textureTime << " s, features " << featureTime << " s, assembly " << assemblyTime << " s" << endl;
+
         return MaterializerResult<BaseVecT>(
             clusterMaterials,
             m_texturizer.get().getTextures(),
@@ -280,5 +419,4 @@ MaterializerResult<BaseVecT> Materializer<BaseVecT>::generateMaterials()
 }
 
 
-
 } // namespace lvr2
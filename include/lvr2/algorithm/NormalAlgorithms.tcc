@@ -38,6 +38,7 @@
 using std::vector;
 
 #include "lvr2/geometry/Normal.hpp"
+#include "lvr2/algorithm/AttributeTransfer.hpp"
 
 namespace lvr2
 {
@@ -109,6 +110,10 @@ DenseVertexMap<Normal<typename BaseVecT::CoordType>> calcVertexNormals(
     DenseVertexMap<Normal<typename BaseVecT::CoordType>> normalMap;
     normalMap.reserve(mesh.numVertices());
 
+    // Vertices without usable adjacent faces
+    vector<VertexHandle> fallbackHandles;
+    vector<BaseVecT> fallbackPositions;
+
     for (auto vH: mesh.vertices())
     {
         // Use averaged normals from adjacent faces
@@ -118,36 +123,46 @@ DenseVertexMap<Normal<typename BaseVecT::CoordType>> calcVertexNormals(
         }
         else
         {
-            // Fall back to normals from point cloud
-            if (!surface.pointBuffer()->hasNormals())
-            {
-                // The panic is justified here: in the process of creating the
-                // mesh, normals have to be estimated. These normals are
-                // written to the point buffer.
-                panic("the point buffer needs normals!");
-            }
+            fallbackHandles.push_back(vH);
+            fallbackPositions.push_back(mesh.getVertexPosition(vH));
+        }
+    }
 
-            // Get idx for nearest point to vertex from point cloud
-            auto vertex = mesh.getVertexPosition(vH);
-            vector<size_t> pointIdx;
-            surface.searchTree()->kSearch(vertex, 1, pointIdx);
-            if (pointIdx.empty())
-            {
-                panic("no near point found!");
-            }
+    if (fallbackHandles.empty())
+    {
+        return normalMap;
+    }
 
-            // Get normal for nearest vertex neighbour from point cloud
-            FloatChannelOptional normals = surface.pointBuffer()->getFloatChannel("normals");
-            if(normals)
-            {
-                Normal<typename BaseVecT::CoordType> normal = (*normals)[pointIdx[0]];
-                normalMap.insert(vH, normal);
-            }
-            else
-            {
-                panic("no normal for point found!");
-            }
-        }
+    // Fall back to normals from point cloud
+    if (!surface.pointBuffer()->hasNormals())
+    {
+        // The panic is justified here: in the process of creating the
+        // mesh, normals have to be estimated. These normals are
+        // written to the point buffer.
+        panic("the point buffer needs normals!");
+    }
+
+    // Get normal for nearest vertex neighbour from point cloud, for all
+    // remaining vertices in one pass
+    AttributeTransfer<BaseVecT> transfer(surface, 1, TransferWeighting::NEAREST);
+    if (!transfer.addChannel("normals"))
+    {
+        panic("no normal for point found!");
+    }
+
+    vector<BaseVecT> pointNormals(fallbackHandles.size());
+    size_t notFound = transfer.transfer(fallbackPositions, [&](size_t i, size_t, const float* n)
+    {
+        pointNormals[i] = BaseVecT(n[0], n[1], n[2]);
+    });
+    if (notFound > 0)
+    {
+        panic("no near point found!");
+    }
+
+    for (size_t i = 0; i < fallbackHandles.size(); i++)
+    {
+        normalMap.insert(fallbackHandles[i], Normal<typename BaseVecT::CoordType>(pointNormals[i]));
     }
 
     return normalMap;
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * OutlierFilter.hpp
+ */
+
+#ifndef LVR2_ALGORITHM_OUTLIERFILTER_H_
+#define LVR2_ALGORITHM_OUTLIERFILTER_H_
+
+#include "lvr2/io/PointBuffer.hpp"
+#include "lvr2/reconstruction/KNearestNeighbors.hpp"
+
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief Statistical outlier removal.
+ *
+ * For every point the mean distance to its k nearest neighbors is computed. Points
+ * whose mean distance is larger than the mean of all mean distances plus
+ * `stdDevMult` times their standard deviation are marked as outliers.
+ *
+ * @param neighbors  Neighborhoods of all points. At least k + 1 neighbors per point
+ *                   have to be available, since the point itself is skipped.
+ * @param k          Number of neighbors used for the mean distance
+ * @param stdDevMult Multiple of the standard deviation used as threshold
+ * @param keep       Is filled with one entry per point, 0 for outliers
+ *
+ * @return The number of outliers
+ */
+size_t statisticalOutlierFilter(
+    const KNearestNeighbors& neighbors,
+    size_t k,
+    float stdDevMult,
+    std::vector<unsigned char>& keep);
+
+/**
+ * @brief Radius outlier removal using precomputed neighborhoods.
+ *
+ * A point is an outlier if fewer than `minNeighbors` other points are within
+ * `radius`. Since the neighborhoods are sorted, only the distance of the
+ * minNeighbors-th neighbor has to be checked, so no additional search is needed.
+ *
+ * @param neighbors    Neighborhoods with more than minNeighbors entries per point
+ * @param radius       Search radius
+ * @param minNeighbors Minimum number of neighbors within the radius
+ * @param keep         Is updated with 0 for outliers, existing zeros are kept
+ *
+ * @return The number of new outliers
+ */
+size_t radiusOutlierFilter(
+    const KNearestNeighbors& neighbors,
+    float radius,
+    size_t minNeighbors,
+    std::vector<unsigned char>& keep);
+
+/**
+ * @brief Removes all points that are not kept from the point buffer.
+ *
+ * All channels with one element per point are compacted in place, i.e. the kept
+ * elements are moved to the front in their original order and the channels are
+ * shortened without copying the data.
+ *
+ * @param buffer The point buffer
+ * @param keep   One entry per point, != 0 for points that are kept
+ *
+ * @return The number of remaining points
+ */
+size_t compactPointBuffer(PointBufferPtr buffer, const std::vector<unsigned char>& keep);
+
+} // namespace lvr2
+
+#endif // LVR2_ALGORITHM_OUTLIERFILTER_H_
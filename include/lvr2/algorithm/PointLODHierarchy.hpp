@@ -0,0 +1,334 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * PointLODHierarchy.hpp
+ */
+
+#ifndef LVR2_ALGORITHM_POINTLODHIERARCHY_H_
+#define LVR2_ALGORITHM_POINTLODHIERARCHY_H_
+
+#include "lvr2/geometry/BaseVector.hpp"
+#include "lvr2/geometry/BoundingBox.hpp"
+#include "lvr2/io/PointBuffer.hpp"
+#include "lvr2/types/MatrixTypes.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief A point as it is stored in the data file of a LOD hierarchy.
+ */
+struct PointLODPoint
+{
+    float           x;
+    float           y;
+    float           z;
+    unsigned char   rgba[4];
+};
+
+/**
+ * @brief A node of a LOD hierarchy as it is stored in the hierarchy file.
+ *
+ * Every point is stored in exactly one node. The points of a node are a
+ * subsample of its subtree with a minimum distance of about `spacing`, so
+ * the points of all nodes on the path from the root to a node represent the
+ * cloud at the resolution of that node.
+ */
+struct PointLODNode
+{
+    /// Minimum corner of the (cubic) node
+    float       min[3];
+
+    /// Edge length of the node
+    float       size;
+
+    /// Approximate point spacing of the node
+    float       spacing;
+
+    /// Depth of the node, the root has depth 0
+    uint32_t    depth;
+
+    /// Index of the first point in the data file
+    uint64_t    offset;
+
+    /// Number of points stored in this node
+    uint64_t    numPoints;
+
+    /// Indices of the children or -1
+    int64_t     children[8];
+};
+
+/**
+ * @brief Builds an on-disk level of detail hierarchy for point clouds that
+ *        do not fit into memory.
+ *
+ * The build works in three phases:
+ *  1. addPoints() sorts the incoming points into the cells of a fixed grid
+ *     of chunks and appends them to one temporary file per chunk whenever
+ *     the in-memory buffer is full.
+ *  2. finish() builds an octree for every chunk in parallel. Each inner node
+ *     takes a grid subsample of the points of its children, leaves hold at
+ *     most maxPointsPerNode points.
+ *  3. The levels above the chunks are built bottom up in the same way from
+ *     the chunk roots.
+ *
+ * The memory usage is bounded by the flush size plus the chunks that are
+ * built at the same time. Their points are limited by chunkPointBudget, a
+ * chunk that is larger than the budget is built alone. Such a chunk still
+ * has to fit into memory, a higher chunkLevel makes the chunks smaller.
+ * The result is a file "hierarchy.lod" with the nodes and a file
+ * "points.lod" with the points of all nodes, which can be queried with
+ * PointLODHierarchy.
+ */
+class PointLODBuilder
+{
+public:
+    struct Options
+    {
+        /// Maximum number of points in a leaf
+        size_t  maxPointsPerNode = 20000;
+
+        /// Depth of the chunk grid, i.e. 2^chunkLevel chunks per axis
+        int     chunkLevel = 4;
+
+        /// Number of buffered points before they are written to the chunks
+        size_t  flushSize = 10000000;
+        /// Maximum number of points of the chunks that are built at the same time
+        size_t  chunkPointBudget = 100000000;
+
+        /// Maximum depth of the hierarchy
+        int     maxDepth = 24;
+
+        /// Number of grid cells per axis used for the subsampling of a node
+        int     gridSize = 128;
+    };
+
+    /**
+     * @param directory Output directory, is created if it does not exist
+     * @param bounds    Bounding box of all points that will be added
+     * @param options   Build options
+     */
+    PointLODBuilder(
+        const std::string& directory,
+        const BoundingBox<BaseVector<float>>& bounds,
+        const Options& options);
+
+    PointLODBuilder(
+        const std::string& directory,
+        const BoundingBox<BaseVector<float>>& bounds);
+
+    ~PointLODBuilder();
+
+    /**
+     * @brief Adds the "points" and, if available, the "colors" channel of
+     *        the given buffer.
+     */
+    void addPoints(const PointBufferPtr& buffer);
+
+    /**
+     * @brief Adds n points.
+     *
+     * @param points     n x 3 coordinates
+     * @param colors     n x colorWidth colors or nullptr
+     * @param colorWidth 3 or 4
+     */
+    void addPoints(const float* points, const unsigned char* colors, size_t n, size_t colorWidth);
+
+    /**
+     * @brief Builds the hierarchy and writes it to the output directory.
+     *
+     * @return false if no points were added or the files could not be written
+     */
+    bool finish();
+
+    /// Number of points added so far
+    size_t numPoints() const { return m_numPoints; }
+
+    /// Number of nodes after finish()
+    size_t numNodes() const { return m_nodes.size(); }
+
+    /// Number of points that were written to the data file so far
+    size_t numWrittenPoints() const { return m_dataSize; }
+
+private:
+
+    struct BuildNode
+    {
+        float                       min[3];
+        float                       size;
+        uint32_t                    depth;
+        std::vector<PointLODPoint>  points;
+        int64_t                     children[8];
+    };
+
+    void flush();
+
+    std::string chunkFile(size_t cell) const;
+
+    std::string levelFile(int level, size_t cell) const;
+
+    int64_t buildSubtree(
+        std::vector<PointLODPoint>& points,
+        const float min[3],
+        float size,
+        uint32_t depth,
+        std::vector<BuildNode>& nodes) const;
+
+    /// Moves a grid subsample of the points of the children into the parent
+    void subsample(BuildNode& parent, std::vector<BuildNode*>& children) const;
+
+    /// Writes the points and returns their offset in the data file
+    uint64_t writePoints(const std::vector<PointLODPoint>& points);
+
+    /// Builds the octree of a chunk, the points of its root are kept in a level file
+    void buildChunk(size_t cell, std::vector<int64_t>& chunkRoots);
+
+    /// Builds the levels above the chunks and returns the index of the root
+    int64_t buildUpperLevels(std::vector<int64_t>& chunkRoots);
+
+    bool writeHierarchy(int64_t root);
+
+    PointLODNode toNode(const BuildNode& node) const;
+
+    std::string                 m_directory;
+    Options                     m_options;
+
+    float                       m_min[3];
+    float                       m_size;
+    float                       m_rootSpacing;
+
+    size_t                      m_numPoints;
+    bool                        m_hasColors;
+
+    std::vector<PointLODPoint>  m_buffer;
+    std::vector<size_t>         m_chunkSizes;
+
+    std::mutex                  m_mutex;
+    std::ofstream               m_data;
+    uint64_t                    m_dataSize;
+    std::vector<PointLODNode>   m_nodes;
+};
+
+/**
+ * @brief Read access to a LOD hierarchy written by PointLODBuilder.
+ *
+ * Only the nodes are kept in memory, the points are read from disk when
+ * they are requested. All const methods are thread safe.
+ */
+class PointLODHierarchy
+{
+public:
+    /**
+     * @param directory Directory containing the hierarchy
+     */
+    PointLODHierarchy(const std::string& directory);
+
+    /// True if the hierarchy was read successfully
+    bool isOpen() const { return m_open; }
+
+    /// All nodes, the root is nodes()[root()]
+    const std::vector<PointLODNode>& nodes() const { return m_nodes; }
+
+    /// Index of the root node
+    size_t root() const { return m_root; }
+
+    /// Total number of points
+    size_t numPoints() const { return m_numPoints; }
+
+    /// True if the points have colors
+    bool hasColors() const { return m_hasColors; }
+
+    /**
+     * @brief Selects the nodes that are needed to render the given view.
+     *
+     * Nodes are visited in order of their screen space error, i.e. their
+     * point spacing projected to pixels at their distance to the camera.
+     * A visible node is refined as long as its error is larger than
+     * maxError and the point budget is not exceeded. Parents are always
+     * selected before their children.
+     *
+     * @param planes            Six frustum planes (a, b, c, d) with normals
+     *                          pointing into the frustum
+     * @param camera            Camera position
+     * @param projectionFactor  Pixels per unit length at distance 1, see
+     *                          projectionFactor()
+     * @param maxError          Screen space error budget in pixels
+     * @param pointBudget       Maximum number of points
+     *
+     * @return Indices of the selected nodes
+     */
+    std::vector<size_t> query(
+        const double planes[24],
+        const Vector3f& camera,
+        float projectionFactor,
+        float maxError,
+        size_t pointBudget) const;
+
+    /**
+     * @brief Reads the points of the given nodes.
+     *
+     * @return A buffer with "points" and, if available, "colors"
+     */
+    PointBufferPtr loadPoints(const std::vector<size_t>& nodes) const;
+
+    /**
+     * @brief Returns true if the node intersects the frustum.
+     */
+    static bool intersects(const PointLODNode& node, const double planes[24]);
+
+    /**
+     * @brief Extracts the six normalized frustum planes of a (column vector)
+     *        view projection matrix.
+     */
+    static void frustumPlanes(const Matrix4f& viewProjection, double planes[24]);
+
+    /**
+     * @brief Pixels per unit length at distance 1 for a perspective
+     *        projection with the given vertical field of view (radians).
+     */
+    static float projectionFactor(float screenHeight, float fovY);
+
+private:
+    std::string                 m_directory;
+    bool                        m_open;
+    size_t                      m_root;
+    size_t                      m_numPoints;
+    bool                        m_hasColors;
+    std::vector<PointLODNode>   m_nodes;
+};
+
+} // namespace lvr2
+
+#endif // LVR2_ALGORITHM_POINTLODHIERARCHY_H_
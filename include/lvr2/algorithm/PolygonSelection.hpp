@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * PolygonSelection.hpp
+ */
+
+#ifndef LVR2_ALGORITHM_POLYGONSELECTION_H_
+#define LVR2_ALGORITHM_POLYGONSELECTION_H_
+
+#include "lvr2/io/DataStruct.hpp"
+#include "lvr2/io/PointBuffer.hpp"
+#include "lvr2/types/MatrixTypes.hpp"
+
+#include <array>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief Selects the points of a cloud whose projection lies inside a 2D
+ *        polygon, e.g. a lasso drawn in a viewer.
+ *
+ * The points are sorted into an octree once. A query projects the corners of
+ * the octree nodes into the image: nodes whose projection does not touch the
+ * polygon are skipped, nodes whose projection lies completely inside of it
+ * are accepted as a whole and only the points of the remaining leaves are
+ * tested individually, in parallel. The class does not depend on a GUI and
+ * queries may run in a background thread.
+ */
+class PolygonSelection
+{
+public:
+
+    /**
+     * @brief Builds the octree for the given points.
+     *
+     * @param points        x, y, z coordinates of the points
+     * @param numPoints     number of points (less than 2^32)
+     * @param maxLeafSize   maximum number of points in a leaf of the octree
+     */
+    PolygonSelection(floatArr points, size_t numPoints, size_t maxLeafSize = 1024);
+
+    /**
+     * @brief Builds the octree for the points of the given buffer.
+     */
+    PolygonSelection(PointBufferPtr buffer, size_t maxLeafSize = 1024);
+
+    /**
+     * @brief Returns the indices of all points that are projected into the
+     *        polygon.
+     *
+     * A point is selected if it lies between the near and the far plane of
+     * the projection and its display coordinates lie inside the polygon.
+     *
+     * @param viewProjection    Matrix that maps world coordinates to clip
+     *                          coordinates (OpenGL convention, the visible
+     *                          depth range is -w <= z <= w)
+     * @param viewport          Origin x, y and width, height of the viewport
+     *                          in display coordinates
+     * @param polygon           Vertices of the polygon in display coordinates
+     *
+     * @return Indices of the selected points in no particular order
+     */
+    std::vector<unsigned int> select(
+        const Transformd& viewProjection,
+        const std::array<double, 4>& viewport,
+        const std::vector<Vector2d>& polygon) const;
+
+    /// Number of points in the octree
+    size_t numPoints() const { return m_numPoints; }
+
+    /// Number of nodes of the octree
+    size_t numNodes() const { return m_nodes.size(); }
+
+private:
+
+    /// A node of the octree. The points of a node are stored in
+    /// m_indices[begin, end).
+    struct Node
+    {
+        float           min[3];
+        float           max[3];
+        unsigned int    begin;
+        unsigned int    end;
+        int             children[8];
+    };
+
+    void build(size_t maxLeafSize);
+
+    floatArr                    m_points;
+    size_t                      m_numPoints;
+    std::vector<unsigned int>   m_indices;
+    std::vector<Node>           m_nodes;
+};
+
+} // namespace lvr2
+
+#endif /* LVR2_ALGORITHM_POLYGONSELECTION_H_ */
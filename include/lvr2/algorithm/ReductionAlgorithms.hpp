@@ -67,6 +67,8 @@ namespace lvr2
  *                         FaceMap containing normals; it is expected to return
  *                         an optional float. `boost::none` means that this
  *                         edge cannot be collapsed.
+ * @param[in] verbose If false, no progress is printed. This is useful when
+ *                    several meshes are reduced in parallel.
  *
  * @return The number of edges actually collapsed.
  */
@@ -75,7 +77,8 @@ size_t iterativeEdgeCollapse(
     BaseMesh<BaseVecT>& mesh,
     const size_t count,
     FaceMap<Normal<typename BaseVecT::CoordType>>& faceNormals,
-    CostF collapseCost
+    CostF collapseCost,
+    bool verbose = true
 );
 
 /**
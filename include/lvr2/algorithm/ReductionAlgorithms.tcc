@@ -29,6 +29,7 @@
  * ReductionAlgorithms.tcc
  */
 
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
@@ -86,11 +87,14 @@ size_t iterativeEdgeCollapse(
     BaseMesh<BaseVecT>& mesh,
     const size_t count,
     FaceMap<Normal<typename BaseVecT::CoordType>>& faceNormals,
-    CostF collapseCost
+    CostF collapseCost,
+    bool verbose
 )
 {
-
-    std::cout << timestamp << "Reduce mesh by collapsing " << count << " edges" << std::endl;
+    if (verbose)
+    {
+        std::cout << timestamp << "Reduce mesh by collapsing " << count << " edges" << std::endl;
+    }
 
     Meap<VertexHandle, float> queue(mesh.nextVertexIndex());
     DenseVertexMap<VertexHandle> bestEdge;
@@ -143,25 +147,36 @@ size_t iterativeEdgeCollapse(
     };
 
     // Output
-    string msg_init = timestamp.getElapsedTime()
-        + "Computing all costs for all edges ";
-    ProgressBar progress_init(mesh.numVertices() + 1, msg_init);
-    ++progress_init;
+    std::unique_ptr<ProgressBar> progress_init;
+    if (verbose)
+    {
+        string msg_init = timestamp.getElapsedTime()
+            + "Computing all costs for all edges ";
+        progress_init.reset(new ProgressBar(mesh.numVertices() + 1, msg_init));
+        ++(*progress_init);
+    }
 
     // Calculate initial costs of all edges
     for (const auto fromH: mesh.vertices())
     {
         updateVertex(fromH);
-        ++progress_init;
+        if (progress_init)
+        {
+            ++(*progress_init);
+        }
     }
 
     // Output
-    string msg = timestamp.getElapsedTime()
-        + "Collapsing up to "
-        + std::to_string(count)
-        + "of the edges ";
-    ProgressBar progress(count + 1, msg);
-    ++progress;
+    std::unique_ptr<ProgressBar> progress;
+    if (verbose)
+    {
+        string msg = timestamp.getElapsedTime()
+            + "Collapsing up to "
+            + std::to_string(count)
+            + "of the edges ";
+        progress.reset(new ProgressBar(count + 1, msg));
+        ++(*progress);
+    }
 
     size_t collapsedEdgeCount = 0;
 
@@ -179,7 +194,10 @@ size_t iterativeEdgeCollapse(
             continue;
         }
 
-        ++progress;
+        if (progress)
+        {
+            ++(*progress);
+        }
 
 
         auto toPos = mesh.getVertexPosition(toH);
@@ -232,7 +250,10 @@ size_t iterativeEdgeCollapse(
     }
 
 
-    cout << endl << timestamp << "Collapsed " << collapsedEdgeCount << " edges..." << endl;
+    if (verbose)
+    {
+        cout << endl << timestamp << "Collapsed " << collapsedEdgeCount << " edges..." << endl;
+    }
 
     return collapsedEdgeCount;
 }
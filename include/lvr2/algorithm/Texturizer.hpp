@@ -52,6 +52,8 @@
 
 #include <opencv2/features2d.hpp>
 
+#include <vector>
+
 namespace lvr2
 {
 
@@ -78,6 +80,18 @@ public:
         int texMaxClusterSize
     );
 
+    /**
+     * @brief Selects how texels are colored in generateTexture()
+     *
+     * By default every texel looks up the nearest point of the cloud. With
+     * point splatting enabled, the points around the bounding rectangle are
+     * projected into the texel grid once instead and texels that did not
+     * receive a point are filled with a push-pull pass.
+     *
+     * @param splat true to use point splatting, false for the nearest neighbour lookup
+     */
+    void setPointSplatting(bool splat);
+
     /**
      * @brief Get the texture to a given texture handle
      *
@@ -118,6 +132,18 @@ public:
             std::vector<cv::KeyPoint>&
             keypoints, cv::Mat& descriptors);
 
+    /**
+     * @brief Discover keypoints in a texture that is not stored in the texturizer
+     *
+     * @param[in] texture The texture
+     * @param[in] detector Feature detector to use (any of @c cv::Feature2D)
+     * @param[out] keypoints Vector of keypoints
+     * @param[out] descriptors Matrix of descriptors for the keypoint
+     */
+    void findKeyPointsInTexture(const Texture& texture,
+            const cv::Ptr<cv::Feature2D>& detector,
+            std::vector<cv::KeyPoint>& keypoints, cv::Mat& descriptors) const;
+
     /**
      * @brief Compute 3D coordinates for texture-relative keypoints
      *
@@ -129,12 +155,25 @@ public:
     std::vector<BaseVecT> keypoints23d(const std::vector<cv::KeyPoint>&
         keypoints, const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect, const TextureHandle& h);
 
+    /**
+     * @brief Compute 3D coordinates for keypoints of a texture that is not stored in the texturizer
+     *
+     * @param[in] keypoints Keypoints in image coordinates
+     * @param[in] boundingRect Bounding rectangle of the texture embedded in 3D
+     * @param[in] texture The texture the keypoints were found in
+     *
+     * @return Vector of 3D coordinates of all keypoints
+     */
+    std::vector<BaseVecT> keypoints23d(const std::vector<cv::KeyPoint>&
+        keypoints, const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect, const Texture& texture) const;
+
     /**
      * @brief Generates a texture for a given bounding rectangle
      *
      * Create a grid, based on given information (texel size, bounding rectangle).
      * For each cell in the grid (which represents a texel), let the `PointsetSurface` find the closest point in the
-     * point cloud and use that point's color as color for the texel.
+     * point cloud and use that point's color as color for the texel. If point splatting is enabled, the texels
+     * are colored by splatTexture() instead.
      *
      * @param index The index the texture will get
      * @param surface The point cloud
@@ -148,6 +187,34 @@ public:
         const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect
     );
 
+    /**
+     * @brief Computes the texture for a given bounding rectangle without storing it
+     *
+     * This does the work of generateTexture(). It does not modify the texturizer, so
+     * textures of several clusters can be computed in parallel and stored afterwards
+     * with addTexture().
+     *
+     * @param index The index the texture will get
+     * @param surface The point cloud
+     * @param boundingRect The bounding rectangle of the cluster
+     *
+     * @return The texture
+     */
+    virtual Texture createTexture(
+        int index,
+        const PointsetSurface<BaseVecT>& surface,
+        const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect
+    ) const;
+
+    /**
+     * @brief Stores a texture
+     *
+     * @param texture The texture
+     *
+     * @return Texture handle of the stored texture
+     */
+    TextureHandle addTexture(Texture&& texture);
+
     /**
      * @brief Calculate texture coordinates for a given 3D point in a texture
      *
@@ -176,7 +243,7 @@ public:
         TextureHandle texH,
         const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect,
         const TexCoords& coords
-    );
+    ) const;
 
     /**
      * @brief Calls the save method for each texture
@@ -192,9 +259,44 @@ public:
 
 protected:
 
+    /**
+     * @brief Colors the texels of a texture by projecting the nearby points onto the rectangle
+     *
+     * All points within the bounding sphere of the rectangle are fetched with a single radius
+     * search. Each point is assigned to the texel it projects into, and a texel keeps the color
+     * of the point closest to its center. The texel centers are the same ones the nearest
+     * neighbour lookup samples at. Texels without a point are filled by pushPull().
+     *
+     * @param texture The texture to fill, its size has to match the rectangle
+     * @param surface The point cloud, must have colors
+     * @param boundingRect The bounding rectangle of the cluster
+     */
+    void splatTexture(
+        Texture& texture,
+        const PointsetSurface<BaseVecT>& surface,
+        const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect
+    ) const;
+
+    /**
+     * @brief Fills the holes of an image with a push-pull pass
+     *
+     * The known pixels are averaged into an image pyramid of half resolution per level. On
+     * the way back, every pixel with a weight below one is blended with the bilinearly
+     * interpolated value of the next coarser level.
+     *
+     * @param rgb The colors of the image, three floats per pixel
+     * @param weight The weight of each pixel, 0 for holes
+     * @param width The width of the image
+     * @param height The height of the image
+     */
+    static void pushPull(std::vector<float>& rgb, std::vector<float>& weight, int width, int height);
+
     /// StableVector, that contains all generated textures with texture handles
     StableVector<TextureHandle, Texture> m_textures;
 
+    /// Whether generateTexture() uses splatTexture() instead of the nearest neighbour lookup
+    bool m_pointSplatting;
+
 };
 
 
@@ -40,6 +40,10 @@
 #include <opencv2/highgui.hpp>
 #include <opencv2/imgproc.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 
 namespace lvr2
 {
@@ -52,8 +56,15 @@ Texturizer<BaseVecT>::Texturizer(
 ) :
     m_texelSize(texelSize),
     m_texMinClusterSize(texMinClusterSize),
-    m_texMaxClusterSize(texMaxClusterSize)
+    m_texMaxClusterSize(texMaxClusterSize),
+    m_pointSplatting(false)
+{
+}
+
+template<typename BaseVecT>
+void Texturizer<BaseVecT>::setPointSplatting(bool splat)
 {
+    m_pointSplatting = splat;
 }
 
 
@@ -114,7 +125,7 @@ BaseVecT Texturizer<BaseVecT>::calculateTexCoordsInv(
     TextureHandle h,
     const BoundingRectangle<typename BaseVecT::CoordType>& br,
     const TexCoords& coords
-)
+) const
 {
     return br.m_supportVector + (br.m_vec1 * br.m_minDistA)
                               + br.m_vec1 * coords.u
@@ -131,7 +142,22 @@ TextureHandle Texturizer<BaseVecT>::generateTexture(
     const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect
 )
 {
-    cout << "Wrong" << endl;
+    return addTexture(createTexture(index, surface, boundingRect));
+}
+
+template<typename BaseVecT>
+TextureHandle Texturizer<BaseVecT>::addTexture(Texture&& texture)
+{
+    return m_textures.push(std::move(texture));
+}
+
+template<typename BaseVecT>
+Texture Texturizer<BaseVecT>::createTexture(
+    int index,
+    const PointsetSurface<BaseVecT>& surface,
+    const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect
+) const
+{
     // Calculate the texture size
     unsigned short int sizeX = ceil((boundingRect.m_maxDistA - boundingRect.m_minDistA) / m_texelSize);
     unsigned short int sizeY = ceil((boundingRect.m_maxDistB - boundingRect.m_minDistB) / m_texelSize);
@@ -139,10 +165,11 @@ TextureHandle Texturizer<BaseVecT>::generateTexture(
     // Create texture
     Texture texture(index, sizeX, sizeY, 3, 1, m_texelSize);
 
-    string comment = timestamp.getElapsedTime() + "Computing texture pixels ";
-    ProgressBar progress(sizeX * sizeY, comment);
-
-    if (surface.pointBuffer()->hasColors())
+    if (surface.pointBuffer()->hasColors() && m_pointSplatting)
+    {
+        splatTexture(texture, surface, boundingRect);
+    }
+    else if (surface.pointBuffer()->hasColors())
     {
         UCharChannel colors = *(surface.pointBuffer()->getUCharChannel("colors"));
 
@@ -180,11 +207,8 @@ TextureHandle Texturizer<BaseVecT>::generateTexture(
                 texture.m_data[(sizeY - y - 1) * (sizeX * 3) + 3 * x + 0] = r;
                 texture.m_data[(sizeY - y - 1) * (sizeX * 3) + 3 * x + 1] = g;
                 texture.m_data[(sizeY - y - 1) * (sizeX * 3) + 3 * x + 2] = b;
-
-                ++progress;
             }
         }
-        std::cout << std::endl;
     }
     else
     {
@@ -194,7 +218,172 @@ TextureHandle Texturizer<BaseVecT>::generateTexture(
         }
     }
 
-    return m_textures.push(texture);
+    return texture;
+}
+
+template<typename BaseVecT>
+void Texturizer<BaseVecT>::splatTexture(
+    Texture& texture,
+    const PointsetSurface<BaseVecT>& surface,
+    const BoundingRectangle<typename BaseVecT::CoordType>& br
+) const
+{
+    using CoordType = typename BaseVecT::CoordType;
+
+    const int sizeX = texture.m_width;
+    const int sizeY = texture.m_height;
+    const CoordType texel = m_texelSize;
+
+    UCharChannel colors = *(surface.pointBuffer()->getUCharChannel("colors"));
+    FloatChannel points = *(surface.pointBuffer()->getFloatChannel("points"));
+
+    // Texel x is sampled at minDistA + (x - 0.5) * texel by the nearest
+    // neighbour lookup, so the grid covers [minDistA - texel, minDistA + (sizeX - 1) * texel]
+    CoordType minA = br.m_minDistA - texel;
+    CoordType minB = br.m_minDistB - texel;
+    CoordType lenA = sizeX * texel;
+    CoordType lenB = sizeY * texel;
+
+    BaseVecT center = br.m_supportVector
+        + br.m_vec1 * (minA + lenA / 2)
+        + br.m_vec2 * (minB + lenB / 2);
+    CoordType radius = std::sqrt(lenA * lenA + lenB * lenB) / 2;
+
+    vector<size_t> candidates;
+    surface.searchTree()->radiusSearch(center, radius, candidates);
+
+    // Index and squared distance of the point closest to each texel center
+    const size_t numTexels = (size_t)sizeX * sizeY;
+    vector<size_t> nearest(numTexels, std::numeric_limits<size_t>::max());
+    vector<CoordType> nearestDist(numTexels, std::numeric_limits<CoordType>::max());
+
+    for (size_t idx : candidates)
+    {
+        BaseVecT w = BaseVecT(points[idx]) - br.m_supportVector;
+        CoordType a = (w.dot(br.m_vec1) - minA) / texel;
+        CoordType b = (w.dot(br.m_vec2) - minB) / texel;
+        if (a < 0 || b < 0 || a >= sizeX || b >= sizeY)
+        {
+            continue;
+        }
+
+        int x = (int)a;
+        int y = (int)b;
+        CoordType da = (a - x - CoordType(0.5)) * texel;
+        CoordType db = (b - y - CoordType(0.5)) * texel;
+        CoordType h = w.dot(br.m_normal);
+        CoordType dist = da * da + db * db + h * h;
+
+        size_t t = (size_t)y * sizeX + x;
+        if (dist < nearestDist[t])
+        {
+            nearestDist[t] = dist;
+            nearest[t] = idx;
+        }
+    }
+
+    vector<float> rgb(3 * numTexels, 0.0f);
+    vector<float> weight(numTexels, 0.0f);
+    for (size_t t = 0; t < numTexels; t++)
+    {
+        if (nearest[t] != std::numeric_limits<size_t>::max())
+        {
+            auto color = colors[nearest[t]];
+            rgb[3 * t + 0] = color[0];
+            rgb[3 * t + 1] = color[1];
+            rgb[3 * t + 2] = color[2];
+            weight[t] = 1.0f;
+        }
+    }
+
+    pushPull(rgb, weight, sizeX, sizeY);
+
+    // Texture rows are stored top down
+    for (int y = 0; y < sizeY; y++)
+    {
+        unsigned char* row = texture.m_data + (size_t)(sizeY - y - 1) * sizeX * 3;
+        for (int x = 0; x < sizeX * 3; x++)
+        {
+            row[x] = (unsigned char)std::min(255.0f, std::max(0.0f, std::round(rgb[(size_t)y * sizeX * 3 + x])));
+        }
+    }
+}
+
+template<typename BaseVecT>
+void Texturizer<BaseVecT>::pushPull(vector<float>& rgb, vector<float>& weight, int width, int height)
+{
+    if (width <= 1 && height <= 1)
+    {
+        return;
+    }
+
+    // Push: average the known pixels into the next coarser level
+    int coarseWidth = (width + 1) / 2;
+    int coarseHeight = (height + 1) / 2;
+    vector<float> coarseRGB(3 * (size_t)coarseWidth * coarseHeight, 0.0f);
+    vector<float> coarseWeight((size_t)coarseWidth * coarseHeight, 0.0f);
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            size_t i = (size_t)y * width + x;
+            size_t c = (size_t)(y / 2) * coarseWidth + x / 2;
+            float w = weight[i];
+            coarseRGB[3 * c + 0] += w * rgb[3 * i + 0];
+            coarseRGB[3 * c + 1] += w * rgb[3 * i + 1];
+            coarseRGB[3 * c + 2] += w * rgb[3 * i + 2];
+            coarseWeight[c] += w;
+        }
+    }
+
+    for (size_t c = 0; c < coarseWeight.size(); c++)
+    {
+        if (coarseWeight[c] > 0)
+        {
+            coarseRGB[3 * c + 0] /= coarseWeight[c];
+            coarseRGB[3 * c + 1] /= coarseWeight[c];
+            coarseRGB[3 * c + 2] /= coarseWeight[c];
+            coarseWeight[c] = std::min(1.0f, coarseWeight[c]);
+        }
+    }
+
+    pushPull(coarseRGB, coarseWeight, coarseWidth, coarseHeight);
+
+    // Pull: blend the holes with the interpolated coarser level
+    for (int y = 0; y < height; y++)
+    {
+        float cy = std::min(std::max((y + 0.5f) / 2 - 0.5f, 0.0f), coarseHeight - 1.0f);
+        int y0 = (int)cy;
+        int y1 = std::min(y0 + 1, coarseHeight - 1);
+        float fy = cy - y0;
+
+        for (int x = 0; x < width; x++)
+        {
+            size_t i = (size_t)y * width + x;
+            float w = weight[i];
+            if (w >= 1.0f)
+            {
+                continue;
+            }
+
+            float cx = std::min(std::max((x + 0.5f) / 2 - 0.5f, 0.0f), coarseWidth - 1.0f);
+            int x0 = (int)cx;
+            int x1 = std::min(x0 + 1, coarseWidth - 1);
+            float fx = cx - x0;
+
+            for (int k = 0; k < 3; k++)
+            {
+                float c00 = coarseRGB[3 * ((size_t)y0 * coarseWidth + x0) + k];
+                float c01 = coarseRGB[3 * ((size_t)y0 * coarseWidth + x1) + k];
+                float c10 = coarseRGB[3 * ((size_t)y1 * coarseWidth + x0) + k];
+                float c11 = coarseRGB[3 * ((size_t)y1 * coarseWidth + x1) + k];
+                float c = (1 - fy) * ((1 - fx) * c00 + fx * c01) + fy * ((1 - fx) * c10 + fx * c11);
+                rgb[3 * i + k] = w * rgb[3 * i + k] + (1 - w) * c;
+            }
+            weight[i] = 1.0f;
+        }
+    }
 }
 
 
@@ -204,7 +393,14 @@ void Texturizer<BaseVecT>::findKeyPointsInTexture(const TextureHandle texH,
         const cv::Ptr<cv::Feature2D>& detector,
         std::vector<cv::KeyPoint>& keypoints, cv::Mat& descriptors)
 {
-    const Texture texture = m_textures[texH];
+    findKeyPointsInTexture(m_textures[texH], detector, keypoints, descriptors);
+}
+
+template<typename BaseVecT>
+void Texturizer<BaseVecT>::findKeyPointsInTexture(const Texture& texture,
+        const cv::Ptr<cv::Feature2D>& detector,
+        std::vector<cv::KeyPoint>& keypoints, cv::Mat& descriptors) const
+{
     if (texture.m_height <= 32 && texture.m_width <= 32)
     {
         return;
@@ -219,11 +415,18 @@ void Texturizer<BaseVecT>::findKeyPointsInTexture(const TextureHandle texH,
 template<typename BaseVecT>
 std::vector<BaseVecT> Texturizer<BaseVecT>::keypoints23d(const std::vector<cv::KeyPoint>&
         keypoints, const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect, const TextureHandle& h)
+{
+    return keypoints23d(keypoints, boundingRect, m_textures[h]);
+}
+
+template<typename BaseVecT>
+std::vector<BaseVecT> Texturizer<BaseVecT>::keypoints23d(const std::vector<cv::KeyPoint>&
+        keypoints, const BoundingRectangle<typename BaseVecT::CoordType>& boundingRect, const Texture& texture) const
 {
     const size_t N = keypoints.size();
     std::vector<BaseVecT> keypoints3d(N);
-    const int width            = m_textures[h].m_width;
-    const int height           = m_textures[h].m_height;
+    const int width            = texture.m_width;
+    const int height           = texture.m_height;
 
     for (size_t p_idx = 0; p_idx < N; ++p_idx)
     {
@@ -234,7 +437,7 @@ std::vector<BaseVecT> Texturizer<BaseVecT>::keypoints23d(const std::vector<cv::K
         // I'm not sure why we need to mirror this coordinate, but it works like
         // this
         const float v      = 1 - keypoint.y / height;
-        BaseVecT location  = calculateTexCoordsInv(h, boundingRect, TexCoords(u, v));
+        BaseVecT location  = calculateTexCoordsInv(TextureHandle(texture.m_index), boundingRect, TexCoords(u, v));
         keypoints3d[p_idx] = location;
     }
     return keypoints3d;
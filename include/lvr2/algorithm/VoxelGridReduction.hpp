@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * VoxelGridReduction.hpp
+ */
+
+#ifndef LVR2_ALGORITHM_VOXELGRIDREDUCTION_H_
+#define LVR2_ALGORITHM_VOXELGRIDREDUCTION_H_
+
+#include "lvr2/io/PointBuffer.hpp"
+#include "lvr2/types/MatrixTypes.hpp"
+
+#include <string>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief The point that represents a voxel in the reduced cloud.
+ */
+enum class VoxelRepresentative
+{
+    /// The point with the lowest index in the voxel
+    FIRST,
+    /// The centroid of all points in the voxel. All channels except "points"
+    /// are taken from the point that is closest to the centroid.
+    CENTROID,
+    /// The point that is closest to the centroid of the voxel
+    CLOSEST
+};
+
+/**
+ * @brief Parses "first", "centroid" or "closest".
+ *
+ * @throws std::invalid_argument if the name is none of them
+ */
+VoxelRepresentative voxelRepresentativeFromString(const std::string& name);
+
+/**
+ * @brief Voxel grid downsampling in linear time.
+ *
+ * The voxel key of every point is computed in parallel, the keys are sorted with
+ * a parallel LSD radix sort and every run of equal keys is replaced by one
+ * representative. All channels with one element per point are gathered into
+ * the reduced buffer in a single pass over the voxels.
+ */
+class VoxelGridReduction
+{
+public:
+    /**
+     * @param voxelSize         Edge length of the voxels
+     * @param representative    The point that is kept for each voxel
+     * @param minPointsPerVoxel Voxels with fewer points are dropped
+     */
+    VoxelGridReduction(
+        float voxelSize,
+        VoxelRepresentative representative = VoxelRepresentative::CLOSEST,
+        size_t minPointsPerVoxel = 1);
+
+    /**
+     * @brief Returns a new buffer containing one point per occupied voxel.
+     *
+     * Channels that do not have one element per point are shared with the
+     * input buffer.
+     */
+    PointBufferPtr reduce(PointBufferPtr buffer);
+
+    /**
+     * @brief Reduces the given points in place.
+     *
+     * @return The number of remaining points, which are stored at the
+     *         beginning of the array
+     */
+    size_t reduce(Vector3f* points, size_t n);
+
+    /// Number of input points of the last reduction
+    size_t numInputPoints() const { return m_numInputPoints; }
+
+    /// Number of output points of the last reduction
+    size_t numOutputPoints() const { return m_numOutputPoints; }
+
+    /// Run time of the last reduction in seconds
+    double seconds() const { return m_seconds; }
+
+    /// Input points per second of the last reduction
+    double throughput() const;
+
+private:
+
+    /**
+     * @brief Sorts the points into voxels.
+     *
+     * @param points    n x 3 coordinates
+     * @param n         Number of points
+     * @param order     Point indices, sorted by voxel
+     * @param voxels    Start of every voxel in order, followed by n
+     *
+     * @return false if the voxel grid is too large for 64 bit keys
+     */
+    bool sortIntoVoxels(
+        const float* points,
+        size_t n,
+        std::vector<size_t>& order,
+        std::vector<size_t>& voxels) const;
+
+    /**
+     * @brief Selects the representatives of all voxels with enough points.
+     *
+     * @param centroids If not null, is filled with the centroid of every
+     *                  selected voxel
+     */
+    void selectRepresentatives(
+        const float* points,
+        const std::vector<size_t>& order,
+        const std::vector<size_t>& voxels,
+        std::vector<size_t>& representatives,
+        std::vector<float>* centroids) const;
+
+    float                   m_voxelSize;
+    VoxelRepresentative     m_representative;
+    size_t                  m_minPointsPerVoxel;
+
+    size_t                  m_numInputPoints;
+    size_t                  m_numOutputPoints;
+    double                  m_seconds;
+};
+
+} // namespace lvr2
+
+#endif // LVR2_ALGORITHM_VOXELGRIDREDUCTION_H_
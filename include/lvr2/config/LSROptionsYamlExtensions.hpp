@@ -72,6 +72,8 @@ struct convert<lvr2::LSROptions>
         node["smallRegionThreshold"] = options.smallRegionThreshold;
         node["retesselate"] = options.retesselate;
         node["lineFusionThreshold"] = options.lineFusionThreshold;
+        node["incremental"] = options.incremental;
+        node["remeshThreshold"] = options.remeshThreshold;
 
         return node;
     }
@@ -203,6 +205,16 @@ struct convert<lvr2::LSROptions>
             options.lineFusionThreshold = node["lineFusionThreshold"].as<float>();
         }
 
+        if (node["incremental"])
+        {
+            options.incremental = node["incremental"].as<bool>();
+        }
+
+        if (node["remeshThreshold"])
+        {
+            options.remeshThreshold = node["remeshThreshold"].as<float>();
+        }
+
         return true;
     }
 };
@@ -59,6 +59,7 @@ struct convert<lvr2::SLAMOptions>
         // ==================== Reduction Options ====================================================
 
         node["reduction"] = options.reduction;
+        node["voxelGridReduction"] = options.voxelGridReduction;
         node["minDistance"] = options.minDistance;
         node["maxDistance"] = options.maxDistance;
 
@@ -128,6 +129,11 @@ struct convert<lvr2::SLAMOptions>
             options.reduction = node["reduction"].as<double>();
         }
 
+        if (node["voxelGridReduction"])
+        {
+            options.voxelGridReduction = node["voxelGridReduction"].as<bool>();
+        }
+
         if (node["minDistance"])
         {
             options.minDistance = node["minDistance"].as<double>();
@@ -128,6 +128,48 @@ size_t countPointsInFile(const boost::filesystem::path& inFile);
 template<typename T>
 void writeFrame(const Transform<T>& transform, const boost::filesystem::path& framesOut);
 
+/// A single entry of a frames file: the (column major) transformation and its use flag
+using Frame = std::pair<Transformd, int>;
+
+/**
+ * @brief   Returns true if the given file starts with the magic number of the
+ *          binary frames format (see \ref writeFrames).
+ */
+bool isBinaryFrames(const boost::filesystem::path& file);
+
+/**
+ * @brief   Reads all frames from a text or binary frames file. The format is
+ *          detected from the file content, not from the extension.
+ *
+ * @param   file        A .frames or .bframes file
+ * @return  The frames in file order. Empty if the file could not be read.
+ */
+std::vector<Frame> readFrames(const boost::filesystem::path& file);
+
+/**
+ * @brief   Writes the given frames to a file. Files with the extension .bframes
+ *          are written in binary with all values in little endian byte order:
+ *          the magic "LVRF", a uint32 version (2) and a uint64 frame count,
+ *          followed by the use flag as int32 and a flag byte per frame. Unless
+ *          the frame repeats the previous transformation, the flag byte is
+ *          followed by the upper three rows of the matrix as doubles in column
+ *          major order (all four rows for non affine matrices). Repeated poses
+ *          of unchanged scans thus take five bytes and all values stay exact.
+ *          All other files are written in the slam6d text format.
+ *
+ * @param   frames      The frames to write
+ * @param   framesOut   The target file
+ */
+void writeFrames(const std::vector<Frame>& frames, const boost::filesystem::path& framesOut);
+
+/**
+ * @brief   Converts a text frames file into a binary one and vice versa.
+ *          The target format is chosen by the extension of \ref out.
+ *
+ * @return  The number of converted frames
+ */
+size_t convertFrames(const boost::filesystem::path& in, const boost::filesystem::path& out);
+
 /**
  * @brief               Writes pose information in Euler representation to the given file
  * 
@@ -56,6 +56,16 @@ Transform<T> getTransformationFromPose(const boost::filesystem::path& pose)
 template<typename T>
 Transform<T> getTransformationFromFrames(const boost::filesystem::path& frames)
 {
+    if(isBinaryFrames(frames))
+    {
+        std::vector<Frame> all = readFrames(frames);
+        if(all.empty())
+        {
+            return Transform<T>::Identity();
+        }
+        return all.back().first.template cast<T>();
+    }
+
     T alignxf[16];
     int color;
 
@@ -101,6 +111,12 @@ Transform<T> getTransformationFromDat(const boost::filesystem::path& frames)
 template<typename T>
 void writeFrame(const Transform<T>& transform, const boost::filesystem::path& framesOut)
 {
+    if(framesOut.extension() == ".bframes")
+    {
+        writeFrames({ Frame(transform.template cast<double>(), 0) }, framesOut);
+        return;
+    }
+
     std::ofstream out(framesOut.c_str());
 
     // write the rotation matrix
@@ -145,7 +161,7 @@ Transform<T> getTransformationFromFile(const boost::filesystem::path& file)
     {
         return getTransformationFromPose<T>(file);
     }
-    else if(extension == ".frames")
+    else if(extension == ".frames" || extension == ".bframes")
     {
         return getTransformationFromFrames<T>(file);
     }
@@ -56,6 +56,21 @@ public:
      */
     virtual ModelPtr read(string filename );
 
+    /**
+     * @brief Parse the given file with several threads. The point range
+     *        is split into blocks that are aligned to the LAZ chunk
+     *        table (or arbitrary for uncompressed files) and each block
+     *        is decoded by an independent reader directly into the
+     *        channels of the returned point buffer. RGB colors, GPS
+     *        time and classifications are loaded if the file contains
+     *        them.
+     *
+     * @param filename      The file to read.
+     * @param numThreads    Number of threads. If zero, the number of
+     *                      threads configured in OpenMPConfig is used.
+     */
+    ModelPtr read(string filename, int numThreads);
+
     /**
      * @brief Save the loaded elements to the given file.
      *
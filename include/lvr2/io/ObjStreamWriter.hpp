@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       ObjStreamWriter.hpp
+ * @brief      Incremental writer for Wavefront OBJ files.
+ */
+
+#ifndef LVR2_IO_OBJSTREAMWRITER_HPP_
+#define LVR2_IO_OBJSTREAMWRITER_HPP_
+
+#include "lvr2/io/StreamWriter.hpp"
+
+#include <fstream>
+#include <string>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Writes OBJ files batch by batch. Vertex colors are appended to
+ *          the vertex definitions as normalized RGB values like ObjIO does.
+ *          Intensities are not supported by the format and are ignored.
+ */
+class ObjStreamWriter : public StreamWriter
+{
+public:
+
+    /**
+     * @brief   Creates the output file.
+     *
+     * @param filename      Name of the OBJ file to write
+     * @param schema        Attributes to write
+     * @param bufferSize    Size of the internal write buffer in bytes
+     */
+    ObjStreamWriter(const std::string& filename, const StreamSchema& schema,
+                    size_t bufferSize = 1 << 22);
+
+    /// Closes the file if close() has not been called yet
+    ~ObjStreamWriter();
+
+    void addVertices(
+        size_t n,
+        const float* vertices,
+        const unsigned char* colors = nullptr,
+        size_t colorWidth = 3,
+        const float* normals = nullptr,
+        const float* intensities = nullptr) override;
+
+    void addFaces(size_t n, const unsigned int* indices, size_t indexOffset = 0) override;
+
+    void close() override;
+
+    /// Returns true if the output file could be opened
+    bool good() const { return m_good; }
+
+private:
+
+    /// Writes the buffer if it exceeds the buffer size
+    void flushIfFull();
+
+    std::ofstream       m_out;
+    std::string         m_buffer;
+    size_t              m_bufferSize;
+    bool                m_good;
+    bool                m_closed;
+};
+
+} // namespace lvr2
+
+#endif // LVR2_IO_OBJSTREAMWRITER_HPP_
@@ -107,7 +107,7 @@ class PLYIO : public BaseIO
         /**
          * \brief Constructor.
          **/
-        PLYIO()
+        PLYIO() : m_fastBinaryRead(true)
         {
             setlocale (LC_ALL, "C");
             m_model.reset();
@@ -162,8 +162,56 @@ class PLYIO : public BaseIO
         ModelPtr read( string filename );
 
 
+        /**
+         * \brief Enables or disables the fast path for binary files.
+         *
+         * If enabled (default), the body of binary PLY files whose elements
+         * have a fixed record size is memory mapped and de-interleaved
+         * directly into the buffers. ASCII files and files with variable
+         * length lists are always read via RPly.
+         *
+         * \param fast         Use the fast binary reader if possible.
+         **/
+        void setFastBinaryRead( bool fast ) { m_fastBinaryRead = fast; }
+
+
     private:
 
+        /**
+         * \brief Destination of a scalar property for the binary fast path.
+         **/
+        struct BinaryTarget
+        {
+            /// Name of the element and property
+            const char*     element;
+            const char*     property;
+
+            /// Destination buffer type (PLY_FLOAT, PLY_UCHAR or PLY_SHORT)
+            e_ply_type      type;
+
+            /// Destination buffer, number of components and component index
+            void*           data;
+            size_t          width;
+            size_t          component;
+        };
+
+
+        /**
+         * \brief Reads the body of a binary PLY file without RPly callbacks.
+         *
+         * \param ply          RPly handle with an already parsed header.
+         * \param filename     Filename of the file to read.
+         * \param targets      Destinations of the scalar properties to read.
+         * \param faces        Destination of the face indices or NULL.
+         *
+         * \return False if the file can not be read with the fast path. In
+         *         this case the caller has to fall back to RPly.
+         **/
+        bool readBinary( p_ply ply, const string& filename,
+                const std::vector<BinaryTarget>& targets, unsigned int* faces );
+
+
+
 
         /**
          * \brief Callback for read vertices.
@@ -192,6 +240,9 @@ class PLYIO : public BaseIO
          **/
         static int readPanoramaCoordCB( p_ply_argument argument );
 
+        /// Use the fast binary reader if possible
+        bool m_fastBinaryRead;
+
 };
 
 } // namespace lvr2
@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       PLYStreamWriter.hpp
+ * @brief      Incremental writer for binary PLY files.
+ */
+
+#ifndef LVR2_IO_PLYSTREAMWRITER_HPP_
+#define LVR2_IO_PLYSTREAMWRITER_HPP_
+
+#include "lvr2/io/StreamWriter.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Writes binary PLY files in host byte order batch by batch.
+ *
+ * Vertices are written to the output file directly. Since PLY requires all
+ * vertices to precede the faces, face batches are buffered in a temporary
+ * file next to the output and appended when the writer is closed. The
+ * header is written with zero padded element counts that are patched at close.
+ */
+class PLYStreamWriter : public StreamWriter
+{
+public:
+
+    /**
+     * @brief   Creates the output file and writes a preliminary header.
+     *
+     * @param filename      Name of the PLY file to write
+     * @param schema        Attributes to write
+     * @param bufferSize    Size of the internal write buffers in bytes
+     */
+    PLYStreamWriter(const std::string& filename, const StreamSchema& schema,
+                    size_t bufferSize = 1 << 22);
+
+    /// Closes the file if close() has not been called yet
+    ~PLYStreamWriter();
+
+    void addVertices(
+        size_t n,
+        const float* vertices,
+        const unsigned char* colors = nullptr,
+        size_t colorWidth = 3,
+        const float* normals = nullptr,
+        const float* intensities = nullptr) override;
+
+    void addFaces(size_t n, const unsigned int* indices, size_t indexOffset = 0) override;
+
+    void close() override;
+
+    /// Returns true if the output file could be opened
+    bool good() const { return m_good; }
+
+private:
+
+    /// Writes the header with the current element counts
+    void writeHeader();
+
+    /// Writes the content of the buffer to the stream and clears it
+    void flush(std::vector<char>& buffer, std::ofstream& out);
+
+    /// Output file and temporary face file
+    std::string         m_filename;
+    std::string         m_faceFilename;
+    std::ofstream       m_out;
+    std::ofstream       m_faceOut;
+
+    /// Write buffers for vertices and faces
+    std::vector<char>   m_vertexBuffer;
+    std::vector<char>   m_faceBuffer;
+    size_t              m_bufferSize;
+
+    /// Size of a vertex record in bytes
+    size_t              m_vertexSize;
+
+    bool                m_good;
+    bool                m_closed;
+};
+
+} // namespace lvr2
+
+#endif // LVR2_IO_PLYSTREAMWRITER_HPP_
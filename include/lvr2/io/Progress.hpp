@@ -38,6 +38,9 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <atomic>
+#include <memory>
+#include <mutex>
 
 using std::stringstream;
 using std::cout;
@@ -60,6 +63,12 @@ namespace lvr2
  * 	After each iteration the ++-operator should be called. The
  * 	progress information in '%' is automatically printed to stdout
  * 	together with the given prefix string.
+ *
+ * 	The increments are counted in per thread counters without locking,
+ * 	so the operator can be called in parallel loops. The counters are
+ * 	added to the total in steps of about 1/200 % of the iterations, and
+ * 	on every increment during the last 0.5 %, so that 100 % is printed
+ * 	with the last iteration.
  */
 
 typedef void(*ProgressCallbackPtr)(int);
@@ -111,20 +120,42 @@ protected:
     /// Prints the output
     void print_bar();
 
+    /// Adds the counter of the calling thread (and at the end the counters
+    /// of all threads) to the total and prints the new progress
+    void update(size_t shard);
+
+    /// Counter of one or more threads, aligned to avoid false sharing
+    struct alignas(64) Shard
+    {
+        std::atomic<size_t> count{0};
+    };
+
+    /// Number of per thread counters
+    static constexpr size_t NumShards = 64;
+
     /// The prefix string
     string 			m_prefix;
 
     /// The number of iterations
     size_t			m_maxVal;
 
-        /// The current counter
-    size_t	 		m_currentVal;
+    /// The current counter (sum of all flushed thread counters)
+    std::atomic<size_t>	m_currentVal;
+
+    /// Per thread counters
+    std::unique_ptr<Shard[]> m_shards;
+
+    /// Number of iterations after which a thread counter is added to m_currentVal
+    size_t			m_flushStep;
 
-    /// A mutex object for counter increment (for parallel executions)
-    boost::mutex 	m_mutex;
+    /// Total above which all thread counters are added on every increment
+    size_t			m_flushLimit;
+
+    /// A mutex object for the output (for parallel executions)
+    std::mutex 		m_printMutex;
 
     /// The current progress in percent
-    int			m_percent;
+    std::atomic<int>	m_percent;
 
     /// A string stream for output generation
     stringstream	m_stream;
@@ -163,8 +194,8 @@ public:
 
 protected:
 
-    /// Prints the current state
-    void print_progress();
+    /// Prints the given state
+    void print_progress(size_t value);
 
     /// The prefix string
     string 			m_prefix;
@@ -173,10 +204,7 @@ protected:
     size_t			m_stepVal;
 
     /// The current counter value
-    size_t			m_currentVal;
-
-    /// A mutex object for counter increment (for parallel executions)
-    boost::mutex 	m_mutex;
+    std::atomic<size_t>	m_currentVal;
 
     /// A string stream for output generation
     stringstream	m_stream;
@@ -0,0 +1,195 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * StageTimer.hpp
+ */
+
+#ifndef LVR2_IO_STAGETIMER_HPP_
+#define LVR2_IO_STAGETIMER_HPP_
+
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Timing values of one processing stage
+ */
+struct StageRecord
+{
+    /// Name of the stage, prefixed with the names of its parent stages ("parent/child")
+    std::string name;
+
+    /// Nesting depth, 0 for top level stages
+    int depth;
+
+    /// Wall clock start time in seconds since the first stage of the program
+    double start;
+
+    /// Wall clock time in seconds
+    double wallTime;
+
+    /// CPU time (user + system, all threads) in seconds
+    double cpuTime;
+
+    /// Peak resident set size of the process at the end of the stage in kB
+    long peakRSS;
+};
+
+/**
+ * @brief   Collects the timing values of named, nestable processing stages.
+ *          Stages are opened and closed by @ref StageTimer objects, a stage
+ *          opened while another one is running on the same thread becomes its
+ *          child. The report can be written as JSON or CSV.
+ */
+class StageReport
+{
+public:
+
+    /**
+     * @brief   Returns the global report
+     */
+    static StageReport& instance();
+
+    /**
+     * @brief   Opens a new stage as child of the innermost stage that is
+     *          running on the calling thread
+     *
+     * @return  Index of the stage record
+     */
+    size_t begin(const std::string& name);
+
+    /**
+     * @brief   Closes the stage with the given index
+     */
+    void end(size_t index);
+
+    /**
+     * @brief   Returns a copy of all records in the order the stages were opened.
+     *          Stages that are still running have a negative wall time.
+     */
+    std::vector<StageRecord> records() const;
+
+    /**
+     * @brief   Writes the report to the given file. Files ending with ".csv"
+     *          are written as CSV, all others as JSON.
+     *
+     * @return  false if the file could not be written
+     */
+    bool save(const std::string& filename) const;
+
+    /**
+     * @brief   Writes the report as JSON array of stage objects
+     */
+    void writeJSON(std::ostream& os) const;
+
+    /**
+     * @brief   Writes the report as CSV table with one stage per line
+     */
+    void writeCSV(std::ostream& os) const;
+
+    /**
+     * @brief   Returns the CPU time (user + system) of the process in seconds
+     */
+    static double processCPUTime();
+
+    /**
+     * @brief   Returns the peak resident set size of the process in kB,
+     *          0 if it is not available on this platform
+     */
+    static long processPeakRSS();
+
+private:
+
+    StageReport();
+
+    /// Wall clock time since creation of the report in seconds
+    double wallTime() const;
+
+    /// Guards m_records
+    mutable std::mutex m_mutex;
+
+    /// Records of all stages
+    std::vector<StageRecord> m_records;
+
+    /// CPU times at the start of the stages
+    std::vector<double> m_cpuStart;
+
+    /// Time of creation
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief   Scope guard for a named stage of the @ref StageReport. The stage
+ *          is started on construction and stopped on destruction or by
+ *          calling @ref stop.
+ *
+ *  {
+ *      StageTimer timer("normals");
+ *      surface->calculateSurfaceNormals();
+ *  }
+ */
+class StageTimer
+{
+public:
+
+    /**
+     * @brief   Starts the stage with the given name
+     */
+    explicit StageTimer(const std::string& name);
+
+    /**
+     * @brief   Stops the stage if it is still running
+     */
+    ~StageTimer();
+
+    /**
+     * @brief   Stops the stage
+     */
+    void stop();
+
+private:
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    /// Index of the stage record
+    size_t m_index;
+
+    /// False after the stage was stopped
+    bool m_running;
+};
+
+} // namespace lvr2
+
+#endif /* LVR2_IO_STAGETIMER_HPP_ */
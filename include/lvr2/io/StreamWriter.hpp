@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       StreamWriter.hpp
+ * @brief      Interface for incremental mesh and point cloud writers.
+ * @details    Stream writers get a schema of the written attributes up
+ *             front and accept batches of vertices and faces, so that
+ *             out-of-core results never have to be materialized in a
+ *             single Model.
+ */
+
+#ifndef LVR2_IO_STREAMWRITER_HPP_
+#define LVR2_IO_STREAMWRITER_HPP_
+
+#include "lvr2/io/MeshBuffer.hpp"
+#include "lvr2/io/PointBuffer.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Attributes written by a StreamWriter. Batches that lack a
+ *          declared attribute are written with zero values.
+ */
+struct StreamSchema
+{
+    /// Write RGB vertex colors
+    bool    vertexColors        = false;
+
+    /// Write vertex normals
+    bool    vertexNormals       = false;
+
+    /// Write one intensity value per vertex
+    bool    vertexIntensities   = false;
+
+    /// Write triangle faces
+    bool    faces               = false;
+};
+
+/**
+ * @brief   Interface for writers that incrementally append vertices and
+ *          faces to a file.
+ */
+class StreamWriter
+{
+public:
+
+    /**
+     * @brief   Creates a writer for the given schema.
+     */
+    StreamWriter(const StreamSchema& schema)
+        : m_schema(schema), m_numVertices(0), m_numFaces(0) {}
+
+    virtual ~StreamWriter() = default;
+
+    /**
+     * @brief   Appends a batch of vertices.
+     *
+     * @param n             Number of vertices in the batch
+     * @param vertices      Vertex positions (x, y, z)
+     * @param colors        Vertex colors or nullptr
+     * @param colorWidth    Number of bytes per color (3 for RGB, 4 for RGBA)
+     * @param normals       Vertex normals (nx, ny, nz) or nullptr
+     * @param intensities   One intensity per vertex or nullptr
+     */
+    virtual void addVertices(
+        size_t n,
+        const float* vertices,
+        const unsigned char* colors = nullptr,
+        size_t colorWidth = 3,
+        const float* normals = nullptr,
+        const float* intensities = nullptr) = 0;
+
+    /**
+     * @brief   Appends a batch of triangles.
+     *
+     * @param n             Number of faces in the batch
+     * @param indices       Three vertex indices per face
+     * @param indexOffset   Offset that is added to all indices, i.e., the
+     *                      number of vertices written before the vertices
+     *                      the batch refers to
+     */
+    virtual void addFaces(size_t n, const unsigned int* indices, size_t indexOffset = 0) = 0;
+
+    /**
+     * @brief   Finishes the file. Further batches are ignored.
+     */
+    virtual void close() = 0;
+
+    /**
+     * @brief   Appends all points of the buffer including the attributes
+     *          declared in the schema.
+     */
+    void addPoints(PointBufferPtr points);
+
+    /**
+     * @brief   Appends the vertices and faces of the given mesh. The face
+     *          indices are shifted by the number of previously written
+     *          vertices.
+     */
+    void addMesh(MeshBufferPtr mesh);
+
+    /// Returns the number of vertices written so far
+    size_t numVertices() const { return m_numVertices; }
+
+    /// Returns the number of faces written so far
+    size_t numFaces() const { return m_numFaces; }
+
+    /// Returns the schema of the written file
+    const StreamSchema& schema() const { return m_schema; }
+
+protected:
+
+    /// The declared attributes
+    StreamSchema    m_schema;
+
+    /// Number of written vertices
+    size_t          m_numVertices;
+
+    /// Number of written faces
+    size_t          m_numFaces;
+};
+
+} // namespace lvr2
+
+#endif // LVR2_IO_STREAMWRITER_HPP_
@@ -45,6 +45,22 @@ class ChunkIO
     template <typename T>
     void saveChunk(T data, std::string layer, int x, int y, int z);
 
+    /**
+     * @brief saves the geometric error of every level of detail of a layer
+     *
+     * @param layer layer whose levels of detail are described
+     * @param errors geometric error per level, starting with the original layer at level 0
+     */
+    void saveLODErrors(std::string layer, const std::vector<float>& errors);
+
+    /**
+     * @brief saves the indices of the scan positions whose tsdf values are fused into a layer
+     *
+     * @param layer tsdf layer
+     * @param scans indices of the fused scan positions
+     */
+    void saveFusedScans(std::string layer, const std::vector<size_t>& scans);
+
     BaseVector<size_t> loadAmount();
 
     float loadChunkSize();
@@ -54,6 +70,22 @@ class ChunkIO
     template <typename T>
     T loadChunk(std::string layer, int x, int y, int z);
 
+    /**
+     * @brief loads the geometric error of every level of detail of a layer
+     *
+     * @param layer layer whose levels of detail are requested
+     * @return geometric error per level or an empty vector if the layer has no levels of detail
+     */
+    std::vector<float> loadLODErrors(std::string layer);
+
+    /**
+     * @brief loads the indices of the scan positions whose tsdf values are fused into a layer
+     *
+     * @param layer tsdf layer
+     * @return indices of the fused scan positions or an empty vector if none were saved
+     */
+    std::vector<size_t> loadFusedScans(std::string layer);
+
   protected:
     Derived* m_file_access                 = static_cast<Derived*>(this);
     ArrayIO<Derived>* m_array_io           = static_cast<ArrayIO<Derived>*>(m_file_access);
@@ -63,6 +95,8 @@ class ChunkIO
     const std::string m_amountName      = "amount";
     const std::string m_chunkSizeName   = "size";
     const std::string m_boundingBoxName = "bounding_box";
+    const std::string m_lodErrorsName   = "_lod_errors";
+    const std::string m_fusedScansName  = "_fused_scans";
 };
 
 } // namespace hdf5features
@@ -54,6 +54,22 @@ void ChunkIO<Derived>::saveChunk(T data, std::string layer, int x, int y, int z)
     static_cast<typename IOType<Derived, T>::io_type*>(m_file_access)->save(dataGroup, data);
 }
 
+template <typename Derived>
+void ChunkIO<Derived>::saveLODErrors(std::string layer, const std::vector<float>& errors)
+{
+    boost::shared_array<float> errorArr(new float[errors.size()]);
+    std::copy(errors.begin(), errors.end(), errorArr.get());
+    m_array_io->save(m_chunkName, layer + m_lodErrorsName, errors.size(), errorArr);
+}
+
+template <typename Derived>
+void ChunkIO<Derived>::saveFusedScans(std::string layer, const std::vector<size_t>& scans)
+{
+    boost::shared_array<size_t> scanArr(new size_t[scans.size()]);
+    std::copy(scans.begin(), scans.end(), scanArr.get());
+    m_array_io->save(m_chunkName, layer + m_fusedScansName, scans.size(), scanArr);
+}
+
 template <typename Derived>
 BaseVector<size_t> ChunkIO<Derived>::loadAmount()
 {
@@ -134,6 +150,34 @@ T ChunkIO<Derived>::loadChunk(std::string layer, int x, int y, int z)
         ->load(m_chunkName + "/" + layer + "/" + chunkName);
 }
 
+template <typename Derived>
+std::vector<float> ChunkIO<Derived>::loadLODErrors(std::string layer)
+{
+    std::vector<float> errors;
+    size_t numLevels;
+    boost::shared_array<float> errorArr
+        = m_array_io->template load<float>(m_chunkName, layer + m_lodErrorsName, numLevels);
+    if (errorArr)
+    {
+        errors.assign(errorArr.get(), errorArr.get() + numLevels);
+    }
+    return errors;
+}
+
+template <typename Derived>
+std::vector<size_t> ChunkIO<Derived>::loadFusedScans(std::string layer)
+{
+    std::vector<size_t> scans;
+    size_t numScans;
+    boost::shared_array<size_t> scanArr
+        = m_array_io->template load<size_t>(m_chunkName, layer + m_fusedScansName, numScans);
+    if (scanArr)
+    {
+        scans.assign(scanArr.get(), scanArr.get() + numScans);
+    }
+    return scans;
+}
+
 } // namespace hdf5features
 
 } // namespace lvr2
@@ -49,6 +49,7 @@
 #include "lvr2/geometry/Normal.hpp"
 #include "lvr2/geometry/Plane.hpp"
 #include "lvr2/io/Progress.hpp"
+#include "lvr2/io/StageTimer.hpp"
 #include "lvr2/geometry/BaseVector.hpp"
 
 
@@ -62,6 +63,7 @@
 
 // #include "SearchTreeNanoflann.hpp"
 #include "SearchTreeFlann.hpp"
+#include "KNearestNeighbors.hpp"
 
 // // SearchTreePCL
 // #ifdef LVR2_USE_PCL
@@ -144,12 +146,32 @@ public:
     virtual pair<typename BaseVecT::CoordType, typename BaseVecT::CoordType>
         distance(BaseVecT v) const;
 
+    /**
+     * @brief Batched version of distance(). The query points are sorted along
+     *        a Morton curve and evaluated in tiles of consecutive queries with
+     *        per thread search buffers and without copying the point channels.
+     *        The results are the same as calling distance() for each query.
+     */
+    virtual void distances(
+        const vector<BaseVecT>& queries,
+        vector<typename BaseVecT::CoordType>& projected,
+        vector<typename BaseVecT::CoordType>& euklidean) const;
+
     /**
      * @brief Calculates initial point normals using a least squares fit to
      *        the \ref m_kn nearest points
      */
     virtual void calculateSurfaceNormals();
 
+    /**
+     * @brief Calculates the normals like calculateSurfaceNormals(), but uses the
+     *        given neighborhoods instead of searching the tree whenever they hold
+     *        enough neighbors. This allows to share one k-nearest-neighbor pass
+     *        with other algorithms, e.g. the outlier filters.
+     *
+     * @param neighbors Neighborhoods of the points of this surface
+     */
+    void calculateSurfaceNormals(const KNearestNeighbors& neighbors);
 
 
 
@@ -241,6 +263,18 @@ private:
      */
     bool boundingBoxOK(float dx, float dy, float dz);
 
+    /**
+     * @brief Returns the k nearest neighbors of point i, taken from the shared
+     *        neighborhoods if possible.
+     */
+    void kSearch(size_t i, const BaseVecT& point, size_t k, vector<size_t>& id, vector<float>& di) const;
+
+    /**
+     * @brief Interleaves the lower 21 bits of the given coordinates to a
+     *        Morton code.
+     */
+    static uint64_t mortonCode(uint64_t x, uint64_t y, uint64_t z);
+
     // /**
     //  * @brief Returns the mean distance of the given point set from
     //  *        the given plane
@@ -324,6 +358,9 @@ private:
     /// Type of used search tree
     string m_searchTreeName;
 
+    /// Shared neighborhoods used during normal estimation
+    const KNearestNeighbors* m_sharedNeighbors = nullptr;
+
 };
 
 
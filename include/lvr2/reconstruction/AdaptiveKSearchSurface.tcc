@@ -163,6 +163,7 @@ void AdaptiveKSearchSurface<BaseVecT>::init()
 template<typename BaseVecT>
 void AdaptiveKSearchSurface<BaseVecT>::calculateSurfaceNormals()
 {
+    StageTimer stage("normals");
     int k_0 = this->m_kn;
     size_t numPoints = this->m_pointBuffer->numPoints();
     const FloatChannel pts = *(this->m_pointBuffer->getFloatChannel("points"));
@@ -202,7 +203,7 @@ void AdaptiveKSearchSurface<BaseVecT>::calculateSurfaceNormals()
             id.clear();
             di.clear();
 
-            this->m_searchTree->kSearch(pts[i], k, id, di);
+            kSearch(i, pts[i], k, id, di);
 
             float min_x = 1e15f;
             float min_y = 1e15f;
@@ -341,7 +342,7 @@ void AdaptiveKSearchSurface<BaseVecT>::interpolateSurfaceNormals()
         vector<size_t> id;
         vector<float> di;
 
-        this->m_searchTree->kSearch(pts[i], this->m_ki, id, di);
+        kSearch(i, pts[i], this->m_ki, id, di);
 
         BaseVecT mean = normals[i];
         for(int j = 0; j < this->m_ki; j++)
@@ -375,6 +376,43 @@ void AdaptiveKSearchSurface<BaseVecT>::interpolateSurfaceNormals()
     }
 }
 
+template<typename BaseVecT>
+void AdaptiveKSearchSurface<BaseVecT>::calculateSurfaceNormals(const KNearestNeighbors& neighbors)
+{
+    if(neighbors.numPoints() != this->m_pointBuffer->numPoints())
+    {
+        cout << timestamp << "Number of neighborhoods does not match the number of points. "
+             << "Searching the neighbors again." << endl;
+        calculateSurfaceNormals();
+        return;
+    }
+
+    m_sharedNeighbors = &neighbors;
+    calculateSurfaceNormals();
+    m_sharedNeighbors = nullptr;
+}
+
+template<typename BaseVecT>
+void AdaptiveKSearchSurface<BaseVecT>::kSearch(
+    size_t i,
+    const BaseVecT& point,
+    size_t k,
+    vector<size_t>& id,
+    vector<float>& di) const
+{
+    if(m_sharedNeighbors && m_sharedNeighbors->counts[i] >= k)
+    {
+        const size_t* neighbors = m_sharedNeighbors->neighbors(i);
+        const float* distances = m_sharedNeighbors->neighborDistances(i);
+        id.assign(neighbors, neighbors + k);
+        di.assign(distances, distances + k);
+    }
+    else
+    {
+        this->m_searchTree->kSearch(point, k, id, di);
+    }
+}
+
 template<typename BaseVecT>
 bool AdaptiveKSearchSurface<BaseVecT>::boundingBoxOK(float dx, float dy, float dz)
 {
@@ -499,6 +537,107 @@ pair<typename BaseVecT::CoordType, typename BaseVecT::CoordType>
     // return make_pair(euklideanDistance, projectedDistance);
 }
 
+template<typename BaseVecT>
+void AdaptiveKSearchSurface<BaseVecT>::distances(
+    const vector<BaseVecT>& queries,
+    vector<typename BaseVecT::CoordType>& projected,
+    vector<typename BaseVecT::CoordType>& euklidean) const
+{
+    using CoordT = typename BaseVecT::CoordType;
+
+    size_t numQueries = queries.size();
+    size_t numPoints = this->m_pointBuffer->numPoints();
+    projected.resize(numQueries);
+    euklidean.resize(numQueries);
+    if(numQueries == 0 || numPoints == 0)
+    {
+        return;
+    }
+
+    // Raw arrays instead of channel copies in the inner loops
+    floatArr pointArray = this->m_pointBuffer->getPointArray();
+    floatArr normalArray = this->m_pointBuffer->getNormalArray();
+    const float* pts = pointArray.get();
+    const float* normals = normalArray.get();
+    int k = std::min<size_t>(this->m_kd, numPoints);
+
+    // Sort the queries along a Morton curve, consecutive queries are spatial neighbors then
+    BoundingBox<BaseVecT> queryBB;
+    for(const BaseVecT& q : queries)
+    {
+        queryBB.expand(q);
+    }
+    BaseVecT queryMin = queryBB.getMin();
+    double scale = ((1 << 21) - 1) / std::max<double>(queryBB.getLongestSide(), 1e-6);
+
+    vector<pair<uint64_t, size_t>> order(numQueries);
+    #pragma omp parallel for
+    for(long i = 0; i < (long)numQueries; i++)
+    {
+        BaseVecT d = queries[i] - queryMin;
+        order[i] = std::make_pair(mortonCode(d.x * scale, d.y * scale, d.z * scale), (size_t)i);
+    }
+    std::sort(order.begin(), order.end());
+
+    // The sorted queries are evaluated in tiles, so that each thread works on a
+    // compact region of the search tree and the point arrays
+    const size_t tileSize = 64;
+    size_t numTiles = (numQueries + tileSize - 1) / tileSize;
+
+    string comment = timestamp.getElapsedTime() + "Calculating distance values ";
+    lvr2::ProgressBar progress(numTiles, comment);
+
+    #pragma omp parallel
+    {
+        vector<size_t> id;
+        vector<CoordT> di;
+
+        #pragma omp for schedule(dynamic, 4)
+        for(long t = 0; t < (long)numTiles; t++)
+        {
+            size_t end = std::min((t + 1) * tileSize, numQueries);
+            for(size_t i = t * tileSize; i < end; i++)
+            {
+                const BaseVecT& p = queries[order[i].second];
+                this->m_searchTree->kSearch(p, k, id, di);
+
+                BaseVecT nearest;
+                BaseVecT avg_normal;
+                for(int j = 0; j < k; j++)
+                {
+                    nearest += BaseVecT(pts[3 * id[j]], pts[3 * id[j] + 1], pts[3 * id[j] + 2]);
+                    avg_normal += BaseVecT(normals[3 * id[j]], normals[3 * id[j] + 1], normals[3 * id[j] + 2]);
+                }
+
+                avg_normal /= k;
+                nearest /= k;
+                auto normal = avg_normal.normalized();
+
+                projected[order[i].second] = (p - nearest).dot(normal);
+                euklidean[order[i].second] = (p - nearest).length();
+            }
+            ++progress;
+        }
+    }
+    cout << endl;
+}
+
+template<typename BaseVecT>
+uint64_t AdaptiveKSearchSurface<BaseVecT>::mortonCode(uint64_t x, uint64_t y, uint64_t z)
+{
+    auto spread = [](uint64_t v)
+    {
+        v &= 0x1FFFFF;
+        v = (v | v << 32) & 0x1F00000000FFFF;
+        v = (v | v << 16) & 0x1F0000FF0000FF;
+        v = (v | v << 8) & 0x100F00F00F00F00F;
+        v = (v | v << 4) & 0x10C30C30C30C30C3;
+        v = (v | v << 2) & 0x1249249249249249;
+        return v;
+    };
+    return spread(x) | spread(y) << 1 | spread(z) << 2;
+}
+
 // template<typename BaseVecT>
 // VertexT AdaptiveKSearchSurface<BaseVecT>::fromID(int i){
 //     return VertexT(
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DMCRangePointHandle.hpp
+ */
+
+#ifndef DMCRangePointHandle_H_
+#define DMCRangePointHandle_H_
+
+#include "lvr2/io/DataStruct.hpp"
+
+#include <array>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief Stores the points of the DMC octree in a single array that is reordered while the
+ *        cells are split.
+ *
+ * A cell is an index range into the array. Partitioning a cell sorts its points by child
+ * cell, so that the points of each child form a contiguous subrange of the parent's range.
+ * Disjoint ranges can be partitioned concurrently, which lets every subtree be built by its
+ * own task.
+ */
+template<typename BaseVecT>
+class DMCRangePointHandle
+{
+public:
+
+    /**
+     * @brief Constructor. Copies the points in their original order.
+     *
+     * @param points    interleaved point coordinates
+     * @param numPoints number of points
+     */
+    DMCRangePointHandle(floatArr points, size_t numPoints);
+
+    /**
+     * @brief Returns the number of points
+     */
+    size_t size() const
+    {
+        return m_points.size();
+    }
+
+    /**
+     * @brief Returns the first point, a cell's points are begin() + [first, last)
+     */
+    const coord<float>* begin() const
+    {
+        return m_points.data();
+    }
+
+    /**
+     * @brief Stably sorts the points of the range [first, last) by their child cell.
+     *
+     * The child index is computed like C_Octree::getChildIndex.
+     *
+     * @param first  first point of the cell
+     * @param last   end of the points of the cell
+     * @param center center of the cell in world coordinates
+     *
+     * @return the points of child c are [bounds[c], bounds[c + 1])
+     */
+    std::array<size_t, 9> partition(size_t first, size_t last, const BaseVecT& center);
+
+    /**
+     * @brief Frees all points
+     */
+    void clear();
+
+    /**
+     * @brief Returns the memory used by the points in bytes
+     */
+    size_t memoryUsage() const
+    {
+        return m_points.capacity() * sizeof(coord<float>);
+    }
+
+private:
+
+    // All points, reordered by cells
+    std::vector<coord<float>> m_points;
+};
+
+} // namespace lvr2
+
+#include "DMCRangePointHandle.tcc"
+
+#endif /* DMCRangePointHandle_H_ */
@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * DMCRangePointHandle.tcc
+ */
+
+#include <algorithm>
+#include <array>
+
+namespace lvr2
+{
+
+template<typename BaseVecT>
+DMCRangePointHandle<BaseVecT>::DMCRangePointHandle(floatArr points, size_t numPoints)
+{
+    m_points.resize(numPoints);
+    for(size_t i = 0; i < numPoints; i++)
+    {
+        m_points[i].x = points[3 * i];
+        m_points[i].y = points[3 * i + 1];
+        m_points[i].z = points[3 * i + 2];
+    }
+}
+
+template<typename BaseVecT>
+std::array<size_t, 9> DMCRangePointHandle<BaseVecT>::partition(size_t first, size_t last, const BaseVecT& center)
+{
+    // Same child order as C_Octree::getChildIndex
+    auto childIndex = [&center](const coord<float>& p)
+    {
+        return (p.x > center[0]) | ((p.y > center[1]) << 1) | ((p.z > center[2]) << 2);
+    };
+
+    // Counting sort of the cell's points by child index
+    std::array<size_t, 9> offsets = {0};
+    for(size_t i = first; i < last; i++)
+    {
+        offsets[childIndex(m_points[i]) + 1]++;
+    }
+    for(int c = 0; c < 8; c++)
+    {
+        offsets[c + 1] += offsets[c];
+    }
+
+    std::vector<coord<float>> sorted(last - first);
+    std::array<size_t, 8> next;
+    std::copy(offsets.begin(), offsets.begin() + 8, next.begin());
+    for(size_t i = first; i < last; i++)
+    {
+        sorted[next[childIndex(m_points[i])]++] = m_points[i];
+    }
+    std::copy(sorted.begin(), sorted.end(), m_points.begin() + first);
+
+    for(size_t& offset : offsets)
+    {
+        offset += first;
+    }
+    return offsets;
+}
+
+template<typename BaseVecT>
+void DMCRangePointHandle<BaseVecT>::clear()
+{
+    std::vector<coord<float>>().swap(m_points);
+}
+
+} // namespace lvr2
@@ -43,12 +43,15 @@
 #include "lvr2/reconstruction/MCTable.hpp"
 #include "lvr2/io/Progress.hpp"
 #include "DMCVecPointHandle.hpp"
+#include "DMCRangePointHandle.hpp"
 
 #include "Octree.hpp"
 #include "DualOctree.hpp"
 #include "Location.hh"
 #include "lvr2/reconstruction/FastReconstruction.hpp"
 
+#include <cstdint>
+
 namespace lvr2
 {
 
@@ -103,6 +106,20 @@ public:
         float comparePrecision
     );
 
+    /**
+     * @brief Enables the parallel reconstruction.
+     *
+     * The dual cells are extracted in parallel into per-thread buffers. Without
+     * dual fitting, the octree is built by one task per subtree on index ranges
+     * into a single reordered point array. The dual fitting of a cell depends on
+     * splits of its neighbours made earlier in the same level, so with dual
+     * fitting the octree is built serially. Both modes give the same mesh as the
+     * serial reconstruction.
+     *
+     * @param parallel true to use the parallel reconstruction
+     */
+    void setParallel(bool parallel) { m_parallel = parallel; }
+
 protected:
 
     /**
@@ -133,6 +150,106 @@ protected:
         int levels,
         bool dual);
 
+    /**
+     * @brief Builds the same octree as buildTree without dual fitting. The split
+     *        decisions of each subtree are made by its own task, the splits are
+     *        then applied in the order of buildTree.
+     *
+     * @param parent Reference to the octree.
+     * @param levels Number of octree levels.
+     */
+    void buildTreeParallel(
+        C_Octree<BaseVecT, BoxT, my_dummy> &parent,
+        int levels);
+
+    /**
+     * @brief Decides which cells of the subtree below a primal cell have to be
+     *        split and appends their keys (see locationKey) to splits. Spawns a
+     *        task for every child that may have to be split.
+     *
+     * @param loc    Location of the cell.
+     * @param first  First point of the cell in m_pointRanges.
+     * @param last   End of the points of the cell in m_pointRanges.
+     * @param splits Keys of the cells to split.
+     */
+    void collectSplits(
+        const Location& loc,
+        size_t first,
+        size_t last,
+        vector<uint64_t>* splits);
+
+    /**
+     * @brief Returns a key that identifies a cell by its location and level
+     */
+    static uint64_t locationKey(const Location& loc)
+    {
+        return ((uint64_t)loc.level() << 48) | ((uint64_t)loc.loc_x() << 32)
+            | ((uint64_t)loc.loc_y() << 16) | (uint64_t)loc.loc_z();
+    }
+
+    /**
+     * @brief Checks whether the points of a (dual) cell are approximated well by the
+     *        marching cubes triangles of the cell.
+     *
+     * @param corners     Corners of the cell in world coordinates.
+     * @param pointsBegin Begin of the points in the cell.
+     * @param pointsEnd   End of the points in the cell.
+     * @param dual        Whether the cell is a dual cell.
+     * @param fitsWell    Is set to false if the error of a triangle is too high.
+     *
+     * @return true if the cell should be split
+     */
+    template<typename PointIt>
+    bool cellNeedsSplit(
+        BaseVecT corners[8],
+        PointIt pointsBegin,
+        PointIt pointsEnd,
+        bool dual,
+        bool& fitsWell);
+
+    /**
+     * @brief Calculates the world coordinates of the corners of a primal cell
+     *
+     * @param octree  Reference to the octree
+     * @param ch      The cell
+     * @param cells   Number of cells at the maximum octree level
+     * @param corners Array the corners are written to
+     */
+    void getPrimalCellCorners(
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree,
+        CellHandle ch,
+        int cells,
+        BaseVecT corners[8]);
+
+    /**
+     * @brief Calculates the world coordinates of the corners of the primal cell
+     *        at the given location
+     */
+    void getPrimalCellCorners(
+        const Location& loc,
+        int cells,
+        BaseVecT corners[8]);
+
+    /**
+     * @brief Calculates the world coordinates of the corners of a dual cell
+     *
+     * @param octree      Reference to the octree
+     * @param cellHandles The 8 cells around the dual cell
+     * @param markers     Border markers of the cells
+     * @param cells       Number of cells at the maximum octree level
+     * @param corners     Array the corners are written to
+     */
+    void getDualCellCorners(
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree,
+        const CellHandle* cellHandles,
+        const uint* markers,
+        int cells,
+        BaseVecT corners[8]);
+
+    /// Access to the points of the serial and the parallel point handles
+    static const coord<float>& dmcPoint(const coord<float>& p) { return p; }
+    static const coord<float>& dmcPoint(const coord<float>* p) { return *p; }
+
     /**
      * @brief Traverses the octree and insert for each leaf the getSurface-function into the thread pool.
      *
@@ -142,6 +259,15 @@ protected:
     void traverseTree(BaseMesh<BaseVecT> &mesh,
         C_Octree<BaseVecT, BoxT, my_dummy> &octree);
 
+    /**
+     * @brief Traverses the octree and extracts the surface of the leaves in parallel.
+     *
+     * @param mesh       The reconstructed mesh.
+     * @param octree     The octree.
+     */
+    void traverseTreeParallel(BaseMesh<BaseVecT> &mesh,
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree);
+
     /**
      * @brief Calculates the position of a aspecific point in a dual cell
      *
@@ -241,6 +367,19 @@ protected:
         int cells,
         short level);
 
+    /**
+     * @brief Performs a local reconstruction like getSurface above, but appends the
+     *        vertices of the triangles to the given buffer.
+     *
+     * @param triangles Buffer for the triangle vertices, three per triangle
+     * @param leaf A octree leaf.
+     * @param cells
+     */
+    void getSurface(vector<BaseVecT> &triangles,
+        DualLeaf<BaseVecT, BoxT> *leaf,
+        int cells,
+        short level);
+
     /**
      * @brief Saves the octree as wireframe. WORKS ONLY SINGLE THREADED!
      *
@@ -278,6 +417,12 @@ protected:
     // PointHandler
     unique_ptr<DMCPointHandle<BaseVecT>> m_pointHandler;
 
+    // Points of the octree cells in parallel mode
+    unique_ptr<DMCRangePointHandle<BaseVecT>> m_pointRanges;
+
+    // Indicator whether the parallel reconstruction is used
+    bool m_parallel;
+
     // just for visualization
     std::vector< BaseVecT > dualVertices;
 };
@@ -32,7 +32,9 @@
  *      Author: Benedikt Schumacher
  */
 
+#include "lvr2/config/lvropenmp.hpp"
 #include "lvr2/geometry/BaseMesh.hpp"
+#include <algorithm>
 #include <vector>
 #include <random>
 using std::vector;
@@ -65,22 +67,13 @@ DMCReconstruction<BaseVecT, BoxT>::DMCReconstruction(
         bb_size[a] = bb_max[a] - bb_min[a];
     }
 
-    // Get all points
-    floatArr points_floatArr = this->m_surface->pointBuffer()->getPointArray();
-    coord3fArr points = *((coord3fArr*) &points_floatArr);
-    vector<coord<float>*> containedPoints;
-    for(size_t i = 0; i < this->m_surface->pointBuffer()->numPoints(); i++)
-    {
-        containedPoints.push_back(&points[i]);
-    }
-
-    m_pointHandler = std::unique_ptr<DMCPointHandle<BaseVecT>>(new DMCVecPointHandle<BaseVecT>(containedPoints));
-
     // Instanciate Octree
     octree = new C_Octree<BaseVecT, BoxT, my_dummy>();
     octree->initialize(m_maxLevel);
 
     m_leaves = 0;
+    m_progressBar = nullptr;
+    m_parallel = false;
 }
 
 template<typename BaseVecT, typename BoxT>
@@ -169,15 +162,16 @@ void DMCReconstruction<BaseVecT, BoxT>::buildTree(
 
                 // check each (dual) cell
                 vector<int> splitting_pos;
-                float highest_error = 0;
                 bool markToSplit = false;
                 int idx = 0;
 
+                int cells_tmp = 1 << m_maxLevel;
+
                 // iterate over one primal cell or over 8 dual cells until error ist to high
                 while (idx < cellPoints.size() && (!markToSplit || dual))
                 {
                     // get cell points
-                    vector<coord<float>*> points = cellPoints[idx];
+                    const vector<coord<float>*>& points = cellPoints[idx];
 
                     // when the cell holds points check whether tey fit well to a trinangle
                     if(points.size() > 12)
@@ -185,246 +179,26 @@ void DMCReconstruction<BaseVecT, BoxT>::buildTree(
                         // get corner vertices of the cell
                         BaseVecT corners[8];
 
-                        int cells_tmp = 2;
-                        for(int i = 1; i < m_maxLevel; i++)
-                        {
-                            cells_tmp *= 2;
-                        }
-
                         // calculation for dual cells
                         if(dual && cur_Level < levels - 2)
                         {
-                            for(int i = 0; i < 8; i++)
-                            {
-                                BaseVecT tmp;
-                                detectVertexForDualCell(parent, cellHandles[idx * 8 + i], cells_tmp, *max_bb_width, i, markers[idx * 8 + i], tmp);
-                                corners[i] = BaseVecT(tmp[0], tmp[1], tmp[2]);
-                            }
-
-                            // swap position of the corners
-                            BaseVecT tmp = corners[2];
-                            corners[2] = corners[3];
-                            corners[3] = tmp;
-                            tmp = corners[6];
-                            corners[6] = corners[7];
-                            corners[7] = tmp;
-
-                            /*for(int i = 0; i < 8; i++)
-                            {
-                                std::cout << corners[i][0] << "; " << corners[i][1] << "; " << corners[i][2] << std::endl;
-                            }
-                            std::cout << "-----------" << std::endl;
-                            int test = 0;
-                            while(test < points.size())
-                            {
-                                std::cout << (*points[test])[0] << "; " << (*points[test])[1] << "; " << (*points[test])[2] << std::endl;
-                                test += 15;
-                            }
-                            std::cout << "+++++++++++" << std::endl;*/
-
+                            getDualCellCorners(parent, &cellHandles[idx * 8], &markers[idx * 8], cells_tmp, corners);
                         }
                         // calculation for primal cells
                         else
                         {
-                            // calculating the real world positions of the corners
-                            Location loc = parent.location(ch);
-                            int binary_cell_size = 1 << loc.level();
-                            corners[0] = BaseVecT(loc.loc_x(),                    loc.loc_y(),                    loc.loc_z());
-                            corners[1] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y(),                    loc.loc_z());
-                            corners[2] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y() + binary_cell_size, loc.loc_z());
-                            corners[3] = BaseVecT(loc.loc_x(),                    loc.loc_y() + binary_cell_size, loc.loc_z());
-                            corners[4] = BaseVecT(loc.loc_x(),                    loc.loc_y(),                    loc.loc_z() + binary_cell_size);
-                            corners[5] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y(),                    loc.loc_z() + binary_cell_size);
-                            corners[6] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y() + binary_cell_size, loc.loc_z() + binary_cell_size);
-                            corners[7] = BaseVecT(loc.loc_x(),                    loc.loc_y() + binary_cell_size, loc.loc_z() + binary_cell_size);
-
-                            for(unsigned char a = 0; a < 8; a++)
-                            {
-                                corners[a] = corners[a] * (*max_bb_width / cells_tmp);
-                                corners[a] = corners[a] + bb_min;
-                            }
+                            getPrimalCellCorners(parent, ch, cells_tmp, corners);
                         }
 
-                        // this is not necessarily a dual leaf
-                        DualLeaf<BaseVecT, BoxT> *leaf = new DualLeaf<BaseVecT, BoxT>(corners);
-
-                        // calculate distances
-                        float distances[8];
-                        BaseVecT vertex_positions[12];
-                        float projectedDistance;
-                        float euklideanDistance;
-                        for (unsigned char i = 0; i < 8; i++)
+                        bool pointsFittingWell;
+                        if(cellNeedsSplit(corners, points.begin(), points.end(), dual, pointsFittingWell))
                         {
-                            float projectedDistance;
-                            float euklideanDistance;
-                            std::tie(projectedDistance, euklideanDistance) = this->m_surface->distance(corners[i]);
-                            distances[i] = projectedDistance;
+                            markToSplit = true;
                         }
-                        leaf->getIntersections(corners, distances, vertex_positions);
-
-                        /*for(int z = 0; z < 8; z++)
+                        if(!pointsFittingWell)
                         {
-                            std::cout << distances[z] << std::endl;
+                            splitting_pos.push_back(idx);
                         }
-                        std::cout << "-------" << std::endl;*/
-
-                        // check for valid length of the distances
-                        bool distancesValid = true;
-                        bool d_all_null = false;
-
-                        // calculate max tolerated distance
-                        float length = 0;
-                        if(!dual)
-                        {
-                            length = corners[1][0] - corners[0][0];
-                            length *= 1.7;
-                        }
-                        else
-                        {
-                            for(uint s = 0; s < 12; s++)
-                            {
-                                BaseVecT vec_tmp = corners[edgeDistanceTable[s][0]] - corners[edgeDistanceTable[s][1]];
-                                float float_tmp = sqrt(vec_tmp[0] * vec_tmp[0] + vec_tmp[1] * vec_tmp[1] + vec_tmp[2] * vec_tmp[2]);
-                                if(float_tmp > length)
-                                {
-                                    length = float_tmp;
-                                }
-                            }
-                            // length *= 1.7;
-                        }
-
-                        for(unsigned char a = 0; a < 8; a++)
-                        {
-                            if(abs(distances[a]) > length)
-                            {
-                                distancesValid = false;
-                                /*if(dual && cur_Level < levels - 2)
-                                {
-                                    markToSplit = false;
-                                }*/
-                            }
-                            else if(distances[a] > 0)
-                            {
-                                d_all_null = false;
-                            }
-                        }
-                        if(distancesValid)
-                        {
-                            bool pointsFittingWell = true;
-
-                            vector< vector<BaseVecT> > triangles;
-                            int index = leaf->getIndex(distances);
-                            /*if(index == 0 || index == 255)
-                            {
-                                for(int a = 0; a < 8; a++)
-                                {
-                                    std::cout << corners[a][0] << "; " << corners[a][1] << "; " << corners[a][2] << std::endl;
-                                }
-                                std::cout << "++++++++++++" << std::endl;
-                                for(unsigned char a = 0; a < 8; a++)
-                                {
-                                    std::cout << distances[a] << std::endl;
-                                }
-                                std::cout << "------------" << std::endl;
-                            }*/
-                            if(!d_all_null)
-                            {
-                                uint edge_index = 0;
-
-                                for(unsigned char a = 0; MCTable[index][a] != -1; a+= 3)
-                                {
-                                    vector<BaseVecT> triangle_vertices;
-                                    for(unsigned char b = 0; b < 3; b++)
-                                    {
-                                        edge_index = MCTable[index][a + b];
-                                        triangle_vertices.push_back(vertex_positions[edge_index]);
-                                    }
-                                    triangles.push_back(triangle_vertices);
-                                }
-
-                                // check, whether the points are fitting well
-                                vector<float*> matrices = vector<float*>();
-
-                                // calculate rotation matrix of every triangle
-                                for ( uint a = 0; a < triangles.size(); a++ )
-                                {
-                                    float matrix[9] = { 0 };
-                                    BaseVecT v1 = triangles[a][0];
-                                    BaseVecT v2 = triangles[a][1];
-                                    BaseVecT v3 = triangles[a][2];
-                                    getRotationMatrix(matrix, v1, v2, v3);
-
-                                    matrices.push_back(matrix);
-                                }
-
-                                vector<float> error(triangles.size(), 0);
-                                vector<int> counter(triangles.size(), 0);
-
-                                // for every point check to which trinagle it is the nearest
-                                if(triangles.size() > 0)
-                                {
-                                    for ( uint a = 0; a < points.size(); a++ )
-                                    {
-                                        signed char min_dist_pos = -1;
-                                        float min_dist = -1;
-
-                                        // check which triangle is nearest
-                                        for ( uint b = 0; b < triangles.size(); b++ )
-                                        {
-                                            BaseVecT tmp = {(*points[a])[0] - (triangles[b][0])[0],
-                                                            (*points[a])[1] - (triangles[b][0])[1],
-                                                            (*points[a])[2] - (triangles[b][0])[2]};
-
-                                            // use rotation matrix for triangle and point
-                                            BaseVecT t1 = triangles[b][0] - triangles[b][0];
-                                            BaseVecT t2 = triangles[b][1] - triangles[b][0];
-                                            BaseVecT t3 = triangles[b][2] - triangles[b][0];
-                                            matrixDotVector(matrices[b], &t1);
-                                            matrixDotVector(matrices[b], &t2);
-                                            matrixDotVector(matrices[b], &t3);
-                                            matrixDotVector(matrices[b], &tmp);
-
-                                            // calculate distance from point to triangle
-                                            float d = getDistance(tmp, t1, t2, t3);
-
-                                            if( min_dist == -1 )
-                                            {
-                                                min_dist = d;
-                                                min_dist_pos = b;
-                                            }
-                                            else if( d < min_dist )
-                                            {
-                                                min_dist = d;
-                                                min_dist_pos = b;
-                                            }
-                                        }
-
-                                        error[min_dist_pos] += (min_dist * min_dist);
-                                        counter[min_dist_pos] += 1;
-                                    }
-
-                                    uint a = 0;
-                                    while(a < error.size() && pointsFittingWell)
-                                    {
-                                        error[a] /= counter[a];
-                                        error[a] = sqrt(error[a]);
-
-                                        if(error[a] > m_maxError)
-                                        {
-                                            splitting_pos.push_back(idx);
-                                            pointsFittingWell = false;
-                                        }
-                                        a++;
-                                    }
-                                }
-                            }
-                            if(MCTable[index][0] == -1 || !pointsFittingWell)
-                            // if((!dual && MCTable[index][0] == -1) || cur_Level >= levels - 2 || !pointsFittingWell)
-                            {
-                                markToSplit = true;
-                            }
-                        }
-                        delete(leaf);
                     }
                     idx++;
                 }
@@ -513,6 +287,294 @@ void DMCReconstruction<BaseVecT, BoxT>::buildTree(
     }
 }
 
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::getPrimalCellCorners(
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree,
+        CellHandle ch,
+        int cells,
+        BaseVecT corners[8])
+{
+    getPrimalCellCorners(octree.location(ch), cells, corners);
+}
+
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::getPrimalCellCorners(
+        const Location& loc,
+        int cells,
+        BaseVecT corners[8])
+{
+    float max_bb_width = *std::max_element(bb_size, bb_size + 3);
+
+    // calculating the real world positions of the corners
+    int binary_cell_size = 1 << loc.level();
+    corners[0] = BaseVecT(loc.loc_x(),                    loc.loc_y(),                    loc.loc_z());
+    corners[1] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y(),                    loc.loc_z());
+    corners[2] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y() + binary_cell_size, loc.loc_z());
+    corners[3] = BaseVecT(loc.loc_x(),                    loc.loc_y() + binary_cell_size, loc.loc_z());
+    corners[4] = BaseVecT(loc.loc_x(),                    loc.loc_y(),                    loc.loc_z() + binary_cell_size);
+    corners[5] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y(),                    loc.loc_z() + binary_cell_size);
+    corners[6] = BaseVecT(loc.loc_x() + binary_cell_size, loc.loc_y() + binary_cell_size, loc.loc_z() + binary_cell_size);
+    corners[7] = BaseVecT(loc.loc_x(),                    loc.loc_y() + binary_cell_size, loc.loc_z() + binary_cell_size);
+
+    for(unsigned char a = 0; a < 8; a++)
+    {
+        corners[a] = corners[a] * (max_bb_width / cells);
+        corners[a] = corners[a] + bb_min;
+    }
+}
+
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::getDualCellCorners(
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree,
+        const CellHandle* cellHandles,
+        const uint* markers,
+        int cells,
+        BaseVecT corners[8])
+{
+    float max_bb_width = *std::max_element(bb_size, bb_size + 3);
+
+    for(int i = 0; i < 8; i++)
+    {
+        detectVertexForDualCell(octree, cellHandles[i], cells, max_bb_width, i, markers[i], corners[i]);
+    }
+
+    // swap position of the corners
+    std::swap(corners[2], corners[3]);
+    std::swap(corners[6], corners[7]);
+}
+
+template<typename BaseVecT, typename BoxT>
+template<typename PointIt>
+bool DMCReconstruction<BaseVecT, BoxT>::cellNeedsSplit(
+        BaseVecT corners[8],
+        PointIt pointsBegin,
+        PointIt pointsEnd,
+        bool dual,
+        bool& fitsWell)
+{
+    fitsWell = true;
+
+    // this is not necessarily a dual leaf
+    DualLeaf<BaseVecT, BoxT> leaf(corners);
+
+    // calculate distances
+    float distances[8];
+    BaseVecT vertex_positions[12];
+    for (unsigned char i = 0; i < 8; i++)
+    {
+        float projectedDistance;
+        float euklideanDistance;
+        std::tie(projectedDistance, euklideanDistance) = this->m_surface->distance(corners[i]);
+        distances[i] = projectedDistance;
+    }
+    leaf.getIntersections(corners, distances, vertex_positions);
+
+    // calculate max tolerated distance
+    float length = 0;
+    if(!dual)
+    {
+        length = corners[1][0] - corners[0][0];
+        length *= 1.7;
+    }
+    else
+    {
+        for(uint s = 0; s < 12; s++)
+        {
+            BaseVecT vec_tmp = corners[edgeDistanceTable[s][0]] - corners[edgeDistanceTable[s][1]];
+            float float_tmp = sqrt(vec_tmp[0] * vec_tmp[0] + vec_tmp[1] * vec_tmp[1] + vec_tmp[2] * vec_tmp[2]);
+            if(float_tmp > length)
+            {
+                length = float_tmp;
+            }
+        }
+    }
+
+    // check for valid length of the distances
+    for(unsigned char a = 0; a < 8; a++)
+    {
+        if(abs(distances[a]) > length)
+        {
+            return false;
+        }
+    }
+
+    int index = leaf.getIndex(distances);
+
+    // the marching cubes table holds at most five triangles per cell
+    BaseVecT triangles[5][3];
+    float matrices[5][9];
+    int numTriangles = 0;
+    for(unsigned char a = 0; MCTable[index][a] != -1; a += 3)
+    {
+        for(unsigned char b = 0; b < 3; b++)
+        {
+            triangles[numTriangles][b] = vertex_positions[MCTable[index][a + b]];
+        }
+
+        // calculate rotation matrix of every triangle
+        getRotationMatrix(matrices[numTriangles], triangles[numTriangles][0], triangles[numTriangles][1], triangles[numTriangles][2]);
+        numTriangles++;
+    }
+
+    if(numTriangles == 0)
+    {
+        return true;
+    }
+
+    // rotated triangles with the first vertex in the origin
+    BaseVecT rotated[5][3];
+    for(int b = 0; b < numTriangles; b++)
+    {
+        for(int c = 0; c < 3; c++)
+        {
+            rotated[b][c] = triangles[b][c] - triangles[b][0];
+            matrixDotVector(matrices[b], &rotated[b][c]);
+        }
+    }
+
+    float error[5] = {0};
+    int counter[5] = {0};
+
+    // for every point check to which trinagle it is the nearest
+    for(PointIt it = pointsBegin; it != pointsEnd; ++it)
+    {
+        const coord<float>& point = dmcPoint(*it);
+
+        int min_dist_pos = -1;
+        float min_dist = -1;
+
+        // check which triangle is nearest
+        for(int b = 0; b < numTriangles; b++)
+        {
+            BaseVecT tmp(point.x - triangles[b][0][0],
+                         point.y - triangles[b][0][1],
+                         point.z - triangles[b][0][2]);
+            matrixDotVector(matrices[b], &tmp);
+
+            // calculate distance from point to triangle
+            float d = getDistance(tmp, rotated[b][0], rotated[b][1], rotated[b][2]);
+
+            if(min_dist == -1 || d < min_dist)
+            {
+                min_dist = d;
+                min_dist_pos = b;
+            }
+        }
+
+        error[min_dist_pos] += (min_dist * min_dist);
+        counter[min_dist_pos] += 1;
+    }
+
+    for(int a = 0; a < numTriangles && fitsWell; a++)
+    {
+        if(sqrt(error[a] / counter[a]) > m_maxError)
+        {
+            fitsWell = false;
+        }
+    }
+
+    return !fitsWell;
+}
+
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::buildTreeParallel(
+        C_Octree<BaseVecT, BoxT, my_dummy> &parent,
+        int levels)
+{
+    m_leaves = 0;
+
+    // Without dual fitting a split decision only depends on the cell and its points, so
+    // every subtree is decided by its own task without touching the shared octree
+    vector<uint64_t> splits;
+    #pragma omp parallel num_threads(OpenMPConfig::getNumThreads())
+    {
+        #pragma omp single
+        collectSplits(parent.location(parent.root()), 0, m_pointRanges->size(), &splits);
+    }
+    std::sort(splits.begin(), splits.end());
+
+    // Apply the splits in the visiting order of buildTree, which gives the same cell layout
+    for(int cur_Level = levels; cur_Level > 0; --cur_Level)
+    {
+        CellHandle ch_end = parent.end();
+        int cellCounter = 0;
+
+        for (CellHandle ch = parent.root(); ch != ch_end; ++ch)
+        {
+            if (parent.level(ch) == cur_Level)
+            {
+                cellCounter++;
+                if(std::binary_search(splits.begin(), splits.end(), locationKey(parent.location(ch))))
+                {
+                    parent.split(ch);
+                    m_leaves += 7;
+                }
+            }
+        }
+        std::cout << cellCounter << " cells at level " << cur_Level << std::endl;
+    }
+}
+
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::collectSplits(
+        const Location& loc,
+        size_t first,
+        size_t last,
+        vector<uint64_t>* splits)
+{
+    // buildTree never visits cells of level 0 and only checks cells with more than 12 points
+    if(loc.level() == 0 || last - first <= 12)
+    {
+        return;
+    }
+
+    BaseVecT corners[8];
+    getPrimalCellCorners(loc, 1 << m_maxLevel, corners);
+
+    bool fitsWell;
+    if(!cellNeedsSplit(corners, m_pointRanges->begin() + first, m_pointRanges->begin() + last, false, fitsWell))
+    {
+        return;
+    }
+
+    #pragma omp critical(dmcSplits)
+    splits->push_back(locationKey(loc));
+
+    // the cell center is calculated exactly as in buildTree
+    float max_bb_width = *std::max_element(bb_size, bb_size + 3);
+    int cells = 1 << (m_maxLevel - loc.level());
+    int max_cells = 1 << loc.level();
+    float stepWidth = max_bb_width / cells;
+    float size = (float)(1 << loc.level());
+
+    BaseVecT cellCenter(loc.loc_x() + 0.5f * size, loc.loc_y() + 0.5f * size, loc.loc_z() + 0.5f * size);
+    cellCenter /= max_cells;
+    cellCenter *= stepWidth;
+    cellCenter += bb_min;
+
+    std::array<size_t, 9> bounds = m_pointRanges->partition(first, last, cellCenter);
+
+    // children in the order of C_Octree::split
+    Location::LocCode mask = 1 << (loc.level() - 1);
+    for(int c = 0; c < 8; c++)
+    {
+        Location child(
+            loc.loc_x() | ((c & 1) ? mask : 0),
+            loc.loc_y() | ((c & 2) ? mask : 0),
+            loc.loc_z() | ((c & 4) ? mask : 0),
+            loc.level() - 1,
+            CellHandle());
+
+        size_t childFirst = bounds[c];
+        size_t childLast = bounds[c + 1];
+        if(child.level() > 0 && childLast - childFirst > 12)
+        {
+            #pragma omp task firstprivate(child, childFirst, childLast)
+            collectSplits(child, childFirst, childLast, splits);
+        }
+    }
+}
+
 template<typename BaseVecT, typename BoxT>
 void DMCReconstruction<BaseVecT, BoxT>::getRotationMatrix(float matrix[9], BaseVecT v1, BaseVecT v2, BaseVecT v3)
 {
@@ -687,16 +749,53 @@ void DMCReconstruction<BaseVecT, BoxT>::getMesh(BaseMesh<BaseVecT> &mesh)
     // start building adaptive octree
     string comment = timestamp.getElapsedTime() + "Creating Octree...";
     cout << comment << endl;
-    buildTree(*octree, m_maxLevel, m_dual);
 
-    comment = timestamp.getElapsedTime() + "Cleaning up RAM...";
-    cout << comment << endl;
-    m_pointHandler->clear();
+    floatArr points = this->m_surface->pointBuffer()->getPointArray();
+    size_t numPoints = this->m_surface->pointBuffer()->numPoints();
+
+    if(m_parallel && !m_dual)
+    {
+        m_pointRanges = std::unique_ptr<DMCRangePointHandle<BaseVecT>>(
+            new DMCRangePointHandle<BaseVecT>(points, numPoints));
+        buildTreeParallel(*octree, m_maxLevel);
+
+        cout << timestamp << "Octree cells: " << octree->size() << ", point storage: "
+             << m_pointRanges->memoryUsage() / (1024.0 * 1024.0) << " MiB" << endl;
+
+        comment = timestamp.getElapsedTime() + "Cleaning up RAM...";
+        cout << comment << endl;
+        m_pointRanges->clear();
+    }
+    else
+    {
+        // Get all points
+        coord3fArr coords = *((coord3fArr*) &points);
+        vector<coord<float>*> containedPoints;
+        for(size_t i = 0; i < numPoints; i++)
+        {
+            containedPoints.push_back(&coords[i]);
+        }
+
+        m_pointHandler = std::unique_ptr<DMCPointHandle<BaseVecT>>(new DMCVecPointHandle<BaseVecT>(containedPoints));
+        buildTree(*octree, m_maxLevel, m_dual);
+
+        comment = timestamp.getElapsedTime() + "Cleaning up RAM...";
+        cout << comment << endl;
+        m_pointHandler->clear();
+    }
 
     comment = timestamp.getElapsedTime() + "Creating Mesh ";
     m_progressBar = new ProgressBar(m_leaves, comment);
-    traverseTree(mesh, *octree);
+    if(m_parallel)
+    {
+        traverseTreeParallel(mesh, *octree);
+    }
+    else
+    {
+        traverseTree(mesh, *octree);
+    }
     delete(octree);
+    octree = nullptr;
     cout << endl;
 }
 
@@ -782,6 +881,59 @@ void DMCReconstruction<BaseVecT, BoxT>::traverseTree(
     return;
 }
 
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::traverseTreeParallel(
+        BaseMesh<BaseVecT> &mesh,
+        C_Octree<BaseVecT, BoxT, my_dummy> &octree)
+{
+    int cells = 1 << m_maxLevel;
+
+    vector<CellHandle> leaves;
+    CellHandle ch_end = octree.end();
+    for (CellHandle ch = octree.root(); ch != ch_end; ++ch)
+    {
+        if (octree.is_leaf(ch))
+        {
+            leaves.push_back(ch);
+        }
+    }
+
+    // Each thread extracts the triangles of a contiguous block of leaves into its own
+    // buffer. The buffers are added to the mesh in block order, which gives the same mesh
+    // as the serial traversal.
+    int numThreads = OpenMPConfig::getNumThreads();
+    vector<vector<BaseVecT>> triangles(numThreads);
+
+    #pragma omp parallel for schedule(static, 1) num_threads(numThreads)
+    for(int t = 0; t < numThreads; t++)
+    {
+        size_t first = leaves.size() * t / numThreads;
+        size_t last = leaves.size() * (t + 1) / numThreads;
+        for(size_t l = first; l < last; l++)
+        {
+            for(unsigned char c = 0; c < 8; c++)
+            {
+                DualLeaf<BaseVecT, BoxT> *dualLeaf = getDualLeaf(leaves[l], cells, octree, c);
+                getSurface(triangles[t], dualLeaf, cells, (short)octree.level(leaves[l]));
+                delete dualLeaf;
+            }
+            ++(*m_progressBar);
+        }
+    }
+
+    for(vector<BaseVecT>& buffer : triangles)
+    {
+        for(size_t i = 0; i + 2 < buffer.size(); i += 3)
+        {
+            VertexHandle v0 = mesh.addVertex(buffer[i]);
+            VertexHandle v1 = mesh.addVertex(buffer[i + 1]);
+            VertexHandle v2 = mesh.addVertex(buffer[i + 2]);
+            mesh.addFace(v0, v1, v2);
+        }
+        vector<BaseVecT>().swap(buffer);
+    }
+}
+
 template<typename BaseVecT, typename BoxT>
 void DMCReconstruction<BaseVecT, BoxT>::detectVertexForDualCell(
         C_Octree<BaseVecT, BoxT, my_dummy> &octree,
@@ -832,7 +984,7 @@ void DMCReconstruction<BaseVecT, BoxT>::detectVertexForDualCell(
 
 template<typename BaseVecT, typename BoxT>
 void DMCReconstruction<BaseVecT, BoxT>::getSurface(
-        BaseMesh<BaseVecT> &mesh,
+        vector<BaseVecT> &triangles,
         DualLeaf<BaseVecT, BoxT> *leaf,
         int cells,
         short level)
@@ -896,18 +1048,29 @@ void DMCReconstruction<BaseVecT, BoxT>::getSurface(
     int index = leaf->getIndex(distances);
     uint edge_index = 0;
 
-    for(unsigned char a = 0; MCTable[index][a] != -1; a+= 3)
+    for(unsigned char a = 0; MCTable[index][a] != -1; a++)
     {
-        vector<VertexHandle> triangle_vertices;
-        for(unsigned char b = 0; b < 3; b++)
-        {
-            edge_index = MCTable[index][a + b];
-            BaseVecT v = vertex_positions[edge_index];
-            // VertexHandle vh = mesh.addVertex(v, level);
-            VertexHandle vh = mesh.addVertex(v);
-            triangle_vertices.push_back(vh);
-        }
-        mesh.addFace(triangle_vertices[0], triangle_vertices[1], triangle_vertices[2]);
+        triangles.push_back(vertex_positions[MCTable[index][a]]);
+    }
+}
+
+template<typename BaseVecT, typename BoxT>
+void DMCReconstruction<BaseVecT, BoxT>::getSurface(
+        BaseMesh<BaseVecT> &mesh,
+        DualLeaf<BaseVecT, BoxT> *leaf,
+        int cells,
+        short level)
+{
+    vector<BaseVecT> triangles;
+    getSurface(triangles, leaf, cells, level);
+
+    for(size_t a = 0; a + 2 < triangles.size(); a += 3)
+    {
+        // VertexHandle vh = mesh.addVertex(v, level);
+        VertexHandle v0 = mesh.addVertex(triangles[a]);
+        VertexHandle v1 = mesh.addVertex(triangles[a + 1]);
+        VertexHandle v2 = mesh.addVertex(triangles[a + 2]);
+        mesh.addFace(v0, v1, v2);
     }
 }
 
@@ -275,9 +275,56 @@ public:
      */
     void calcIndices();
 
+    /**
+     * @brief   Returns the cell with the given lattice indices or nullptr. The
+     *          cell is found by its hash value in constant time.
+     */
+    BoxT* findCell(int i, int j, int k) const;
+
+    /**
+     * @brief   Trilinearly interpolates the signed distance values of the query
+     *          points at the given positions. The queries are processed in
+     *          parallel blocks. Within a block the cell indices are computed in
+     *          a separate, vectorizable pass and consecutive queries in the same
+     *          cell share the hash lookup, so spatially sorted batches are cheapest.
+     *
+     * @param positions     Query positions
+     * @param distances     Interpolated distance for every position. NaN if the
+     *                      position is not covered by a cell or one of the cell
+     *                      corners has an invalid distance value.
+     * @param gradients     If not null, filled with the gradient of the
+     *                      interpolated distance field (zero for invalid queries)
+     * @return              The number of valid queries
+     */
+    size_t interpolateDistances(
+        const vector<BaseVecT>& positions,
+        vector<float>& distances,
+        vector<BaseVecT>* gradients = nullptr
+    ) const;
+
+    /**
+     * @brief   Single query version of \ref interpolateDistances.
+     *
+     * @return  False if the distance is not defined at the given position
+     */
+    bool interpolateDistance(const BaseVecT& position, float& distance, BaseVecT* gradient = nullptr) const;
+
 
 protected:
 
+    /**
+     * @brief   Reads the distances of the cell corners in the order x + 2 * y + 4 * z.
+     *
+     * @return  False if the cell is null or has an invalid corner
+     */
+    bool cornerDistances(BoxT* cell, float* distances) const;
+
+    /**
+     * @brief   Trilinear interpolation of the corner distances at the local cell
+     *          coordinates (tx, ty, tz) in [0, 1]. Optionally computes the gradient.
+     */
+    float trilinear(const float* d, float tx, float ty, float tz, BaseVecT* gradient) const;
+
     inline int calcIndex(float f)
     {
         return f < 0 ? f - .5 : f + .5;
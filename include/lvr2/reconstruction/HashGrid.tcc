@@ -39,8 +39,11 @@
 #include "lvr2/reconstruction/FastReconstructionTables.hpp"
 #include "lvr2/reconstruction/HashGrid.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 
 namespace lvr2
 {
@@ -872,4 +875,180 @@ void HashGrid<BaseVecT, BoxT>::setBB(BoundingBox<BaseVecT>& bb)
     calcIndices();
 }
 
+template <typename BaseVecT, typename BoxT>
+BoxT* HashGrid<BaseVecT, BoxT>::findCell(int i, int j, int k) const
+{
+    // Indices outside of the padded lattice would alias other cells
+    int max = (int)m_maxIndex - 2;
+    if (i < -1 || j < -1 || k < -1 || i > max || j > max || k > max)
+    {
+        return nullptr;
+    }
+
+    auto it = m_cells.find(hashValue(i, j, k));
+    return it == m_cells.end() ? nullptr : it->second;
+}
+
+template <typename BaseVecT, typename BoxT>
+bool HashGrid<BaseVecT, BoxT>::cornerDistances(BoxT* cell, float* distances) const
+{
+    // Box corner index for the corner offsets (x + 2 * y + 4 * z), see box_creation_table
+    const static int corner[8] = {0, 1, 3, 2, 4, 5, 7, 6};
+
+    if (!cell)
+    {
+        return false;
+    }
+
+    for (int c = 0; c < 8; c++)
+    {
+        unsigned int qp = cell->getVertex(corner[c]);
+        if (qp == BoxT::INVALID_INDEX || m_queryPoints[qp].m_invalid)
+        {
+            return false;
+        }
+        distances[c] = m_queryPoints[qp].m_distance;
+    }
+    return true;
+}
+
+template <typename BaseVecT, typename BoxT>
+float HashGrid<BaseVecT, BoxT>::trilinear(const float* d, float tx, float ty, float tz, BaseVecT* gradient) const
+{
+    // Interpolate along x, then y, then z
+    const float d00 = d[0] + tx * (d[1] - d[0]);
+    const float d10 = d[2] + tx * (d[3] - d[2]);
+    const float d01 = d[4] + tx * (d[5] - d[4]);
+    const float d11 = d[6] + tx * (d[7] - d[6]);
+    const float d0 = d00 + ty * (d10 - d00);
+    const float d1 = d01 + ty * (d11 - d01);
+
+    if (gradient)
+    {
+        // Partial derivatives of the interpolant, scaled to world units
+        const float inv = 1.0f / m_voxelsize;
+        const float gx0 = (d[1] - d[0]) + ty * ((d[3] - d[2]) - (d[1] - d[0]));
+        const float gx1 = (d[5] - d[4]) + ty * ((d[7] - d[6]) - (d[5] - d[4]));
+        *gradient = BaseVecT(
+            (gx0 + tz * (gx1 - gx0)) * inv,
+            ((d10 - d00) + tz * ((d11 - d01) - (d10 - d00))) * inv,
+            (d1 - d0) * inv
+        );
+    }
+
+    return d0 + tz * (d1 - d0);
+}
+
+template <typename BaseVecT, typename BoxT>
+size_t HashGrid<BaseVecT, BoxT>::interpolateDistances(
+    const vector<BaseVecT>& positions,
+    vector<float>& distances,
+    vector<BaseVecT>* gradients) const
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    const size_t numQueries = positions.size();
+    distances.resize(numQueries);
+    if (gradients)
+    {
+        gradients->resize(numQueries);
+    }
+
+    const BaseVecT v_min = m_boundingBox.getMin();
+    const float inv = 1.0f / m_voxelsize;
+
+    const long blockSize = 256;
+    const long numBlocks = (numQueries + blockSize - 1) / blockSize;
+    size_t numValid = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:numValid)
+    for (long b = 0; b < numBlocks; b++)
+    {
+        const long first = b * blockSize;
+        const long count = std::min<long>(blockSize, numQueries - first);
+
+        // Cell i spans [i - 0.5, i + 0.5] voxels around v_min. The lattice
+        // coordinates of the whole block are computed first.
+        int index[blockSize][3];
+        float local[blockSize][3];
+        for (long q = 0; q < count; q++)
+        {
+            const BaseVecT& p = positions[first + q];
+            const float f[3] = {
+                (p.x - v_min.x) * inv + 0.5f,
+                (p.y - v_min.y) * inv + 0.5f,
+                (p.z - v_min.z) * inv + 0.5f
+            };
+            for (int a = 0; a < 3; a++)
+            {
+                const float fl = std::floor(f[a]);
+                index[q][a] = (int)fl;
+                local[q][a] = f[a] - fl;
+            }
+        }
+
+        // Consecutive queries in the same cell reuse its corner values
+        int cached[3] = {0, 0, 0};
+        bool hasCache = false;
+        bool valid = false;
+        float d[8];
+
+        for (long q = 0; q < count; q++)
+        {
+            const int* idx = index[q];
+            if (!hasCache || idx[0] != cached[0] || idx[1] != cached[1] || idx[2] != cached[2])
+            {
+                std::copy(idx, idx + 3, cached);
+                hasCache = true;
+                valid = cornerDistances(findCell(idx[0], idx[1], idx[2]), d);
+            }
+
+            BaseVecT* gradient = gradients ? &(*gradients)[first + q] : nullptr;
+            if (valid)
+            {
+                distances[first + q] = trilinear(d, local[q][0], local[q][1], local[q][2], gradient);
+                numValid++;
+            }
+            else
+            {
+                distances[first + q] = nan;
+                if (gradient)
+                {
+                    *gradient = BaseVecT(0, 0, 0);
+                }
+            }
+        }
+    }
+
+    return numValid;
+}
+
+template <typename BaseVecT, typename BoxT>
+bool HashGrid<BaseVecT, BoxT>::interpolateDistance(const BaseVecT& position, float& distance, BaseVecT* gradient) const
+{
+    const BaseVecT v_min = m_boundingBox.getMin();
+    const float f[3] = {
+        (position.x - v_min.x) / m_voxelsize + 0.5f,
+        (position.y - v_min.y) / m_voxelsize + 0.5f,
+        (position.z - v_min.z) / m_voxelsize + 0.5f
+    };
+    const int i = (int)std::floor(f[0]);
+    const int j = (int)std::floor(f[1]);
+    const int k = (int)std::floor(f[2]);
+
+    float d[8];
+    if (!cornerDistances(findCell(i, j, k), d))
+    {
+        distance = std::numeric_limits<float>::quiet_NaN();
+        if (gradient)
+        {
+            *gradient = BaseVecT(0, 0, 0);
+        }
+        return false;
+    }
+
+    distance = trilinear(d, f[0] - i, f[1] - j, f[2] - k, gradient);
+    return true;
+}
+
 } // namespace lvr2
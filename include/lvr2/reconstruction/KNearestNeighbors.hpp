@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * KNearestNeighbors.hpp
+ */
+
+#ifndef LVR2_RECONSTRUCTION_KNEARESTNEIGHBORS_H_
+#define LVR2_RECONSTRUCTION_KNEARESTNEIGHBORS_H_
+
+#include "lvr2/reconstruction/SearchTree.hpp"
+#include "lvr2/types/Channel.hpp"
+
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief The k nearest neighbors of all points of a point cloud.
+ *
+ * The neighbors of each point are stored in a fixed size block of k entries, sorted
+ * by distance like the results of SearchTree::kSearch. The query point itself is
+ * part of its neighborhood. Computing the neighborhoods once allows several
+ * algorithms, e.g. outlier filters and normal estimation, to share one search pass.
+ */
+struct KNearestNeighbors
+{
+    /// Number of neighbors searched per point
+    size_t k = 0;
+
+    /// Neighbor indices, k entries per point
+    std::vector<size_t> indices;
+
+    /// Euclidean distances of the neighbors, k entries per point
+    std::vector<float> distances;
+
+    /// Number of valid entries per point (<= k)
+    std::vector<unsigned int> counts;
+
+    size_t numPoints() const { return counts.size(); }
+
+    const size_t* neighbors(size_t i) const { return indices.data() + i * k; }
+
+    const float* neighborDistances(size_t i) const { return distances.data() + i * k; }
+
+    /**
+     * @brief Removes the points that are not kept and renumbers the remaining
+     *        neighbors, so the neighborhoods fit a point buffer that was compacted
+     *        with the same mask. Removed neighbors are dropped from the blocks,
+     *        so some points have fewer than k valid neighbors afterwards.
+     *
+     * @param keep One entry per point, != 0 for points that are kept
+     */
+    void compact(const std::vector<unsigned char>& keep);
+};
+
+/**
+ * @brief Searches the k nearest neighbors of all points in parallel.
+ *
+ * @param tree   Search tree over the points
+ * @param points The point channel the tree was built from
+ * @param k      Number of neighbors per point, including the point itself
+ */
+template<typename BaseVecT>
+KNearestNeighbors computeKNearestNeighbors(
+    const SearchTree<BaseVecT>& tree,
+    const Channel<float>& points,
+    size_t k);
+
+} // namespace lvr2
+
+#include "KNearestNeighbors.tcc"
+
+#endif // LVR2_RECONSTRUCTION_KNEARESTNEIGHBORS_H_
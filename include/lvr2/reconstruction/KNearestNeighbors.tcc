@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * KNearestNeighbors.tcc
+ */
+
+#include <cmath>
+
+namespace lvr2
+{
+
+inline void KNearestNeighbors::compact(const std::vector<unsigned char>& keep)
+{
+    size_t n = counts.size();
+
+    // new index of every kept point
+    std::vector<size_t> newIndex(n);
+    size_t next = 0;
+    for(size_t i = 0; i < n; i++)
+    {
+        newIndex[i] = next;
+        if(keep[i])
+        {
+            next++;
+        }
+    }
+
+    // Blocks only move towards the front, so the compaction can be done in place.
+    for(size_t i = 0; i < n; i++)
+    {
+        if(!keep[i])
+        {
+            continue;
+        }
+
+        size_t src = i * k;
+        size_t dst = newIndex[i] * k;
+        unsigned int count = 0;
+        for(unsigned int j = 0; j < counts[i]; j++)
+        {
+            size_t neighbor = indices[src + j];
+            if(keep[neighbor])
+            {
+                indices[dst + count] = newIndex[neighbor];
+                distances[dst + count] = distances[src + j];
+                count++;
+            }
+        }
+        counts[newIndex[i]] = count;
+    }
+
+    indices.resize(next * k);
+    distances.resize(next * k);
+    counts.resize(next);
+}
+
+template<typename BaseVecT>
+KNearestNeighbors computeKNearestNeighbors(
+    const SearchTree<BaseVecT>& tree,
+    const Channel<float>& points,
+    size_t k)
+{
+    KNearestNeighbors result;
+    size_t n = points.numElements();
+    result.k = k;
+    result.indices.resize(n * k);
+    result.distances.resize(n * k);
+    result.counts.resize(n);
+
+    #pragma omp parallel
+    {
+        std::vector<size_t> id;
+        std::vector<typename BaseVecT::CoordType> di;
+
+        #pragma omp for schedule(dynamic, 1024)
+        for(long i = 0; i < (long)n; i++)
+        {
+            BaseVecT query(points[i][0], points[i][1], points[i][2]);
+            id.clear();
+            di.clear();
+            tree.kSearch(query, k, id, di);
+
+            // The distance semantics differ between the search trees, so the
+            // euclidean distances are computed from the points
+            size_t found = std::min(id.size(), k);
+            size_t offset = i * k;
+            for(size_t j = 0; j < found; j++)
+            {
+                float dx = points[id[j]][0] - query[0];
+                float dy = points[id[j]][1] - query[1];
+                float dz = points[id[j]][2] - query[2];
+                result.indices[offset + j] = id[j];
+                result.distances[offset + j] = std::sqrt(dx * dx + dy * dy + dz * dz);
+            }
+            result.counts[i] = found;
+        }
+    }
+
+    return result;
+}
+
+} // namespace lvr2
@@ -33,6 +33,7 @@
 #include "lvr2/reconstruction/FastBox.hpp"
 #include "lvr2/algorithm/ChunkManager.hpp"
 #include "lvr2/geometry/HalfEdgeMesh.hpp"
+#include "lvr2/io/StageTimer.hpp"
 
 
 namespace lvr2
@@ -116,6 +117,18 @@ namespace lvr2
         // Threshold for fusing line segments while tesselating.
         float lineFusionThreshold = 0.01;
 
+        // Voxel size of the voxel grid reduction of each chunk's points. If 0 nothing will be reduced.
+        float reductionVoxelSize = 0;
+
+        // Fuse only the points of changed scans into the existing tsdf chunks (weighted average)
+        // instead of recomputing the affected partitions from scratch. Only possible for scans that
+        // aren't fused yet, otherwise the affected partitions are recomputed.
+        bool incremental = false;
+
+        // Incremental mode: a chunk is only re-meshed if one of its tsdf values changed by more
+        // than this fraction of the voxel size.
+        float remeshThreshold = 0.1;
+
         vector<float> getFlipPoint() const
         {
             std::vector<float> dest = flipPoint;
@@ -187,6 +200,30 @@ namespace lvr2
          */
         HalfEdgeMesh<BaseVecT> getPartialReconstruct(BoundingBox<BaseVecT> newChunksBB, std::shared_ptr<ChunkHashGrid> chunkHashGrid,  float voxelSize);
 
+        /**
+         * sets the voxel size of the voxel grid reduction that is applied to the points of each chunk
+         * before the reconstruction
+         *
+         * @param voxelSize voxel size of the reduction, 0 disables the reduction
+         */
+        void setReductionVoxelSize(float voxelSize) { m_reductionVoxelSize = voxelSize; }
+
+        /**
+         * enables the incremental mode of mpiChunkAndReconstruct: only the points of changed scans are
+         * fused into the tsdf chunks that already exist in the chunk manager. This is limited to new
+         * scans. If a scan that is already fused changed (e.g. it was registered again), the affected
+         * chunks are recomputed from all overlapping scans instead.
+         *
+         * @param incremental true to fuse changed scans, false to recompute the affected partitions
+         * @param remeshThreshold fraction of the voxel size a tsdf value of a chunk has to change by
+         *                        for the chunk to be re-meshed
+         */
+        void setIncremental(bool incremental, float remeshThreshold = 0.1)
+        {
+            m_incremental = incremental;
+            m_remeshThreshold = remeshThreshold;
+        }
+
 
 
 
@@ -205,6 +242,27 @@ namespace lvr2
                 shared_ptr<ChunkHashGrid> cm,
                 std::string layerName);
 
+        /**
+         * This method fuses the tsdf-values of one chunk into the chunk that is already stored in the
+         * ChunkManager-Layer. The valid distances of cells present in both are averaged with the
+         * per-corner weights of the stored chunk, new cells are appended. If there is no stored chunk,
+         * the chunk is added as is. The stored values must not contain an observation of the same
+         * scans, an average can't remove it.
+         *
+         * @params x, y, z grid-coordinates for the chunk
+         * @param ps_grid HashGrid which contains the new tsdf-values for the voxel
+         * @param cm ChunkManager instance which manages the chunks
+         * @param layerName the name of the chunkManager-layer
+         * @param voxelSize voxel size of the layer
+         * @return the maximum absolute change of a stored tsdf value, infinity if the chunk is new or
+         *         gained cells that are not extruded
+         */
+        float fuseTSDFChunkManager(int x, int y, int z,
+                shared_ptr<lvr2::PointsetGrid<BaseVector<float>, lvr2::FastBox<BaseVector<float>>>> ps_grid,
+                shared_ptr<ChunkHashGrid> cm,
+                std::string layerName,
+                float voxelSize);
+
         //flag to trigger .ply output of big Mesh
         bool m_bigMesh = true;
 
@@ -288,6 +346,15 @@ namespace lvr2
         // Threshold for fusing line segments while tesselating. Default: 0.01
         float m_lineFusionThreshold;
 
+        // Voxel size of the voxel grid reduction of each chunk's points. Default: 0 (disabled)
+        float m_reductionVoxelSize = 0;
+
+        // fuse changed scans into the existing tsdf chunks instead of recomputing them
+        bool m_incremental = false;
+
+        // min. change of a tsdf value (fraction of the voxel size) that triggers re-meshing a chunk
+        float m_remeshThreshold = 0.1;
+
 
     };
 } // namespace lvr2
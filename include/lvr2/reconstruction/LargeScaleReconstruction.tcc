@@ -25,7 +25,12 @@
  * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <set>
+#include <unordered_map>
 #include "lvr2/types/ScanTypes.hpp"
 #include "lvr2/io/hdf5/HDF5FeatureBase.hpp"
 #include "lvr2/io/hdf5/ChannelIO.hpp"
@@ -39,7 +44,7 @@
 #include "lvr2/reconstruction/PointsetGrid.hpp"
 #include "lvr2/reconstruction/FastBox.hpp"
 #include "lvr2/reconstruction/FastReconstruction.hpp"
-#include "lvr2/registration/OctreeReduction.hpp"
+#include "lvr2/algorithm/VoxelGridReduction.hpp"
 
 #include "lvr2/algorithm/CleanupAlgorithms.hpp"
 #include "lvr2/algorithm/NormalAlgorithms.hpp"
@@ -117,6 +122,9 @@ namespace lvr2
               options.minPlaneSize, options.smallRegionThreshold,
               options.retesselate, options.lineFusionThreshold, options.bigMesh, options.debugChunks, options.useGPU)
     {
+        m_reductionVoxelSize = options.reductionVoxelSize;
+        m_incremental = options.incremental;
+        m_remeshThreshold = options.remeshThreshold;
     }
 
 
@@ -130,7 +138,9 @@ namespace lvr2
         }
 
         cout << lvr2::timestamp << "Starting BigGrid" << endl;
+        StageTimer bigGridStage("BigGrid");
         BigGrid<BaseVecT> bg( m_bgVoxelSize ,project, m_scale);
+        bigGridStage.stop();
         cout << lvr2::timestamp << "BigGrid finished " << endl;
 
         BoundingBox<BaseVecT> bb = bg.getBB();
@@ -217,11 +227,13 @@ namespace lvr2
                 }
 
                 lvr2::PointBufferPtr p_loader_reduced;
-                //if(numPoints > (m_chunkSize*500000)) // reduction TODO add options
-                if(false)
+                if(m_reductionVoxelSize > 0)
                 {
-                    OctreeReduction oct(p_loader, m_voxelSizes[h], 20);
-                    p_loader_reduced = oct.getReducedPoints();
+                    VoxelGridReduction reduction(m_reductionVoxelSize);
+                    p_loader_reduced = reduction.reduce(p_loader);
+                    cout << timestamp << "Reduced " << reduction.numInputPoints() << " to "
+                         << reduction.numOutputPoints() << " points (" << reduction.throughput() / 1e6
+                         << " M points/s)" << endl;
                 }
                 else
                 {
@@ -375,8 +387,57 @@ namespace lvr2
             return 0;
         }
 
+        // scans that are fused into every tsdf layer, a weighted average can't remove the old
+        // observation of a scan, so only scans that aren't fused yet can be fused incrementally
+        bool fuse = m_incremental;
+        std::set<size_t> fusedScans;
+        if(m_incremental)
+        {
+            for(int h = 0; h < m_voxelSizes.size(); h++)
+            {
+                std::vector<size_t> layerScans = chunkManager->loadFusedScans("tsdf_values_" + std::to_string(m_voxelSizes[h]));
+                fusedScans.insert(layerScans.begin(), layerScans.end());
+            }
+            for(size_t i = 0; i < project->changed.size(); i++)
+            {
+                if(project->changed[i] && fusedScans.count(i))
+                {
+                    cout << lvr2::timestamp << "Scan " << i << " is already fused into the tsdf chunks, "
+                         << "recomputing the affected chunks instead of fusing" << endl;
+                    fuse = false;
+                    break;
+                }
+            }
+        }
+
+        ScanProjectEditMarkPtr gridProject = project;
+        if(fuse)
+        {
+            // only the points of the changed scans are fused into the existing chunks, so the
+            // unchanged scans (overlapping or not) don't have to be loaded at all
+            gridProject = ScanProjectEditMarkPtr(new ScanProjectEditMark);
+            gridProject->project = ScanProjectPtr(new ScanProject(*project->project));
+            gridProject->project->positions.clear();
+            for(size_t i = 0; i < project->changed.size(); i++)
+            {
+                if(project->changed[i])
+                {
+                    gridProject->project->positions.push_back(project->project->positions[i]);
+                    gridProject->changed.push_back(true);
+                }
+            }
+
+            if(gridProject->changed.empty())
+            {
+                cout << lvr2::timestamp << "No changed scans, nothing to fuse" << endl;
+                return 1;
+            }
+        }
+
         cout << lvr2::timestamp << "Starting BigGrid" << endl;
-        BigGrid<BaseVecT> bg( m_bgVoxelSize ,project, m_scale);
+        StageTimer bigGridStage("BigGrid");
+        BigGrid<BaseVecT> bg( m_bgVoxelSize, gridProject, m_scale);
+        bigGridStage.stop();
         cout << lvr2::timestamp << "BigGrid finished " << endl;
 
         BoundingBox<BaseVecT> bb = bg.getBB();
@@ -397,8 +458,12 @@ namespace lvr2
         partitionBoxes = vGrid.getBoxes();
         BaseVecT addMin = BaseVecT(std::floor(partbb.getMin().x / m_chunkSize) * m_chunkSize, std::floor(partbb.getMin().y / m_chunkSize) * m_chunkSize, std::floor(partbb.getMin().z / m_chunkSize) * m_chunkSize);
         BaseVecT addMax = BaseVecT(std::ceil(partbb.getMax().x / m_chunkSize) * m_chunkSize, std::ceil(partbb.getMax().y / m_chunkSize) * m_chunkSize, std::ceil(partbb.getMax().z / m_chunkSize) * m_chunkSize);
-        newChunksBB.expand(addMin);
-        newChunksBB.expand(addMax);
+        if(!fuse)
+        {
+            // in incremental mode only the chunks that actually changed are added below
+            newChunksBB.expand(addMin);
+            newChunksBB.expand(addMax);
+        }
         cout << lvr2::timestamp << "finished vGrid" << endl;
         std::cout << lvr2::timestamp << "got: " << partitionBoxes->size() << " Chunks"
                       << std::endl;
@@ -409,6 +474,12 @@ namespace lvr2
         BaseVecT addCMBBMax = BaseVecT(std::ceil(bb.getMax().x / m_chunkSize) * m_chunkSize, std::ceil(bb.getMax().y / m_chunkSize) * m_chunkSize, std::ceil(bb.getMax().z / m_chunkSize) * m_chunkSize);
         cmBB.expand(addCMBBMin);
         cmBB.expand(addCMBBMax);
+        if(fuse && chunkManager->getBoundingBox().isValid())
+        {
+            // the BigGrid only knows the changed scans
+            cmBB.expand(chunkManager->getBoundingBox().getMin());
+            cmBB.expand(chunkManager->getBoundingBox().getMax());
+        }
 
         chunkManager->setBoundingBox(cmBB);
         int numChunks_global = (cmBB.getXSize() / m_chunkSize) * (cmBB.getYSize() / m_chunkSize) * (cmBB.getZSize() / m_chunkSize);
@@ -428,7 +499,14 @@ namespace lvr2
             // vector to save the new chunk names - which chunks have to be reconstructed
             vector<BaseVector<int>> newChunks = vector<BaseVector<int>>();
 
+            // incremental mode: chunks whose tsdf was fused, newly created and below the re-mesh threshold
+            size_t chunksTouched = 0;
+            size_t chunksCreated = 0;
+            size_t chunksUnchanged = 0;
+            unsigned long layerStart = lvr2::timestamp.getCurrentTimeInMs();
+
             string layerName = "tsdf_values_" + std::to_string(m_voxelSizes[h]);
+            StageTimer layerStage(layerName);
             //create chunks
 
             for (int i = 0; i < partitionBoxes->size(); i++)
@@ -488,11 +566,13 @@ namespace lvr2
                 }
 
                 lvr2::PointBufferPtr p_loader_reduced;
-                //if(numPoints > (m_chunkSize*500000)) // reduction TODO add options
-                if(false)
+                if(m_reductionVoxelSize > 0)
                 {
-                    OctreeReduction oct(p_loader, m_voxelSizes[h], 20);
-                    p_loader_reduced = oct.getReducedPoints();
+                    VoxelGridReduction reduction(m_reductionVoxelSize);
+                    p_loader_reduced = reduction.reduce(p_loader);
+                    cout << timestamp << "Reduced " << reduction.numInputPoints() << " to "
+                         << reduction.numOutputPoints() << " points (" << reduction.throughput() / 1e6
+                         << " M points/s)" << endl;
                 }
                 else
                 {
@@ -558,7 +638,30 @@ namespace lvr2
                 int z = (int)floor(partitionBoxes->at(i).getCentroid().z / m_chunkSize);
 
 
-                addTSDFChunkManager(x, y, z, ps_grid, chunkManager, layerName);
+                if(fuse)
+                {
+                    float maxChange = fuseTSDFChunkManager(x, y, z, ps_grid, chunkManager, layerName, m_voxelSizes[h]);
+                    chunksTouched++;
+
+                    if(maxChange == std::numeric_limits<float>::infinity())
+                    {
+                        chunksCreated++;
+                    }
+                    else if(maxChange <= m_remeshThreshold * m_voxelSizes[h])
+                    {
+                        // the fused tsdf is (almost) the same as before, no need to re-mesh the chunk
+                        chunksUnchanged++;
+                        timeSum += lvr2::timestamp.getCurrentTimeInMs() - timeStart;
+                        continue;
+                    }
+
+                    newChunksBB.expand(BaseVecT(x * m_chunkSize, y * m_chunkSize, z * m_chunkSize));
+                    newChunksBB.expand(BaseVecT((x + 1) * m_chunkSize, (y + 1) * m_chunkSize, (z + 1) * m_chunkSize));
+                }
+                else
+                {
+                    addTSDFChunkManager(x, y, z, ps_grid, chunkManager, layerName);
+                }
                 BaseVector<int> chunkCoordinates(x, y, z);
                 // also save the grid coordinates of the chunk added to the ChunkManager
                 newChunks.push_back(chunkCoordinates);
@@ -589,6 +692,26 @@ namespace lvr2
             std::cout << lvr2::timestamp << "Skipped PartitionBoxes: " << partitionBoxesSkipped << std::endl;
 
             cout << "ChunkManagerIO Time: " <<(double) (timeSum / 1000.0) << " s" << endl;
+            if(fuse)
+            {
+                cout << lvr2::timestamp << "Incremental update of layer " << layerName << ": "
+                     << chunksTouched << " chunks touched (" << chunksCreated << " created, "
+                     << chunksTouched - chunksCreated - chunksUnchanged << " changed, "
+                     << chunksUnchanged << " below re-mesh threshold) in "
+                     << (lvr2::timestamp.getCurrentTimeInMs() - layerStart) / 1000.0 << " s" << endl;
+            }
+
+            // remember the scans in the layer, later incremental runs must not fuse them again
+            std::vector<size_t> layerScans = chunkManager->loadFusedScans(layerName);
+            std::set<size_t> scans(layerScans.begin(), layerScans.end());
+            for(size_t j = 0; j < project->changed.size(); j++)
+            {
+                if(project->changed[j])
+                {
+                    scans.insert(j);
+                }
+            }
+            chunkManager->saveFusedScans(layerName, std::vector<size_t>(scans.begin(), scans.end()));
             cout << lvr2::timestamp << "finished" << endl;
 
             if(m_bigMesh && h == 0)
@@ -703,6 +826,7 @@ namespace lvr2
         //cant save bool?
         boost::shared_array<int> extruded(new int[csize]);
         boost::shared_array<float> queryPoints(new float[8 * csize]);
+        boost::shared_array<float> weights(new float[8 * csize]);
 
         for(auto it = ps_grid->firstCell() ; it!= ps_grid->lastCell(); it++)
         {
@@ -715,7 +839,9 @@ namespace lvr2
 
             for (int k = 0; k < 8; ++k)
             {
-                queryPoints[8 * counter + k] = qp[it->second->getVertex(k)].m_distance;
+                const QueryPoint<BaseVecT>& q = qp[it->second->getVertex(k)];
+                queryPoints[8 * counter + k] = q.m_distance;
+                weights[8 * counter + k] = q.m_invalid ? 0.0f : 1.0f;
             }
             ++counter;
         }
@@ -724,10 +850,135 @@ namespace lvr2
         chunk->addFloatChannel(queryPoints, "tsdf_values", csize, 8);
         chunk->addChannel(extruded, "extruded", csize, 1);
         chunk->addAtomic<unsigned int>(csize, "num_voxel");
+        if(m_incremental)
+        {
+            // weights of the cell corners for later fusions, invalid distances have no weight
+            chunk->addFloatChannel(weights, "tsdf_weights", csize, 8);
+        }
 
         cm->setChunk<PointBufferPtr>(layerName, x, y, z, chunk);
     }
 
+    template <typename BaseVecT>
+    float LargeScaleReconstruction<BaseVecT>::fuseTSDFChunkManager(int x, int y, int z,
+            std::shared_ptr<lvr2::PointsetGrid<Vec, lvr2::FastBox<Vec>>> ps_grid, std::shared_ptr<ChunkHashGrid> cm,
+            std::string layerName, float voxelSize)
+    {
+        // upper bound of the accumulated weight of a cell, keeps the tsdf able to adapt to changes
+        const float maxWeight = 64;
+
+        boost::optional<PointBufferPtr> storedChunk = cm->getChunk<PointBufferPtr>(layerName, x, y, z);
+        boost::optional<Channel<float>> optTSDF;
+        boost::optional<Channel<int>> optExtruded;
+        if(storedChunk)
+        {
+            optTSDF = storedChunk.get()->getFloatChannel("tsdf_values");
+            optExtruded = storedChunk.get()->getChannel<int>("extruded");
+        }
+        if(!optTSDF || !optExtruded)
+        {
+            addTSDFChunkManager(x, y, z, ps_grid, cm, layerName);
+            return std::numeric_limits<float>::infinity();
+        }
+
+        size_t numStored = storedChunk.get()->numPoints();
+        floatArr storedCenters = storedChunk.get()->getPointArray();
+        boost::optional<Channel<float>> optWeights = storedChunk.get()->getFloatChannel("tsdf_weights");
+
+        std::vector<float> centers(storedCenters.get(), storedCenters.get() + 3 * numStored);
+        std::vector<float> values(optTSDF.get().dataPtr().get(), optTSDF.get().dataPtr().get() + 8 * numStored);
+        std::vector<int> extruded(optExtruded.get().dataPtr().get(), optExtruded.get().dataPtr().get() + numStored);
+        std::vector<float> weights(8 * numStored, 1.0f);
+        if(optWeights && optWeights.get().width() == 8)
+        {
+            std::copy(optWeights.get().dataPtr().get(), optWeights.get().dataPtr().get() + 8 * numStored, weights.begin());
+        }
+
+        // the cell centers of all grids of a layer lie on the same lattice, so a cell is identified by
+        // its lattice index relative to the chunk origin
+        BaseVecT origin(x * m_chunkSize, y * m_chunkSize, z * m_chunkSize);
+        auto cellKey = [&origin, voxelSize](float cx, float cy, float cz)
+        {
+            auto index = [voxelSize](float f)
+            {
+                return static_cast<uint64_t>(std::lround(f / voxelSize)) & 0x1FFFFF;
+            };
+            return (index(cx - origin.x) << 42) | (index(cy - origin.y) << 21) | index(cz - origin.z);
+        };
+
+        std::unordered_map<uint64_t, size_t> storedCells;
+        storedCells.reserve(numStored);
+        for(size_t i = 0; i < numStored; i++)
+        {
+            storedCells[cellKey(centers[3 * i], centers[3 * i + 1], centers[3 * i + 2])] = i;
+        }
+
+        float maxChange = 0;
+        vector<QueryPoint<BaseVecT>>& qp = ps_grid->getQueryPoints();
+        for(auto it = ps_grid->firstCell(); it != ps_grid->lastCell(); it++)
+        {
+            auto center = it->second->getCenter();
+            auto found = storedCells.find(cellKey(center[0], center[1], center[2]));
+            if(found == storedCells.end())
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    centers.push_back(center[j]);
+                }
+                for (int k = 0; k < 8; ++k)
+                {
+                    const QueryPoint<BaseVecT>& q = qp[it->second->getVertex(k)];
+                    values.push_back(q.m_distance);
+                    weights.push_back(q.m_invalid ? 0.0f : 1.0f);
+                }
+                extruded.push_back(it->second->m_extruded);
+
+                if(!it->second->m_extruded)
+                {
+                    maxChange = std::numeric_limits<float>::infinity();
+                }
+                continue;
+            }
+
+            // running weighted average per corner, the new observation has weight 1 if it is valid
+            size_t i = found->second;
+            for (int k = 0; k < 8; ++k)
+            {
+                const QueryPoint<BaseVecT>& q = qp[it->second->getVertex(k)];
+                if(q.m_invalid)
+                {
+                    continue;
+                }
+                float w = weights[8 * i + k];
+                float fused = (w * values[8 * i + k] + q.m_distance) / (w + 1);
+                maxChange = std::max(maxChange, std::abs(fused - values[8 * i + k]));
+                values[8 * i + k] = fused;
+                weights[8 * i + k] = std::min(w + 1, maxWeight);
+            }
+            extruded[i] = extruded[i] && it->second->m_extruded;
+        }
+
+        size_t csize = extruded.size();
+        floatArr fusedCenters(new float[3 * csize]);
+        floatArr fusedValues(new float[8 * csize]);
+        floatArr fusedWeights(new float[8 * csize]);
+        boost::shared_array<int> fusedExtruded(new int[csize]);
+        std::copy(centers.begin(), centers.end(), fusedCenters.get());
+        std::copy(values.begin(), values.end(), fusedValues.get());
+        std::copy(weights.begin(), weights.end(), fusedWeights.get());
+        std::copy(extruded.begin(), extruded.end(), fusedExtruded.get());
+
+        PointBufferPtr chunk = PointBufferPtr(new PointBuffer(fusedCenters, csize));
+        chunk->addFloatChannel(fusedValues, "tsdf_values", csize, 8);
+        chunk->addFloatChannel(fusedWeights, "tsdf_weights", csize, 8);
+        chunk->addChannel(fusedExtruded, "extruded", csize, 1);
+        chunk->addAtomic<unsigned int>(csize, "num_voxel");
+
+        cm->setChunk<PointBufferPtr>(layerName, x, y, z, chunk);
+
+        return maxChange;
+    }
+
 
     template<typename BaseVecT>
     HalfEdgeMesh<BaseVecT> LargeScaleReconstruction<BaseVecT>::getPartialReconstruct(BoundingBox<BaseVecT> newChunksBB,
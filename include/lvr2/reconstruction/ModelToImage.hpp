@@ -92,6 +92,44 @@ public:
             minRange(std::numeric_limits<float>::max()) {}
     } DepthListMatrix;
 
+    /// Compact image of projected points in compressed row storage. The
+    /// points projected to pixel (i, j) are stored in indices (and their
+    /// ranges in ranges) from offsets[i * width + j] to
+    /// offsets[i * width + j + 1], sorted by point index.
+    typedef struct PLX
+    {
+        int     width;
+        int     height;
+        vector<size_t> offsets;
+        vector<size_t> indices;
+        vector<float>  ranges;
+        float   maxRange;
+        float   minRange;
+        PLX() :
+            width(0),
+            height(0),
+            maxRange(std::numeric_limits<float>::lowest()),
+            minRange(std::numeric_limits<float>::max()) {}
+
+        /// Number of points projected to pixel (i, j)
+        size_t size(int i, int j) const
+        {
+            return offsets[i * width + j + 1] - offsets[i * width + j];
+        }
+
+        /// First point index of pixel (i, j)
+        const size_t* begin(int i, int j) const
+        {
+            return indices.data() + offsets[i * width + j];
+        }
+
+        /// End of the point indices of pixel (i, j)
+        const size_t* end(int i, int j) const
+        {
+            return indices.data() + offsets[i * width + j + 1];
+        }
+    } DepthListIndex;
+
 
     ///
     /// \brief The ProjectionType enum
@@ -179,6 +217,16 @@ public:
     ///
     void computeDepthListMatrix(DepthListMatrix& mat);
 
+    ///
+    /// \brief  Computes a DepthListIndex, i.e., a compact representation of
+    ///         a DepthListMatrix that stores the point indices of all pixels
+    ///         in a single array. Points are projected in parallel, points
+    ///         at the origin (missing measurements) are skipped.
+    ///
+    /// \param index        The generated DepthListIndex
+    ///
+    void computeDepthListIndex(DepthListIndex& index);
+
 
     ///
     /// \brief  Retruns the point buffer
@@ -731,7 +731,8 @@ std::pair<std::vector<CellHandle>, std::vector<uint> > C_Octree< BaseVecT, BoxT,
 {
     std::vector<CellHandle> cellHandles;
     std::vector<uint> markers;
-    std::vector<Location*> locations;
+    cellHandles.reserve(8);
+    markers.reserve(8);
 
     // get lower left back corner of given cell
     Location locinfo = location( _ch );
@@ -778,18 +779,10 @@ std::pair<std::vector<CellHandle>, std::vector<uint> > C_Octree< BaseVecT, BoxT,
             marker |= 1 << 2;
         }
 
-        locations.push_back(new Location(new_loc_x, new_loc_y, new_loc_z, locinfo.level() + 1, locinfo.parent()));
+        cellHandles.push_back(traverse(root(), new_loc_x, new_loc_y, new_loc_z));
         markers.push_back(marker);
     }
 
-    for(Location * location : locations)
-    {
-        cellHandles.push_back(traverse(root(), location->loc_x(), location->loc_y(), location->loc_z()));
-        delete location;
-    }
-    locations.clear();
-    std::vector<Location*>().swap(locations);
-
     return make_pair(cellHandles, markers);
 }
 
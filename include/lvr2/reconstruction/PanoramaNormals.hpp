@@ -46,6 +46,22 @@ public:
 
     PointBufferPtr computeNormals(int with, int height, bool interpolate);
 
+    ///
+    /// \brief Computes the same normals as computeNormals (without
+    ///        interpolation), but faster.
+    ///
+    /// The moments of the neighborhood of a pixel are kept as running sums
+    /// that slide along the columns and rows of the panorama, so the cost per
+    /// pixel does not depend on the size of the neighborhood. The normals are
+    /// the eigenvectors of the smallest eigenvalues of the covariance
+    /// matrices, computed in closed form. Points without a normal keep a
+    /// zero normal.
+    ///
+    /// \param width   Width of the neighborhood in pixels
+    /// \param height  Height of the neighborhood in pixels
+    ///
+    PointBufferPtr computeNormalsFast(int width, int height);
+
 private:
     ModelToImage*       m_mti;
     PointBufferPtr      m_buffer;
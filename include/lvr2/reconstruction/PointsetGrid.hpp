@@ -39,6 +39,7 @@
 
 #include "PointsetSurface.hpp"
 #include "lvr2/geometry/BoundingBox.hpp"
+#include "lvr2/io/StageTimer.hpp"
 
 namespace lvr2
 {
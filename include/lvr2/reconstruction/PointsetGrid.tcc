@@ -69,30 +69,31 @@ PointsetGrid<BaseVecT, BoxT>::PointsetGrid(
 template<typename BaseVecT, typename BoxT>
 void PointsetGrid<BaseVecT, BoxT>::calcDistanceValues()
 {
-    // Status message output
-    string comment = timestamp.getElapsedTime() + "Calculating distance values ";
-    ProgressBar progress(this->m_queryPoints.size(), comment);
-
+    StageTimer stage("distance values");
     Timestamp ts;
 
-    // Calculate a distance value for each query point
-    #pragma omp parallel for schedule(dynamic, 4)
-    for( int i = 0; i < (int)this->m_queryPoints.size(); i++){
-        float projectedDistance;
-        float euklideanDistance;
+    // Evaluate all query points in one batch, so that the surface can share the
+    // neighbor searches of neighboring query points
+    size_t numQueries = this->m_queryPoints.size();
+    vector<BaseVecT> positions(numQueries);
+    for(size_t i = 0; i < numQueries; i++)
+    {
+        positions[i] = this->m_queryPoints[i].m_position;
+    }
 
-        //cout << euklideanDistance << " " << projectedDistance << endl;
+    vector<typename BaseVecT::CoordType> projectedDistances;
+    vector<typename BaseVecT::CoordType> euklideanDistances;
+    m_surface->distances(positions, projectedDistances, euklideanDistances);
 
-        std::tie(projectedDistance, euklideanDistance) =
-            this->m_surface->distance(this->m_queryPoints[i].m_position);
-        if (euklideanDistance > 1.7320 * this->m_voxelsize)
+    #pragma omp parallel for
+    for(long i = 0; i < (long)numQueries; i++)
+    {
+        if (euklideanDistances[i] > 1.7320 * this->m_voxelsize)
         {
             this->m_queryPoints[i].m_invalid = true;
         }
-        this->m_queryPoints[i].m_distance = projectedDistance;
-        ++progress;
+        this->m_queryPoints[i].m_distance = projectedDistances[i];
     }
-    cout << endl;
     cout << timestamp << "Elapsed time: " << ts.getElapsedTimeInS() << endl;
 }
 
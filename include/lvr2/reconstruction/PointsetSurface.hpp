@@ -36,7 +36,9 @@
 #define LVR2_RECONSTRUCTION_POINTSETSURFACE_HPP_
 
 #include <memory>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "lvr2/geometry/Normal.hpp"
 #include "lvr2/io/PointBuffer.hpp"
@@ -44,6 +46,7 @@
 #include "lvr2/reconstruction/SearchTree.hpp"
 
 using std::pair;
+using std::vector;
 
 namespace lvr2
 {
@@ -73,6 +76,21 @@ public:
      */
     virtual pair<typename BaseVecT::CoordType, typename BaseVecT::CoordType>
         distance(BaseVecT v) const = 0;
+
+    /**
+     * @brief   Calculates the distances of many query points at once. The
+     *          default implementation calls @ref distance for each of them,
+     *          surfaces may override it with a faster batched evaluation.
+     *
+     * @param queries   The query points
+     * @param projected The projected distances, see @ref distance
+     * @param euklidean The euclidian distances, see @ref distance
+     */
+    virtual void distances(
+        const vector<BaseVecT>& queries,
+        vector<typename BaseVecT::CoordType>& projected,
+        vector<typename BaseVecT::CoordType>& euklidean) const;
+
     /**
      * @brief   Calculates surface normals for each data point in the given
      *          PointBuffeer. If the buffer alreay contains normal information
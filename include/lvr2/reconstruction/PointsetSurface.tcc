@@ -50,6 +50,22 @@ PointsetSurface<BaseVecT>::PointsetSurface(PointBufferPtr pointBuffer)
     }
 }
 
+template<typename BaseVecT>
+void PointsetSurface<BaseVecT>::distances(
+    const vector<BaseVecT>& queries,
+    vector<typename BaseVecT::CoordType>& projected,
+    vector<typename BaseVecT::CoordType>& euklidean) const
+{
+    projected.resize(queries.size());
+    euklidean.resize(queries.size());
+
+    #pragma omp parallel for schedule(dynamic, 64)
+    for(long i = 0; i < (long)queries.size(); i++)
+    {
+        std::tie(projected[i], euklidean[i]) = distance(queries[i]);
+    }
+}
+
 template<typename BaseVecT>
 Normal<float> PointsetSurface<BaseVecT>::getInterpolatedNormal(const BaseVecT& position) const
 {
@@ -99,7 +99,18 @@ void SearchTreeFlann<BaseVecT>::radiusSearch(
     vector<size_t>& indices
 ) const
 {
-    panic_unimplemented("radiusSearch() is not implemented for FLANN yet");
+    CoordT point[3] = { qp.x, qp.y, qp.z };
+    flann::Matrix<CoordT> query_point(point, 1, 3);
+
+    vector<vector<size_t>> ind;
+    vector<vector<CoordT>> dist;
+
+    // The L2 distance functor of FLANN works on squared distances
+    flann::SearchParams params;
+    params.sorted = false;
+    m_tree->radiusSearch(query_point, ind, dist, r * r, params);
+
+    indices = std::move(ind[0]);
 }
 
 template<typename BaseVecT>
@@ -0,0 +1,104 @@
+//
+// DynamicHashGrid.hpp
+//
+
+#ifndef LAS_VEGAS_DYNAMICHASHGRID_HPP
+#define LAS_VEGAS_DYNAMICHASHGRID_HPP
+
+#include "lvr2/geometry/BoundingBox.hpp"
+#include "lvr2/geometry/Handles.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace lvr2{
+
+    /**
+     * @brief Uniform hash grid over the vertices of a mesh that supports insertion, removal and
+     *        movement of single vertices and exact nearest neighbor queries.
+     *
+     * The cell size is derived from the extent of the bounding box and the number of stored
+     * vertices. Whenever the number of vertices has grown by a factor of four, the grid is rebuilt
+     * with a cell size that is half as large, so the number of vertices per cell stays small while
+     * the mesh grows. The nearest neighbor query searches shells of cells around the query point
+     * and returns the same vertex as a linear scan over the vertices in ascending handle order,
+     * i.e. the vertex with the smallest handle index among the closest vertices.
+     */
+    template <typename BaseVecT>
+    class DynamicHashGrid {
+
+    public:
+        /**
+         * @brief Creates an empty grid.
+         *
+         * @param bb bounding box of the region the vertices will be placed in
+         */
+        explicit DynamicHashGrid(const BoundingBox<BaseVecT>& bb);
+
+        /// Adds a vertex at the given position
+        void insert(VertexHandle vH, const BaseVecT& position);
+
+        /// Removes a vertex
+        void remove(VertexHandle vH);
+
+        /// Moves a vertex to the given position
+        void move(VertexHandle vH, const BaseVecT& position);
+
+        /**
+         * @brief Finds the vertex that is closest to the given point.
+         *
+         * @return handle of the closest vertex or a handle with index
+         *         numeric_limits<int>::max() if the grid is empty
+         */
+        VertexHandle findNearest(const BaseVecT& point) const;
+
+        /// Number of stored vertices
+        size_t size() const { return m_size; }
+
+        /// Current edge length of the grid cells
+        float cellSize() const { return m_cellSize; }
+
+    private:
+
+        typedef uint64_t CellKey;
+
+        /// Grid coordinates of a position
+        void cellIndex(const BaseVecT& position, int& x, int& y, int& z) const;
+
+        static CellKey key(int x, int y, int z);
+
+        void insertIntoCell(Index idx, const BaseVecT& position);
+
+        void removeFromCell(Index idx);
+
+        /// Computes the cell size for the current number of vertices and re-inserts all vertices
+        void rebuild();
+
+        /// Searches all vertices in the cell and updates the best candidate
+        void searchCell(int x, int y, int z, const BaseVecT& point, float& bestDistance, Index& best) const;
+
+        std::unordered_map<CellKey, std::vector<Index>> m_cells;
+
+        // Positions and cell keys of the vertices, indexed by the handle index
+        std::vector<BaseVecT> m_positions;
+        std::vector<CellKey> m_vertexCells;
+        std::vector<bool> m_contained;
+
+        BaseVecT m_origin;
+        float m_extent;
+        float m_cellSize;
+        size_t m_size;
+
+        // number of vertices the cell size was computed for
+        size_t m_sizedFor;
+
+        // range of the occupied cell indices
+        int m_min[3];
+        int m_max[3];
+    };
+}
+
+#include "DynamicHashGrid.tcc"
+
+#endif //LAS_VEGAS_DYNAMICHASHGRID_HPP
@@ -0,0 +1,255 @@
+//
+// DynamicHashGrid.tcc
+//
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace lvr2{
+
+    template <typename BaseVecT>
+    DynamicHashGrid<BaseVecT>::DynamicHashGrid(const BoundingBox<BaseVecT>& bb)
+        : m_origin(bb.getMin()), m_size(0), m_sizedFor(1)
+    {
+        m_extent = std::max({bb.getXSize(), bb.getYSize(), bb.getZSize()});
+        if(!(m_extent > 0))
+        {
+            m_extent = 1;
+        }
+        m_cellSize = m_extent;
+
+        for(int i = 0; i < 3; i++)
+        {
+            m_min[i] = std::numeric_limits<int>::max();
+            m_max[i] = std::numeric_limits<int>::min();
+        }
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::cellIndex(const BaseVecT& position, int& x, int& y, int& z) const
+    {
+        x = (int)std::floor((position.x - m_origin.x) / m_cellSize);
+        y = (int)std::floor((position.y - m_origin.y) / m_cellSize);
+        z = (int)std::floor((position.z - m_origin.z) / m_cellSize);
+    }
+
+    template <typename BaseVecT>
+    typename DynamicHashGrid<BaseVecT>::CellKey DynamicHashGrid<BaseVecT>::key(int x, int y, int z)
+    {
+        // 21 bits per axis, shifted to be positive
+        const int64_t bias = 1 << 20;
+        return ((uint64_t)((x + bias) & 0x1FFFFF) << 42)
+             | ((uint64_t)((y + bias) & 0x1FFFFF) << 21)
+             | (uint64_t)((z + bias) & 0x1FFFFF);
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::insertIntoCell(Index idx, const BaseVecT& position)
+    {
+        int c[3];
+        cellIndex(position, c[0], c[1], c[2]);
+        for(int i = 0; i < 3; i++)
+        {
+            m_min[i] = std::min(m_min[i], c[i]);
+            m_max[i] = std::max(m_max[i], c[i]);
+        }
+
+        CellKey k = key(c[0], c[1], c[2]);
+        m_cells[k].push_back(idx);
+        m_vertexCells[idx] = k;
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::removeFromCell(Index idx)
+    {
+        auto it = m_cells.find(m_vertexCells[idx]);
+        std::vector<Index>& cell = it->second;
+        auto pos = std::find(cell.begin(), cell.end(), idx);
+        *pos = cell.back();
+        cell.pop_back();
+        if(cell.empty())
+        {
+            m_cells.erase(it);
+        }
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::insert(VertexHandle vH, const BaseVecT& position)
+    {
+        Index idx = vH.idx();
+        if(idx >= m_positions.size())
+        {
+            m_positions.resize(idx + 1);
+            m_vertexCells.resize(idx + 1);
+            m_contained.resize(idx + 1, false);
+        }
+        if(m_contained[idx])
+        {
+            move(vH, position);
+            return;
+        }
+
+        m_positions[idx] = position;
+        m_contained[idx] = true;
+        m_size++;
+
+        if(m_size > 4 * m_sizedFor)
+        {
+            rebuild();
+        }
+        else
+        {
+            insertIntoCell(idx, position);
+        }
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::remove(VertexHandle vH)
+    {
+        Index idx = vH.idx();
+        if(idx >= m_contained.size() || !m_contained[idx])
+        {
+            return;
+        }
+
+        removeFromCell(idx);
+        m_contained[idx] = false;
+        m_size--;
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::move(VertexHandle vH, const BaseVecT& position)
+    {
+        Index idx = vH.idx();
+        if(idx >= m_contained.size() || !m_contained[idx])
+        {
+            insert(vH, position);
+            return;
+        }
+
+        m_positions[idx] = position;
+
+        int x, y, z;
+        cellIndex(position, x, y, z);
+        if(key(x, y, z) != m_vertexCells[idx])
+        {
+            removeFromCell(idx);
+            insertIntoCell(idx, position);
+        }
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::rebuild()
+    {
+        // Vertices of a surface mesh that fills the bounding box have a spacing of roughly
+        // extent / sqrt(n). Aim for about two vertices per occupied cell.
+        m_sizedFor = m_size;
+        m_cellSize = m_extent * std::sqrt(2.0f / m_size);
+
+        m_cells.clear();
+        for(int i = 0; i < 3; i++)
+        {
+            m_min[i] = std::numeric_limits<int>::max();
+            m_max[i] = std::numeric_limits<int>::min();
+        }
+
+        for(Index idx = 0; idx < m_contained.size(); idx++)
+        {
+            if(m_contained[idx])
+            {
+                insertIntoCell(idx, m_positions[idx]);
+            }
+        }
+    }
+
+    template <typename BaseVecT>
+    void DynamicHashGrid<BaseVecT>::searchCell(int x, int y, int z, const BaseVecT& point, float& bestDistance, Index& best) const
+    {
+        auto it = m_cells.find(key(x, y, z));
+        if(it == m_cells.end())
+        {
+            return;
+        }
+
+        for(Index idx : it->second)
+        {
+            // same computation as the linear search in GrowingCellStructure
+            BaseVecT distanceVector = point - m_positions[idx];
+            float length = distanceVector.length2();
+            if(length < bestDistance || (length == bestDistance && idx < best))
+            {
+                bestDistance = length;
+                best = idx;
+            }
+        }
+    }
+
+    template <typename BaseVecT>
+    VertexHandle DynamicHashGrid<BaseVecT>::findNearest(const BaseVecT& point) const
+    {
+        Index best = std::numeric_limits<int>::max();
+        float bestDistance = std::numeric_limits<float>::infinity();
+        if(m_size == 0)
+        {
+            return VertexHandle(best);
+        }
+
+        int c[3];
+        cellIndex(point, c[0], c[1], c[2]);
+
+        for(int r = 0; ; r++)
+        {
+            // search the shell of cells with chebyshev distance r around the query cell,
+            // restricted to the range of occupied cells
+            int lo[3], hi[3];
+            bool covered = true;
+            for(int i = 0; i < 3; i++)
+            {
+                lo[i] = std::max(c[i] - r, m_min[i]);
+                hi[i] = std::min(c[i] + r, m_max[i]);
+                covered = covered && c[i] - r <= m_min[i] && c[i] + r >= m_max[i];
+            }
+
+            for(int x = lo[0]; x <= hi[0]; x++)
+            {
+                for(int y = lo[1]; y <= hi[1]; y++)
+                {
+                    if(std::abs(x - c[0]) == r || std::abs(y - c[1]) == r)
+                    {
+                        for(int z = lo[2]; z <= hi[2]; z++)
+                        {
+                            searchCell(x, y, z, point, bestDistance, best);
+                        }
+                    }
+                    else
+                    {
+                        if(c[2] - r >= lo[2])
+                        {
+                            searchCell(x, y, c[2] - r, point, bestDistance, best);
+                        }
+                        if(r > 0 && c[2] + r <= hi[2])
+                        {
+                            searchCell(x, y, c[2] + r, point, bestDistance, best);
+                        }
+                    }
+                }
+            }
+
+            if(covered)
+            {
+                break;
+            }
+
+            // All vertices outside of the searched cells are at least r cells away. A small
+            // tolerance accounts for rounding in the cell index computation.
+            float bound = (r - 0.001f) * m_cellSize;
+            if(r > 0 && bestDistance < bound * bound)
+            {
+                break;
+            }
+        }
+
+        return VertexHandle(best);
+    }
+}
@@ -9,7 +9,7 @@
 #include "lvr2/config/BaseOption.hpp"
 #include "lvr2/geometry/HalfEdgeMesh.hpp"
 #include "lvr2/reconstruction/PointsetSurface.hpp"
-#include "lvr2/reconstruction/gs2/DynamicKDTree.hpp"
+#include "lvr2/reconstruction/gs2/DynamicHashGrid.hpp"
 #include "lvr2/reconstruction/gs2/TumbleTree.hpp"
 
 namespace lvr2
@@ -104,6 +104,19 @@ class GrowingCellStructure
 
     void setNumBalances(int m_balances) { GrowingCellStructure::m_balances = m_balances; }
 
+    /**
+     * Use the linear search over all mesh vertices instead of the vertex grid to find the
+     * winning vertex. Both searches select the same vertices, the linear one is only kept
+     * as a reference.
+     */
+    void setLinearSearch(bool linearSearch) { GrowingCellStructure::m_linearSearch = linearSearch; }
+
+    /**
+     * Print mesh and tumble tree statistics after the reconstruction. Some of them
+     * are expensive to compute, so they are off by default.
+     */
+    void setVerbose(bool verbose) { GrowingCellStructure::m_verbose = verbose; }
+
   private:
     PointsetSurfacePtr<BaseVecT>* m_surface; // helper-surface
     HalfEdgeMesh<BaseVecT>* m_mesh;
@@ -123,7 +136,9 @@ class GrowingCellStructure
 
     // "GCS" related members
     TumbleTree* tumble_tree;
-    DynamicKDTree<BaseVecT>* kd_tree;
+    DynamicHashGrid<BaseVecT>* vertex_grid; // spatial index of the mesh vertices for the winner search
+    bool m_linearSearch = false;
+    bool m_verbose = false;
     std::vector<Cell*> cellArr; // TODO: OUTSOURCE IT INTO THE TUMBLETREE CLASS, NEW PARAMETER FOR
                                 // THE TUMBLE TREE CONSTRUCTOR
                                 // CONTAINING THE MAXMIMUM SIZE OF THE MESH
@@ -27,7 +27,7 @@ namespace lvr2 {
         m_surface = &surface;
         m_mesh = 0;
         tumble_tree = new TumbleTree(); //create tumble tree
-        kd_tree = new DynamicKDTree<BaseVecT>(3); // create 3-dimensional kd-tree for distance evaluation
+        vertex_grid = 0; // created in getInitialMesh
     }
 
     /**
@@ -52,9 +52,13 @@ namespace lvr2 {
         //get initial tetrahedron mesh
         getInitialMesh();
 
-        //progress bar
+        //progress bar, the linear search counts every visited vertex, the grid search every basic step
         size_t runtime_length = (size_t)((((size_t)m_runtime*(size_t)m_numSplits)
                                           *(((size_t)m_numSplits*(size_t)m_runtime)+1)/(size_t)2) * (size_t)m_basicSteps);
+        if(!m_linearSearch)
+        {
+            runtime_length = (size_t)m_runtime * (size_t)m_numSplits * (size_t)m_basicSteps;
+        }
         PacmanProgressBar progress_bar(runtime_length);
 
         //algorithm
@@ -106,20 +110,28 @@ namespace lvr2 {
         }
 
 
-        cout << "Max depth of tt: " << (m_balances != 0 ? max_depth : tumble_tree->maxDepth()) << endl;
-        cout << "Not Deleted in TT: " << tumble_tree->notDeleted << endl;
-        cout << "Tumble Tree size: " << tumble_tree->size() << endl;
-        cout << "KD-Tree size: " << kd_tree->size() << endl;
-        cout << "Cell array size: " << cellVecSize() << endl;
-        cout << "Not found counter: " << notFoundCounter << endl;
-        cout << endl;
-        cout << "Equilaterality test percentage: " << equilaterality().second << endl;
-        cout << "Skewness test percentage: " << equilaterality().first << endl;
-        cout << "Average Valence: " << avgValence() << endl;
-
-        cout << "Valances >= 10: " << numVertexValences(10) << endl;
-        cout << "Valances >= 15: " << numVertexValences(15) << endl;
+        if(m_verbose)
+        {
+            cout << "Max depth of tt: " << (m_balances != 0 ? max_depth : tumble_tree->maxDepth()) << endl;
+            cout << "Not Deleted in TT: " << tumble_tree->notDeleted << endl;
+            cout << "Tumble Tree size: " << tumble_tree->size() << endl;
+            if(!m_useGSS)
+            {
+                cout << "Vertex grid size: " << vertex_grid->size() << endl;
+            }
+            cout << "Cell array size: " << cellVecSize() << endl;
+            cout << "Not found counter: " << notFoundCounter << endl;
+            cout << endl;
+            cout << "Equilaterality test percentage: " << equilaterality().second << endl;
+            cout << "Skewness test percentage: " << equilaterality().first << endl;
+            cout << "Average Valence: " << avgValence() << endl;
+
+            cout << "Valances >= 10: " << numVertexValences(10) << endl;
+            cout << "Valances >= 15: " << numVertexValences(15) << endl;
+        }
         delete tumble_tree;
+        delete vertex_grid;
+        vertex_grid = 0;
     }
 
 
@@ -141,15 +153,21 @@ namespace lvr2 {
         //cout << "basic step" << endl;
         if(!m_useGSS) //if only gcs is used (gcs basic step)
         {
-            VertexHandle winnerH = this->getClosestPointInMesh(random_point, progress_bar); //TODO: better runtime efficency(kd-tree)
-            /*Index winnerIndex = kd_tree->findNearest(random_point);
-            VertexHandle winnerH(winnerIndex);*/
+            VertexHandle winnerH(0);
+            if(m_linearSearch)
+            {
+                winnerH = this->getClosestPointInMesh(random_point, progress_bar);
+            }
+            else
+            {
+                winnerH = vertex_grid->findNearest(random_point);
+                ++progress_bar;
+            }
 
             //smooth the winning vertex
             BaseVecT &winner = m_mesh->getVertexPosition(winnerH);
-            //kd_tree->deleteNode(winner);
             winner += (random_point - winner) * getLearningRate();
-            //kd_tree->insert(winner, winnerH);
+            vertex_grid->move(winnerH, winner);
 
             //smooth the winning vertices' neighbors (laplacian smoothing)
 
@@ -160,12 +178,11 @@ namespace lvr2 {
             for(auto v : neighborsOfWinner)
             {
                 BaseVecT& nb = m_mesh->getVertexPosition(v);
-                //kd_tree->deleteNode(nb);
 
                 nb += (random_point - winner) * getNeighborLearningRate();
                 if(m_mesh->numVertices() > 100) performLaplacianSmoothing(v, random_point, getNeighborLearningRate());
 
-                //kd_tree->insert(nb, v);
+                vertex_grid->move(v, nb);
             }
 
 
@@ -240,8 +257,8 @@ namespace lvr2 {
             cellArr[newVH.idx()] = tumble_tree->insert(actual_sc / 2, newVH);
 
 
-            /*BaseVecT kdInsert = m_mesh->getVertexPosition(newVH);
-            kd_tree->insert(kdInsert, newVH);*/
+            //the split only adds the new vertex, the position of the split vertex is unchanged
+            vertex_grid->insert(newVH, m_mesh->getVertexPosition(newVH));
 
         }
         else //GSS TODO: INCLUDE GSS ADDITIONS
@@ -342,11 +359,13 @@ namespace lvr2 {
 
                     if(eToSixVal && m_mesh->isCollapsable(eToSixVal.unwrap()))
                     {
-                        //TODO: use collapse result to remove the (vertex) from the tumble tree and the kd tree
+                        //TODO: use collapse result to remove the (vertex) from the tumble tree
                         //otherwise this wont work
                         EdgeCollapseResult result = m_mesh->collapseEdge(eToSixVal.unwrap());
                         tumble_tree->remove(cellArr[result.removedPoint.idx()], result.removedPoint);
                         cellArr[result.removedPoint.idx()] = NULL;
+                        vertex_grid->remove(result.removedPoint);
+                        vertex_grid->move(result.midPoint, m_mesh->getVertexPosition(result.midPoint));
                         std::cout << "Collapsed an Edge!" << endl;
                     }
                 }
@@ -391,7 +410,7 @@ namespace lvr2 {
 
     /**
      * Gets the closest point to the given point using the euclidean distance
-     * runtime: O(n) //TODO: make it better. kd-tree? KD-TREE IMPLEMENTATION IN GS2 NOT GOOD.
+     * runtime: O(n), only used as reference for the vertex grid search
      *
      * @tparam BaseVecT
      * @tparam NormalT
@@ -561,6 +580,14 @@ namespace lvr2 {
         auto vH3 = m_mesh->addVertex(right);
         auto vH4 = m_mesh->addVertex(back);
 
+        //created in both modes so it is never null, only the GCS steps keep it up to date
+        delete vertex_grid;
+        vertex_grid = new DynamicHashGrid<BaseVecT>(bounding_box);
+        vertex_grid->insert(vH1, top);
+        vertex_grid->insert(vH2, left);
+        vertex_grid->insert(vH3, right);
+        vertex_grid->insert(vH4, back);
+
         cout << vH1 << " | " << vH2 << " | " << vH3 << " | " << vH4 << endl;
 
         FaceHandle fH1(0);
@@ -598,11 +625,6 @@ namespace lvr2 {
             cellArr[vH2.idx()] = tumble_tree->insert(1, vH2);
             cellArr[vH3.idx()] = tumble_tree->insert(1, vH3);
             cellArr[vH4.idx()] = tumble_tree->insert(1, vH4);
-
-            kd_tree->insert(top, vH1);
-            kd_tree->insert(left, vH2);
-            kd_tree->insert(right, vH3);
-            kd_tree->insert(back, vH4);
         }
     }
 
@@ -746,11 +768,22 @@ namespace lvr2 {
     void GrowingCellStructure<BaseVecT, NormalT>::aggressiveCutOut(VertexHandle vH) {
         cout << "Aggressive Cutout..." << endl;
         auto faces = m_mesh->getFacesOfVertex(vH);
+        auto neighbors = m_mesh->getNeighboursOfVertex(vH);
         tumble_tree->remove(cellArr[vH.idx()], vH);
         for(auto face : faces)
         {
             m_mesh->removeFace(face);
         }
+
+        //removing the faces also removes vertices without remaining faces
+        neighbors.push_back(vH);
+        for(auto vertex : neighbors)
+        {
+            if(!m_mesh->containsVertex(vertex))
+            {
+                vertex_grid->remove(vertex);
+            }
+        }
     }
 
     /**
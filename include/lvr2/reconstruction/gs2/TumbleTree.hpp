@@ -34,6 +34,7 @@ class TumbleTree
 
     Cell* insert(Cell* c, double sc, VertexHandle vH);
     Cell* findMin(Cell* c);
+    Cell* removeMin(Cell* c);
     Cell* findMax(Cell* c);
     Cell* find(double sc, VertexHandle vH, Cell* c, double alpha = 1);
     int size(Cell* c);
@@ -178,17 +178,19 @@ namespace lvr2{
             //two subtrees
             else
             {
-                struct Cell *tmp = findMin(c->right); //inorder successor
-                c->signal_counter = tmp->signal_counter;
-                c->alpha = 1;
-                c->duplicateMap.clear();
+                //replace the cell by its inorder successor. the successor cell itself is moved instead of
+                //copying its content, so that pointers to it (e.g. the cell array of the gcs) stay valid
+                struct Cell *tmp = findMin(c->right); //inorder successor, alphas on the path are propagated
+                c->right = removeMin(c->right);
 
-                for(auto iter = tmp->duplicateMap.begin(); iter != tmp->duplicateMap.end(); ++iter)
-                {
-                    c->duplicateMap.insert(*iter, tmp->signal_counter);
-                }
+                tmp->left = c->left;
+                tmp->right = c->right;
+                tmp->left->parent = tmp;
+                if(tmp->right) tmp->right->parent = tmp;
+                tmp->parent = c->parent;
 
-                c->right = remove(tmp->signal_counter, *tmp->duplicateMap.begin(), c->right, true);
+                delete c;
+                return tmp;
             }
 
         }
@@ -197,6 +199,27 @@ namespace lvr2{
     }
 
 
+    /**
+     * unlinks the cell with the minimum sc from the subtree without deleting it. the pending alphas on the
+     * path have to be propagated already (findMin)
+     * @param c root of the subtree
+     * @return the new root of the subtree
+     */
+    Cell* TumbleTree::removeMin(Cell* c)
+    {
+        if(c->left == NULL)
+        {
+            return c->right;
+        }
+
+        c->left = removeMin(c->left);
+        if(c->left)
+        {
+            c->left->parent = c;
+        }
+        return c;
+    }
+
     /**
      * finds the cell with the minimum sc
      * @param c starting cell
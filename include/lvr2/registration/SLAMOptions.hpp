@@ -66,6 +66,9 @@ struct SLAMOptions
     /// The Voxel size for Octree based reduction
     double  reduction = -1;
 
+    /// Use a voxel grid instead of an Octree for the reduction. Keeps the Point closest to the centroid of each voxel
+    bool    voxelGridReduction = false;
+
     /// Ignore all Points closer than <value> to the origin of a scan
     double  minDistance = -1;
 
@@ -109,6 +109,15 @@ public:
      */
     void reduce(double voxelSize, int maxLeafSize);
 
+    /**
+     * @brief Reduces the Scan using a voxel grid, keeping the Point closest to the centroid of each voxel
+     * 
+     * Does not change the amount of allocated Memory unless trim() is called
+     * 
+     * @param voxelSize 
+     */
+    void reduceVoxelGrid(double voxelSize);
+
     /**
      * @brief Reduces the Scan by removing all Points closer than minDistance to the origin
      * 
@@ -201,7 +210,8 @@ public:
     const std::pair<Transformd, FrameUse>& frame(size_t index) const;
 
     /**
-     * @brief Writes the Frames to the specified location
+     * @brief Writes the Frames to the specified location. Paths ending in .bframes
+     *        are written in the binary frames format (see lvr2::writeFrames)
      * 
      * @param path The path of the file to write to
      */
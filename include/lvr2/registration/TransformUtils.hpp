@@ -41,6 +41,9 @@
 
 #include <Eigen/Dense>
 
+#include <algorithm>
+#include <cmath>
+
 namespace lvr2
 {
 
@@ -117,6 +120,37 @@ void transformAndReducePointCloud(ModelPtr& model, int modulo, const CoordinateT
 template<typename T>
 void transformPointCloud(ModelPtr model, const Transform<T>& transformation);
 
+/**
+ * @brief   Transforms an array of interleaved xyz float triples in place. The
+ *          points are processed in parallel blocks with the matrix coefficients
+ *          hoisted out of the loop, so that the compiler can vectorize it.
+ *
+ * @param   points          Array of 3 * n floats
+ * @param   n               Number of points
+ * @param   transformation  An affine transformation
+ */
+template<typename T>
+void transformPoints(float* points, size_t n, const Transform<T>& transformation);
+
+/**
+ * @brief   Transforms an array of interleaved normals in place with the inverse
+ *          transpose of the linear part of the transformation. The normals are
+ *          renormalized if the transformation contains a scaling.
+ *
+ * @param   normals         Array of 3 * n floats
+ * @param   n               Number of normals
+ * @param   transformation  An affine transformation
+ */
+template<typename T>
+void transformNormals(float* normals, size_t n, const Transform<T>& transformation);
+
+/**
+ * @brief   Transforms the points and, if present, the normals of the given
+ *          point buffer in place.
+ */
+template<typename T>
+void transformPointBuffer(PointBufferPtr buffer, const Transform<T>& transformation);
+
 /**
  * @brief   Transforms the given source frame according to the given coordinate
  *          transform struct 
@@ -227,21 +227,96 @@ void transformPointCloud(ModelPtr model, const Transform<T>& transformation)
 {
     std::cout << timestamp << "Transforming model." << std::endl;
 
-    size_t numPoints = model->m_pointCloud->numPoints();
-    floatArr arr = model->m_pointCloud->getPointArray();
+    transformPointBuffer(model->m_pointCloud, transformation);
+}
+
+template<typename T>
+void transformPoints(float* points, size_t n, const Transform<T>& transformation)
+{
+    const T m00 = transformation(0, 0), m01 = transformation(0, 1), m02 = transformation(0, 2), m03 = transformation(0, 3);
+    const T m10 = transformation(1, 0), m11 = transformation(1, 1), m12 = transformation(1, 2), m13 = transformation(1, 3);
+    const T m20 = transformation(2, 0), m21 = transformation(2, 1), m22 = transformation(2, 2), m23 = transformation(2, 3);
+
+    const long blockSize = 4096;
+    const long numBlocks = (n + blockSize - 1) / blockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < numBlocks; b++)
+    {
+        float* p = points + 3 * b * blockSize;
+        const long count = std::min<long>(blockSize, n - b * blockSize);
+        for (long i = 0; i < count; i++)
+        {
+            const T x = p[3 * i], y = p[3 * i + 1], z = p[3 * i + 2];
+            p[3 * i]     = m00 * x + m01 * y + m02 * z + m03;
+            p[3 * i + 1] = m10 * x + m11 * y + m12 * z + m13;
+            p[3 * i + 2] = m20 * x + m21 * y + m22 * z + m23;
+        }
+    }
+}
+
+template<typename T>
+void transformNormals(float* normals, size_t n, const Transform<T>& transformation)
+{
+    const Rotation<T> linear = transformation.template block<3, 3>(0, 0);
+    const Rotation<T> normalMatrix = linear.inverse().transpose();
+
+    // Rigid transformations keep the length of the normals
+    const bool renormalize = !(normalMatrix * normalMatrix.transpose()).isIdentity(1e-6);
 
-    for(int i = 0; i < numPoints; i++)
+    const float m00 = normalMatrix(0, 0), m01 = normalMatrix(0, 1), m02 = normalMatrix(0, 2);
+    const float m10 = normalMatrix(1, 0), m11 = normalMatrix(1, 1), m12 = normalMatrix(1, 2);
+    const float m20 = normalMatrix(2, 0), m21 = normalMatrix(2, 1), m22 = normalMatrix(2, 2);
+
+    const long blockSize = 4096;
+    const long numBlocks = (n + blockSize - 1) / blockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (long b = 0; b < numBlocks; b++)
+    {
+        float* p = normals + 3 * b * blockSize;
+        const long count = std::min<long>(blockSize, n - b * blockSize);
+        for (long i = 0; i < count; i++)
+        {
+            const float x = p[3 * i], y = p[3 * i + 1], z = p[3 * i + 2];
+            float nx = m00 * x + m01 * y + m02 * z;
+            float ny = m10 * x + m11 * y + m12 * z;
+            float nz = m20 * x + m21 * y + m22 * z;
+            if (renormalize)
+            {
+                const float length = std::sqrt(nx * nx + ny * ny + nz * nz);
+                const float inv = length > 0 ? 1.0f / length : 0.0f;
+                nx *= inv;
+                ny *= inv;
+                nz *= inv;
+            }
+            p[3 * i]     = nx;
+            p[3 * i + 1] = ny;
+            p[3 * i + 2] = nz;
+        }
+    }
+}
+
+template<typename T>
+void transformPointBuffer(PointBufferPtr buffer, const Transform<T>& transformation)
+{
+    if (!buffer)
     {
-        float x = arr[3 * i];
-        float y = arr[3 * i + 1];
-        float z = arr[3 * i + 2];
+        return;
+    }
 
-        Vector4<T> v(x,y,z,1);
-        Vector4<T> tv = transformation * v;
+    size_t numPoints = buffer->numPoints();
+    floatArr points = buffer->getPointArray();
+    if (points)
+    {
+        transformPoints(points.get(), numPoints, transformation);
+    }
 
-        arr[3 * i]     = tv[0];
-        arr[3 * i + 1] = tv[1];
-        arr[3 * i + 2] = tv[2];
+    size_t numNormals, width;
+    floatArr normals = buffer->getFloatArray("normals", numNormals, width);
+    if (normals && width == 3)
+    {
+        transformNormals(normals.get(), numNormals, transformation);
     }
 }
 
@@ -38,9 +38,11 @@
 
 #include "lvr2/geometry/Handles.hpp"
 
+#include <array>
 #include <vector>
 #include <utility>
 
+using std::array;
 using std::vector;
 using std::pair;
 
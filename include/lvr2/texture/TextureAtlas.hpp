@@ -0,0 +1,148 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * TextureAtlas.hpp
+ */
+
+#ifndef LVR2_TEXTURE_TEXTUREATLAS_HPP_
+#define LVR2_TEXTURE_TEXTUREATLAS_HPP_
+
+#include "lvr2/io/MeshBuffer.hpp"
+#include "lvr2/texture/Texture.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Position of a packed texture in the atlas
+ */
+struct AtlasRegion
+{
+    /// Index of the page the texture was copied to
+    size_t page;
+
+    /// Column of the first texel of the texture in the page (without padding)
+    unsigned int x;
+
+    /// Row of the first texel of the texture in the page (without padding)
+    unsigned int y;
+};
+
+/**
+ * @brief   Summary of a packing run
+ */
+struct AtlasStatistics
+{
+    /// Number of packed textures
+    size_t numTextures = 0;
+
+    /// Number of created pages
+    size_t numPages = 0;
+
+    /// Number of texels of all packed textures, without padding
+    size_t textureTexels = 0;
+
+    /// Number of texels of all pages
+    size_t pageTexels = 0;
+
+    /// Fraction of the page texels that are covered by textures
+    double utilisation() const
+    {
+        return pageTexels ? (double)textureTexels / pageTexels : 0.0;
+    }
+};
+
+/**
+ * @brief   Packs many small textures into a few large atlas pages.
+ *
+ * The textures are sorted by height and placed on shelves from left to
+ * right, starting a new shelf when a row is full and a new page when a page
+ * is full. Every texture is surrounded by a border of the given width that
+ * repeats its edge texels, so that filtering in a renderer does not blend
+ * neighbouring textures. Textures that are larger than a page are kept as
+ * pages of their own. The pages are cropped to the area that is actually used.
+ */
+class TextureAtlas
+{
+public:
+
+    /**
+     * @brief   Constructor
+     *
+     * @param   pageSize    Maximum width and height of a page in texels
+     * @param   padding     Width of the border around each texture in texels
+     */
+    TextureAtlas(unsigned short pageSize = 4096, unsigned short padding = 2);
+
+    /**
+     * @brief   Packs the given textures into pages
+     *
+     * @param   textures    The textures to pack. All textures must have the
+     *                      same number of channels and bytes per channel.
+     * @param   regions     Filled with the position of each texture
+     *
+     * @return  The pages, their index is their position in the vector
+     */
+    std::vector<Texture> pack(const std::vector<Texture>& textures, std::vector<AtlasRegion>& regions) const;
+
+    /**
+     * @brief   Replaces the textures of a mesh buffer by atlas pages
+     *
+     * All materials that refer to a texture are replaced by one material per
+     * page. Face material indices, the "cluster_material_indices" channel and
+     * the texture coordinates of the vertices are rewritten accordingly. Each
+     * vertex has to be used by faces of a single material, as it is the case
+     * for buffers created by the TextureFinalizer.
+     *
+     * @param   buffer      The mesh buffer
+     *
+     * @return  Statistics of the packing
+     */
+    AtlasStatistics apply(MeshBuffer& buffer) const;
+
+    /**
+     * @brief   Computes the statistics of a packing
+     */
+    static AtlasStatistics statistics(const std::vector<Texture>& textures, const std::vector<Texture>& pages);
+
+private:
+
+    /// Maximum width and height of a page
+    unsigned short m_pageSize;
+
+    /// Border around each texture
+    unsigned short m_padding;
+};
+
+} // namespace lvr2
+
+#endif /* LVR2_TEXTURE_TEXTUREATLAS_HPP_ */
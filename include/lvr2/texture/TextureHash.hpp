@@ -0,0 +1,90 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * TextureHash.hpp
+ */
+
+#ifndef LVR2_TEXTURE_TEXTUREHASH_HPP_
+#define LVR2_TEXTURE_TEXTUREHASH_HPP_
+
+#include "lvr2/texture/Texture.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace lvr2
+{
+
+/**
+ * @brief   Perceptual fingerprint of a texture
+ *
+ *          The hash is a 64 bit difference hash (dHash) of the grayscale
+ *          image scaled down to 9 x 8 texels. Textures that look alike
+ *          get hashes with a small hamming distance, even if they differ
+ *          slightly due to sensor noise or sampling. Since the hash ignores
+ *          absolute brightness and color, the mean color is stored as well.
+ */
+struct TextureHash
+{
+    /// Difference hash of the scaled down grayscale image
+    uint64_t hash = 0;
+
+    /// Mean color of the texture
+    std::array<unsigned char, 3> meanColor = {0, 0, 0};
+
+    /// Dimensions of the texture
+    unsigned short width = 0, height = 0;
+};
+
+/**
+ * @brief   Computes the perceptual hash of an 8 bit RGB or grayscale texture
+ */
+TextureHash computeTextureHash(const Texture& texture);
+
+/**
+ * @brief   Number of differing bits in the difference hashes of a and b
+ */
+int hashDistance(const TextureHash& a, const TextureHash& b);
+
+/**
+ * @brief   Checks whether two textures are near duplicates
+ *
+ * @param a             Hash of the first texture
+ * @param b             Hash of the second texture
+ * @param maxDistance   Maximum hamming distance of the difference hashes
+ * @param maxColorDiff  Maximum difference of the mean colors per channel
+ *
+ * @return  True if both textures have the same size, a hash distance
+ *          of at most maxDistance and similar mean colors
+ */
+bool isDuplicate(const TextureHash& a, const TextureHash& b, int maxDistance, int maxColorDiff = 8);
+
+} // namespace lvr2
+
+#endif /* LVR2_TEXTURE_TEXTUREHASH_HPP_ */
@@ -35,6 +35,9 @@
 
 #include "lvr2/algorithm/ChunkBuilder.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace lvr2
 {
 
@@ -115,7 +118,91 @@ MeshBufferPtr ChunkBuilder::buildMesh(
     std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitVertices,
     std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitFaces) const
 {
-    std::unordered_map<unsigned int, unsigned int> vertexIndices;
+    std::vector<unsigned int> vertexIndices;
+    return buildMesh(attributedMesh, splitVertices, splitFaces, vertexIndices);
+}
+
+namespace
+{
+
+/// Source and destination of an attribute channel that is copied element wise
+template <typename T>
+struct ChannelCopy
+{
+    const T* src;
+    T* dst;
+    size_t width;
+};
+
+template <typename T>
+void copyElement(const std::vector<ChannelCopy<T>>& channels, size_t from, size_t to)
+{
+    for (const ChannelCopy<T>& c : channels)
+    {
+        std::copy(c.src + from * c.width, c.src + (from + 1) * c.width, c.dst + to * c.width);
+    }
+}
+
+/// Copies the element from the original mesh to the chunk for all channels
+struct ChannelCopies
+{
+    std::vector<ChannelCopy<unsigned char>> uchars;
+    std::vector<ChannelCopy<unsigned int>> uints;
+    std::vector<ChannelCopy<float>> floats;
+
+    void copy(size_t from, size_t to) const
+    {
+        copyElement(uchars, from, to);
+        copyElement(uints, from, to);
+        copyElement(floats, from, to);
+    }
+};
+
+/**
+ * @brief Adds an empty channel of the given size to the chunk if the channel of the original
+ * mesh holds an element per vertex or per face. Other channels are added unchanged.
+ */
+template <typename T>
+void addChunkChannel(MeshBufferPtr mesh,
+                     const std::string& name,
+                     const Channel<T>& channel,
+                     size_t numOriginalVertices,
+                     size_t numOriginalFaces,
+                     size_t numVertices,
+                     size_t numFaces,
+                     std::vector<ChannelCopy<T>>& vertexChannels,
+                     std::vector<ChannelCopy<T>>& faceChannels)
+{
+    if (channel.numElements() == numOriginalVertices)
+    {
+        mesh->addEmptyChannel<T>(name, numVertices, channel.width());
+        vertexChannels.push_back({channel.dataPtr().get(),
+                                  mesh->getChannel<T>(name)->dataPtr().get(),
+                                  channel.width()});
+    }
+    else if (channel.numElements() == numOriginalFaces)
+    {
+        mesh->addEmptyChannel<T>(name, numFaces, channel.width());
+        faceChannels.push_back({channel.dataPtr().get(),
+                                mesh->getChannel<T>(name)->dataPtr().get(),
+                                channel.width()});
+    }
+    else
+    {
+        // a channel that is not a vertex or a face channel will be added unchanged to each chunk
+        mesh->addChannel<T>(std::make_shared<Channel<T>>(channel), name);
+    }
+}
+
+} // namespace
+
+MeshBufferPtr ChunkBuilder::buildMesh(
+    MeshBufferPtr attributedMesh,
+    std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitVertices,
+    std::shared_ptr<std::unordered_map<unsigned int, unsigned int>> splitFaces,
+    std::vector<unsigned int>& vertexIndices) const
+{
+    const unsigned int invalidIndex = std::numeric_limits<unsigned int>::max();
 
     lvr2::floatArr vertices(new float[numVertices() * 3]);
     lvr2::indexArray faceIndices(new unsigned int[numFaces() * 3]);
@@ -123,255 +210,111 @@ MeshBufferPtr ChunkBuilder::buildMesh(
     // build new model by adding vertices, faces and attribute channels
     lvr2::MeshBufferPtr mesh(new lvr2::MeshBuffer);
 
-    // TODO: add more types if needed; it is more efficient to sort the channel in the channel manager
-    std::vector<std::string> vertexChannelUChar;
-    std::vector<std::string> vertexChannelUInt;
-    std::vector<std::string> vertexChannelFloat;
-    std::vector<std::string> faceChannelUChar;
-    std::vector<std::string> faceChannelUInt;
-    std::vector<std::string> faceChannelFloat;
+    // TODO: add more types if needed
+    ChannelCopies vertexChannels;
+    ChannelCopies faceChannels;
 
+    const size_t numOriginalVertices = attributedMesh->numVertices();
+    const size_t numOriginalFaces = attributedMesh->numFaces();
 
     for (auto elem : *attributedMesh)
     {
-        if(elem.first != "vertices" && elem.first != "face_indices")
+        if (elem.first == "vertices" || elem.first == "face_indices")
         {
-            if(elem.second.is_type<unsigned char>())
-            {
-                if(elem.second.numElements() == attributedMesh->numVertices())
-                {
-                    mesh->addEmptyUCharChannel(elem.first, numVertices(), elem.second.width());
-                    vertexChannelUChar.push_back(elem.first);
-                }
-                else if(elem.second.numElements() == attributedMesh->numFaces())
-                {
-                    mesh->addEmptyUCharChannel(elem.first, numFaces(), elem.second.width());
-                    faceChannelUChar.push_back(elem.first);
-                }
-                else
-                {
-                    // a channel that is not a vertex or a face channel will be added unchanged to each chunk
-                    mesh->addUCharChannel(std::make_shared<
-                            lvr2::Channel<unsigned char>>(attributedMesh->getUCharChannel(elem.first).get()), elem.first);
-                }
-            }
-            else if(elem.second.is_type<unsigned int>())
-            {
-                if(elem.second.numElements() == attributedMesh->numVertices())
-                {
-                    mesh->addEmptyIndexChannel(elem.first, numVertices(), elem.second.width());
-                    vertexChannelUInt.push_back(elem.first);
-                }
-                else if(elem.second.numElements() == attributedMesh->numFaces())
-                {
-                    mesh->addEmptyIndexChannel(elem.first, numFaces(), elem.second.width());
-                    faceChannelUInt.push_back(elem.first);
-                }
-                else
-                {
-                    // a channel that is not a vertex or a face channel will be added unchanged to each chunk
-                    mesh->addIndexChannel(std::make_shared<
-                            lvr2::Channel<unsigned int>>(attributedMesh->getIndexChannel(elem.first).get()), elem.first);
-                }
-            }
-            else if(elem.second.is_type<float>())
-            {
-                if(elem.second.numElements() == attributedMesh->numVertices())
-                {
-                    mesh->addEmptyFloatChannel(elem.first, numVertices(), elem.second.width());
-                    vertexChannelFloat.push_back(elem.first);
-                }
-                else if(elem.second.numElements() == attributedMesh->numFaces())
-                {
-                    mesh->addEmptyFloatChannel(elem.first, numFaces(), elem.second.width());
-                    faceChannelFloat.push_back(elem.first);
-                }
-                else
-                {
-                    // a channel that is not a vertex or a face channel will be added unchanged to each chunk
-                    mesh->addFloatChannel(std::make_shared<
-                            lvr2::Channel<float>>(attributedMesh->getFloatChannel(elem.first).get()), elem.first);
-                }
-            }
-            else
-            {
-
-            }
-
+            continue;
         }
 
+        if (elem.second.is_type<unsigned char>())
+        {
+            addChunkChannel<unsigned char>(mesh, elem.first, elem.second.extract<unsigned char>(),
+                numOriginalVertices, numOriginalFaces, numVertices(), numFaces(),
+                vertexChannels.uchars, faceChannels.uchars);
+        }
+        else if (elem.second.is_type<unsigned int>())
+        {
+            addChunkChannel<unsigned int>(mesh, elem.first, elem.second.extract<unsigned int>(),
+                numOriginalVertices, numOriginalFaces, numVertices(), numFaces(),
+                vertexChannels.uints, faceChannels.uints);
+        }
+        else if (elem.second.is_type<float>())
+        {
+            addChunkChannel<float>(mesh, elem.first, elem.second.extract<float>(),
+                numOriginalVertices, numOriginalFaces, numVertices(), numFaces(),
+                vertexChannels.floats, faceChannels.floats);
+        }
     }
 
+    // The buffer maps vertex indices of the original mesh to chunk indices. It is reused
+    // between chunks and only the entries touched by this chunk are reset at the end.
+    std::vector<unsigned int> usedVertices;
+    usedVertices.reserve(numVertices());
 
-    // fill vertex buffer with duplicate vertices
-    for (VertexHandle vertex : m_duplicateVertices)
-    {
-        if (vertexIndices.find(vertex.idx()) == vertexIndices.end())
+    auto addVertex = [&](const VertexHandle& vertex) {
+        const unsigned int originalIndex = vertex.idx();
+        if (originalIndex >= vertexIndices.size())
         {
-            unsigned int vertexIndex                               = vertexIndices.size();
-            vertexIndices[static_cast<unsigned int>(vertex.idx())] = vertexIndex;
-
-            // apply vertex position
-            for (uint8_t j = 0; j < 3; j++)
-            {
-                vertices[vertexIndex * 3 + j] = m_originalMesh->getVertexPosition(vertex)[j];
-            }
+            vertexIndices.resize(std::max<size_t>(originalIndex + 1, m_originalMesh->nextVertexIndex()),
+                                 invalidIndex);
+        }
 
-            // apply vertex attributes
-            unsigned int attributedVertexIndex = vertex.idx();
-            if (splitVertices->find(attributedVertexIndex) != splitVertices->end())
-            {
-                attributedVertexIndex = splitVertices->at(attributedVertexIndex);
-            }
+        if (vertexIndices[originalIndex] != invalidIndex)
+        {
+            return vertexIndices[originalIndex];
+        }
 
+        unsigned int vertexIndex = usedVertices.size();
+        vertexIndices[originalIndex] = vertexIndex;
+        usedVertices.push_back(originalIndex);
 
-            // vertex channels
-            for(const std::string& name : vertexChannelUChar)
-            {
-                Channel<unsigned char> tmp = mesh->getUCharChannel(name).get();
-                for(size_t component = 0; component < tmp.width(); component++)
-                {
+        // apply vertex position
+        const BaseVector<float> position = m_originalMesh->getVertexPosition(vertex);
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            vertices[vertexIndex * 3 + j] = position[j];
+        }
 
-                    tmp.dataPtr()[vertexIndex * tmp.width() + component]
-                            = attributedMesh->getUCharHandle(attributedVertexIndex, name)[component];
+        // apply vertex attributes
+        unsigned int attributedVertexIndex = originalIndex;
+        auto split = splitVertices->find(attributedVertexIndex);
+        if (split != splitVertices->end())
+        {
+            attributedVertexIndex = split->second;
+        }
+        vertexChannels.copy(attributedVertexIndex, vertexIndex);
 
-//                    // alternative way using Handles instead of dataPtr():
-//                    mesh->getUCharHandle(vertexIndex, name)[component]
-//                            = attributedMesh->getFloatHandle(attributedVertexIndex, name)[component];
-                }
-            }
-            for(const std::string& name : vertexChannelUInt)
-            {
-                Channel<unsigned int> tmp = mesh->getIndexChannel(name).get();
-                for(size_t component = 0; component < tmp.width(); component++)
-                {
-                    tmp.dataPtr()[vertexIndex * tmp.width() + component]
-                            = attributedMesh->getIndexHandle(attributedVertexIndex, name)[component];
-                }
-            }
-            for(const std::string& name : vertexChannelFloat)
-            {
-                Channel<float> tmp = mesh->getFloatChannel(name).get();
+        return vertexIndex;
+    };
 
-                for(size_t component = 0; component < tmp.width(); component++)
-                {
-                    tmp.dataPtr()[vertexIndex * tmp.width() + component]
-                            = attributedMesh->getFloatHandle(attributedVertexIndex, name)[component];
-                }
-            }
-        }
+    // fill vertex buffer with duplicate vertices
+    for (VertexHandle vertex : m_duplicateVertices)
+    {
+        addVertex(vertex);
     }
 
     // fill new vertex and face buffer
     for (unsigned int face = 0; face < m_faces.size(); face++)
     {
+        std::array<VertexHandle, 3> faceVertices = m_originalMesh->getVerticesOfFace(m_faces[face]);
         for (uint8_t faceVertex = 0; faceVertex < 3; faceVertex++)
         {
-            if (vertexIndices.find(
-                    m_originalMesh->getVerticesOfFace(m_faces[face])[faceVertex].idx())
-                == vertexIndices.end())
-            {
-                unsigned int vertexIndex = vertexIndices.size();
-                vertexIndices[static_cast<unsigned int>(
-                    m_originalMesh->getVerticesOfFace(m_faces[face])[faceVertex].idx())]
-                    = vertexIndex;
-
-                // apply vertex position
-                for (uint8_t vertexComponent = 0; vertexComponent < 3; vertexComponent++)
-                {
-                    vertices[vertexIndex * 3 + vertexComponent]
-                        = m_originalMesh->getVertexPosition(m_originalMesh->getVerticesOfFace(
-                            m_faces[face])[faceVertex])[vertexComponent];
-                }
-
-                // apply vertex attributes
-                unsigned int attributedVertexIndex
-                    = m_originalMesh->getVerticesOfFace(m_faces[face])[faceVertex].idx();
-                if (splitVertices->find(attributedVertexIndex) != splitVertices->end())
-                {
-                    attributedVertexIndex = splitVertices->at(attributedVertexIndex);
-                }
-
-                // vertex channels
-                for(const std::string& name : vertexChannelUChar)
-                {
-                    Channel<unsigned char> tmp = mesh->getUCharChannel(name).get();
-                    for(size_t component = 0; component < tmp.width(); component++)
-                    {
-                        tmp.dataPtr()[vertexIndex * tmp.width() + component]
-                                = attributedMesh->getUCharHandle(attributedVertexIndex, name)[component];
-
-//                        // alternative way using Handles instead of dataPtr():
-//                        mesh->getUCharHandle(vertexIndex, name)[component]
-//                              = attributedMesh->getFloatHandle(attributedVertexIndex, name)[component];
-                    }
-                }
-                for(const std::string& name : vertexChannelUInt)
-                {
-                    Channel<unsigned int> tmp = mesh->getIndexChannel(name).get();
-                    for(size_t component = 0; component < tmp.width(); component++)
-                    {
-                        tmp.dataPtr()[vertexIndex * tmp.width() + component]
-                                = attributedMesh->getIndexHandle(attributedVertexIndex, name)[component];
-                    }
-                }
-                for(const std::string& name : vertexChannelFloat)
-                {
-                    Channel<float> tmp = mesh->getFloatChannel(name).get();
-
-                    for(size_t component = 0; component < tmp.width(); component++)
-                    {
-                        mesh->getFloatHandle(vertexIndex, name)[component]
-                                = attributedMesh->getFloatHandle(attributedVertexIndex, name)[component];
-                    }
-                }
-            }
-
             // apply face vertex
-            faceIndices[face * 3 + faceVertex] = vertexIndices[static_cast<unsigned int>(
-                m_originalMesh->getVerticesOfFace(m_faces[face])[faceVertex].idx())];
+            faceIndices[face * 3 + faceVertex] = addVertex(faceVertices[faceVertex]);
         }
 
         // apply face attributes
         unsigned int attributedFaceIndex = m_faces[face].idx();
-        if (splitVertices->find(attributedFaceIndex) != splitVertices->end())
+        auto split = splitFaces->find(attributedFaceIndex);
+        if (split != splitFaces->end())
         {
-            attributedFaceIndex = splitVertices->at(attributedFaceIndex);
+            attributedFaceIndex = split->second;
         }
+        faceChannels.copy(attributedFaceIndex, face);
+    }
 
-        // face channels
-        for(const std::string& name : faceChannelUChar)
-        {
-            Channel<unsigned char> tmp = mesh->getUCharChannel(name).get();
-            for(size_t component = 0; component < tmp.width(); component++)
-            {
-                tmp.dataPtr()[face * tmp.width() + component]
-                        = attributedMesh->getUCharHandle(attributedFaceIndex, name)[component];
-
-//                        // alternative way using Handles instead of dataPtr():
-//                        mesh->getUCharHandle(face, name)[component]
-//                              = attributedMesh->getFloatHandle(attibutedFaceIndex, name)[component];
-            }
-        }
-        for(const std::string& name : faceChannelUInt)
-        {
-            Channel<unsigned int> tmp = mesh->getIndexChannel(name).get();
-            for(size_t component = 0; component < tmp.width(); component++)
-            {
-                tmp.dataPtr()[face * tmp.width() + component]
-                        = attributedMesh->getIndexHandle(attributedFaceIndex, name)[component];
-            }
-        }
-        for(const std::string& name : faceChannelFloat)
-        {
-            Channel<float> tmp = mesh->getFloatChannel(name).get();
-
-            for(size_t component = 0; component < tmp.width(); component++)
-            {
-                mesh->getFloatHandle(face, name)[component]
-                        = attributedMesh->getFloatHandle(attributedFaceIndex, name)[component];
-            }
-        }
+    // reset the entries of the index buffer for the next chunk
+    for (unsigned int originalIndex : usedVertices)
+    {
+        vertexIndices[originalIndex] = invalidIndex;
     }
 
     // add vertices and face_indices to the mesh
@@ -63,8 +63,19 @@ ChunkHashGrid::ChunkHashGrid(std::string hdf5Path,
     setBoundingBox(boundingBox);
 }
 
+ChunkHashGrid::~ChunkHashGrid()
+{
+    if (m_prefetchPool)
+    {
+        // finish the queued prefetch requests, they still access the HDF5 file
+        m_prefetchPool->stop(true);
+    }
+}
+
 bool ChunkHashGrid::isChunkLoaded(std::string layer, std::size_t hashValue)
 {
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
     auto layerIt = m_hashGrid.find(layer);
     if (layerIt != m_hashGrid.end())
     {
@@ -79,13 +90,16 @@ bool ChunkHashGrid::isChunkLoaded(std::string layer, std::size_t hashValue)
 
 bool ChunkHashGrid::isChunkLoaded(std::string layer, int x, int y, int z)
 {
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
     return isChunkLoaded(layer, hashValue(x, y, z));
 }
 
 void ChunkHashGrid::rehashCache(const BaseVector<std::size_t>& oldChunkAmount,
                                 const BaseVector<std::size_t>& oldChunkIndexOffset)
 {
-    std::unordered_map<std::string, std::unordered_map<std::size_t, val_type>> tmpCache;
+    // move all cached chunks to their new hash; the lru list entries are updated in place, so
+    // the positions stored in the cache entries stay valid
+    std::unordered_map<std::string, std::unordered_map<std::size_t, CacheEntry>> newHashGrid;
     for (std::pair<std::string, std::size_t>& elem : m_items)
     {
         // undo old hash function
@@ -93,38 +107,13 @@ void ChunkHashGrid::rehashCache(const BaseVector<std::size_t>& oldChunkAmount,
         int j = (elem.second / oldChunkAmount.z) % oldChunkAmount.y - oldChunkIndexOffset.y;
         int i = elem.second / (oldChunkAmount.y * oldChunkAmount.z) - oldChunkIndexOffset.x;
 
-        val_type chunk;
-
-        auto layerIt = tmpCache.find(elem.first);
-        if (layerIt != tmpCache.end())
-        {
-            auto chunkIt = tmpCache[elem.first].find(elem.second);
-            if (chunkIt != tmpCache[elem.first].end())
-            {
-                chunk = tmpCache[elem.first][elem.second];
-            }
-            else
-            {
-                chunk = m_hashGrid[elem.first][elem.second];
-            }
-        }
-        else
-        {
-            chunk = m_hashGrid[elem.first][elem.second];
-        }
-
         std::size_t newHash = hashValue(i, j, k);
 
-        auto chunkIt = m_hashGrid[elem.first].find(newHash);
-        if (chunkIt != m_hashGrid[elem.first].end())
-        {
-            tmpCache[elem.first][newHash] = m_hashGrid[elem.first][newHash];
-        }
-        m_hashGrid[elem.first][newHash] = chunk;
-        m_hashGrid[elem.first].erase(elem.second);
-
+        newHashGrid[elem.first][newHash] = std::move(m_hashGrid[elem.first][elem.second]);
         elem.second = newHash;
     }
+
+    m_hashGrid = std::move(newHashGrid);
 }
 
 void ChunkHashGrid::expandBoundingBox(const val_type& data)
@@ -144,33 +133,142 @@ void ChunkHashGrid::expandBoundingBox(const val_type& data)
 
 void ChunkHashGrid::loadChunk(std::string layer, int x, int y, int z, const val_type& data)
 {
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
     std::size_t chunkHash = hashValue(x, y, z);
+    size_t bytes          = boost::apply_visitor(ChunkMemoryVisitor(), data);
 
-    if (isChunkLoaded(layer, chunkHash))
+    auto& layerGrid = m_hashGrid[layer];
+    auto chunkIt    = layerGrid.find(chunkHash);
+    if (chunkIt != layerGrid.end())
+    {
+        // chunk exists for layer in grid; replace its content and move it to the front
+        m_cacheMemory -= chunkIt->second.bytes;
+        chunkIt->second.data  = data;
+        chunkIt->second.bytes = bytes;
+        m_items.splice(m_items.begin(), m_items, chunkIt->second.lruPosition);
+    }
+    else
     {
-        // chunk exists for layer in grid
-        // remove chunk from cache to put the chunk to front of lru cache later
-        m_items.remove({layer, chunkHash});
+        // add new chunk to cache
+        m_items.push_front({layer, chunkHash});
+        layerGrid[chunkHash] = {data, m_items.begin(), bytes};
     }
+    m_cacheMemory += bytes;
 
-    // add new chunk to cache
-    m_items.push_front({layer, chunkHash});
+    evictChunks();
+}
 
-    // check if cache is full
-    if (m_items.size() > m_cacheSize)
+ChunkHashGrid::val_type* ChunkHashGrid::touchChunk(const std::string& layer, std::size_t hashValue)
+{
+    auto layerIt = m_hashGrid.find(layer);
+    if (layerIt == m_hashGrid.end())
+    {
+        return nullptr;
+    }
+
+    auto chunkIt = layerIt->second.find(hashValue);
+    if (chunkIt == layerIt->second.end())
+    {
+        return nullptr;
+    }
+
+    m_items.splice(m_items.begin(), m_items, chunkIt->second.lruPosition);
+    return &chunkIt->second.data;
+}
+
+void ChunkHashGrid::evictChunks()
+{
+    // always keep the most recently used chunk, even if it exceeds the memory budget alone
+    while (m_items.size() > 1
+           && (m_items.size() > m_cacheSize
+               || (m_cacheMemoryBudget > 0 && m_cacheMemory > m_cacheMemoryBudget)))
     {
         // remove chunk from grid keep the grid for the current layer even if it holds no elements
-        m_hashGrid[m_items.back().first].erase(m_items.back().second);
+        auto& layerGrid = m_hashGrid[m_items.back().first];
+        auto chunkIt    = layerGrid.find(m_items.back().second);
+        m_cacheMemory -= chunkIt->second.bytes;
+        layerGrid.erase(chunkIt);
 
         // remove erased element from cache
         m_items.pop_back();
+        m_cacheEvictions++;
+    }
+
+    // a cache size of 0 does not keep any chunks
+    if (m_cacheSize == 0 && !m_items.empty())
+    {
+        m_hashGrid[m_items.back().first].erase(m_items.back().second);
+        m_items.pop_back();
+        m_cacheMemory = 0;
+        m_cacheEvictions++;
     }
+}
+
+void ChunkHashGrid::setCacheMemoryBudget(size_t bytes)
+{
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+    m_cacheMemoryBudget = bytes;
+    evictChunks();
+}
+
+ChunkCacheStatistics ChunkHashGrid::getCacheStatistics()
+{
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
 
-    m_hashGrid[layer][chunkHash] = data;
+    ChunkCacheStatistics statistics;
+    statistics.hits       = m_cacheHits;
+    statistics.misses     = m_cacheMisses;
+    statistics.evictions  = m_cacheEvictions;
+    statistics.prefetched = m_prefetched;
+    statistics.numChunks  = m_items.size();
+    statistics.usedMemory = m_cacheMemory;
+    return statistics;
+}
+
+void ChunkHashGrid::resetCacheStatistics()
+{
+    m_cacheHits      = 0;
+    m_cacheMisses    = 0;
+    m_cacheEvictions = 0;
+    m_prefetched     = 0;
+}
+
+void ChunkHashGrid::waitForPrefetch()
+{
+    std::unique_lock<std::mutex> lock(m_prefetchMutex);
+    m_prefetchDone.wait(lock, [this] { return m_pendingPrefetches == 0; });
+}
+
+void ChunkHashGrid::saveLODErrors(const std::string& layer, const std::vector<float>& errors)
+{
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    m_io.saveLODErrors(layer, errors);
+}
+
+std::vector<float> ChunkHashGrid::loadLODErrors(const std::string& layer)
+{
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    return m_io.loadLODErrors(layer);
+}
+
+void ChunkHashGrid::saveFusedScans(const std::string& layer, const std::vector<size_t>& scans)
+{
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    m_io.saveFusedScans(layer, scans);
+}
+
+std::vector<size_t> ChunkHashGrid::loadFusedScans(const std::string& layer)
+{
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    return m_io.loadFusedScans(layer);
 }
 
 void ChunkHashGrid::setBoundingBox(const BoundingBox<BaseVector<float>> boundingBox)
 {
+    std::lock_guard<std::recursive_mutex> ioLock(m_ioMutex);
+    std::lock_guard<std::recursive_mutex> cacheLock(m_cacheMutex);
+
     if (m_boundingBox.getMin() == boundingBox.getMin()
         && m_boundingBox.getMax() == boundingBox.getMax())
     {
@@ -36,11 +36,24 @@
 
 #include "lvr2/algorithm/ChunkManager.hpp"
 
+#include "lvr2/algorithm/ColorAlgorithms.hpp"
+#include "lvr2/algorithm/FinalizeAlgorithms.hpp"
+#include "lvr2/algorithm/NormalAlgorithms.hpp"
+#include "lvr2/algorithm/ReductionAlgorithms.hpp"
+
+#include "lvr2/config/lvropenmp.hpp"
 #include "lvr2/io/ModelFactory.hpp"
+#include "lvr2/io/Timestamp.hpp"
 
 #include <algorithm>
 #include <boost/filesystem.hpp>
 #include <cmath>
+#include <condition_variable>
+#include <ctpl.h>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
 
 namespace
 {
@@ -58,6 +71,223 @@ struct VectorCapsule
     ~VectorCapsule() = default;
     void operator()(void*) {}
 };
+
+/**
+ * @brief Bounded FIFO that hands built chunk meshes from the builder threads to the single
+ *        thread that writes them into the HDF5 file.
+ *
+ * push() blocks while the queue is full, so at most capacity chunks are held in memory
+ * while waiting to be written.
+ */
+template <typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+
+    void push(T&& item)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notFull.wait(lock, [this] { return m_items.size() < m_capacity; });
+        m_items.push_back(std::move(item));
+        m_notEmpty.notify_one();
+    }
+
+    T pop()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_notEmpty.wait(lock, [this] { return !m_items.empty(); });
+        T item = std::move(m_items.front());
+        m_items.pop_front();
+        m_notFull.notify_one();
+        return item;
+    }
+
+  private:
+    size_t m_capacity;
+    std::deque<T> m_items;
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+};
+
+/// A built chunk mesh together with its chunk coordinates and simplified levels of detail
+struct BuiltChunk
+{
+    int x;
+    int y;
+    int z;
+    lvr2::MeshBufferPtr mesh;
+    std::vector<lvr2::MeshBufferPtr> lods;
+    /// set if building the chunk failed, rethrown by the writing thread
+    std::exception_ptr error;
+};
+
+/**
+ * @brief Returns the cost of collapsing the edge between fromH and toH into toH for the chunk
+ *        level of detail generation or boost::none if the edge may not be collapsed.
+ *
+ * Vertices on the border of the chunk are never moved and the valence of the remaining vertex
+ * is limited, so that long sequences of collapses do not create degenerated fans. The cost is
+ * the length of the edge, which results in evenly sized triangles on every level.
+ */
+boost::optional<float> chunkCollapseCost(const lvr2::HalfEdgeMesh<lvr2::BaseVector<float>>& mesh,
+                                         lvr2::VertexHandle fromH,
+                                         lvr2::VertexHandle toH,
+                                         const lvr2::FaceMap<lvr2::Normal<float>>& normals)
+{
+    using namespace lvr2;
+
+    // The minimal value of the dot product between the normals of a face before and after
+    // the collapse.
+    const float MIN_NORMAL_DIFF = 0.5;
+
+    // The maximal valence of the vertex that remains after the collapse.
+    const size_t MAX_VALENCE = 12;
+
+    auto adjacentFaces = mesh.getFacesOfEdge(mesh.getEdgeBetween(fromH, toH).unwrap());
+    if (!adjacentFaces[0] || !adjacentFaces[1])
+    {
+        return boost::none;
+    }
+
+    std::vector<FaceHandle> facesAroundFrom;
+    std::vector<EdgeHandle> edgesAroundFrom;
+    std::vector<EdgeHandle> edgesAroundTo;
+    mesh.getFacesOfVertex(fromH, facesAroundFrom);
+    mesh.getEdgesOfVertex(fromH, edgesAroundFrom);
+    mesh.getEdgesOfVertex(toH, edgesAroundTo);
+
+    // from is on the border if it has more edges than faces
+    if (facesAroundFrom.size() != edgesAroundFrom.size()
+        || edgesAroundFrom.size() + edgesAroundTo.size() - 3 > MAX_VALENCE)
+    {
+        return boost::none;
+    }
+
+    for (auto fH : facesAroundFrom)
+    {
+        auto verts = mesh.getVerticesOfFace(fH);
+        if (verts[0] == toH || verts[1] == toH || verts[2] == toH)
+        {
+            continue;
+        }
+
+        std::array<BaseVector<float>, 3> newVerts;
+        for (size_t i = 0; i < 3; i++)
+        {
+            newVerts[i] = mesh.getVertexPosition(verts[i] == fromH ? toH : verts[i]);
+        }
+
+        auto newNormal = getFaceNormal(newVerts);
+        if (!newNormal || newNormal->dot(normals[fH]) < MIN_NORMAL_DIFF)
+        {
+            return boost::none;
+        }
+    }
+
+    return mesh.getVertexPosition(fromH).distanceFrom(mesh.getVertexPosition(toH));
+}
+
+/**
+ * @brief Simplifies a chunk mesh to numLODs levels of detail.
+ *
+ * Each level is reduced from the previous one to about a quarter of its faces. The edge collapse
+ * never moves vertices on the border of the mesh, so the borders of all levels are identical to
+ * the border of the original chunk. If a level can not be simplified any further, the previous
+ * level is used for the remaining ones.
+ */
+std::vector<lvr2::MeshBufferPtr> buildChunkLODs(lvr2::MeshBufferPtr chunk, size_t numLODs)
+{
+    using namespace lvr2;
+    using Vec = BaseVector<float>;
+
+    std::vector<MeshBufferPtr> lods(numLODs, chunk);
+    if (numLODs == 0)
+    {
+        return lods;
+    }
+
+    size_t level = 1;
+    try
+    {
+        HalfEdgeMesh<Vec> mesh(chunk);
+        DenseFaceMap<Normal<float>> faceNormals = calcFaceNormals(mesh);
+
+        // vertex handles stay valid during the reduction, so the colors can be looked up by
+        // the index of the original vertex
+        size_t colorWidth = 0;
+        ucharArr colors = chunk->getVertexColors(colorWidth);
+        DenseVertexMap<Rgb8Color> vertexColors;
+        if (colors && colorWidth >= 3)
+        {
+            vertexColors.reserve(chunk->numVertices());
+            for (size_t i = 0; i < chunk->numVertices(); i++)
+            {
+                const unsigned char* c = &colors[colorWidth * i];
+                vertexColors.insert(VertexHandle(i), {c[0], c[1], c[2]});
+            }
+        }
+
+        auto cost = [&mesh](VertexHandle fromH,
+                            VertexHandle toH,
+                            const FaceMap<Normal<float>>& normals) {
+            return chunkCollapseCost(mesh, fromH, toH, normals);
+        };
+
+        for (; level <= numLODs; level++)
+        {
+            // every collapse of an inner edge removes two faces
+            size_t targetFaces = chunk->numFaces() >> (2 * level);
+            if (mesh.numFaces() > targetFaces)
+            {
+                iterativeEdgeCollapse(
+                    mesh, (mesh.numFaces() - targetFaces) / 2, faceNormals, cost, false);
+            }
+
+            DenseVertexMap<Normal<float>> vertexNormals = calcVertexNormals(mesh, faceNormals);
+
+            SimpleFinalizer<Vec> finalizer;
+            finalizer.setNormalData(vertexNormals);
+            if (vertexColors.numValues() > 0)
+            {
+                finalizer.setColorData(vertexColors);
+            }
+            lods[level - 1] = finalizer.apply(mesh);
+        }
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << lvr2::timestamp << "ChunkManager: Unable to simplify chunk to level "
+                  << level << ": " << e.what() << std::endl;
+        for (; level <= numLODs; level++)
+        {
+            lods[level - 1] = level > 1 ? lods[level - 2] : chunk;
+        }
+    }
+
+    return lods;
+}
+
+/// Adds the edge lengths of all faces of the mesh to sum and count
+void accumulateEdgeLengths(const lvr2::MeshBufferPtr& mesh, double& sum, size_t& count)
+{
+    lvr2::floatArr vertices = mesh->getVertices();
+    lvr2::indexArray faces = mesh->getFaceIndices();
+    for (size_t i = 0; i < mesh->numFaces(); i++)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            const float* a = &vertices[3 * faces[3 * i + j]];
+            const float* b = &vertices[3 * faces[3 * i + (j + 1) % 3]];
+            float dx = a[0] - b[0];
+            float dy = a[1] - b[1];
+            float dz = a[2] - b[2];
+            sum += std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+        count += 3;
+    }
+}
 } // namespace
 
 namespace lvr2
@@ -68,13 +298,15 @@ ChunkManager::ChunkManager(MeshBufferPtr mesh,
                            float maxChunkOverlap,
                            std::string savePath,
                            std::string layer,
-                           size_t cacheSize)
+                           size_t cacheSize,
+                           size_t numLODs)
     : ChunkManager(std::vector<MeshBufferPtr>{mesh},
                    chunksize,
                    maxChunkOverlap,
                    savePath,
                    std::vector<std::string>{layer},
-                   cacheSize)
+                   cacheSize,
+                   numLODs)
 {
 }
 ChunkManager::ChunkManager(std::vector<MeshBufferPtr> meshes,
@@ -82,7 +314,8 @@ ChunkManager::ChunkManager(std::vector<MeshBufferPtr> meshes,
                            float maxChunkOverlap,
                            std::string savePath,
                            std::vector<std::string> layers,
-                           size_t cacheSize)
+                           size_t cacheSize,
+                           size_t numLODs)
     : ChunkHashGrid(savePath + "/chunk_mesh.h5", cacheSize)
 {
     setChunkSize(chunksize);
@@ -103,7 +336,7 @@ ChunkManager::ChunkManager(std::vector<MeshBufferPtr> meshes,
 
     for (size_t i = 0; i < meshes.size(); ++i)
     {
-        buildChunks(meshes[i], maxChunkOverlap, savePath, layers[i]);
+        buildChunks(meshes[i], maxChunkOverlap, savePath, layers[i], numLODs);
     }
 }
 
@@ -652,7 +885,8 @@ void ChunkManager::cutLargeFaces(
 void ChunkManager::buildChunks(MeshBufferPtr mesh,
                                float maxChunkOverlap,
                                std::string savePath,
-                               std::string layer)
+                               std::string layer,
+                               size_t numLODs)
 {
     std::vector<ChunkBuilderPtr> chunkBuilders(getChunkAmount().x * getChunkAmount().y
                                                * getChunkAmount().z);
@@ -700,36 +934,267 @@ void ChunkManager::buildChunks(MeshBufferPtr mesh,
         ++iterator;
     }
 
-    // save the chunks as .ply
+    // collect the chunks that contain faces
+    std::vector<BaseVector<int>> chunkIndices;
     for (int i = getChunkMinChunkIndex().x; i < getChunkMaxChunkIndex().x; i++)
     {
         for (int j = getChunkMinChunkIndex().y; j < getChunkMaxChunkIndex().y; j++)
         {
             for (int k = getChunkMinChunkIndex().z; k < getChunkMaxChunkIndex().z; k++)
             {
-                std::size_t hash = hashValue(i, j, k);
-
-                if (chunkBuilders[hash]->numFaces() > 0)
+                if (chunkBuilders[hashValue(i, j, k)]->numFaces() > 0)
                 {
-                    // std::cout << "writing " << i << " " << j << " " << k << std::endl;
+                    chunkIndices.push_back(BaseVector<int>(i, j, k));
+                }
+                else
+                {
+                    chunkBuilders[hashValue(i, j, k)] = nullptr;
+                }
+            }
+        }
+    }
+
+    const int numThreads = std::min<int>(OpenMPConfig::getNumThreads(), chunkIndices.size());
+
+    // index buffers used by the chunk builders, one for each thread
+    std::vector<std::vector<unsigned int>> vertexIndexBuffers(std::max(numThreads, 1));
+
+    // sum and number of the edge lengths per level of detail, used as their geometric error
+    std::vector<double> edgeLengthSums(numLODs + 1, 0.0);
+    std::vector<size_t> edgeCounts(numLODs + 1, 0);
+    auto writeChunk = [&](const BuiltChunk& chunk) {
+        // write chunk in hdf5
+        setChunk<MeshBufferPtr>(layer, chunk.x, chunk.y, chunk.z, chunk.mesh);
+        accumulateEdgeLengths(chunk.mesh, edgeLengthSums[0], edgeCounts[0]);
+
+        for (size_t level = 1; level <= chunk.lods.size(); level++)
+        {
+            setChunk<MeshBufferPtr>(
+                getLODLayer(layer, level), chunk.x, chunk.y, chunk.z, chunk.lods[level - 1]);
+            accumulateEdgeLengths(chunk.lods[level - 1], edgeLengthSums[level], edgeCounts[level]);
+        }
+    };
+    auto writeLODErrors = [&]() {
+        if (numLODs == 0)
+        {
+            return;
+        }
+
+        std::vector<float> errors(numLODs + 1, 0.0f);
+        for (size_t level = 0; level <= numLODs; level++)
+        {
+            if (edgeCounts[level] > 0)
+            {
+                errors[level] = edgeLengthSums[level] / edgeCounts[level];
+            }
+        }
+        saveLODErrors(layer, errors);
+
+        std::lock_guard<std::mutex> lock(m_lodErrorsMutex);
+        m_lodErrors[layer] = errors;
+    };
+
+    if (numThreads <= 1)
+    {
+        for (const BaseVector<int>& index : chunkIndices)
+        {
+            std::size_t hash = hashValue(index.x, index.y, index.z);
+
+            // get mesh of chunk from chunk builder
+            MeshBufferPtr chunkMeshPtr = chunkBuilders[hash]->buildMesh(
+                mesh, splitVertices, splitFaces, vertexIndexBuffers[0]);
+
+            // export chunked meshes for debugging
+            // ModelFactory::saveModel(ModelPtr(new Model(chunkMeshPtr)),
+            //                        savePath + "/" + std::to_string(i) + "-"
+            //                            + std::to_string(j) + "-" + std::to_string(k)
+            //                            + ".ply");
+            writeChunk({index.x,
+                        index.y,
+                        index.z,
+                        chunkMeshPtr,
+                        buildChunkLODs(chunkMeshPtr, numLODs)});
+
+            chunkBuilders[hash] = nullptr; // deallocate
+        }
+        writeLODErrors();
+        return;
+    }
+
+    // Build the chunk meshes in parallel. HDF5 is not thread safe, so the chunks are handed to
+    // this thread through a bounded queue and written one after another while the pool keeps
+    // building the next chunks.
+    BoundedQueue<BuiltChunk> builtChunks(2 * numThreads);
+    ctpl::thread_pool pool(numThreads);
 
-                    // get mesh of chunk from chunk builder
-                    MeshBufferPtr chunkMeshPtr
-                        = chunkBuilders[hash]->buildMesh(mesh, splitVertices, splitFaces);
+    for (const BaseVector<int>& index : chunkIndices)
+    {
+        pool.push([&, index](int threadId) {
+            std::size_t hash = hashValue(index.x, index.y, index.z);
+
+            BuiltChunk chunk{index.x, index.y, index.z, nullptr, {}, nullptr};
+            try
+            {
+                chunk.mesh = chunkBuilders[hash]->buildMesh(
+                    mesh, splitVertices, splitFaces, vertexIndexBuffers[threadId]);
+                chunk.lods = buildChunkLODs(chunk.mesh, numLODs);
+            }
+            catch (...)
+            {
+                chunk.error = std::current_exception();
+            }
 
-                    // export chunked meshes for debugging
-                    // ModelFactory::saveModel(ModelPtr(new Model(chunkMeshPtr)),
-                    //                        savePath + "/" + std::to_string(i) + "-"
-                    //                            + std::to_string(j) + "-" + std::to_string(k)
-                    //                            + ".ply");
-                    // write chunk in hdf5
-                    setChunk<MeshBufferPtr>(layer, i, j, k, chunkMeshPtr);
+            chunkBuilders[hash] = nullptr; // deallocate
+            builtChunks.push(std::move(chunk));
+        });
+    }
 
-                    chunkBuilders[hash] = nullptr; // deallocate
+    // Every task pushes exactly one chunk, so all of them have to be popped even after a failure,
+    // otherwise the tasks block on the full queue. The first error is rethrown once the pool is
+    // idle, as the serial build would have thrown it.
+    std::exception_ptr error;
+    for (size_t n = 0; n < chunkIndices.size(); n++)
+    {
+        BuiltChunk chunk = builtChunks.pop();
+        if (!chunk.error && !error)
+        {
+            try
+            {
+                writeChunk(chunk);
+            }
+            catch (...)
+            {
+                chunk.error = std::current_exception();
+            }
+        }
+        if (chunk.error)
+        {
+            std::cerr << timestamp << "ChunkManager: Unable to build chunk " << chunk.x << " "
+                      << chunk.y << " " << chunk.z << std::endl;
+            if (!error)
+            {
+                error = chunk.error;
+            }
+        }
+    }
+
+    pool.stop(true);
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+    writeLODErrors();
+}
+
+std::string ChunkManager::getLODLayer(const std::string& layer, size_t level)
+{
+    return level == 0 ? layer : layer + "_lod" + std::to_string(level);
+}
+
+std::vector<float> ChunkManager::getLODErrors(const std::string& layer)
+{
+    std::lock_guard<std::mutex> lock(m_lodErrorsMutex);
+    auto it = m_lodErrors.find(layer);
+    if (it == m_lodErrors.end())
+    {
+        it = m_lodErrors.emplace(layer, loadLODErrors(layer)).first;
+    }
+    return it->second;
+}
+
+size_t ChunkManager::getNumLODs(std::string layer)
+{
+    return std::max<size_t>(getLODErrors(layer).size(), 1);
+}
+
+std::vector<ChunkManager::ChunkLOD>
+ChunkManager::selectLODs(const BoundingBox<BaseVector<float>>& area,
+                         const BaseVector<float>& camera,
+                         float projectionFactor,
+                         float maxError,
+                         std::string layer)
+{
+    std::vector<float> errors = getLODErrors(layer);
+
+    BaseVector<int> minIndex = getCellCoordinates(area.getMin());
+    BaseVector<int> maxIndex = getCellCoordinates(area.getMax());
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        minIndex[i] = std::max(minIndex[i], getChunkMinChunkIndex()[i]);
+        maxIndex[i] = std::min(maxIndex[i], getChunkMaxChunkIndex()[i] - 1);
+    }
+
+    // selected levels together with the distance of their chunk to the camera
+    std::vector<std::pair<float, ChunkLOD>> selected;
+    for (int x = minIndex.x; x <= maxIndex.x; x++)
+    {
+        for (int y = minIndex.y; y <= maxIndex.y; y++)
+        {
+            for (int z = minIndex.z; z <= maxIndex.z; z++)
+            {
+                // distance between the camera and the bounding box of the chunk
+                BaseVector<int> index(x, y, z);
+                float squaredDistance = 0.0f;
+                for (unsigned int i = 0; i < 3; i++)
+                {
+                    float min = index[i] * getChunkSize();
+                    float max = min + getChunkSize();
+                    float d   = std::max({min - camera[i], 0.0f, camera[i] - max});
+                    squaredDistance += d * d;
+                }
+                float distance = std::sqrt(squaredDistance);
+
+                auto projectedError = [&](size_t level) {
+                    return distance > 0.0f ? errors[level] * projectionFactor / distance
+                                           : std::numeric_limits<float>::infinity();
+                };
+
+                // select the coarsest level whose projected error is small enough, the camera
+                // is inside of the chunk if the distance is 0
+                ChunkLOD lod{index, 0, layer, errors.empty() ? 0.0f : projectedError(0)};
+                for (size_t level = errors.size(); level-- > 1;)
+                {
+                    float error = projectedError(level);
+                    if (error <= maxError)
+                    {
+                        lod.level = level;
+                        lod.layer = getLODLayer(layer, level);
+                        lod.error = error;
+                        break;
+                    }
                 }
+
+                selected.emplace_back(distance, lod);
             }
         }
     }
+
+    // near chunks first
+    std::stable_sort(selected.begin(),
+                     selected.end(),
+                     [](const std::pair<float, ChunkLOD>& a, const std::pair<float, ChunkLOD>& b) {
+                         return a.first < b.first;
+                     });
+
+    std::vector<ChunkLOD> lods;
+    lods.reserve(selected.size());
+    for (const auto& entry : selected)
+    {
+        lods.push_back(entry.second);
+    }
+    return lods;
+}
+
+void ChunkManager::prefetchLODs(const std::vector<ChunkLOD>& lods)
+{
+    for (const ChunkLOD& lod : lods)
+    {
+        // use the center of the chunk, so that no neighbouring chunk is loaded
+        BaseVector<float> center((lod.index.x + 0.5f) * getChunkSize(),
+                                 (lod.index.y + 0.5f) * getChunkSize(),
+                                 (lod.index.z + 0.5f) * getChunkSize());
+        prefetch<MeshBufferPtr>(lod.layer, BoundingBox<BaseVector<float>>(center, center));
+    }
 }
 
 BaseVector<float> ChunkManager::getFaceCenter(std::shared_ptr<HalfEdgeMesh<BaseVector<float>>> mesh,
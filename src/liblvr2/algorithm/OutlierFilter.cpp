@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * OutlierFilter.cpp
+ */
+
+#include "lvr2/algorithm/OutlierFilter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lvr2
+{
+
+namespace
+{
+
+template<typename T>
+void compactChannelsOfType(PointBufferPtr& buffer, const std::vector<unsigned char>& keep, size_t numKept)
+{
+    size_t n = keep.size();
+
+    std::vector<std::pair<std::string, Channel<T>>> channels;
+    buffer->getAllChannelsOfType(channels);
+    for(auto& channel : channels)
+    {
+        Channel<T>& ch = channel.second;
+
+        // only channels with one element per point
+        if(ch.numElements() != n)
+        {
+            continue;
+        }
+
+        size_t w = ch.width();
+        T* data = ch.dataPtr().get();
+        size_t next = 0;
+        for(size_t i = 0; i < n; i++)
+        {
+            if(keep[i])
+            {
+                if(next != i)
+                {
+                    std::copy(data + i * w, data + (i + 1) * w, data + next * w);
+                }
+                next++;
+            }
+        }
+
+        (*buffer)[channel.first] = Channel<T>(numKept, w, ch.dataPtr());
+    }
+}
+
+} // anonymous namespace
+
+size_t statisticalOutlierFilter(
+    const KNearestNeighbors& neighbors,
+    size_t k,
+    float stdDevMult,
+    std::vector<unsigned char>& keep)
+{
+    size_t n = neighbors.numPoints();
+    keep.assign(n, 1);
+    if(n == 0)
+    {
+        return 0;
+    }
+
+    // mean distance of every point to its neighbors, skipping the point itself
+    std::vector<float> meanDistances(n);
+    double sum = 0.0;
+    double sqSum = 0.0;
+
+    #pragma omp parallel for schedule(static) reduction(+:sum, sqSum)
+    for(long i = 0; i < (long)n; i++)
+    {
+        const size_t* id = neighbors.neighbors(i);
+        const float* di = neighbors.neighborDistances(i);
+
+        float distSum = 0.0f;
+        size_t used = 0;
+        for(unsigned int j = 0; j < neighbors.counts[i] && used < k; j++)
+        {
+            if(id[j] != (size_t)i)
+            {
+                distSum += di[j];
+                used++;
+            }
+        }
+
+        meanDistances[i] = used > 0 ? distSum / used : 0.0f;
+        sum += meanDistances[i];
+        sqSum += (double)meanDistances[i] * meanDistances[i];
+    }
+
+    double mean = sum / n;
+    double variance = n > 1 ? (sqSum - sum * sum / n) / (n - 1) : 0.0;
+    double threshold = mean + stdDevMult * std::sqrt(std::max(variance, 0.0));
+
+    size_t outliers = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:outliers)
+    for(long i = 0; i < (long)n; i++)
+    {
+        if(meanDistances[i] > threshold)
+        {
+            keep[i] = 0;
+            outliers++;
+        }
+    }
+
+    return outliers;
+}
+
+size_t radiusOutlierFilter(
+    const KNearestNeighbors& neighbors,
+    float radius,
+    size_t minNeighbors,
+    std::vector<unsigned char>& keep)
+{
+    size_t n = neighbors.numPoints();
+    keep.resize(n, 1);
+
+    size_t outliers = 0;
+
+    #pragma omp parallel for schedule(static) reduction(+:outliers)
+    for(long i = 0; i < (long)n; i++)
+    {
+        if(!keep[i])
+        {
+            continue;
+        }
+
+        // count the other points within the radius. The neighbors are sorted,
+        // so the search can stop at the first one outside.
+        const size_t* id = neighbors.neighbors(i);
+        const float* di = neighbors.neighborDistances(i);
+        size_t inside = 0;
+        for(unsigned int j = 0; j < neighbors.counts[i] && di[j] <= radius && inside < minNeighbors; j++)
+        {
+            if(id[j] != (size_t)i)
+            {
+                inside++;
+            }
+        }
+
+        if(inside < minNeighbors)
+        {
+            keep[i] = 0;
+            outliers++;
+        }
+    }
+
+    return outliers;
+}
+
+size_t compactPointBuffer(PointBufferPtr buffer, const std::vector<unsigned char>& keep)
+{
+    size_t numKept = std::count_if(keep.begin(), keep.end(), [](unsigned char k) { return k != 0; });
+    if(numKept == keep.size())
+    {
+        return numKept;
+    }
+
+    compactChannelsOfType<char>(buffer, keep, numKept);
+    compactChannelsOfType<unsigned char>(buffer, keep, numKept);
+    compactChannelsOfType<short>(buffer, keep, numKept);
+    compactChannelsOfType<unsigned short>(buffer, keep, numKept);
+    compactChannelsOfType<int>(buffer, keep, numKept);
+    compactChannelsOfType<unsigned int>(buffer, keep, numKept);
+    compactChannelsOfType<float>(buffer, keep, numKept);
+    compactChannelsOfType<double>(buffer, keep, numKept);
+
+    return numKept;
+}
+
+} // namespace lvr2
@@ -0,0 +1,773 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * PointLODHierarchy.cpp
+ */
+
+#include "lvr2/algorithm/PointLODHierarchy.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+namespace lvr2
+{
+
+namespace
+{
+
+const char LOD_MAGIC[8] = {'L', 'V', 'R', 'L', 'O', 'D', '0', '1'};
+
+bool readPoints(const std::string& file, std::vector<PointLODPoint>& points)
+{
+    std::ifstream in(file, std::ios::binary | std::ios::ate);
+    if(!in.good())
+    {
+        return false;
+    }
+    size_t bytes = in.tellg();
+    points.resize(bytes / sizeof(PointLODPoint));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(points.data()), points.size() * sizeof(PointLODPoint));
+    return in.good();
+}
+
+bool writePointFile(const std::string& file, const std::vector<PointLODPoint>& points, bool append)
+{
+    std::ofstream out(file, std::ios::binary | (append ? std::ios::app : std::ios::trunc));
+    out.write(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(PointLODPoint));
+    return out.good();
+}
+
+/// Index of the child of a node that contains the point
+inline int octant(const PointLODPoint& p, const float center[3])
+{
+    return (p.x >= center[0] ? 1 : 0) | (p.y >= center[1] ? 2 : 0) | (p.z >= center[2] ? 4 : 0);
+}
+
+} // namespace
+
+PointLODBuilder::PointLODBuilder(
+    const std::string& directory,
+    const BoundingBox<BaseVector<float>>& bounds)
+    : PointLODBuilder(directory, bounds, Options())
+{
+}
+
+PointLODBuilder::PointLODBuilder(
+    const std::string& directory,
+    const BoundingBox<BaseVector<float>>& bounds,
+    const Options& options)
+    : m_directory(directory),
+      m_options(options),
+      m_numPoints(0),
+      m_hasColors(false),
+      m_dataSize(0)
+{
+    m_options.chunkLevel = std::max(0, std::min(m_options.chunkLevel, 8));
+    m_options.gridSize = std::max(1, m_options.gridSize);
+    m_options.maxPointsPerNode = std::max<size_t>(1, m_options.maxPointsPerNode);
+
+    // The hierarchy is a cube around the bounding box
+    BaseVector<float> min = bounds.getMin();
+    m_min[0] = min.x;
+    m_min[1] = min.y;
+    m_min[2] = min.z;
+    m_size = std::max({bounds.getXSize(), bounds.getYSize(), bounds.getZSize()});
+    m_size = std::max(m_size * 1.0001f, std::numeric_limits<float>::min());
+    m_rootSpacing = m_size / m_options.gridSize;
+
+    size_t dims = (size_t)1 << m_options.chunkLevel;
+    m_chunkSizes.resize(dims * dims * dims, 0);
+
+    boost::filesystem::create_directories(m_directory);
+}
+
+PointLODBuilder::~PointLODBuilder()
+{
+    // Remove temporary files of an unfinished build
+    for(size_t cell = 0; cell < m_chunkSizes.size(); cell++)
+    {
+        if(m_chunkSizes[cell] > 0)
+        {
+            boost::filesystem::remove(chunkFile(cell));
+        }
+    }
+}
+
+std::string PointLODBuilder::chunkFile(size_t cell) const
+{
+    return m_directory + "/chunk_" + std::to_string(cell) + ".tmp";
+}
+
+std::string PointLODBuilder::levelFile(int level, size_t cell) const
+{
+    return m_directory + "/level_" + std::to_string(level) + "_" + std::to_string(cell) + ".tmp";
+}
+
+void PointLODBuilder::addPoints(const PointBufferPtr& buffer)
+{
+    FloatChannelOptional points = buffer->getFloatChannel("points");
+    if(!points)
+    {
+        return;
+    }
+
+    UCharChannelOptional colors = buffer->getUCharChannel("colors");
+    addPoints(
+        points->dataPtr().get(),
+        colors ? colors->dataPtr().get() : nullptr,
+        points->numElements(),
+        colors ? colors->width() : 0);
+}
+
+void PointLODBuilder::addPoints(const float* points, const unsigned char* colors, size_t n, size_t colorWidth)
+{
+    size_t start = m_buffer.size();
+    m_buffer.resize(start + n);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < n; i++)
+    {
+        PointLODPoint& p = m_buffer[start + i];
+        p.x = points[3 * i];
+        p.y = points[3 * i + 1];
+        p.z = points[3 * i + 2];
+        p.rgba[0] = p.rgba[1] = p.rgba[2] = p.rgba[3] = 255;
+        if(colors)
+        {
+            for(size_t c = 0; c < std::min<size_t>(colorWidth, 4); c++)
+            {
+                p.rgba[c] = colors[colorWidth * i + c];
+            }
+        }
+    }
+
+    m_numPoints += n;
+    m_hasColors |= colors != nullptr && colorWidth >= 3;
+
+    if(m_buffer.size() >= m_options.flushSize)
+    {
+        flush();
+    }
+}
+
+void PointLODBuilder::flush()
+{
+    size_t n = m_buffer.size();
+    if(n == 0)
+    {
+        return;
+    }
+
+    size_t dims = (size_t)1 << m_options.chunkLevel;
+    float cellSize = m_size / dims;
+
+    // Counting sort of the buffered points by chunk
+    std::vector<uint32_t> cells(n);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t i = 0; i < n; i++)
+    {
+        const PointLODPoint& p = m_buffer[i];
+        long x = std::min<long>(std::max<long>((long)((p.x - m_min[0]) / cellSize), 0), dims - 1);
+        long y = std::min<long>(std::max<long>((long)((p.y - m_min[1]) / cellSize), 0), dims - 1);
+        long z = std::min<long>(std::max<long>((long)((p.z - m_min[2]) / cellSize), 0), dims - 1);
+        cells[i] = x + dims * (y + dims * z);
+    }
+
+    std::vector<size_t> offsets(m_chunkSizes.size() + 1, 0);
+    for(size_t i = 0; i < n; i++)
+    {
+        offsets[cells[i] + 1]++;
+    }
+    for(size_t c = 0; c < m_chunkSizes.size(); c++)
+    {
+        offsets[c + 1] += offsets[c];
+    }
+
+    std::vector<PointLODPoint> sorted(n);
+    std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+    for(size_t i = 0; i < n; i++)
+    {
+        sorted[pos[cells[i]]++] = m_buffer[i];
+    }
+    m_buffer = std::vector<PointLODPoint>();
+
+    // Every chunk has its own file, so the chunks can be appended in parallel
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t c = 0; c < m_chunkSizes.size(); c++)
+    {
+        size_t count = offsets[c + 1] - offsets[c];
+        if(count > 0)
+        {
+            std::ofstream out(chunkFile(c), std::ios::binary | std::ios::app);
+            out.write(reinterpret_cast<const char*>(sorted.data() + offsets[c]), count * sizeof(PointLODPoint));
+            m_chunkSizes[c] += count;
+        }
+    }
+}
+
+int64_t PointLODBuilder::buildSubtree(
+    std::vector<PointLODPoint>& points,
+    const float min[3],
+    float size,
+    uint32_t depth,
+    std::vector<BuildNode>& nodes) const
+{
+    int64_t id = nodes.size();
+    nodes.emplace_back();
+    BuildNode& node = nodes.back();
+    std::copy(min, min + 3, node.min);
+    node.size = size;
+    node.depth = depth;
+    std::fill(node.children, node.children + 8, -1);
+
+    if(points.size() <= m_options.maxPointsPerNode || (int)depth >= m_options.maxDepth)
+    {
+        node.points.swap(points);
+        return id;
+    }
+
+    float half = size / 2;
+    float center[3] = {min[0] + half, min[1] + half, min[2] + half};
+
+    std::vector<PointLODPoint> childPoints[8];
+    for(const PointLODPoint& p : points)
+    {
+        childPoints[octant(p, center)].push_back(p);
+    }
+    points = std::vector<PointLODPoint>();
+
+    for(int c = 0; c < 8; c++)
+    {
+        if(childPoints[c].empty())
+        {
+            continue;
+        }
+        float childMin[3] = {
+            c & 1 ? center[0] : min[0],
+            c & 2 ? center[1] : min[1],
+            c & 4 ? center[2] : min[2]
+        };
+        // nodes may be reallocated, so the child index is stored after the call
+        int64_t child = buildSubtree(childPoints[c], childMin, half, depth + 1, nodes);
+        nodes[id].children[c] = child;
+    }
+
+    std::vector<BuildNode*> children;
+    for(int c = 0; c < 8; c++)
+    {
+        if(nodes[id].children[c] >= 0)
+        {
+            children.push_back(&nodes[nodes[id].children[c]]);
+        }
+    }
+    subsample(nodes[id], children);
+
+    return id;
+}
+
+void PointLODBuilder::subsample(BuildNode& parent, std::vector<BuildNode*>& children) const
+{
+    size_t g = m_options.gridSize;
+    float cellSize = parent.size / g;
+    std::vector<bool> occupied(g * g * g, false);
+
+    for(BuildNode* child : children)
+    {
+        size_t kept = 0;
+        for(const PointLODPoint& p : child->points)
+        {
+            size_t x = std::min<long>(std::max<long>((long)((p.x - parent.min[0]) / cellSize), 0), g - 1);
+            size_t y = std::min<long>(std::max<long>((long)((p.y - parent.min[1]) / cellSize), 0), g - 1);
+            size_t z = std::min<long>(std::max<long>((long)((p.z - parent.min[2]) / cellSize), 0), g - 1);
+            size_t key = x + g * (y + g * z);
+            if(!occupied[key])
+            {
+                occupied[key] = true;
+                parent.points.push_back(p);
+            }
+            else
+            {
+                child->points[kept++] = p;
+            }
+        }
+        child->points.resize(kept);
+    }
+}
+
+uint64_t PointLODBuilder::writePoints(const std::vector<PointLODPoint>& points)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t offset = m_dataSize;
+    m_data.write(reinterpret_cast<const char*>(points.data()), points.size() * sizeof(PointLODPoint));
+    m_dataSize += points.size();
+    return offset;
+}
+
+PointLODNode PointLODBuilder::toNode(const BuildNode& node) const
+{
+    PointLODNode n;
+    std::copy(node.min, node.min + 3, n.min);
+    n.size = node.size;
+    n.spacing = node.size / m_options.gridSize;
+    n.depth = node.depth;
+    n.offset = 0;
+    n.numPoints = node.points.size();
+    std::copy(node.children, node.children + 8, n.children);
+    return n;
+}
+
+void PointLODBuilder::buildChunk(size_t cell, std::vector<int64_t>& chunkRoots)
+{
+    std::vector<PointLODPoint> points;
+    readPoints(chunkFile(cell), points);
+    boost::filesystem::remove(chunkFile(cell));
+
+    size_t dims = (size_t)1 << m_options.chunkLevel;
+    float size = m_size / dims;
+    float min[3] = {
+        m_min[0] + size * (cell % dims),
+        m_min[1] + size * ((cell / dims) % dims),
+        m_min[2] + size * (cell / (dims * dims))
+    };
+
+    std::vector<BuildNode> nodes;
+    buildSubtree(points, min, size, m_options.chunkLevel, nodes);
+
+    // The root is written by the parent level, all other nodes are final
+    std::vector<uint64_t> offsets(nodes.size(), 0);
+    for(size_t i = 1; i < nodes.size(); i++)
+    {
+        offsets[i] = writePoints(nodes[i].points);
+    }
+    writePointFile(levelFile(m_options.chunkLevel, cell), nodes[0].points, false);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int64_t base = m_nodes.size();
+    for(size_t i = 0; i < nodes.size(); i++)
+    {
+        PointLODNode node = toNode(nodes[i]);
+        node.offset = offsets[i];
+        for(int c = 0; c < 8; c++)
+        {
+            if(node.children[c] >= 0)
+            {
+                node.children[c] += base;
+            }
+        }
+        m_nodes.push_back(node);
+    }
+    chunkRoots[cell] = base;
+}
+
+int64_t PointLODBuilder::buildUpperLevels(std::vector<int64_t>& chunkRoots)
+{
+    std::vector<int64_t> current = chunkRoots;
+
+    for(int level = m_options.chunkLevel - 1; level >= 0; level--)
+    {
+        size_t dims = (size_t)1 << level;
+        size_t childDims = 2 * dims;
+        float size = m_size / dims;
+        std::vector<int64_t> parents(dims * dims * dims, -1);
+
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(size_t cell = 0; cell < parents.size(); cell++)
+        {
+            size_t x = cell % dims;
+            size_t y = (cell / dims) % dims;
+            size_t z = cell / (dims * dims);
+
+            BuildNode parent;
+            parent.min[0] = m_min[0] + size * x;
+            parent.min[1] = m_min[1] + size * y;
+            parent.min[2] = m_min[2] + size * z;
+            parent.size = size;
+            parent.depth = level;
+            std::fill(parent.children, parent.children + 8, -1);
+
+            BuildNode children[8];
+            std::vector<BuildNode*> childPtrs;
+            for(int c = 0; c < 8; c++)
+            {
+                size_t childCell = (2 * x + (c & 1 ? 1 : 0))
+                                 + childDims * ((2 * y + (c & 2 ? 1 : 0))
+                                 + childDims * (2 * z + (c & 4 ? 1 : 0)));
+                if(current[childCell] < 0)
+                {
+                    continue;
+                }
+                parent.children[c] = current[childCell];
+                readPoints(levelFile(level + 1, childCell), children[c].points);
+                boost::filesystem::remove(levelFile(level + 1, childCell));
+                childPtrs.push_back(&children[c]);
+            }
+
+            if(childPtrs.empty())
+            {
+                continue;
+            }
+
+            subsample(parent, childPtrs);
+
+            for(int c = 0; c < 8; c++)
+            {
+                if(parent.children[c] < 0)
+                {
+                    continue;
+                }
+                uint64_t offset = writePoints(children[c].points);
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_nodes[parent.children[c]].offset = offset;
+                m_nodes[parent.children[c]].numPoints = children[c].points.size();
+            }
+
+            writePointFile(levelFile(level, cell), parent.points, false);
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            parents[cell] = m_nodes.size();
+            m_nodes.push_back(toNode(parent));
+        }
+
+        current.swap(parents);
+    }
+
+    // Finally write the points of the root
+    int64_t root = current[0];
+    if(root >= 0)
+    {
+        std::vector<PointLODPoint> points;
+        readPoints(levelFile(0, 0), points);
+        boost::filesystem::remove(levelFile(0, 0));
+        m_nodes[root].offset = writePoints(points);
+        m_nodes[root].numPoints = points.size();
+    }
+    return root;
+}
+
+bool PointLODBuilder::writeHierarchy(int64_t root)
+{
+    std::ofstream out(m_directory + "/hierarchy.lod", std::ios::binary | std::ios::trunc);
+
+    uint64_t numNodes = m_nodes.size();
+    uint64_t numPoints = m_dataSize;
+    uint64_t rootIndex = root;
+    uint32_t hasColors = m_hasColors ? 1 : 0;
+
+    out.write(LOD_MAGIC, sizeof(LOD_MAGIC));
+    out.write(reinterpret_cast<const char*>(&numNodes), sizeof(numNodes));
+    out.write(reinterpret_cast<const char*>(&numPoints), sizeof(numPoints));
+    out.write(reinterpret_cast<const char*>(&rootIndex), sizeof(rootIndex));
+    out.write(reinterpret_cast<const char*>(&hasColors), sizeof(hasColors));
+    out.write(reinterpret_cast<const char*>(m_nodes.data()), numNodes * sizeof(PointLODNode));
+
+    return out.good();
+}
+
+bool PointLODBuilder::finish()
+{
+    flush();
+
+    if(m_numPoints == 0)
+    {
+        std::cout << timestamp << "PointLODBuilder: No points to build a hierarchy from." << std::endl;
+        return false;
+    }
+
+    m_data.open(m_directory + "/points.lod", std::ios::binary | std::ios::trunc);
+    m_dataSize = 0;
+    m_nodes.clear();
+
+    std::vector<size_t> cells;
+    for(size_t cell = 0; cell < m_chunkSizes.size(); cell++)
+    {
+        if(m_chunkSizes[cell] > 0)
+        {
+            cells.push_back(cell);
+        }
+    }
+
+    std::cout << timestamp << "PointLODBuilder: Building " << cells.size() << " chunks" << std::endl;
+
+    std::vector<int64_t> chunkRoots(m_chunkSizes.size(), -1);
+
+    // A chunk is only started if its points fit into the budget next to the
+    // chunks that are being built, otherwise its thread waits for them
+    std::mutex budgetMutex;
+    std::condition_variable budgetFreed;
+    size_t pointsInFlight = 0;
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(size_t i = 0; i < cells.size(); i++)
+    {
+        size_t n = m_chunkSizes[cells[i]];
+        {
+            std::unique_lock<std::mutex> lock(budgetMutex);
+            budgetFreed.wait(lock, [&]
+            {
+                return pointsInFlight == 0 || pointsInFlight + n <= m_options.chunkPointBudget;
+            });
+            pointsInFlight += n;
+        }
+
+        buildChunk(cells[i], chunkRoots);
+
+        {
+            std::lock_guard<std::mutex> lock(budgetMutex);
+            pointsInFlight -= n;
+        }
+        budgetFreed.notify_all();
+    }
+    std::fill(m_chunkSizes.begin(), m_chunkSizes.end(), 0);
+
+    int64_t root = buildUpperLevels(chunkRoots);
+    bool good = m_data.good();
+    m_data.close();
+
+    if(root < 0 || !good)
+    {
+        std::cout << timestamp << "PointLODBuilder: Unable to write " << m_directory << std::endl;
+        return false;
+    }
+
+    std::cout << timestamp << "PointLODBuilder: Wrote " << m_dataSize << " points in "
+              << m_nodes.size() << " nodes" << std::endl;
+
+    return writeHierarchy(root);
+}
+
+PointLODHierarchy::PointLODHierarchy(const std::string& directory)
+    : m_directory(directory), m_open(false), m_root(0), m_numPoints(0), m_hasColors(false)
+{
+    std::ifstream in(directory + "/hierarchy.lod", std::ios::binary);
+    if(!in.good())
+    {
+        std::cout << timestamp << "PointLODHierarchy: Unable to open " << directory << std::endl;
+        return;
+    }
+
+    char magic[sizeof(LOD_MAGIC)];
+    uint64_t numNodes, numPoints, root;
+    uint32_t hasColors;
+
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&numNodes), sizeof(numNodes));
+    in.read(reinterpret_cast<char*>(&numPoints), sizeof(numPoints));
+    in.read(reinterpret_cast<char*>(&root), sizeof(root));
+    in.read(reinterpret_cast<char*>(&hasColors), sizeof(hasColors));
+    if(!in.good() || std::memcmp(magic, LOD_MAGIC, sizeof(magic)) != 0 || root >= numNodes)
+    {
+        std::cout << timestamp << "PointLODHierarchy: " << directory << " contains no valid hierarchy" << std::endl;
+        return;
+    }
+
+    m_nodes.resize(numNodes);
+    in.read(reinterpret_cast<char*>(m_nodes.data()), numNodes * sizeof(PointLODNode));
+    if(!in.good())
+    {
+        m_nodes.clear();
+        return;
+    }
+
+    m_root = root;
+    m_numPoints = numPoints;
+    m_hasColors = hasColors != 0;
+    m_open = true;
+}
+
+bool PointLODHierarchy::intersects(const PointLODNode& node, const double planes[24])
+{
+    for(int i = 0; i < 6; i++)
+    {
+        // The corner that is farthest along the plane normal
+        double distance = planes[i * 4 + 3];
+        for(int a = 0; a < 3; a++)
+        {
+            double v = planes[i * 4 + a] >= 0 ? node.min[a] + node.size : node.min[a];
+            distance += planes[i * 4 + a] * v;
+        }
+        if(distance < 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<size_t> PointLODHierarchy::query(
+    const double planes[24],
+    const Vector3f& camera,
+    float projectionFactor,
+    float maxError,
+    size_t pointBudget) const
+{
+    std::vector<size_t> result;
+    if(!m_open)
+    {
+        return result;
+    }
+
+    // Projected spacing of a node at its closest distance to the camera
+    auto error = [&](const PointLODNode& node)
+    {
+        float sqDist = 0;
+        for(int a = 0; a < 3; a++)
+        {
+            float lo = node.min[a];
+            float hi = node.min[a] + node.size;
+            float d = camera[a] < lo ? lo - camera[a] : (camera[a] > hi ? camera[a] - hi : 0);
+            sqDist += d * d;
+        }
+        if(sqDist == 0)
+        {
+            return std::numeric_limits<float>::max();
+        }
+        return node.spacing * projectionFactor / std::sqrt(sqDist);
+    };
+
+    using Entry = std::pair<float, size_t>;
+    std::priority_queue<Entry> queue;
+    if(intersects(m_nodes[m_root], planes))
+    {
+        queue.push(Entry(error(m_nodes[m_root]), m_root));
+    }
+
+    size_t numPoints = 0;
+    while(!queue.empty())
+    {
+        Entry entry = queue.top();
+        queue.pop();
+
+        const PointLODNode& node = m_nodes[entry.second];
+        if(numPoints + node.numPoints > pointBudget)
+        {
+            continue;
+        }
+        result.push_back(entry.second);
+        numPoints += node.numPoints;
+
+        if(entry.first <= maxError)
+        {
+            continue;
+        }
+        for(int c = 0; c < 8; c++)
+        {
+            if(node.children[c] >= 0 && intersects(m_nodes[node.children[c]], planes))
+            {
+                queue.push(Entry(error(m_nodes[node.children[c]]), node.children[c]));
+            }
+        }
+    }
+
+    return result;
+}
+
+PointBufferPtr PointLODHierarchy::loadPoints(const std::vector<size_t>& nodes) const
+{
+    size_t total = 0;
+    for(size_t i : nodes)
+    {
+        total += m_nodes[i].numPoints;
+    }
+
+    floatArr points(new float[3 * total]);
+    ucharArr colors;
+    if(m_hasColors)
+    {
+        colors = ucharArr(new unsigned char[3 * total]);
+    }
+
+    std::ifstream in(m_directory + "/points.lod", std::ios::binary);
+    std::vector<PointLODPoint> buffer;
+    size_t pos = 0;
+    for(size_t i : nodes)
+    {
+        const PointLODNode& node = m_nodes[i];
+        buffer.resize(node.numPoints);
+        in.seekg(node.offset * sizeof(PointLODPoint));
+        in.read(reinterpret_cast<char*>(buffer.data()), node.numPoints * sizeof(PointLODPoint));
+        for(const PointLODPoint& p : buffer)
+        {
+            points[3 * pos] = p.x;
+            points[3 * pos + 1] = p.y;
+            points[3 * pos + 2] = p.z;
+            if(colors)
+            {
+                std::copy(p.rgba, p.rgba + 3, colors.get() + 3 * pos);
+            }
+            pos++;
+        }
+    }
+
+    PointBufferPtr result(new PointBuffer(points, total));
+    if(colors)
+    {
+        result->setColorArray(colors, total, 3);
+    }
+    return result;
+}
+
+void PointLODHierarchy::frustumPlanes(const Matrix4f& m, double planes[24])
+{
+    for(int i = 0; i < 6; i++)
+    {
+        // left, right, bottom, top, near, far
+        int row = i / 2;
+        float sign = i % 2 == 0 ? 1.0f : -1.0f;
+        double length = 0;
+        for(int a = 0; a < 4; a++)
+        {
+            planes[i * 4 + a] = m(3, a) + sign * m(row, a);
+        }
+        for(int a = 0; a < 3; a++)
+        {
+            length += planes[i * 4 + a] * planes[i * 4 + a];
+        }
+        length = std::sqrt(length);
+        for(int a = 0; a < 4 && length > 0; a++)
+        {
+            planes[i * 4 + a] /= length;
+        }
+    }
+}
+
+float PointLODHierarchy::projectionFactor(float screenHeight, float fovY)
+{
+    return screenHeight / (2.0f * std::tan(fovY / 2.0f));
+}
+
+} // namespace lvr2
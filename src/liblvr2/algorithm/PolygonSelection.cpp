@@ -0,0 +1,496 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * PolygonSelection.cpp
+ */
+
+#include "lvr2/algorithm/PolygonSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace lvr2
+{
+
+namespace
+{
+
+/// Maximum depth of the octree, guards against clusters of identical points
+const int MAX_DEPTH = 32;
+
+/// Projection of the polygon and the viewport used by a single query
+struct Projection
+{
+    Transformd                  matrix;
+    double                      viewport[4];
+    std::vector<Vector2d>       polygon;
+    double                      polyMin[2];
+    double                      polyMax[2];
+
+    /**
+     * @brief Projects p to display coordinates. Returns false if p is not
+     *        between the near and the far plane.
+     */
+    bool project(const double p[3], double& x, double& y, int& clip) const
+    {
+        double cx = matrix(0, 0) * p[0] + matrix(0, 1) * p[1] + matrix(0, 2) * p[2] + matrix(0, 3);
+        double cy = matrix(1, 0) * p[0] + matrix(1, 1) * p[1] + matrix(1, 2) * p[2] + matrix(1, 3);
+        double cz = matrix(2, 0) * p[0] + matrix(2, 1) * p[1] + matrix(2, 2) * p[2] + matrix(2, 3);
+        double cw = matrix(3, 0) * p[0] + matrix(3, 1) * p[1] + matrix(3, 2) * p[2] + matrix(3, 3);
+
+        // Bit 0: behind the camera, bit 1: in front of the near plane,
+        // bit 2: behind the far plane
+        clip = (cw <= 0 ? 1 : 0) | (cz < -cw ? 2 : 0) | (cz > cw ? 4 : 0);
+        if (clip)
+        {
+            return false;
+        }
+
+        x = viewport[0] + (cx / cw + 1.0) * 0.5 * viewport[2];
+        y = viewport[1] + (cy / cw + 1.0) * 0.5 * viewport[3];
+        return true;
+    }
+
+    /// Edges of the polygon sorted into horizontal rows, the edges that
+    /// overlap row r are rowEdges[rowStart[r], rowStart[r + 1])
+    std::vector<size_t>         rowStart;
+    std::vector<size_t>         rowEdges;
+    double                      rowHeight;
+
+    /// Sorts the edges of the polygon into rows of equal height
+    void buildRows()
+    {
+        size_t n = polygon.size();
+        size_t numRows = std::max<size_t>(1, std::min<size_t>(n, 1024));
+        rowHeight = std::max((polyMax[1] - polyMin[1]) / numRows, 1e-9);
+
+        auto rowOf = [&](double y) {
+            return std::min<size_t>(numRows - 1, std::max(0.0, (y - polyMin[1]) / rowHeight));
+        };
+
+        std::vector<std::vector<size_t>> rows(numRows);
+        for (size_t i = 0, j = n - 1; i < n; j = i++)
+        {
+            size_t r0 = rowOf(std::min(polygon[i].y(), polygon[j].y()));
+            size_t r1 = rowOf(std::max(polygon[i].y(), polygon[j].y()));
+            for (size_t r = r0; r <= r1; r++)
+            {
+                rows[r].push_back(i);
+            }
+        }
+
+        rowStart.assign(1, 0);
+        rowEdges.clear();
+        for (const auto& row : rows)
+        {
+            rowEdges.insert(rowEdges.end(), row.begin(), row.end());
+            rowStart.push_back(rowEdges.size());
+        }
+    }
+
+    /// Even-odd point in polygon test against the edges of the row of y
+    bool inside(double x, double y) const
+    {
+        if (y < polyMin[1] || y > polyMax[1] || x < polyMin[0] || x > polyMax[0])
+        {
+            return false;
+        }
+
+        size_t numRows = rowStart.size() - 1;
+        size_t r = std::min<size_t>(numRows - 1, (y - polyMin[1]) / rowHeight);
+
+        bool c = false;
+        size_t n = polygon.size();
+        for (size_t e = rowStart[r]; e < rowStart[r + 1]; e++)
+        {
+            size_t i = rowEdges[e];
+            const Vector2d& a = polygon[i == 0 ? n - 1 : i - 1];
+            const Vector2d& b = polygon[i];
+            if (((b.y() > y) != (a.y() > y))
+                && (x < (a.x() - b.x()) * (y - b.y()) / (a.y() - b.y()) + b.x()))
+            {
+                c = !c;
+            }
+        }
+        return c;
+    }
+};
+
+/// Liang-Barsky test whether the segment a, b intersects the rectangle
+bool segmentIntersectsRect(const Vector2d& a, const Vector2d& b, const double min[2], const double max[2])
+{
+    double t0 = 0.0;
+    double t1 = 1.0;
+    Vector2d d = b - a;
+    for (int i = 0; i < 2; i++)
+    {
+        if (d[i] == 0.0)
+        {
+            if (a[i] < min[i] || a[i] > max[i])
+            {
+                return false;
+            }
+            continue;
+        }
+        double ta = (min[i] - a[i]) / d[i];
+        double tb = (max[i] - a[i]) / d[i];
+        if (ta > tb)
+        {
+            std::swap(ta, tb);
+        }
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if (t0 > t1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+enum class Overlap
+{
+    OUTSIDE,
+    INSIDE,
+    PARTIAL
+};
+
+/// Classifies the axis aligned box min, max against the projected polygon
+Overlap classifyBox(const Projection& proj, const float min[3], const float max[3])
+{
+    double rectMin[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    double rectMax[2] = {std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+    int clipAnd = 7;
+    int clipOr = 0;
+    for (int i = 0; i < 8; i++)
+    {
+        double corner[3] = {(i & 1) ? max[0] : min[0], (i & 2) ? max[1] : min[1], (i & 4) ? max[2] : min[2]};
+        double x, y;
+        int clip;
+        if (proj.project(corner, x, y, clip))
+        {
+            rectMin[0] = std::min(rectMin[0], x);
+            rectMin[1] = std::min(rectMin[1], y);
+            rectMax[0] = std::max(rectMax[0], x);
+            rectMax[1] = std::max(rectMax[1], y);
+        }
+        clipAnd &= clip;
+        clipOr |= clip;
+    }
+
+    // All corners are on the invisible side of the same plane
+    if (clipAnd)
+    {
+        return Overlap::OUTSIDE;
+    }
+
+    // Some corners are clipped, the projection of the box is unbounded
+    if (clipOr)
+    {
+        return Overlap::PARTIAL;
+    }
+
+    if (rectMax[0] < proj.polyMin[0] || rectMin[0] > proj.polyMax[0]
+        || rectMax[1] < proj.polyMin[1] || rectMin[1] > proj.polyMax[1])
+    {
+        return Overlap::OUTSIDE;
+    }
+
+    // If no edge of the polygon touches the rectangle, the rectangle lies
+    // either completely inside or completely outside of the polygon.
+    size_t n = proj.polygon.size();
+    for (size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+        if (segmentIntersectsRect(proj.polygon[j], proj.polygon[i], rectMin, rectMax))
+        {
+            return Overlap::PARTIAL;
+        }
+    }
+
+    return proj.inside(rectMin[0], rectMin[1]) ? Overlap::INSIDE : Overlap::OUTSIDE;
+}
+
+} // namespace
+
+PolygonSelection::PolygonSelection(floatArr points, size_t numPoints, size_t maxLeafSize)
+    : m_points(points), m_numPoints(numPoints)
+{
+    build(maxLeafSize);
+}
+
+PolygonSelection::PolygonSelection(PointBufferPtr buffer, size_t maxLeafSize)
+    : m_points(buffer->getPointArray()), m_numPoints(buffer->numPoints())
+{
+    build(maxLeafSize);
+}
+
+void PolygonSelection::build(size_t maxLeafSize)
+{
+    maxLeafSize = std::max<size_t>(maxLeafSize, 1);
+
+    m_indices.resize(m_numPoints);
+    #pragma omp parallel for
+    for (size_t i = 0; i < m_numPoints; i++)
+    {
+        m_indices[i] = i;
+    }
+
+    Node root;
+    std::fill(root.min, root.min + 3, std::numeric_limits<float>::max());
+    std::fill(root.max, root.max + 3, std::numeric_limits<float>::lowest());
+    root.begin = 0;
+    root.end = m_numPoints;
+    std::fill(root.children, root.children + 8, -1);
+    for (size_t i = 0; i < m_numPoints; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            root.min[j] = std::min(root.min[j], m_points[3 * i + j]);
+            root.max[j] = std::max(root.max[j], m_points[3 * i + j]);
+        }
+    }
+    m_nodes.push_back(root);
+
+    // Split the nodes level by level. The nodes of a level are independent,
+    // so they are split in parallel and their children are appended afterwards.
+    std::vector<int> level = {0};
+    for (int depth = 0; depth < MAX_DEPTH && !level.empty(); depth++)
+    {
+        std::vector<std::vector<Node>> children(level.size());
+
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t l = 0; l < level.size(); l++)
+        {
+            const Node& node = m_nodes[level[l]];
+            size_t size = node.end - node.begin;
+            if (size <= maxLeafSize)
+            {
+                continue;
+            }
+
+            float center[3];
+            for (int j = 0; j < 3; j++)
+            {
+                center[j] = (node.min[j] + node.max[j]) / 2;
+            }
+
+            auto octant = [&](unsigned int index) {
+                const float* p = &m_points[3 * index];
+                return (p[0] > center[0] ? 1 : 0) | (p[1] > center[1] ? 2 : 0) | (p[2] > center[2] ? 4 : 0);
+            };
+
+            // Counting sort of the indices by octant
+            size_t counts[8] = {0};
+            for (size_t i = node.begin; i < node.end; i++)
+            {
+                counts[octant(m_indices[i])]++;
+            }
+
+            // Every point lies in the same octant, the node can not be split
+            if (*std::max_element(counts, counts + 8) == size)
+            {
+                continue;
+            }
+
+            size_t offsets[8];
+            offsets[0] = 0;
+            for (int o = 1; o < 8; o++)
+            {
+                offsets[o] = offsets[o - 1] + counts[o - 1];
+            }
+
+            std::vector<unsigned int> sorted(size);
+            for (size_t i = node.begin; i < node.end; i++)
+            {
+                unsigned int index = m_indices[i];
+                sorted[offsets[octant(index)]++] = index;
+            }
+            std::copy(sorted.begin(), sorted.end(), m_indices.begin() + node.begin);
+
+            size_t begin = node.begin;
+            for (int o = 0; o < 8; o++)
+            {
+                if (counts[o] == 0)
+                {
+                    continue;
+                }
+
+                Node child;
+                std::fill(child.min, child.min + 3, std::numeric_limits<float>::max());
+                std::fill(child.max, child.max + 3, std::numeric_limits<float>::lowest());
+                child.begin = begin;
+                child.end = begin + counts[o];
+                std::fill(child.children, child.children + 8, -1);
+                for (size_t i = child.begin; i < child.end; i++)
+                {
+                    const float* p = &m_points[3 * m_indices[i]];
+                    for (int j = 0; j < 3; j++)
+                    {
+                        child.min[j] = std::min(child.min[j], p[j]);
+                        child.max[j] = std::max(child.max[j], p[j]);
+                    }
+                }
+                children[l].push_back(child);
+                begin = child.end;
+            }
+        }
+
+        std::vector<int> nextLevel;
+        for (size_t l = 0; l < level.size(); l++)
+        {
+            int c = 0;
+            for (const Node& child : children[l])
+            {
+                m_nodes[level[l]].children[c++] = m_nodes.size();
+                nextLevel.push_back(m_nodes.size());
+                m_nodes.push_back(child);
+            }
+        }
+        level.swap(nextLevel);
+    }
+}
+
+std::vector<unsigned int> PolygonSelection::select(
+    const Transformd& viewProjection,
+    const std::array<double, 4>& viewport,
+    const std::vector<Vector2d>& polygon) const
+{
+    std::vector<unsigned int> selected;
+    if (polygon.size() < 3 || m_nodes.empty())
+    {
+        return selected;
+    }
+
+    Projection proj;
+    proj.matrix = viewProjection;
+    std::copy(viewport.begin(), viewport.end(), proj.viewport);
+    proj.polygon = polygon;
+    proj.polyMin[0] = proj.polyMin[1] = std::numeric_limits<double>::max();
+    proj.polyMax[0] = proj.polyMax[1] = std::numeric_limits<double>::lowest();
+    for (const Vector2d& v : polygon)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            proj.polyMin[j] = std::min(proj.polyMin[j], v[j]);
+            proj.polyMax[j] = std::max(proj.polyMax[j], v[j]);
+        }
+    }
+    proj.buildRows();
+
+    // Collect the nodes that are accepted as a whole and the leaves whose
+    // points have to be tested
+    std::vector<int> acceptedNodes;
+    std::vector<int> partialLeaves;
+    std::vector<int> stack = {0};
+    while (!stack.empty())
+    {
+        int n = stack.back();
+        stack.pop_back();
+        const Node& node = m_nodes[n];
+
+        Overlap overlap = classifyBox(proj, node.min, node.max);
+        if (overlap == Overlap::INSIDE)
+        {
+            acceptedNodes.push_back(n);
+        }
+        else if (overlap == Overlap::PARTIAL)
+        {
+            bool leaf = true;
+            for (int c = 0; c < 8; c++)
+            {
+                if (node.children[c] >= 0)
+                {
+                    stack.push_back(node.children[c]);
+                    leaf = false;
+                }
+            }
+            if (leaf)
+            {
+                partialLeaves.push_back(n);
+            }
+        }
+    }
+
+    // Test the points of the partially covered leaves
+    std::vector<std::vector<unsigned int>> leafSelections(partialLeaves.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t l = 0; l < partialLeaves.size(); l++)
+    {
+        const Node& node = m_nodes[partialLeaves[l]];
+        std::vector<unsigned int>& leafSelection = leafSelections[l];
+        for (size_t i = node.begin; i < node.end; i++)
+        {
+            unsigned int index = m_indices[i];
+            double p[3] = {m_points[3 * index], m_points[3 * index + 1], m_points[3 * index + 2]};
+            double x, y;
+            int clip;
+            if (proj.project(p, x, y, clip) && proj.inside(x, y))
+            {
+                leafSelection.push_back(index);
+            }
+        }
+    }
+
+    // Copy the accepted ranges and the tested points into the result
+    std::vector<const unsigned int*> sources;
+    std::vector<size_t> sizes;
+    for (int n : acceptedNodes)
+    {
+        sources.push_back(&m_indices[m_nodes[n].begin]);
+        sizes.push_back(m_nodes[n].end - m_nodes[n].begin);
+    }
+    for (const auto& leafSelection : leafSelections)
+    {
+        sources.push_back(leafSelection.data());
+        sizes.push_back(leafSelection.size());
+    }
+
+    std::vector<size_t> offsets(sizes.size() + 1, 0);
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        offsets[i + 1] = offsets[i] + sizes[i];
+    }
+    selected.resize(offsets.back());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        if (sizes[i] > 0)
+        {
+            std::memcpy(&selected[offsets[i]], sources[i], sizes[i] * sizeof(unsigned int));
+        }
+    }
+
+    return selected;
+}
+
+} // namespace lvr2
@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * VoxelGridReduction.cpp
+ */
+
+#include "lvr2/algorithm/VoxelGridReduction.hpp"
+#include "lvr2/config/lvropenmp.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace lvr2
+{
+
+namespace
+{
+
+/**
+ * @brief Stable parallel LSD radix sort of key / value pairs, 8 bits per pass.
+ *
+ * The input is split into one block per thread. Each block builds a histogram
+ * of its digits, the histograms are turned into scatter offsets ordered by
+ * (digit, block), so every block can scatter its elements independently.
+ */
+void radixSort(std::vector<uint64_t>& keys, std::vector<size_t>& values, uint64_t maxKey)
+{
+    size_t n = keys.size();
+    size_t numBlocks = std::max<size_t>(1, std::min<size_t>(OpenMPConfig::getNumThreads(), n / 4096));
+
+    std::vector<uint64_t> tmpKeys(n);
+    std::vector<size_t> tmpValues(n);
+    std::vector<size_t> offsets(256 * numBlocks);
+
+    for(int shift = 0; shift < 64 && (maxKey >> shift) > 0; shift += 8)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+
+        #pragma omp parallel for schedule(static, 1)
+        for(size_t b = 0; b < numBlocks; b++)
+        {
+            size_t* hist = &offsets[256 * b];
+            size_t end = n * (b + 1) / numBlocks;
+            for(size_t i = n * b / numBlocks; i < end; i++)
+            {
+                hist[(keys[i] >> shift) & 0xFF]++;
+            }
+        }
+
+        size_t sum = 0;
+        for(size_t d = 0; d < 256; d++)
+        {
+            for(size_t b = 0; b < numBlocks; b++)
+            {
+                size_t count = offsets[256 * b + d];
+                offsets[256 * b + d] = sum;
+                sum += count;
+            }
+        }
+
+        #pragma omp parallel for schedule(static, 1)
+        for(size_t b = 0; b < numBlocks; b++)
+        {
+            size_t* pos = &offsets[256 * b];
+            size_t end = n * (b + 1) / numBlocks;
+            for(size_t i = n * b / numBlocks; i < end; i++)
+            {
+                size_t p = pos[(keys[i] >> shift) & 0xFF]++;
+                tmpKeys[p] = keys[i];
+                tmpValues[p] = values[i];
+            }
+        }
+
+        keys.swap(tmpKeys);
+        values.swap(tmpValues);
+    }
+}
+
+/// Raw description of a channel that is gathered byte wise
+struct GatherChannel
+{
+    const unsigned char*    src;
+    unsigned char*          dst;
+    size_t                  elementSize;
+};
+
+template<typename T>
+void addGatherChannels(
+    PointBufferPtr& src,
+    PointBufferPtr& dst,
+    size_t n,
+    size_t m,
+    std::vector<GatherChannel>& gather)
+{
+    std::vector<std::pair<std::string, Channel<T>>> channels;
+    src->getAllChannelsOfType(channels);
+    for(auto& channel : channels)
+    {
+        Channel<T>& ch = channel.second;
+        if(ch.numElements() != n)
+        {
+            // Not a per point channel
+            (*dst)[channel.first] = ch;
+            continue;
+        }
+
+        Channel<T> reduced(m, ch.width());
+        gather.push_back({
+            reinterpret_cast<const unsigned char*>(ch.dataPtr().get()),
+            reinterpret_cast<unsigned char*>(reduced.dataPtr().get()),
+            sizeof(T) * ch.width()
+        });
+        (*dst)[channel.first] = reduced;
+    }
+}
+
+} // namespace
+
+VoxelRepresentative voxelRepresentativeFromString(const std::string& name)
+{
+    if(name == "first")
+    {
+        return VoxelRepresentative::FIRST;
+    }
+    if(name == "centroid")
+    {
+        return VoxelRepresentative::CENTROID;
+    }
+    if(name == "closest")
+    {
+        return VoxelRepresentative::CLOSEST;
+    }
+    throw std::invalid_argument("Unknown voxel grid mode '" + name + "'. Valid modes are first, centroid and closest.");
+}
+
+VoxelGridReduction::VoxelGridReduction(
+    float voxelSize,
+    VoxelRepresentative representative,
+    size_t minPointsPerVoxel)
+    : m_voxelSize(voxelSize),
+      m_representative(representative),
+      m_minPointsPerVoxel(std::max<size_t>(1, minPointsPerVoxel)),
+      m_numInputPoints(0),
+      m_numOutputPoints(0),
+      m_seconds(0)
+{
+}
+
+double VoxelGridReduction::throughput() const
+{
+    return m_seconds > 0 ? m_numInputPoints / m_seconds : 0;
+}
+
+bool VoxelGridReduction::sortIntoVoxels(
+    const float* points,
+    size_t n,
+    std::vector<size_t>& order,
+    std::vector<size_t>& voxels) const
+{
+    float minX = std::numeric_limits<float>::max(), maxX = std::numeric_limits<float>::lowest();
+    float minY = minX, maxY = maxX, minZ = minX, maxZ = maxX;
+
+    #pragma omp parallel for reduction(min:minX, minY, minZ) reduction(max:maxX, maxY, maxZ)
+    for(size_t i = 0; i < n; i++)
+    {
+        const float* p = points + 3 * i;
+        minX = std::min(minX, p[0]); maxX = std::max(maxX, p[0]);
+        minY = std::min(minY, p[1]); maxY = std::max(maxY, p[1]);
+        minZ = std::min(minZ, p[2]); maxZ = std::max(maxZ, p[2]);
+    }
+
+    uint64_t dimX = (uint64_t)std::floor((maxX - minX) / m_voxelSize) + 1;
+    uint64_t dimY = (uint64_t)std::floor((maxY - minY) / m_voxelSize) + 1;
+    uint64_t dimZ = (uint64_t)std::floor((maxZ - minZ) / m_voxelSize) + 1;
+    if((long double)dimX * dimY * dimZ > (long double)std::numeric_limits<uint64_t>::max())
+    {
+        return false;
+    }
+
+    std::vector<uint64_t> keys(n);
+    order.resize(n);
+
+    #pragma omp parallel for
+    for(size_t i = 0; i < n; i++)
+    {
+        const float* p = points + 3 * i;
+        uint64_t x = std::min<uint64_t>((uint64_t)((p[0] - minX) / m_voxelSize), dimX - 1);
+        uint64_t y = std::min<uint64_t>((uint64_t)((p[1] - minY) / m_voxelSize), dimY - 1);
+        uint64_t z = std::min<uint64_t>((uint64_t)((p[2] - minZ) / m_voxelSize), dimZ - 1);
+        keys[i] = x + dimX * (y + dimY * z);
+        order[i] = i;
+    }
+
+    radixSort(keys, order, dimX * dimY * dimZ - 1);
+
+    // Find the start of every run of equal keys. Every block counts its starts
+    // first, so the starts can be written in parallel afterwards.
+    size_t numBlocks = std::max<size_t>(1, std::min<size_t>(OpenMPConfig::getNumThreads(), n / 4096));
+    std::vector<size_t> blockStarts(numBlocks + 1, 0);
+
+    #pragma omp parallel for schedule(static, 1)
+    for(size_t b = 0; b < numBlocks; b++)
+    {
+        size_t end = n * (b + 1) / numBlocks;
+        for(size_t i = n * b / numBlocks; i < end; i++)
+        {
+            if(i == 0 || keys[i] != keys[i - 1])
+            {
+                blockStarts[b + 1]++;
+            }
+        }
+    }
+    for(size_t b = 0; b < numBlocks; b++)
+    {
+        blockStarts[b + 1] += blockStarts[b];
+    }
+
+    voxels.resize(blockStarts[numBlocks] + 1);
+    voxels.back() = n;
+
+    #pragma omp parallel for schedule(static, 1)
+    for(size_t b = 0; b < numBlocks; b++)
+    {
+        size_t pos = blockStarts[b];
+        size_t end = n * (b + 1) / numBlocks;
+        for(size_t i = n * b / numBlocks; i < end; i++)
+        {
+            if(i == 0 || keys[i] != keys[i - 1])
+            {
+                voxels[pos++] = i;
+            }
+        }
+    }
+
+    return true;
+}
+
+void VoxelGridReduction::selectRepresentatives(
+    const float* points,
+    const std::vector<size_t>& order,
+    const std::vector<size_t>& voxels,
+    std::vector<size_t>& representatives,
+    std::vector<float>* centroids) const
+{
+    size_t numVoxels = voxels.size() - 1;
+
+    // Output position of every voxel, dropped voxels get the same position as
+    // their successor
+    std::vector<size_t> outIndex(numVoxels + 1, 0);
+    for(size_t v = 0; v < numVoxels; v++)
+    {
+        outIndex[v + 1] = outIndex[v] + (voxels[v + 1] - voxels[v] >= m_minPointsPerVoxel ? 1 : 0);
+    }
+
+    size_t m = outIndex[numVoxels];
+    representatives.resize(m);
+    if(centroids)
+    {
+        centroids->resize(3 * m);
+    }
+
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t v = 0; v < numVoxels; v++)
+    {
+        size_t begin = voxels[v];
+        size_t end = voxels[v + 1];
+        if(end - begin < m_minPointsPerVoxel)
+        {
+            continue;
+        }
+
+        // The radix sort is stable, so the first index of a run is the lowest
+        if(m_representative == VoxelRepresentative::FIRST)
+        {
+            representatives[outIndex[v]] = order[begin];
+            continue;
+        }
+
+        double cx = 0, cy = 0, cz = 0;
+        for(size_t i = begin; i < end; i++)
+        {
+            const float* p = points + 3 * order[i];
+            cx += p[0];
+            cy += p[1];
+            cz += p[2];
+        }
+        double count = end - begin;
+        cx /= count;
+        cy /= count;
+        cz /= count;
+
+        size_t closest = order[begin];
+        double minDist = std::numeric_limits<double>::max();
+        for(size_t i = begin; i < end; i++)
+        {
+            const float* p = points + 3 * order[i];
+            double dx = p[0] - cx, dy = p[1] - cy, dz = p[2] - cz;
+            double dist = dx * dx + dy * dy + dz * dz;
+            if(dist < minDist || (dist == minDist && order[i] < closest))
+            {
+                minDist = dist;
+                closest = order[i];
+            }
+        }
+        representatives[outIndex[v]] = closest;
+
+        if(centroids)
+        {
+            float* c = centroids->data() + 3 * outIndex[v];
+            c[0] = cx;
+            c[1] = cy;
+            c[2] = cz;
+        }
+    }
+}
+
+PointBufferPtr VoxelGridReduction::reduce(PointBufferPtr buffer)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    size_t n = buffer->numPoints();
+    m_numInputPoints = n;
+
+    FloatChannelOptional pts = buffer->getFloatChannel("points");
+    std::vector<size_t> order;
+    std::vector<size_t> voxels;
+    if(!pts || n == 0 || m_voxelSize <= 0 || !sortIntoVoxels(pts->dataPtr().get(), n, order, voxels))
+    {
+        std::cout << timestamp << "VoxelGridReduction: Unable to reduce point buffer." << std::endl;
+        m_numOutputPoints = n;
+        m_seconds = 0;
+        return buffer;
+    }
+
+    bool centroid = m_representative == VoxelRepresentative::CENTROID;
+    std::vector<size_t> representatives;
+    std::vector<float> centroids;
+    selectRepresentatives(pts->dataPtr().get(), order, voxels, representatives, centroid ? &centroids : nullptr);
+    order = std::vector<size_t>();
+    voxels = std::vector<size_t>();
+
+    size_t m = representatives.size();
+
+    PointBufferPtr reduced(new PointBuffer);
+    std::vector<GatherChannel> gather;
+    addGatherChannels<char>(buffer, reduced, n, m, gather);
+    addGatherChannels<unsigned char>(buffer, reduced, n, m, gather);
+    addGatherChannels<short>(buffer, reduced, n, m, gather);
+    addGatherChannels<unsigned short>(buffer, reduced, n, m, gather);
+    addGatherChannels<int>(buffer, reduced, n, m, gather);
+    addGatherChannels<unsigned int>(buffer, reduced, n, m, gather);
+    addGatherChannels<float>(buffer, reduced, n, m, gather);
+    addGatherChannels<double>(buffer, reduced, n, m, gather);
+
+    float* reducedPoints = reduced->getFloatChannel("points")->dataPtr().get();
+
+    // Gather all channels in one pass over the voxels
+    #pragma omp parallel for schedule(static)
+    for(size_t j = 0; j < m; j++)
+    {
+        size_t i = representatives[j];
+        for(const GatherChannel& ch : gather)
+        {
+            std::memcpy(ch.dst + j * ch.elementSize, ch.src + i * ch.elementSize, ch.elementSize);
+        }
+        if(centroid)
+        {
+            std::memcpy(reducedPoints + 3 * j, centroids.data() + 3 * j, 3 * sizeof(float));
+        }
+    }
+
+    m_numOutputPoints = m;
+    m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return reduced;
+}
+
+size_t VoxelGridReduction::reduce(Vector3f* points, size_t n)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    m_numInputPoints = n;
+
+    // Vector3f is not aligned, so the array can be used as n x 3 floats
+    static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f has to be packed");
+    const float* coords = reinterpret_cast<const float*>(points);
+
+    std::vector<size_t> order;
+    std::vector<size_t> voxels;
+    if(n == 0 || m_voxelSize <= 0 || !sortIntoVoxels(coords, n, order, voxels))
+    {
+        m_numOutputPoints = n;
+        m_seconds = 0;
+        return n;
+    }
+
+    bool centroid = m_representative == VoxelRepresentative::CENTROID;
+    std::vector<size_t> representatives;
+    std::vector<float> centroids;
+    selectRepresentatives(coords, order, voxels, representatives, centroid ? &centroids : nullptr);
+
+    size_t m = representatives.size();
+    std::vector<Vector3f> reduced(m);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t j = 0; j < m; j++)
+    {
+        if(centroid)
+        {
+            reduced[j] = Vector3f(centroids[3 * j], centroids[3 * j + 1], centroids[3 * j + 2]);
+        }
+        else
+        {
+            reduced[j] = points[representatives[j]];
+        }
+    }
+    std::copy(reduced.begin(), reduced.end(), points);
+
+    m_numOutputPoints = m;
+    m_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return m;
+}
+
+} // namespace lvr2
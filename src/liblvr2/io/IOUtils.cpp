@@ -31,6 +31,10 @@
 #include "lvr2/io/AsciiIO.hpp"
 #include "lvr2/registration/TransformUtils.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <random>
 #include <unordered_set>
 
@@ -52,12 +56,19 @@ void transformPointCloudAndAppend(PointBufferPtr& buffer,
      sprintf(pose, "%s/%s.pose", transfromFile.parent_path().c_str(), transfromFile.stem().c_str());
 
      boost::filesystem::path framesPath(frames);
+     boost::filesystem::path binaryFramesPath(framesPath);
+     binaryFramesPath.replace_extension(".bframes");
      boost::filesystem::path posePath(pose);
 
 
      Transformd transform = Transformd::Identity();
 
-     if(boost::filesystem::exists(framesPath))
+     if(boost::filesystem::exists(binaryFramesPath))
+     {
+        std::cout << timestamp << "Transforming according to " << binaryFramesPath.filename() << std::endl;
+        transform = getTransformationFromFrames<double>(binaryFramesPath);
+     }
+     else if(boost::filesystem::exists(framesPath))
      {
         std::cout << timestamp << "Transforming according to " << framesPath.filename() << std::endl;
         transform = getTransformationFromFrames<double>(framesPath);
@@ -91,42 +102,15 @@ void transformPointCloudAndAppend(PointBufferPtr& buffer,
          return;
      }
 
-     for(size_t i = 0; i < n_points; i++)
-     {
-
-        float x = points[3 * i];
-        float y = points[3 * i + 1];
-        float z = points[3 * i + 2];
-
-        Vector4d v(x,y,z,1);
-        Vector4d tv = transform * v;
-
-//        points[3 * i]     = tv[0];
-//        points[3 * i + 1] = tv[1];
-//        points[3 * i + 2] = tv[2];
-
-        pts.push_back(tv[0]);
-        pts.push_back(tv[1]);
-        pts.push_back(tv[2]);
-
-        Rotationd rotation = transform.block(0, 0, 3, 3);
-
-        float nx = normals[3 * i];
-        float ny = normals[3 * i + 1];
-        float nz = normals[3 * i + 2];
-
-        Vector3d normal(nx, ny, nz);
-        Vector3d tn = rotation * normal;
-
-//        normals[3 * i]     = tn[0];
-//        normals[3 * i + 1] = tn[1];
-//        normals[3 * i + 2] = tn[2];
-
-        nrm.push_back(tn[0]);
-        nrm.push_back(tn[1]);
-        nrm.push_back(tn[2]);
-     }
+     // Transform copies of the data at the end of the target vectors,
+     // the buffer itself stays untouched
+     size_t pointOffset = pts.size();
+     size_t normalOffset = nrm.size();
+     pts.insert(pts.end(), points.get(), points.get() + 3 * n_points);
+     nrm.insert(nrm.end(), normals.get(), normals.get() + 3 * n_points);
 
+     transformPoints(pts.data() + pointOffset, n_points, transform);
+     transformNormals(nrm.data() + normalOffset, n_points, transform);
 }
 
 size_t countPointsInFile(const boost::filesystem::path& inFile)
@@ -161,6 +145,215 @@ void writePose(const BaseVector<float>& position, const BaseVector<float>& angle
     }
 }
 
+namespace
+{
+
+const char framesMagic[4] = { 'L', 'V', 'R', 'F' };
+const uint32_t framesVersion = 2;
+
+/// The frame has the same transformation as the previous one and stores no matrix
+const uint8_t frameRepeated = 1;
+/// The last row of the frame is not (0, 0, 0, 1) and is stored as well
+const uint8_t frameProjective = 2;
+
+/// Appends the value in little endian byte order, independent of the host
+void appendLE(std::string& data, uint64_t value, size_t bytes)
+{
+    for(size_t i = 0; i < bytes; i++)
+    {
+        data.push_back((char)((value >> (8 * i)) & 0xff));
+    }
+}
+
+/// Reads a little endian value of the given size
+uint64_t readLE(const char* ptr, size_t bytes)
+{
+    uint64_t value = 0;
+    for(size_t i = 0; i < bytes; i++)
+    {
+        value |= (uint64_t)(uint8_t)ptr[i] << (8 * i);
+    }
+    return value;
+}
+
+void appendDouble(std::string& data, double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    appendLE(data, bits, sizeof(bits));
+}
+
+double readDouble(const char* ptr)
+{
+    uint64_t bits = readLE(ptr, sizeof(bits));
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+bool isBinaryFrames(const boost::filesystem::path& file)
+{
+    std::ifstream in(file.c_str(), std::ios::binary);
+    char magic[4];
+    return in.read(magic, 4) && std::equal(magic, magic + 4, framesMagic);
+}
+
+std::vector<Frame> readFrames(const boost::filesystem::path& file)
+{
+    std::vector<Frame> frames;
+
+    std::ifstream in(file.c_str(), std::ios::binary);
+    if(!in.good())
+    {
+        return frames;
+    }
+
+    // Read the whole file at once, text frame dumps are parsed from memory
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if(data.size() >= 4 && std::equal(framesMagic, framesMagic + 4, data.begin()))
+    {
+        const size_t headerSize = 4 + sizeof(uint32_t) + sizeof(uint64_t);
+        if(data.size() < headerSize)
+        {
+            return frames;
+        }
+
+        uint32_t version = readLE(data.data() + 4, sizeof(uint32_t));
+        uint64_t count = readLE(data.data() + 4 + sizeof(uint32_t), sizeof(uint64_t));
+        if(version != framesVersion)
+        {
+            std::cout << timestamp << "Warning: unsupported frames version " << version
+                      << " in " << file.filename() << std::endl;
+            return frames;
+        }
+
+        const size_t frameHeaderSize = sizeof(int32_t) + 1;
+        const char* ptr = data.data() + headerSize;
+        const char* end = data.data() + data.size();
+        Transformd previous = Transformd::Identity();
+        frames.reserve(std::min<uint64_t>(count, data.size()));
+
+        for(uint64_t i = 0; i < count && (size_t)(end - ptr) >= frameHeaderSize; i++)
+        {
+            int use = (int32_t)(uint32_t)readLE(ptr, sizeof(int32_t));
+            uint8_t flags = ptr[sizeof(int32_t)];
+            ptr += frameHeaderSize;
+
+            if(!(flags & frameRepeated))
+            {
+                size_t rows = (flags & frameProjective) ? 4 : 3;
+                if((size_t)(end - ptr) < 4 * rows * sizeof(double))
+                {
+                    break;
+                }
+
+                previous.setIdentity();
+                for(int c = 0; c < 4; c++)
+                {
+                    for(size_t r = 0; r < rows; r++)
+                    {
+                        previous(r, c) = readDouble(ptr);
+                        ptr += sizeof(double);
+                    }
+                }
+            }
+            frames.push_back(Frame(previous, use));
+        }
+        return frames;
+    }
+
+    // slam6d text format: 16 values and a use flag per line
+    const char* ptr = data.c_str();
+    while(true)
+    {
+        Frame frame;
+        char* end;
+        int i = 0;
+        for(; i < 16; i++)
+        {
+            frame.first.data()[i] = strtod(ptr, &end);
+            if(end == ptr)
+            {
+                break;
+            }
+            ptr = end;
+        }
+        long use = strtol(ptr, &end, 10);
+        if(i < 16 || end == ptr)
+        {
+            break;
+        }
+        ptr = end;
+        frame.second = use;
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+void writeFrames(const std::vector<Frame>& frames, const boost::filesystem::path& framesOut)
+{
+    if(framesOut.extension() == ".bframes")
+    {
+        std::string data(framesMagic, 4);
+        appendLE(data, framesVersion, sizeof(uint32_t));
+        appendLE(data, frames.size(), sizeof(uint64_t));
+
+        for(size_t i = 0; i < frames.size(); i++)
+        {
+            const Transformd& t = frames[i].first;
+            uint8_t flags = 0;
+            if(i > 0 && t == frames[i - 1].first)
+            {
+                flags |= frameRepeated;
+            }
+            else if(t.row(3) != Eigen::RowVector4d(0, 0, 0, 1))
+            {
+                flags |= frameProjective;
+            }
+
+            // The use flag is an int and stored at full width
+            appendLE(data, (uint32_t)(int32_t)frames[i].second, sizeof(int32_t));
+            data.push_back((char)flags);
+
+            if(!(flags & frameRepeated))
+            {
+                size_t rows = (flags & frameProjective) ? 4 : 3;
+                for(int c = 0; c < 4; c++)
+                {
+                    for(size_t r = 0; r < rows; r++)
+                    {
+                        appendDouble(data, t(r, c));
+                    }
+                }
+            }
+        }
+
+        std::ofstream out(framesOut.c_str(), std::ios::binary);
+        out.write(data.data(), data.size());
+        return;
+    }
+
+    std::ofstream out(framesOut.c_str());
+    for(const Frame& frame : frames)
+    {
+        for(int i = 0; i < 16; i++)
+        {
+            out << frame.first(i) << " ";
+        }
+        out << frame.second << "\n";
+    }
+}
+
+size_t convertFrames(const boost::filesystem::path& in, const boost::filesystem::path& out)
+{
+    std::vector<Frame> frames = readFrames(in);
+    writeFrames(frames, out);
+    return frames.size();
+}
+
 size_t writeModel(ModelPtr model, const boost::filesystem::path& outfile)
 {
     size_t n_ip = model->m_pointCloud->numPoints();
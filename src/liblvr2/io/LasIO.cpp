@@ -38,69 +38,175 @@ using std::endl;
 
 #include "lvr2/io/LasIO.hpp"
 #include "lvr2/io/Timestamp.hpp"
+#include "lvr2/config/lvropenmp.hpp"
 
 #include <lasreader.hpp>
 #include <laswriter.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace lvr2
 {
 
 ModelPtr LasIO::read(string filename )
 {
+    return read(filename, 0);
+}
 
-    // Create Lasreader object
+ModelPtr LasIO::read(string filename, int numThreads)
+{
+    // Open a first reader to get the header information
     LASreadOpener lasreadopener;
     lasreadopener.set_file_name(filename.c_str());
 
-    if(lasreadopener.active())
+    LASreader* lasreader = lasreadopener.active() ? lasreadopener.open() : 0;
+    if(!lasreader)
     {
-        LASreader* lasreader = lasreadopener.open();
+        cout << timestamp << "LasIO::read(): Unable to open file " << filename << endl;
+        return ModelPtr();
+    }
 
-        // Get number of points in file
-        size_t num_points = lasreader->npoints;
+    // Get number of points in file and available attributes
+    size_t num_points = lasreader->npoints;
+    bool have_rgb = lasreader->point.have_rgb;
+    bool have_gps_time = lasreader->point.have_gps_time;
 
-        // Alloc coordinate array
-        floatArr points ( new float[3 * num_points]);
-        floatArr intensities ( new float[num_points]);
-        ucharArr colors (new unsigned char[3 * num_points]);
+    // Compressed files can only be entered at chunk boundaries
+    // efficiently, so align the blocks to the chunk size
+    size_t chunk_size = 1;
+    if(lasreader->header.laszip && lasreader->header.laszip->compressor
+       && lasreader->header.laszip->chunk_size != U32_MAX)
+    {
+        chunk_size = lasreader->header.laszip->chunk_size;
+    }
 
-        // Read point data
-        for(size_t i = 0; i < num_points; i++)
-        {
-            size_t buf_pos = 3 * i;
-            lasreader->read_point();
-            points[buf_pos]     = lasreader->point.x;
-            points[buf_pos + 1] = lasreader->point.y;
-            points[buf_pos + 2] = lasreader->point.z;
+    lasreader->close();
+    delete lasreader;
 
-            // Create fake colors from intensities
-            /// TODO: Check for color attributes if possible...
-            colors[buf_pos] = lasreader->point.intensity;
-            colors[buf_pos + 1] = lasreader->point.intensity;
-            colors[buf_pos + 2] = lasreader->point.intensity;
+    if(numThreads <= 0)
+    {
+        numThreads = OpenMPConfig::getNumThreads();
+    }
+
+    // Use more blocks than threads to balance the load
+    size_t min_block_size = 100000;
+    size_t num_blocks = std::min<size_t>(4 * numThreads, num_points / min_block_size + 1);
+    size_t block_size = (num_points + num_blocks - 1) / num_blocks;
+    block_size = ((block_size + chunk_size - 1) / chunk_size) * chunk_size;
+    num_blocks = block_size ? (num_points + block_size - 1) / block_size : 0;
+
+    // Alloc channels
+    floatArr points (new float[3 * num_points]);
+    floatArr intensities (new float[num_points]);
+    ucharArr classifications (new unsigned char[num_points]);
+    doubleArr gps_times;
+    std::vector<unsigned short> rgb;
+    if(have_gps_time)
+    {
+        gps_times = doubleArr(new double[num_points]);
+    }
+    if(have_rgb)
+    {
+        rgb.resize(3 * num_points);
+    }
 
-            intensities[i] = lasreader->point.intensity;
+    bool success = true;
+    bool have_classes = false;
+    unsigned short max_color = 0;
 
+    #pragma omp parallel for schedule(dynamic) num_threads(numThreads) \
+        reduction(&&:success) reduction(||:have_classes) reduction(max:max_color)
+    for(size_t b = 0; b < num_blocks; b++)
+    {
+        size_t start = b * block_size;
+        size_t end = std::min(start + block_size, num_points);
+
+        // Each block is decoded by an independent reader
+        LASreadOpener opener;
+        opener.set_file_name(filename.c_str());
+        LASreader* reader = opener.open();
+        if(!reader || !reader->seek(start))
+        {
+            success = false;
+            delete reader;
+            continue;
         }
 
-        // Create point buffer and model
-        PointBufferPtr p_buffer( new PointBuffer);
-        p_buffer->setPointArray(points, num_points);
-        p_buffer->addFloatChannel(intensities, "intensities", num_points, 1);
-        p_buffer->setColorArray(colors, num_points);
+        for(size_t i = start; i < end; i++)
+        {
+            if(!reader->read_point())
+            {
+                success = false;
+                break;
+            }
+
+            const LASpoint& p = reader->point;
+            points[3 * i]       = reader->get_x();
+            points[3 * i + 1]   = reader->get_y();
+            points[3 * i + 2]   = reader->get_z();
+            intensities[i]      = p.intensity;
+            classifications[i]  = p.classification;
+            have_classes        = have_classes || p.classification;
+
+            if(have_gps_time)
+            {
+                gps_times[i] = p.gps_time;
+            }
+
+            if(have_rgb)
+            {
+                for(int c = 0; c < 3; c++)
+                {
+                    rgb[3 * i + c] = p.rgb[c];
+                    max_color = std::max(max_color, p.rgb[c]);
+                }
+            }
+        }
+
+        reader->close();
+        delete reader;
+    }
 
-        ModelPtr m_ptr( new Model(p_buffer));
-        m_model = m_ptr;
+    if(!success)
+    {
+        cout << timestamp << "LasIO::read(): Error while reading " << filename << endl;
+        return ModelPtr();
+    }
 
-        delete lasreader;
+    // Create point buffer and model
+    PointBufferPtr p_buffer( new PointBuffer);
+    p_buffer->setPointArray(points, num_points);
+    p_buffer->addFloatChannel(intensities, "intensities", num_points, 1);
 
-        return m_ptr;
+    if(have_classes)
+    {
+        p_buffer->addUCharChannel(classifications, "classifications", num_points, 1);
     }
-    else
+
+    if(have_gps_time)
     {
-        cout << timestamp << "LasIO::read(): Unable to open file " << filename << endl;
-        return ModelPtr();
+        p_buffer->addChannel<double>(gps_times, "gps_time", num_points, 1);
     }
+
+    if(have_rgb)
+    {
+        // LAS colors are 16 bit, but many files store 8 bit values
+        int shift = max_color > 255 ? 8 : 0;
+        ucharArr colors (new unsigned char[3 * num_points]);
+
+        #pragma omp parallel for num_threads(numThreads)
+        for(size_t i = 0; i < 3 * num_points; i++)
+        {
+            colors[i] = rgb[i] >> shift;
+        }
+        p_buffer->setColorArray(colors, num_points);
+    }
+
+    ModelPtr m_ptr( new Model(p_buffer));
+    m_model = m_ptr;
+
+    return m_ptr;
 }
 
 
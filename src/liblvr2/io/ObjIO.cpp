@@ -606,7 +606,8 @@ void ObjIO::save( string filename )
     {
         std::vector<Texture>& texts = m_model->m_mesh->getTextures();
 
-        for (size_t i = 0; i < texts.size(); i++)
+        #pragma omp parallel for schedule(dynamic)
+        for (long i = 0; i < (long)texts.size(); i++)
         {
             TextureFactory::saveTexture(texts[i], "texture_" + std::to_string(i) + textureImageExtension);
         }
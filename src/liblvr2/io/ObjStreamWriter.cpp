@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       ObjStreamWriter.cpp
+ * @brief      Incremental writer for Wavefront OBJ files (implementation).
+ */
+
+#include "lvr2/io/ObjStreamWriter.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <cstdio>
+
+namespace lvr2
+{
+
+ObjStreamWriter::ObjStreamWriter(const std::string& filename, const StreamSchema& schema,
+                                 size_t bufferSize)
+    : StreamWriter(schema),
+      m_bufferSize(bufferSize),
+      m_good(false),
+      m_closed(false)
+{
+    m_out.open(filename);
+    if (!m_out.good())
+    {
+        std::cerr << timestamp << "ObjStreamWriter: Could not create »" << filename << "«" << std::endl;
+        return;
+    }
+    m_buffer.reserve(m_bufferSize + 256);
+    m_good = true;
+}
+
+ObjStreamWriter::~ObjStreamWriter()
+{
+    close();
+}
+
+void ObjStreamWriter::flushIfFull()
+{
+    if (m_buffer.size() >= m_bufferSize)
+    {
+        m_out.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+    }
+}
+
+void ObjStreamWriter::addVertices(
+    size_t n,
+    const float* vertices,
+    const unsigned char* colors,
+    size_t colorWidth,
+    const float* normals,
+    const float* intensities)
+{
+    if (!m_good || m_closed || !vertices)
+    {
+        return;
+    }
+
+    char line[256];
+    for (size_t i = 0; i < n; i++)
+    {
+        int len = snprintf(line, sizeof(line), "v %.9g %.9g %.9g",
+                           vertices[3 * i], vertices[3 * i + 1], vertices[3 * i + 2]);
+        m_buffer.append(line, len);
+
+        if (m_schema.vertexColors)
+        {
+            float r = colors ? colors[colorWidth * i] / 255.0f : 0.0f;
+            float g = colors ? colors[colorWidth * i + 1] / 255.0f : 0.0f;
+            float b = colors ? colors[colorWidth * i + 2] / 255.0f : 0.0f;
+            len = snprintf(line, sizeof(line), " %g %g %g", r, g, b);
+            m_buffer.append(line, len);
+        }
+        m_buffer.push_back('\n');
+
+        if (m_schema.vertexNormals)
+        {
+            len = normals
+                ? snprintf(line, sizeof(line), "vn %.9g %.9g %.9g\n",
+                           normals[3 * i], normals[3 * i + 1], normals[3 * i + 2])
+                : snprintf(line, sizeof(line), "vn 0 0 0\n");
+            m_buffer.append(line, len);
+        }
+
+        flushIfFull();
+    }
+    m_numVertices += n;
+}
+
+void ObjStreamWriter::addFaces(size_t n, const unsigned int* indices, size_t indexOffset)
+{
+    if (!m_good || m_closed || !m_schema.faces || !indices)
+    {
+        return;
+    }
+
+    char line[128];
+    for (size_t i = 0; i < n; i++)
+    {
+        // OBJ indices start at 1
+        size_t a = indices[3 * i] + indexOffset + 1;
+        size_t b = indices[3 * i + 1] + indexOffset + 1;
+        size_t c = indices[3 * i + 2] + indexOffset + 1;
+
+        int len = m_schema.vertexNormals
+            ? snprintf(line, sizeof(line), "f %zu//%zu %zu//%zu %zu//%zu\n", a, a, b, b, c, c)
+            : snprintf(line, sizeof(line), "f %zu %zu %zu\n", a, b, c);
+        m_buffer.append(line, len);
+
+        flushIfFull();
+    }
+    m_numFaces += n;
+}
+
+void ObjStreamWriter::close()
+{
+    if (m_closed)
+    {
+        return;
+    }
+    m_closed = true;
+
+    if (m_good)
+    {
+        m_out.write(m_buffer.data(), m_buffer.size());
+        m_buffer.clear();
+        m_out.close();
+    }
+}
+
+} // namespace lvr2
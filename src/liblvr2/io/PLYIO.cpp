@@ -42,12 +42,14 @@
 #include "lvr2/io/PLYIO.hpp"
 #include "lvr2/io/Timestamp.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <ctime>
 #include <sstream>
 #include <fstream>
 
 #include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <opencv2/opencv.hpp>
 
 namespace lvr2
@@ -636,82 +638,156 @@ ModelPtr PLYIO::read( string filename, bool readColor, bool readConfidence,
     short*          point_panorama_coords    = pointPanoramaCoords.get();
 
 
-    /* Set callbacks. */
-    if ( vertex )
+    /* Try to read binary files directly. */
+    bool bodyRead = false;
+    if ( m_fastBinaryRead )
     {
-        ply_set_read_cb( ply, "vertex", "x", readVertexCb, &vertex, 0 );
-        ply_set_read_cb( ply, "vertex", "y", readVertexCb, &vertex, 0 );
-        ply_set_read_cb( ply, "vertex", "z", readVertexCb, &vertex, 1 );
-    }
-    if ( vertex_color )
-    {
-        ply_set_read_cb( ply, "vertex", "red",   readColorCb,  &vertex_color,  0 );
-        ply_set_read_cb( ply, "vertex", "green", readColorCb,  &vertex_color,  0 );
-        ply_set_read_cb( ply, "vertex", "blue",  readColorCb,  &vertex_color,  1 );
-    }
-    if ( vertex_confidence )
-    {
-        ply_set_read_cb( ply, "vertex", "confidence", readVertexCb, &vertex_confidence, 1 );
-    }
-    if ( vertex_intensity )
-    {
-        ply_set_read_cb( ply, "vertex", "intensity", readVertexCb, &vertex_intensity, 1 );
-    }
-    if ( vertex_normal )
-    {
-        ply_set_read_cb( ply, "vertex", "nx", readVertexCb, &vertex_normal, 0 );
-        ply_set_read_cb( ply, "vertex", "ny", readVertexCb, &vertex_normal, 0 );
-        ply_set_read_cb( ply, "vertex", "nz", readVertexCb, &vertex_normal, 1 );
-    }
-    if ( vertex_panorama_coords )
-    {
-        ply_set_read_cb( ply, "vertex", "x_coords", readPanoramaCoordCB, &vertex_panorama_coords, 0 );
-        ply_set_read_cb( ply, "vertex", "y_coords", readPanoramaCoordCB, &vertex_panorama_coords, 1 );
-    }
+        std::vector<BinaryTarget> targets;
+        if ( vertex )
+        {
+            targets.push_back( { "vertex", "x", PLY_FLOAT, vertex, 3, 0 } );
+            targets.push_back( { "vertex", "y", PLY_FLOAT, vertex, 3, 1 } );
+            targets.push_back( { "vertex", "z", PLY_FLOAT, vertex, 3, 2 } );
+        }
+        if ( vertex_color )
+        {
+            targets.push_back( { "vertex", "red",   PLY_UCHAR, vertex_color, 3, 0 } );
+            targets.push_back( { "vertex", "green", PLY_UCHAR, vertex_color, 3, 1 } );
+            targets.push_back( { "vertex", "blue",  PLY_UCHAR, vertex_color, 3, 2 } );
+        }
+        if ( vertex_confidence )
+        {
+            targets.push_back( { "vertex", "confidence", PLY_FLOAT, vertex_confidence, 1, 0 } );
+        }
+        if ( vertex_intensity )
+        {
+            targets.push_back( { "vertex", "intensity", PLY_FLOAT, vertex_intensity, 1, 0 } );
+        }
+        if ( vertex_normal )
+        {
+            targets.push_back( { "vertex", "nx", PLY_FLOAT, vertex_normal, 3, 0 } );
+            targets.push_back( { "vertex", "ny", PLY_FLOAT, vertex_normal, 3, 1 } );
+            targets.push_back( { "vertex", "nz", PLY_FLOAT, vertex_normal, 3, 2 } );
+        }
+        if ( vertex_panorama_coords )
+        {
+            targets.push_back( { "vertex", "x_coords", PLY_SHORT, vertex_panorama_coords, 2, 0 } );
+            targets.push_back( { "vertex", "y_coords", PLY_SHORT, vertex_panorama_coords, 2, 1 } );
+        }
+        if ( point )
+        {
+            targets.push_back( { "point", "x", PLY_FLOAT, point, 3, 0 } );
+            targets.push_back( { "point", "y", PLY_FLOAT, point, 3, 1 } );
+            targets.push_back( { "point", "z", PLY_FLOAT, point, 3, 2 } );
+        }
+        if ( point_color )
+        {
+            targets.push_back( { "point", "red",   PLY_UCHAR, point_color, 3, 0 } );
+            targets.push_back( { "point", "green", PLY_UCHAR, point_color, 3, 1 } );
+            targets.push_back( { "point", "blue",  PLY_UCHAR, point_color, 3, 2 } );
+        }
+        if ( point_confidence )
+        {
+            targets.push_back( { "point", "confidence", PLY_FLOAT, point_confidence, 1, 0 } );
+        }
+        if ( point_intensity )
+        {
+            targets.push_back( { "point", "intensity", PLY_FLOAT, point_intensity, 1, 0 } );
+        }
+        if ( point_normal )
+        {
+            targets.push_back( { "point", "nx", PLY_FLOAT, point_normal, 3, 0 } );
+            targets.push_back( { "point", "ny", PLY_FLOAT, point_normal, 3, 1 } );
+            targets.push_back( { "point", "nz", PLY_FLOAT, point_normal, 3, 2 } );
+        }
+        if ( point_panorama_coords )
+        {
+            targets.push_back( { "point", "x_coords", PLY_SHORT, point_panorama_coords, 2, 0 } );
+            targets.push_back( { "point", "y_coords", PLY_SHORT, point_panorama_coords, 2, 1 } );
+        }
 
-    if ( face )
-    {
-        ply_set_read_cb( ply, "face", "vertex_indices", readFaceCb, &face, 0 );
-        ply_set_read_cb( ply, "face", "vertex_index", readFaceCb, &face, 0 );
+        bodyRead = readBinary( ply, filename, targets, face );
     }
 
-    if ( point )
-    {
-        ply_set_read_cb( ply, "point", "x", readVertexCb, &point, 0 );
-        ply_set_read_cb( ply, "point", "y", readVertexCb, &point, 0 );
-        ply_set_read_cb( ply, "point", "z", readVertexCb, &point, 1 );
-    }
-    if ( point_color )
-    {
-        ply_set_read_cb( ply, "point", "red",   readColorCb,  &point_color,  0 );
-        ply_set_read_cb( ply, "point", "green", readColorCb,  &point_color,  0 );
-        ply_set_read_cb( ply, "point", "blue",  readColorCb,  &point_color,  1 );
-    }
-    if ( point_confidence )
-    {
-        ply_set_read_cb( ply, "point", "confidence", readVertexCb, &point_confidence, 1 );
-    }
-    if ( point_intensity )
-    {
-        ply_set_read_cb( ply, "point", "intensity", readVertexCb, &point_intensity, 1 );
-    }
-    if ( point_normal )
-    {
-        ply_set_read_cb( ply, "point", "nx", readVertexCb, &point_normal, 0 );
-        ply_set_read_cb( ply, "point", "ny", readVertexCb, &point_normal, 0 );
-        ply_set_read_cb( ply, "point", "nz", readVertexCb, &point_normal, 1 );
-    }
-    if ( point_panorama_coords )
+    if ( !bodyRead )
     {
-        ply_set_read_cb( ply, "point", "x_coords", readPanoramaCoordCB, &point_panorama_coords, 0 );
-        ply_set_read_cb( ply, "point", "y_coords", readPanoramaCoordCB, &point_panorama_coords, 1 );
-    }
+        /* Set callbacks. */
+        if ( vertex )
+        {
+            ply_set_read_cb( ply, "vertex", "x", readVertexCb, &vertex, 0 );
+            ply_set_read_cb( ply, "vertex", "y", readVertexCb, &vertex, 0 );
+            ply_set_read_cb( ply, "vertex", "z", readVertexCb, &vertex, 1 );
+        }
+        if ( vertex_color )
+        {
+            ply_set_read_cb( ply, "vertex", "red",   readColorCb,  &vertex_color,  0 );
+            ply_set_read_cb( ply, "vertex", "green", readColorCb,  &vertex_color,  0 );
+            ply_set_read_cb( ply, "vertex", "blue",  readColorCb,  &vertex_color,  1 );
+        }
+        if ( vertex_confidence )
+        {
+            ply_set_read_cb( ply, "vertex", "confidence", readVertexCb, &vertex_confidence, 1 );
+        }
+        if ( vertex_intensity )
+        {
+            ply_set_read_cb( ply, "vertex", "intensity", readVertexCb, &vertex_intensity, 1 );
+        }
+        if ( vertex_normal )
+        {
+            ply_set_read_cb( ply, "vertex", "nx", readVertexCb, &vertex_normal, 0 );
+            ply_set_read_cb( ply, "vertex", "ny", readVertexCb, &vertex_normal, 0 );
+            ply_set_read_cb( ply, "vertex", "nz", readVertexCb, &vertex_normal, 1 );
+        }
+        if ( vertex_panorama_coords )
+        {
+            ply_set_read_cb( ply, "vertex", "x_coords", readPanoramaCoordCB, &vertex_panorama_coords, 0 );
+            ply_set_read_cb( ply, "vertex", "y_coords", readPanoramaCoordCB, &vertex_panorama_coords, 1 );
+        }
 
-    /* Read ply file. */
-    if ( !ply_read( ply ) )
-    {
-        std::cerr << timestamp << "Could not read »" << filename << "«."
-            << std::endl;
+        if ( face )
+        {
+            ply_set_read_cb( ply, "face", "vertex_indices", readFaceCb, &face, 0 );
+            ply_set_read_cb( ply, "face", "vertex_index", readFaceCb, &face, 0 );
+        }
+
+        if ( point )
+        {
+            ply_set_read_cb( ply, "point", "x", readVertexCb, &point, 0 );
+            ply_set_read_cb( ply, "point", "y", readVertexCb, &point, 0 );
+            ply_set_read_cb( ply, "point", "z", readVertexCb, &point, 1 );
+        }
+        if ( point_color )
+        {
+            ply_set_read_cb( ply, "point", "red",   readColorCb,  &point_color,  0 );
+            ply_set_read_cb( ply, "point", "green", readColorCb,  &point_color,  0 );
+            ply_set_read_cb( ply, "point", "blue",  readColorCb,  &point_color,  1 );
+        }
+        if ( point_confidence )
+        {
+            ply_set_read_cb( ply, "point", "confidence", readVertexCb, &point_confidence, 1 );
+        }
+        if ( point_intensity )
+        {
+            ply_set_read_cb( ply, "point", "intensity", readVertexCb, &point_intensity, 1 );
+        }
+        if ( point_normal )
+        {
+            ply_set_read_cb( ply, "point", "nx", readVertexCb, &point_normal, 0 );
+            ply_set_read_cb( ply, "point", "ny", readVertexCb, &point_normal, 0 );
+            ply_set_read_cb( ply, "point", "nz", readVertexCb, &point_normal, 1 );
+        }
+        if ( point_panorama_coords )
+        {
+            ply_set_read_cb( ply, "point", "x_coords", readPanoramaCoordCB, &point_panorama_coords, 0 );
+            ply_set_read_cb( ply, "point", "y_coords", readPanoramaCoordCB, &point_panorama_coords, 1 );
+        }
+
+        /* Read ply file. */
+        if ( !ply_read( ply ) )
+        {
+            std::cerr << timestamp << "Could not read »" << filename << "«."
+                << std::endl;
+        }
     }
 
     /* Check if we got only vertices and neither points nor faces. If that is
@@ -979,4 +1055,295 @@ int PLYIO::readPanoramaCoordCB( p_ply_argument argument )
 
 }
 
+namespace
+{
+
+/**
+ * @brief   Calls f with a value of the C++ type matching the given
+ *          PLY type. Returns false for unknown types.
+ */
+template<typename Func>
+bool dispatchPlyType( e_ply_type type, Func&& f )
+{
+    switch ( type )
+    {
+        case PLY_INT8:    case PLY_CHAR:   f( int8_t() );   return true;
+        case PLY_UINT8:   case PLY_UCHAR:  f( uint8_t() );  return true;
+        case PLY_INT16:   case PLY_SHORT:  f( int16_t() );  return true;
+        case PLY_UINT16:  case PLY_USHORT: f( uint16_t() ); return true;
+        case PLY_INT32:   case PLY_INT:    f( int32_t() );  return true;
+        case PLY_UIN32:   case PLY_UINT:   f( uint32_t() ); return true;
+        case PLY_FLOAT32: case PLY_FLOAT:  f( float() );    return true;
+        case PLY_FLOAT64: case PLY_DOUBLE: f( double() );   return true;
+        default: return false;
+    }
+}
+
+size_t plyTypeSize( e_ply_type type )
+{
+    size_t size = 0;
+    dispatchPlyType( type, [&size]( auto v ) { size = sizeof( v ); } );
+    return size;
+}
+
+/**
+ * @brief   Reads a possibly unaligned value of type T and swaps its
+ *          byte order if requested.
+ */
+template<typename T>
+inline T readValue( const char* p, bool swapBytes )
+{
+    T value;
+    if ( swapBytes )
+    {
+        char bytes[sizeof( T )];
+        std::reverse_copy( p, p + sizeof( T ), bytes );
+        std::memcpy( &value, bytes, sizeof( T ) );
+    }
+    else
+    {
+        std::memcpy( &value, p, sizeof( T ) );
+    }
+    return value;
+}
+
+/**
+ * @brief   Copies one property of n records with the given stride into
+ *          a buffer with width components per entry.
+ */
+template<typename SrcT, typename DstT>
+void deinterleave( const char* body, size_t n, size_t stride, size_t offset,
+        bool swapBytes, DstT* dst, size_t width, size_t component )
+{
+    const char* src = body + offset;
+
+    #pragma omp parallel for schedule(static)
+    for ( size_t i = 0; i < n; i++ )
+    {
+        dst[i * width + component] =
+            static_cast<DstT>( readValue<SrcT>( src + i * stride, swapBytes ) );
+    }
+}
+
+/// Layout information of a PLY element in a binary file
+struct BinaryElement
+{
+    string          name;
+    size_t          count;
+    size_t          stride;
+    size_t          offset;
+    p_ply_element   element;
+};
+
+bool hostIsLittleEndian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const uint8_t*>( &one ) == 1;
+}
+
+} // namespace
+
+
+bool PLYIO::readBinary( p_ply ply, const string& filename,
+        const std::vector<BinaryTarget>& targets, unsigned int* faces )
+{
+    boost::iostreams::mapped_file_source file;
+    try
+    {
+        file.open( filename );
+    }
+    catch ( std::exception& e )
+    {
+        return false;
+    }
+
+    const char* data = file.data();
+    const size_t size = file.size();
+
+    /* Find the storage mode and the end of the header. RPly already parsed
+     * the header, but does not expose these. */
+    const char marker[] = "end_header";
+    const char* end = std::search( data, data + size, marker, marker + sizeof( marker ) - 1 );
+    if ( end == data + size )
+    {
+        return false;
+    }
+    const string header( data, end );
+    const char* body = static_cast<const char*>( std::memchr( end, '\n', data + size - end ) );
+    if ( !body )
+    {
+        return false;
+    }
+    body++;
+
+    bool swapBytes;
+    if ( header.find( "format binary_little_endian" ) != string::npos )
+    {
+        swapBytes = !hostIsLittleEndian();
+    }
+    else if ( header.find( "format binary_big_endian" ) != string::npos )
+    {
+        swapBytes = hostIsLittleEndian();
+    }
+    else
+    {
+        /* ASCII files are handled by RPly */
+        return false;
+    }
+
+    /* Compute the record stride of all elements. Only triangle faces
+     * are allowed to contain a list property. */
+    std::vector<BinaryElement> elements;
+    size_t offset = 0;
+    p_ply_element elem = NULL;
+    while ( ( elem = ply_get_next_element( ply, elem ) ) )
+    {
+        const char* elemName;
+        long int n;
+        ply_get_element_info( elem, &elemName, &n );
+
+        BinaryElement e{ elemName, static_cast<size_t>( n ), 0, offset, elem };
+
+        int numLists = 0;
+        p_ply_property prop = NULL;
+        while ( ( prop = ply_get_next_property( elem, prop ) ) )
+        {
+            const char* propName;
+            e_ply_type type, lengthType, valueType;
+            ply_get_property_info( prop, &propName, &type, &lengthType, &valueType );
+            if ( type == PLY_LIST )
+            {
+                if ( e.name != "face" || ++numLists > 1 )
+                {
+                    return false;
+                }
+                e.stride += plyTypeSize( lengthType ) + 3 * plyTypeSize( valueType );
+            }
+            else
+            {
+                e.stride += plyTypeSize( type );
+            }
+        }
+        offset += e.count * e.stride;
+        elements.push_back( e );
+    }
+
+    if ( body + offset > data + size )
+    {
+        return false;
+    }
+
+    /* Check that all faces are triangles before touching any buffer. */
+    for ( const BinaryElement& e : elements )
+    {
+        if ( e.name != "face" )
+        {
+            continue;
+        }
+
+        size_t propOffset = 0;
+        p_ply_property prop = NULL;
+        while ( ( prop = ply_get_next_property( e.element, prop ) ) )
+        {
+            const char* propName;
+            e_ply_type type, lengthType, valueType;
+            ply_get_property_info( prop, &propName, &type, &lengthType, &valueType );
+            if ( type != PLY_LIST )
+            {
+                propOffset += plyTypeSize( type );
+                continue;
+            }
+
+            const char* src = body + e.offset + propOffset;
+            long int nonTriangles = 0;
+            dispatchPlyType( lengthType, [&]( auto v )
+            {
+                using LengthT = decltype( v );
+                #pragma omp parallel for reduction(+:nonTriangles)
+                for ( size_t i = 0; i < e.count; i++ )
+                {
+                    if ( readValue<LengthT>( src + i * e.stride, swapBytes ) != 3 )
+                    {
+                        nonTriangles++;
+                    }
+                }
+            } );
+
+            if ( nonTriangles )
+            {
+                return false;
+            }
+
+            const bool isIndexList = !strcmp( propName, "vertex_indices" )
+                || !strcmp( propName, "vertex_index" );
+            if ( faces && isIndexList )
+            {
+                const char* indices = src + plyTypeSize( lengthType );
+                dispatchPlyType( valueType, [&]( auto v )
+                {
+                    using IndexT = decltype( v );
+                    for ( size_t k = 0; k < 3; k++ )
+                    {
+                        deinterleave<IndexT>( indices + k * sizeof( IndexT ), e.count,
+                                e.stride, 0, swapBytes, faces, 3, k );
+                    }
+                } );
+            }
+            propOffset += plyTypeSize( lengthType ) + 3 * plyTypeSize( valueType );
+        }
+    }
+
+    /* De-interleave the requested scalar properties. */
+    for ( const BinaryElement& e : elements )
+    {
+        size_t propOffset = 0;
+        p_ply_property prop = NULL;
+        while ( ( prop = ply_get_next_property( e.element, prop ) ) )
+        {
+            const char* propName;
+            e_ply_type type, lengthType, valueType;
+            ply_get_property_info( prop, &propName, &type, &lengthType, &valueType );
+            if ( type == PLY_LIST )
+            {
+                propOffset += plyTypeSize( lengthType ) + 3 * plyTypeSize( valueType );
+                continue;
+            }
+
+            for ( const BinaryTarget& t : targets )
+            {
+                if ( e.name != t.element || strcmp( propName, t.property ) )
+                {
+                    continue;
+                }
+
+                dispatchPlyType( type, [&]( auto v )
+                {
+                    using SrcT = decltype( v );
+                    const char* src = body + e.offset;
+                    switch ( t.type )
+                    {
+                        case PLY_FLOAT:
+                            deinterleave<SrcT>( src, e.count, e.stride, propOffset, swapBytes,
+                                    static_cast<float*>( t.data ), t.width, t.component );
+                            break;
+                        case PLY_UCHAR:
+                            deinterleave<SrcT>( src, e.count, e.stride, propOffset, swapBytes,
+                                    static_cast<uint8_t*>( t.data ), t.width, t.component );
+                            break;
+                        case PLY_SHORT:
+                            deinterleave<SrcT>( src, e.count, e.stride, propOffset, swapBytes,
+                                    static_cast<short*>( t.data ), t.width, t.component );
+                            break;
+                        default:
+                            break;
+                    }
+                } );
+            }
+            propOffset += plyTypeSize( type );
+        }
+    }
+
+    return true;
+}
+
 } // namespace lvr2
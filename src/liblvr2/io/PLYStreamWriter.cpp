@@ -0,0 +1,286 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       PLYStreamWriter.cpp
+ * @brief      Incremental writer for binary PLY files (implementation).
+ */
+
+#include "lvr2/io/PLYStreamWriter.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace lvr2
+{
+
+namespace
+{
+
+/// Width of the zero padded element counts in the header
+const int countWidth = 20;
+
+bool hostIsLittleEndian()
+{
+    const uint16_t one = 1;
+    return *reinterpret_cast<const uint8_t*>(&one) == 1;
+}
+
+template<typename T>
+inline char* put(char* ptr, T value)
+{
+    std::memcpy(ptr, &value, sizeof(T));
+    return ptr + sizeof(T);
+}
+
+} // namespace
+
+PLYStreamWriter::PLYStreamWriter(const std::string& filename, const StreamSchema& schema,
+                                 size_t bufferSize)
+    : StreamWriter(schema),
+      m_filename(filename),
+      m_faceFilename(filename + ".faces.tmp"),
+      m_bufferSize(bufferSize),
+      m_good(false),
+      m_closed(false)
+{
+    m_vertexSize = 3 * sizeof(float);
+    if (m_schema.vertexColors)
+    {
+        m_vertexSize += 3 * sizeof(unsigned char);
+    }
+    if (m_schema.vertexNormals)
+    {
+        m_vertexSize += 3 * sizeof(float);
+    }
+    if (m_schema.vertexIntensities)
+    {
+        m_vertexSize += sizeof(float);
+    }
+
+    m_out.open(m_filename, std::ios::binary);
+    if (!m_out.good())
+    {
+        std::cerr << timestamp << "PLYStreamWriter: Could not create »" << m_filename << "«" << std::endl;
+        return;
+    }
+
+    if (m_schema.faces)
+    {
+        m_faceOut.open(m_faceFilename, std::ios::binary);
+        if (!m_faceOut.good())
+        {
+            std::cerr << timestamp << "PLYStreamWriter: Could not create »" << m_faceFilename << "«" << std::endl;
+            m_out.close();
+            boost::filesystem::remove(m_filename);
+            return;
+        }
+    }
+
+    m_vertexBuffer.reserve(m_bufferSize + m_vertexSize);
+    m_faceBuffer.reserve(m_schema.faces ? m_bufferSize : 0);
+
+    writeHeader();
+    m_good = true;
+}
+
+PLYStreamWriter::~PLYStreamWriter()
+{
+    close();
+}
+
+void PLYStreamWriter::writeHeader()
+{
+    std::stringstream header;
+    header << "ply\n";
+    // Records are written in host byte order, so declare it
+    header << (hostIsLittleEndian() ? "format binary_little_endian 1.0\n" : "format binary_big_endian 1.0\n");
+    header << "comment written by lvr2\n";
+    header << "element vertex " << std::setfill('0') << std::setw(countWidth) << m_numVertices << "\n";
+    header << "property float x\n";
+    header << "property float y\n";
+    header << "property float z\n";
+    if (m_schema.vertexColors)
+    {
+        header << "property uchar red\n";
+        header << "property uchar green\n";
+        header << "property uchar blue\n";
+    }
+    if (m_schema.vertexNormals)
+    {
+        header << "property float nx\n";
+        header << "property float ny\n";
+        header << "property float nz\n";
+    }
+    if (m_schema.vertexIntensities)
+    {
+        header << "property float intensity\n";
+    }
+    if (m_schema.faces)
+    {
+        header << "element face " << std::setfill('0') << std::setw(countWidth) << m_numFaces << "\n";
+        header << "property list uchar int vertex_indices\n";
+    }
+    header << "end_header\n";
+
+    const std::string str = header.str();
+    m_out.write(str.data(), str.size());
+}
+
+void PLYStreamWriter::flush(std::vector<char>& buffer, std::ofstream& out)
+{
+    if (!buffer.empty())
+    {
+        out.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+}
+
+void PLYStreamWriter::addVertices(
+    size_t n,
+    const float* vertices,
+    const unsigned char* colors,
+    size_t colorWidth,
+    const float* normals,
+    const float* intensities)
+{
+    if (!m_good || m_closed || !vertices)
+    {
+        return;
+    }
+
+    const unsigned char noColor[3] = {0, 0, 0};
+    const float noNormal[3] = {0.0f, 0.0f, 0.0f};
+
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t pos = m_vertexBuffer.size();
+        m_vertexBuffer.resize(pos + m_vertexSize);
+        char* ptr = m_vertexBuffer.data() + pos;
+
+        std::memcpy(ptr, vertices + 3 * i, 3 * sizeof(float));
+        ptr += 3 * sizeof(float);
+
+        if (m_schema.vertexColors)
+        {
+            std::memcpy(ptr, colors ? colors + colorWidth * i : noColor, 3);
+            ptr += 3;
+        }
+        if (m_schema.vertexNormals)
+        {
+            std::memcpy(ptr, normals ? normals + 3 * i : noNormal, 3 * sizeof(float));
+            ptr += 3 * sizeof(float);
+        }
+        if (m_schema.vertexIntensities)
+        {
+            ptr = put(ptr, intensities ? intensities[i] : 0.0f);
+        }
+
+        if (m_vertexBuffer.size() >= m_bufferSize)
+        {
+            flush(m_vertexBuffer, m_out);
+        }
+    }
+    m_numVertices += n;
+}
+
+void PLYStreamWriter::addFaces(size_t n, const unsigned int* indices, size_t indexOffset)
+{
+    if (!m_good || m_closed || !m_schema.faces || !indices)
+    {
+        return;
+    }
+
+    const size_t faceSize = sizeof(uint8_t) + 3 * sizeof(int32_t);
+    for (size_t i = 0; i < n; i++)
+    {
+        size_t pos = m_faceBuffer.size();
+        m_faceBuffer.resize(pos + faceSize);
+        char* ptr = m_faceBuffer.data() + pos;
+
+        ptr = put(ptr, static_cast<uint8_t>(3));
+        for (size_t k = 0; k < 3; k++)
+        {
+            ptr = put(ptr, static_cast<int32_t>(indices[3 * i + k] + indexOffset));
+        }
+
+        if (m_faceBuffer.size() >= m_bufferSize)
+        {
+            flush(m_faceBuffer, m_faceOut);
+        }
+    }
+    m_numFaces += n;
+}
+
+void PLYStreamWriter::close()
+{
+    if (m_closed)
+    {
+        return;
+    }
+    m_closed = true;
+
+    if (!m_good)
+    {
+        return;
+    }
+
+    flush(m_vertexBuffer, m_out);
+
+    // Append buffered faces after all vertices
+    if (m_schema.faces)
+    {
+        flush(m_faceBuffer, m_faceOut);
+        m_faceOut.close();
+
+        std::ifstream faces(m_faceFilename, std::ios::binary);
+        std::vector<char> chunk(m_bufferSize);
+        while (faces.read(chunk.data(), chunk.size()) || faces.gcount() > 0)
+        {
+            m_out.write(chunk.data(), faces.gcount());
+        }
+        faces.close();
+        boost::filesystem::remove(m_faceFilename);
+    }
+
+    // Patch element counts. The zero padded header keeps its size.
+    m_out.seekp(0);
+    writeHeader();
+    m_out.close();
+
+    if (!m_out)
+    {
+        std::cerr << timestamp << "PLYStreamWriter: Error while writing »" << m_filename << "«" << std::endl;
+    }
+}
+
+} // namespace lvr2
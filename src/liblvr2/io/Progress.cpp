@@ -35,6 +35,7 @@
 
 #include "lvr2/io/Progress.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <iostream>
 
@@ -46,15 +47,29 @@ using std::flush;
 namespace lvr2
 {
 
+namespace
+{
+
+/// Index of the per thread counter used by the calling thread
+size_t shardIndex()
+{
+    static std::atomic<size_t> numThreads(0);
+    thread_local size_t index = numThreads++;
+    return index;
+}
+
+} // namespace
+
 ProgressCallbackPtr ProgressBar::m_progressCallback = 0;
 ProgressTitleCallbackPtr ProgressBar::m_titleCallback = 0;
 
 ProgressBar::ProgressBar(size_t max_val, string prefix)
+    : m_currentVal(0), m_shards(new Shard[NumShards]), m_percent(0)
 {
 	m_prefix = prefix;
 	m_maxVal = max_val;
-    m_currentVal = 0;
-	m_percent = 0;
+	m_flushStep = std::max<size_t>(1, m_maxVal / (NumShards * 200));
+	m_flushLimit = m_maxVal > NumShards * m_flushStep ? m_maxVal - NumShards * m_flushStep : 0;
 
 	if(m_titleCallback)
 	{
@@ -82,79 +97,82 @@ void ProgressBar::setProgressTitleCallback(ProgressTitleCallbackPtr ptr)
 
 void ProgressBar::operator++()
 {
-    boost::mutex::scoped_lock lock(m_mutex);
+    *this += 1;
+}
 
-    m_currentVal++;
-    short difference = (short)((float)m_currentVal/m_maxVal * 100 - m_percent);
-    if (difference < 1)
+void ProgressBar::operator+=(size_t n)
+{
+    size_t shard = shardIndex() % NumShards;
+    size_t pending = m_shards[shard].count.fetch_add(n, std::memory_order_relaxed) + n;
+    if (pending < m_flushStep && m_currentVal.load(std::memory_order_relaxed) < m_flushLimit)
     {
         return;
     }
+    update(shard);
+}
 
-    while (difference >= 1)
-    {
-        m_percent++;
-        difference--;
-        print_bar();
+void ProgressBar::update(size_t shard)
+{
+    size_t pending = m_shards[shard].count.exchange(0, std::memory_order_relaxed);
+    size_t total = m_currentVal.fetch_add(pending, std::memory_order_relaxed) + pending;
 
-        if(m_progressCallback)
+    if (total >= m_flushLimit)
+    {
+        // Collect what the other threads counted since their last flush
+        pending = 0;
+        for (size_t i = 0; i < NumShards; i++)
         {
-        	m_progressCallback(m_percent);
+            if (m_shards[i].count.load(std::memory_order_relaxed))
+            {
+                pending += m_shards[i].count.exchange(0, std::memory_order_relaxed);
+            }
         }
+        total = m_currentVal.fetch_add(pending, std::memory_order_relaxed) + pending;
     }
 
-}
-
-void ProgressBar::operator+=(size_t n)
-{
-    boost::mutex::scoped_lock lock(m_mutex);
-
-    m_currentVal+= n;
-    short difference = (short)((float)m_currentVal/m_maxVal * 100 - m_percent);
-    if (difference < 1)
+    int percent = m_maxVal ? (int)std::min<size_t>(100, total * 100 / m_maxVal) : 100;
+    if (percent <= m_percent.load(std::memory_order_relaxed))
     {
         return;
     }
 
-    while (difference >= 1)
+    std::lock_guard<std::mutex> lock(m_printMutex);
+    while (m_percent < percent)
     {
         m_percent++;
-        difference--;
         print_bar();
 
         if(m_progressCallback)
         {
-            m_progressCallback(m_percent);
+        	m_progressCallback(m_percent);
         }
     }
-
 }
 
 void ProgressBar::print_bar()
 {
-	cout <<  "\r" << m_prefix << " " << m_percent << "%" << flush;
+	cout <<  "\r" << m_prefix << " " << m_percent.load() << "%" << flush;
 }
 
 ProgressCounter::ProgressCounter(int stepVal, string prefix)
+    : m_currentVal(0)
 {
 	m_prefix = prefix;
 	m_stepVal = stepVal;
-	m_currentVal = 0;
 }
 
 void ProgressCounter::operator++()
 {
-	boost::mutex::scoped_lock lock(m_mutex);
-	m_currentVal++;
-	if(m_currentVal % m_stepVal == 0)
+	size_t value = ++m_currentVal;
+	if(value % m_stepVal == 0)
 	{
-		print_progress();
+		print_progress(value);
 	}
 }
 
-void ProgressCounter::print_progress()
+void ProgressCounter::print_progress(size_t value)
 {
-	cout << "\r" << m_prefix << " " << m_currentVal << flush;
+	cout << "\r" << m_prefix << " " << value << flush;
 }
 
 PacmanProgressCallbackPtr PacmanProgressBar::m_progressCallback = 0;
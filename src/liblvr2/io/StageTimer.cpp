@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * StageTimer.cpp
+ */
+
+#include "lvr2/io/StageTimer.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+#if defined(_MSC_VER)
+#include <Windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace lvr2
+{
+
+namespace
+{
+
+/// Indices of the stages that are running on this thread, innermost last
+thread_local std::vector<size_t> openStages;
+
+std::string escapeJSON(const std::string& s)
+{
+    std::string escaped;
+    for(char c : s)
+    {
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+/// Quotes inside a quoted CSV field are doubled
+std::string escapeCSV(const std::string& s)
+{
+    std::string escaped;
+    for(char c : s)
+    {
+        if(c == '"')
+        {
+            escaped += '"';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // namespace
+
+StageReport::StageReport()
+    : m_start(std::chrono::steady_clock::now())
+{
+}
+
+StageReport& StageReport::instance()
+{
+    static StageReport report;
+    return report;
+}
+
+double StageReport::wallTime() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+size_t StageReport::begin(const std::string& name)
+{
+    StageRecord record;
+    record.depth = openStages.size();
+    record.start = wallTime();
+    record.wallTime = -1;
+    record.cpuTime = -1;
+    record.peakRSS = 0;
+    double cpu = processCPUTime();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    record.name = openStages.empty() ? name : m_records[openStages.back()].name + "/" + name;
+    m_records.push_back(record);
+    m_cpuStart.push_back(cpu);
+    openStages.push_back(m_records.size() - 1);
+    return m_records.size() - 1;
+}
+
+void StageReport::end(size_t index)
+{
+    double wall = wallTime();
+    double cpu = processCPUTime();
+    long rss = processPeakRSS();
+
+    auto it = std::find(openStages.begin(), openStages.end(), index);
+    if(it != openStages.end())
+    {
+        openStages.erase(it);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(index < m_records.size())
+    {
+        StageRecord& record = m_records[index];
+        record.wallTime = wall - record.start;
+        record.cpuTime = cpu - m_cpuStart[index];
+        record.peakRSS = rss;
+    }
+}
+
+std::vector<StageRecord> StageReport::records() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_records;
+}
+
+bool StageReport::save(const std::string& filename) const
+{
+    std::ofstream out(filename);
+    if(!out.good())
+    {
+        return false;
+    }
+
+    bool csv = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".csv") == 0;
+    if(csv)
+    {
+        writeCSV(out);
+    }
+    else
+    {
+        writeJSON(out);
+    }
+    return out.good();
+}
+
+void StageReport::writeJSON(std::ostream& os) const
+{
+    std::vector<StageRecord> stages = records();
+
+    os << std::fixed << std::setprecision(6) << "[" << std::endl;
+    for(size_t i = 0; i < stages.size(); i++)
+    {
+        const StageRecord& r = stages[i];
+        os << "  {\"name\": \"" << escapeJSON(r.name) << "\", \"depth\": " << r.depth
+           << ", \"start_s\": " << r.start << ", \"wall_s\": " << r.wallTime
+           << ", \"cpu_s\": " << r.cpuTime << ", \"peak_rss_kb\": " << r.peakRSS << "}"
+           << (i + 1 < stages.size() ? "," : "") << std::endl;
+    }
+    os << "]" << std::endl;
+}
+
+void StageReport::writeCSV(std::ostream& os) const
+{
+    std::vector<StageRecord> stages = records();
+
+    os << std::fixed << std::setprecision(6);
+    os << "name,depth,start_s,wall_s,cpu_s,peak_rss_kb" << std::endl;
+    for(const StageRecord& r : stages)
+    {
+        os << "\"" << escapeCSV(r.name) << "\"," << r.depth << "," << r.start << "," << r.wallTime << ","
+           << r.cpuTime << "," << r.peakRSS << std::endl;
+    }
+}
+
+double StageReport::processCPUTime()
+{
+#if defined(_MSC_VER)
+    FILETIME creation, exit, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+    {
+        return 0;
+    }
+    auto toSeconds = [](const FILETIME& t)
+    {
+        return ((static_cast<unsigned long long>(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7;
+    };
+    return toSeconds(kernel) + toSeconds(user);
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6
+         + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#endif
+}
+
+long StageReport::processPeakRSS()
+{
+#if defined(_MSC_VER)
+    return 0;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#if defined(__APPLE__)
+    // bytes on macOS
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+StageTimer::StageTimer(const std::string& name)
+    : m_index(StageReport::instance().begin(name)), m_running(true)
+{
+}
+
+StageTimer::~StageTimer()
+{
+    stop();
+}
+
+void StageTimer::stop()
+{
+    if(m_running)
+    {
+        m_running = false;
+        StageReport::instance().end(m_index);
+    }
+}
+
+} // namespace lvr2
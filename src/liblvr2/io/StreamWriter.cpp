@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file       StreamWriter.cpp
+ * @brief      Convenience functions of the stream writer interface.
+ */
+
+#include "lvr2/io/StreamWriter.hpp"
+
+namespace lvr2
+{
+
+void StreamWriter::addPoints(PointBufferPtr points)
+{
+    if (!points || !points->numPoints())
+    {
+        return;
+    }
+
+    size_t n = points->numPoints();
+    size_t w_color = 3;
+    size_t numIntensities = 0;
+    size_t w_intensities = 0;
+
+    floatArr vertices = points->getPointArray();
+    ucharArr colors = points->getColorArray(w_color);
+    floatArr normals = points->getNormalArray();
+    floatArr intensities = points->getFloatArray("intensities", numIntensities, w_intensities);
+
+    addVertices(n, vertices.get(), colors.get(), w_color, normals.get(),
+                numIntensities == n ? intensities.get() : nullptr);
+}
+
+void StreamWriter::addMesh(MeshBufferPtr mesh)
+{
+    if (!mesh || !mesh->numVertices())
+    {
+        return;
+    }
+
+    size_t n = mesh->numVertices();
+    size_t w_color = 3;
+    size_t numIntensities = 0;
+    size_t w_intensities = 0;
+    size_t offset = m_numVertices;
+
+    floatArr vertices = mesh->getVertices();
+    ucharArr colors = mesh->getVertexColors(w_color);
+    floatArr normals = mesh->getVertexNormals();
+    floatArr intensities = mesh->getFloatArray("vertex_intensities", numIntensities, w_intensities);
+
+    addVertices(n, vertices.get(), colors.get(), w_color, normals.get(),
+                numIntensities == n ? intensities.get() : nullptr);
+
+    indexArray faces = mesh->getFaceIndices();
+    if (faces)
+    {
+        addFaces(mesh->numFaces(), faces.get(), offset);
+    }
+}
+
+} // namespace lvr2
@@ -99,6 +99,11 @@ YAML::Node loadMetaInformation(const std::string &in)
 
         boost::filesystem::path framesPath(inPath.stem().string() + ".frames");
         boost::filesystem::path framesInPath = inPath.parent_path() / framesPath;
+        if (!boost::filesystem::exists(framesInPath))
+        {
+            // Fall back to the binary frames format
+            framesInPath.replace_extension(".bframes");
+        }
         if (boost::filesystem::exists(framesInPath))
         {
             std::cout << timestamp
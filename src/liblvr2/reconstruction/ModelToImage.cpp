@@ -34,13 +34,13 @@
 
 #include "lvr2/reconstruction/ModelToImage.hpp"
 #include "lvr2/reconstruction/Projection.hpp"
-#include "lvr2/io/Progress.hpp"
 #include "lvr2/io/Timestamp.hpp"
 #include "lvr2/geometry/BaseVector.hpp"
 
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <limits>
 #include <list>
 using namespace std;
 
@@ -79,6 +79,9 @@ ModelToImage::ModelToImage(
                 minVerticalAngle, maxVerticalAngle,
                 imageOptimization, system);
 
+    // The projection may adapt the image size to the field of view
+    m_width = m_projection->w();
+    m_height = m_projection->h();
 }
 
 
@@ -88,104 +91,184 @@ ModelToImage::~ModelToImage()
     // TODO Auto-generated destructor stub
 }
 
-void ModelToImage::computeDepthListMatrix(DepthListMatrix& mat)
+void ModelToImage::computeDepthListIndex(DepthListIndex& index)
 {
-    cout << timestamp << "Initializting DepthListMatrix with dimensions " << m_width << " x " << m_height << endl;
-    // Set correct image width and height
-    for(int i = 0; i < m_height; i++)
-    {
-        mat.pixels.emplace_back(vector<vector<PanoramaPoint> >());
-        for(int j = 0; j < m_width; j++)
-        {
-            mat.pixels[i].push_back(vector<PanoramaPoint>());
-        }
-    }
+    cout << timestamp << "Initializting DepthListIndex with dimensions " << m_width << " x " << m_height << endl;
 
     // Get point array and size from buffer
     size_t n_points = m_points->numPoints();
     floatArr points = m_points->getPointArray();
 
-    // Create progress output
-    string comment = timestamp.getElapsedTime() + "Projecting points ";
-    ProgressBar progress(n_points, comment);
+    const size_t n_pixels = (size_t)m_width * m_height;
+    const size_t no_pixel = std::numeric_limits<size_t>::max();
 
-    float range;
-    int img_x, img_y;
-    for(int i = 0; i < n_points; i++)
-    {        
-        Vec ppt(points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+    index.width = m_width;
+    index.height = m_height;
+    index.offsets.assign(n_pixels + 1, 0);
 
+    // Assign each point to its pixel
+    vector<size_t> pixel(n_points);
+    vector<float> ranges(n_points);
+
+    float minRange = index.minRange;
+    float maxRange = index.maxRange;
+
+    #pragma omp parallel for reduction(min:minRange) reduction(max:maxRange)
+    for(size_t i = 0; i < n_points; i++)
+    {
+        pixel[i] = no_pixel;
+        ranges[i] = 0.0f;
+
+        // Scanners store missing measurements at the origin. They have no
+        // direction and would all end up in pixel (0, 0).
+        if(points[3 * i] == 0.0f && points[3 * i + 1] == 0.0f && points[3 * i + 2] == 0.0f)
+        {
+            continue;
+        }
+
+        float range = 0.0f;
+        int img_x = 0, img_y = 0;
         m_projection->project(
                     img_x, img_y, range,
-                    ppt.x, ppt.y, ppt.z);
+                    points[3 * i], points[3 * i + 1], points[3 * i + 2]);
 
         // Update min and max ranges
-        if(range > mat.maxRange)
+        minRange = std::min(minRange, range);
+        maxRange = std::max(maxRange, range);
+
+        ranges[i] = range;
+        if(range < m_maxZ)
         {
-            mat.maxRange = range;
+            pixel[i] = (size_t)img_y * m_width + img_x;
+
+            #pragma omp atomic
+            index.offsets[pixel[i] + 1]++;
         }
+    }
+    index.minRange = minRange;
+    index.maxRange = maxRange;
+
+    // Prefix sum over the pixel counts
+    for(size_t p = 0; p < n_pixels; p++)
+    {
+        index.offsets[p + 1] += index.offsets[p];
+    }
+
+    // Scatter the point indices into their pixel ranges
+    index.indices.resize(index.offsets[n_pixels]);
+    index.ranges.resize(index.offsets[n_pixels]);
+    vector<size_t> next(index.offsets.begin(), index.offsets.end() - 1);
 
-        if(range < mat.minRange)
+    #pragma omp parallel for
+    for(size_t i = 0; i < n_points; i++)
+    {
+        if(pixel[i] != no_pixel)
         {
-            mat.minRange = range;
+            size_t pos;
+            #pragma omp atomic capture
+            pos = next[pixel[i]]++;
+            index.indices[pos] = i;
         }
+    }
 
-        if(range < m_maxZ)
+    // Restore the projection order within each pixel
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(size_t p = 0; p < n_pixels; p++)
+    {
+        size_t* first = index.indices.data() + index.offsets[p];
+        size_t* last = index.indices.data() + index.offsets[p + 1];
+        if(last - first > 1)
         {
-            // Add point index to image pixel
-            mat.pixels[img_y][img_x].emplace_back(PanoramaPoint(i));
+            std::sort(first, last);
+        }
+        for(size_t* it = first; it != last; ++it)
+        {
+            index.ranges[it - index.indices.data()] = ranges[*it];
         }
-        ++progress;
     }
-    cout << endl;
+
+    cout << timestamp << "Projected " << index.indices.size() << " of " << n_points << " points" << endl;
 }
 
-void ModelToImage::computeDepthImage(ModelToImage::DepthImage& img, ModelToImage::ProjectionPolicy policy)
+void ModelToImage::computeDepthListMatrix(DepthListMatrix& mat)
 {
-    cout << timestamp << "Computing depth image. Image dimensions: " << m_width << " x " << m_height << endl;
+    DepthListIndex index;
+    computeDepthListIndex(index);
+
+    mat.minRange = index.minRange;
+    mat.maxRange = index.maxRange;
 
     // Set correct image width and height
+    mat.pixels.resize(m_height);
     for(int i = 0; i < m_height; i++)
     {
-        img.pixels.emplace_back(vector<float>());
+        mat.pixels[i].resize(m_width);
         for(int j = 0; j < m_width; j++)
         {
-            img.pixels[i].push_back(0.0f);
+            mat.pixels[i][j].reserve(index.size(i, j));
+            for(const size_t* it = index.begin(i, j); it != index.end(i, j); ++it)
+            {
+                mat.pixels[i][j].emplace_back(PanoramaPoint(*it));
+            }
         }
     }
+}
 
+void ModelToImage::computeDepthImage(ModelToImage::DepthImage& img, ModelToImage::ProjectionPolicy policy)
+{
+    cout << timestamp << "Computing depth image. Image dimensions: " << m_width << " x " << m_height << endl;
 
-    // Get point array and size from buffer
-    size_t n_points = m_points->numPoints();
-    floatArr points = m_points->getPointArray();
+    DepthListIndex index;
+    computeDepthListIndex(index);
 
-    // Create progress output
-    string comment = timestamp.getElapsedTime() + "Projecting points ";
-    ProgressBar progress(n_points, comment);
+    img.minRange = index.minRange;
+    img.maxRange = index.maxRange;
 
-    float range;
-    int img_x, img_y;
-    for(int i = 0; i < n_points; i++)
-    {
-        m_projection->project(
-                    img_x, img_y, range,
-                    points[3 * i], points[3 * i + 1], points[3 * i + 2]);
+    // Set correct image width and height
+    img.pixels.assign(m_height, vector<float>(m_width, 0.0f));
 
-        // Update min and max ranges
-        if(range > img.maxRange)
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < m_height; i++)
+    {
+        for(int j = 0; j < m_width; j++)
         {
-            img.maxRange = range;
-        }
+            size_t n = index.size(i, j);
+            if(n == 0)
+            {
+                continue;
+            }
 
-        if(range < img.minRange)
-        {
-            img.minRange = range;
-        }
+            const float* first = index.ranges.data() + index.offsets[i * m_width + j];
+            const float* last = first + n;
 
-        img.pixels[img_y][img_x] = range;
-        ++progress;
+            switch(policy)
+            {
+                case FIRST:
+                    img.pixels[i][j] = *first;
+                    break;
+                case MINRANGE:
+                    img.pixels[i][j] = *std::min_element(first, last);
+                    break;
+                case MAXRANGE:
+                    img.pixels[i][j] = *std::max_element(first, last);
+                    break;
+                case AVERAGE:
+                {
+                    double sum = 0.0;
+                    for(const float* it = first; it != last; ++it)
+                    {
+                        sum += *it;
+                    }
+                    img.pixels[i][j] = sum / n;
+                    break;
+                }
+                case LAST:
+                default:
+                    img.pixels[i][j] = *(last - 1);
+            }
+        }
     }
-    cout << endl;
+
     cout << timestamp << "Min / Max range: " << img.minRange << " / " << img.maxRange << endl;
 }
 
@@ -49,6 +49,91 @@ namespace lvr2
 
 using Vec = BaseVector<float>;
 
+namespace
+{
+
+/// Number of points and first and second order moments of a neighborhood
+struct Moments
+{
+    double n = 0;
+    double x = 0, y = 0, z = 0;
+    double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+
+    void add(const float* p)
+    {
+        n += 1;
+        x += p[0];
+        y += p[1];
+        z += p[2];
+        xx += (double)p[0] * p[0];
+        xy += (double)p[0] * p[1];
+        xz += (double)p[0] * p[2];
+        yy += (double)p[1] * p[1];
+        yz += (double)p[1] * p[2];
+        zz += (double)p[2] * p[2];
+    }
+
+    void add(const Moments& m, double sign)
+    {
+        n += sign * m.n;
+        x += sign * m.x;
+        y += sign * m.y;
+        z += sign * m.z;
+        xx += sign * m.xx;
+        xy += sign * m.xy;
+        xz += sign * m.xz;
+        yy += sign * m.yy;
+        yz += sign * m.yz;
+        zz += sign * m.zz;
+    }
+
+    /// Eigenvector of the smallest eigenvalue of the covariance matrix
+    Eigen::Vector3d normal() const
+    {
+        double mx = x / n;
+        double my = y / n;
+        double mz = z / n;
+
+        Eigen::Matrix3d cov;
+        cov(0, 0) = xx / n - mx * mx;
+        cov(0, 1) = xy / n - mx * my;
+        cov(0, 2) = xz / n - mx * mz;
+        cov(1, 1) = yy / n - my * my;
+        cov(1, 2) = yz / n - my * mz;
+        cov(2, 2) = zz / n - mz * mz;
+        cov(1, 0) = cov(0, 1);
+        cov(2, 0) = cov(0, 2);
+        cov(2, 1) = cov(1, 2);
+
+        // Closed form solution for symmetric 3x3 matrices, the eigenvalues
+        // are sorted in increasing order
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+        solver.computeDirect(cov);
+        return solver.eigenvectors().col(0);
+    }
+};
+
+/// Adds (sign = 1) or removes (sign = -1) the first point of every pixel in
+/// row i to the column sums
+void addRow(const ModelToImage::DepthListIndex& mat,
+            const floatArr& points,
+            int i,
+            double sign,
+            std::vector<Moments>& columns)
+{
+    for(int j = 0; j < mat.width; j++)
+    {
+        if(mat.size(i, j) > 0)
+        {
+            Moments m;
+            m.add(&points[*mat.begin(i, j) * 3]);
+            columns[j].add(m, sign);
+        }
+    }
+}
+
+} // namespace
+
 PanoramaNormals::PanoramaNormals(ModelToImage* mti)
     : m_mti(mti)
 {
@@ -79,8 +164,8 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
     }
 
     // Get panorama
-    ModelToImage::DepthListMatrix mat;
-    m_mti->computeDepthListMatrix(mat);
+    ModelToImage::DepthListIndex mat;
+    m_mti->computeDepthListIndex(mat);
 
     // If the desired neighborhood is larger than 2 x 2 pixels
     // compute offsets for i und j dimension of the image.
@@ -100,26 +185,24 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
     // Compute normals
     // Create progress output
     string comment = timestamp.getElapsedTime() + "Computing normals ";
-    ProgressBar progress(mat.pixels.size(), comment);
-
+    ProgressBar progress(mat.height, comment);
 
-
-    for(size_t i = 0; i < mat.pixels.size(); i++)
+    #pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < mat.height; i++)
     {
-        #pragma omp parallel for
-        for(size_t j = 0; j < mat.pixels[i].size(); j++)
+        // Collect 'neighboring' points
+        vector<size_t> nb;
+
+        for(int j = 0; j < mat.width; j++)
         {
             // Check if image entry is empty
-            if(mat.pixels[i][j].size() == 0)
+            if(mat.size(i, j) == 0)
             {
                 continue;
             }
 
-            // Collect 'neighboring' points
-            vector<ModelToImage::PanoramaPoint> nb;
-
             // The points at the current position are part of the neighborhood
-            std::copy(mat.pixels[i][j].begin(), mat.pixels[i][j].end(), std::back_inserter(nb));
+            nb.assign(mat.begin(i, j), mat.end(i, j));
 
             for(int off_i = -di; off_i <= di; off_i++)
             {
@@ -129,16 +212,16 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
                     int p_j = j + off_j;
 
 
-                    if(p_i >= 0 && p_i < mat.pixels.size() &&
-                       p_j >= 0 && p_j < mat.pixels[i].size())
+                    if(p_i >= 0 && p_i < mat.height &&
+                       p_j >= 0 && p_j < mat.width)
                     {
                         // We only save the first point as representative
                         // because using all points from list will likely
                         // result in undesirable configurations for local
                         // normal estimation
-                        if(mat.pixels[p_i][p_j].size() > 0)
+                        if(mat.size(p_i, p_j) > 0)
                         {
-                            nb.push_back(mat.pixels[p_i][p_j][0]);
+                            nb.push_back(*mat.begin(p_i, p_j));
                         }
                     }
                 }
@@ -154,7 +237,7 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
                 for(int i = 0; i < nb.size(); i++)
                 {
                     // Determine position of geometry in point array
-                    size_t index = nb[i].index * 3;
+                    size_t index = nb[i] * 3;
 
                     // Get point coordinates
                     Vec neighbor(in_points[index],
@@ -175,24 +258,18 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
 
                 for(int i = 0; i < nb.size(); i++)
                 {
-                    size_t index = nb[i].index * 3;
+                    size_t index = nb[i] * 3;
 
                     Vec pt(in_points[index    ] - mean.x,
                                      in_points[index + 1] - mean.y,
-                                     in_points[index + 3] - mean.z);
+                                     in_points[index + 2] - mean.z);
 
+                    covariance[0] += pt.x * pt.x;
+                    covariance[1] += pt.x * pt.y;
                     covariance[4] += pt.y * pt.y;
+                    covariance[6] += pt.x * pt.z;
                     covariance[7] += pt.y * pt.z;
                     covariance[8] += pt.z * pt.z;
-
-                    pt.x *= pt.x;
-                    pt.y *= pt.x;
-                    pt.z *= pt.x;
-
-                    covariance[0] += pt.x;
-                    covariance[1] += pt.y;
-                    covariance[6] += pt.z;
-
                 }
 
                 covariance[3] = covariance[1];
@@ -221,11 +298,14 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
                 float ny = gsl_vector_get(&evec_0.vector, 1);
                 float nz = gsl_vector_get(&evec_0.vector, 2);
 
+                gsl_matrix_free(evec);
+                gsl_vector_free(eval);
+
                 // Flip normals towards reference point
                 Normal<float> nn(nx, ny, nz);
                 Vec center(0, 0, 0);
 
-                size_t index = mat.pixels[i][j][0].index * 3;
+                size_t index = *mat.begin(i, j) * 3;
                 Vec p1 = center - Vec(in_points[index], in_points[index + 1], in_points[index + 2]);
 
                 if(Normal<float>(p1) * nn < 0)
@@ -235,13 +315,13 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
                     nz *= -1;
                 }
 
-                for(size_t k = 0; k < mat.pixels[i][j].size(); k++)
+                for(const size_t* k = mat.begin(i, j); k != mat.end(i, j); ++k)
                 {
                     // Assign the same normal to all points
                     // behind this pixel to preserve the complete
                     // point cloud
-                    size_t index = mat.pixels[i][j][k].index * 3;
-                    size_t color_index = mat.pixels[i][j][k].index * w_color;
+                    size_t index = *k * 3;
+                    size_t color_index = *k * w_color;
 
                     // Copy point and normal to target buffer
                     p_arr[index    ] = in_points[index];
@@ -329,4 +409,161 @@ PointBufferPtr PanoramaNormals::computeNormals(int width, int height, bool inter
     return out_buffer;
 }
 
+PointBufferPtr PanoramaNormals::computeNormalsFast(int width, int height)
+{
+    Timestamp ts;
+
+    PointBufferPtr in_buffer = m_mti->pointBuffer();
+    size_t w_color;
+    size_t n_inPoints = in_buffer->numPoints();
+    floatArr in_points = in_buffer->getPointArray();
+    ucharArr in_colors = in_buffer->getColorArray(w_color);
+
+    // Copy all points, points without a normal keep a zero normal
+    floatArr p_arr(new float[n_inPoints * 3]);
+    floatArr n_arr(new float[n_inPoints * 3]);
+    std::copy(in_points.get(), in_points.get() + n_inPoints * 3, p_arr.get());
+    std::fill(n_arr.get(), n_arr.get() + n_inPoints * 3, 0.0f);
+
+    ucharArr c_arr;
+    if(in_buffer->hasColors())
+    {
+        c_arr = ucharArr(new unsigned char[n_inPoints * 3]);
+        for(size_t k = 0; k < n_inPoints; k++)
+        {
+            c_arr[3 * k    ] = in_colors[k * w_color];
+            c_arr[3 * k + 1] = in_colors[k * w_color + 1];
+            c_arr[3 * k + 2] = in_colors[k * w_color + 2];
+        }
+    }
+
+    ModelToImage::DepthListIndex mat;
+    m_mti->computeDepthListIndex(mat);
+
+    // Same neighborhood as in computeNormals
+    int di = 2;
+    if(width > 2)
+    {
+        di = width / 2;
+    }
+
+    int dj = 2;
+    if(height > 2)
+    {
+        dj = height / 2;
+    }
+
+    // Every block of rows is processed by one thread. The column sums over
+    // rows i - di to i + di are updated from one row to the next, the window
+    // sums over columns j - dj to j + dj from one pixel to the next.
+    const int blockSize = 32;
+    int numBlocks = (mat.height + blockSize - 1) / blockSize;
+    size_t numNormals = 0;
+
+    #pragma omp parallel reduction(+:numNormals)
+    {
+        // Buffer of each thread, reused for all of its blocks
+        std::vector<Moments> columns(mat.width);
+
+        #pragma omp for schedule(dynamic)
+        for(int b = 0; b < numBlocks; b++)
+        {
+            int firstRow = b * blockSize;
+            int lastRow = std::min(firstRow + blockSize, mat.height);
+
+            std::fill(columns.begin(), columns.end(), Moments());
+            for(int r = std::max(0, firstRow - di); r <= std::min(mat.height - 1, firstRow + di); r++)
+            {
+                addRow(mat, in_points, r, 1.0, columns);
+            }
+
+            for(int i = firstRow; i < lastRow; i++)
+            {
+                if(i > firstRow)
+                {
+                    if(i + di < mat.height)
+                    {
+                        addRow(mat, in_points, i + di, 1.0, columns);
+                    }
+                    if(i - di - 1 >= 0)
+                    {
+                        addRow(mat, in_points, i - di - 1, -1.0, columns);
+                    }
+                }
+
+                Moments window;
+                for(int j = 0; j <= std::min(mat.width - 1, dj); j++)
+                {
+                    window.add(columns[j], 1.0);
+                }
+
+                for(int j = 0; j < mat.width; j++)
+                {
+                    if(j > 0)
+                    {
+                        if(j + dj < mat.width)
+                        {
+                            window.add(columns[j + dj], 1.0);
+                        }
+                        if(j - dj - 1 >= 0)
+                        {
+                            window.add(columns[j - dj - 1], -1.0);
+                        }
+                    }
+
+                    if(mat.size(i, j) == 0)
+                    {
+                        continue;
+                    }
+
+                    // All points of the pixel itself belong to the
+                    // neighborhood as well
+                    Moments m = window;
+                    for(const size_t* k = mat.begin(i, j); k != mat.end(i, j); ++k)
+                    {
+                        m.add(&in_points[*k * 3]);
+                    }
+
+                    if(m.n < 3.5)
+                    {
+                        continue;
+                    }
+
+                    Eigen::Vector3d n = m.normal();
+
+                    // Flip normals towards the scanner at the origin
+                    const float* p = &in_points[*mat.begin(i, j) * 3];
+                    if(p[0] * n.x() + p[1] * n.y() + p[2] * n.z() > 0)
+                    {
+                        n = -n;
+                    }
+
+                    for(const size_t* k = mat.begin(i, j); k != mat.end(i, j); ++k)
+                    {
+                        n_arr[*k * 3    ] = n.x();
+                        n_arr[*k * 3 + 1] = n.y();
+                        n_arr[*k * 3 + 2] = n.z();
+                    }
+                    numNormals += mat.size(i, j);
+                }
+            }
+        }
+    }
+
+    double seconds = ts.getElapsedTimeInS();
+    cout << timestamp << "Computed " << numNormals << " normals of " << n_inPoints
+         << " points in " << seconds << " s (" << n_inPoints / seconds / 1e6
+         << " M points/s)" << endl;
+
+    PointBufferPtr out_buffer(new PointBuffer);
+    if(in_buffer->hasColors())
+    {
+        out_buffer->setColorArray(c_arr, n_inPoints);
+    }
+    out_buffer->setPointArray(p_arr, n_inPoints);
+    out_buffer->setNormalArray(n_arr, n_inPoints);
+
+    return out_buffer;
+}
+
 } // namespace lvr2
@@ -100,7 +100,14 @@ void SLAMAlign::reduceScan(const SLAMScanPtr& scan)
     size_t prev = scan->numPoints();
     if (m_options.reduction >= 0)
     {
-        scan->reduce(m_options.reduction, m_options.maxLeafSize);
+        if (m_options.voxelGridReduction)
+        {
+            scan->reduceVoxelGrid(m_options.reduction);
+        }
+        else
+        {
+            scan->reduce(m_options.reduction, m_options.maxLeafSize);
+        }
     }
     if (m_options.minDistance >= 0)
     {
@@ -34,6 +34,8 @@
 
 #include "lvr2/registration/SLAMScanWrapper.hpp"
 #include "lvr2/registration/TreeUtils.hpp"
+#include "lvr2/algorithm/VoxelGridReduction.hpp"
+#include "lvr2/io/IOUtils.hpp"
 
 #include <fstream>
 
@@ -92,6 +94,13 @@ void SLAMScanWrapper::reduce(double voxelSize, int maxLeafSize)
     m_points.resize(m_numPoints);
 }
 
+void SLAMScanWrapper::reduceVoxelGrid(double voxelSize)
+{
+    VoxelGridReduction reduction(voxelSize, VoxelRepresentative::CLOSEST);
+    m_numPoints = reduction.reduce(m_points.data(), m_numPoints);
+    m_points.resize(m_numPoints);
+}
+
 void SLAMScanWrapper::setMinDistance(double minDistance)
 {
     double sqDist = minDistance * minDistance;
@@ -192,16 +201,14 @@ const std::pair<Transformd, FrameUse>& SLAMScanWrapper::frame(size_t index) cons
 
 void SLAMScanWrapper::writeFrames(std::string path) const
 {
-    ofstream out(path);
+    std::vector<Frame> frames;
+    frames.reserve(m_frames.size());
     for (const std::pair<Transformd, FrameUse>& frame : m_frames)
     {
-        for (int i = 0; i < 16; i++)
-        {
-            out << frame.first(i) << " ";
-        }
-
-        out << (int)frame.second << endl;
+        frames.push_back(Frame(frame.first, (int)frame.second));
     }
+
+    lvr2::writeFrames(frames, path);
 }
 
 } /* namespace lvr2 */
@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * TextureAtlas.cpp
+ */
+
+#include "lvr2/texture/TextureAtlas.hpp"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <numeric>
+
+namespace lvr2
+{
+
+TextureAtlas::TextureAtlas(unsigned short pageSize, unsigned short padding)
+    : m_pageSize(pageSize), m_padding(padding)
+{
+}
+
+std::vector<Texture> TextureAtlas::pack(const std::vector<Texture>& textures, std::vector<AtlasRegion>& regions) const
+{
+    regions.assign(textures.size(), AtlasRegion{0, 0, 0});
+    if(textures.empty())
+    {
+        return std::vector<Texture>();
+    }
+
+    // Tall textures first, so that the shelves are filled evenly
+    std::vector<size_t> order(textures.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+    {
+        if(textures[a].m_height != textures[b].m_height)
+        {
+            return textures[a].m_height > textures[b].m_height;
+        }
+        return textures[a].m_width > textures[b].m_width;
+    });
+
+    // Used width and height of each page
+    std::vector<std::pair<size_t, size_t>> pageSizes;
+    std::vector<size_t> oversized;
+
+    size_t shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+    for(size_t i : order)
+    {
+        size_t w = textures[i].m_width + 2 * m_padding;
+        size_t h = textures[i].m_height + 2 * m_padding;
+
+        if(w > m_pageSize || h > m_pageSize)
+        {
+            oversized.push_back(i);
+            continue;
+        }
+
+        if(!pageSizes.empty() && shelfX + w > m_pageSize)
+        {
+            // Start a new shelf
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        if(pageSizes.empty() || shelfY + h > m_pageSize)
+        {
+            // Start a new page
+            pageSizes.push_back(std::make_pair(0, 0));
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
+        }
+
+        std::pair<size_t, size_t>& page = pageSizes.back();
+        regions[i] = AtlasRegion{pageSizes.size() - 1, (unsigned int)(shelfX + m_padding), (unsigned int)(shelfY + m_padding)};
+        shelfX += w;
+        shelfHeight = std::max(shelfHeight, h);
+        page.first = std::max(page.first, shelfX);
+        page.second = std::max(page.second, shelfY + h);
+    }
+
+    // Textures that are larger than a page get a page of their own without a border
+    for(size_t i : oversized)
+    {
+        regions[i] = AtlasRegion{pageSizes.size(), 0, 0};
+        pageSizes.push_back(std::make_pair(textures[i].m_width, textures[i].m_height));
+    }
+
+    const unsigned char numChannels = textures[0].m_numChannels;
+    const unsigned char numBytes = textures[0].m_numBytesPerChan;
+    const size_t texelBytes = (size_t)numChannels * numBytes;
+
+    std::vector<Texture> pages;
+    pages.reserve(pageSizes.size());
+    for(size_t p = 0; p < pageSizes.size(); p++)
+    {
+        pages.emplace_back(p, pageSizes[p].first, pageSizes[p].second, numChannels, numBytes, textures[0].m_texelSize);
+        std::fill(pages.back().m_data, pages.back().m_data + pageSizes[p].first * pageSizes[p].second * texelBytes, 0);
+    }
+
+    // Copy the textures and repeat their borders, the regions do not overlap
+    #pragma omp parallel for schedule(dynamic)
+    for(long i = 0; i < (long)textures.size(); i++)
+    {
+        const Texture& tex = textures[i];
+        Texture& page = pages[regions[i].page];
+        const int w = tex.m_width;
+        const int h = tex.m_height;
+        if(w == 0 || h == 0)
+        {
+            continue;
+        }
+        const int pad = (w == page.m_width && h == page.m_height) ? 0 : m_padding;
+
+        for(int y = -pad; y < h + pad; y++)
+        {
+            const unsigned char* srcRow = tex.m_data + (size_t)std::min(std::max(y, 0), h - 1) * w * texelBytes;
+            unsigned char* dstRow = page.m_data + ((size_t)(regions[i].y + y) * page.m_width + regions[i].x) * texelBytes;
+
+            std::copy(srcRow, srcRow + w * texelBytes, dstRow);
+            for(int x = 1; x <= pad; x++)
+            {
+                std::copy(srcRow, srcRow + texelBytes, dstRow - x * texelBytes);
+                std::copy(srcRow + (w - 1) * texelBytes, srcRow + w * texelBytes, dstRow + (w - 1 + x) * texelBytes);
+            }
+        }
+    }
+
+    return pages;
+}
+
+AtlasStatistics TextureAtlas::apply(MeshBuffer& buffer) const
+{
+    std::vector<Texture>& textures = buffer.getTextures();
+    std::vector<Material>& materials = buffer.getMaterials();
+    if(textures.empty())
+    {
+        return AtlasStatistics();
+    }
+
+    // Materials refer to textures by their index
+    std::map<size_t, size_t> textureOfIndex;
+    for(size_t t = 0; t < textures.size(); t++)
+    {
+        textureOfIndex[textures[t].m_index] = t;
+    }
+
+    std::vector<AtlasRegion> regions;
+    std::vector<Texture> pages = pack(textures, regions);
+
+    // Color materials keep their order, textured materials are replaced by
+    // one material per page
+    std::vector<Material> newMaterials;
+    std::vector<unsigned int> materialMap(materials.size());
+    std::vector<long> materialTexture(materials.size(), -1);
+    for(size_t m = 0; m < materials.size(); m++)
+    {
+        if(materials[m].m_texture && textureOfIndex.count(materials[m].m_texture->idx()))
+        {
+            materialTexture[m] = textureOfIndex[materials[m].m_texture->idx()];
+        }
+        else
+        {
+            materialMap[m] = newMaterials.size();
+            newMaterials.push_back(materials[m]);
+        }
+    }
+
+    size_t firstPageMaterial = newMaterials.size();
+    for(size_t p = 0; p < pages.size(); p++)
+    {
+        Material material;
+        material.m_texture = TextureHandle(p);
+        std::array<unsigned char, 3> white = {255, 255, 255};
+        material.m_color = white;
+        newMaterials.push_back(material);
+    }
+
+    for(size_t m = 0; m < materials.size(); m++)
+    {
+        if(materialTexture[m] >= 0)
+        {
+            materialMap[m] = firstPageMaterial + regions[materialTexture[m]].page;
+        }
+    }
+
+    // Move the texture coordinates into the pages
+    size_t numFaces = buffer.numFaces();
+    size_t numVertices = buffer.numVertices();
+    indexArray faces = buffer.getFaceIndices();
+    indexArray faceMaterials = buffer.getFaceMaterialIndices();
+    floatArr texCoords = buffer.getTextureCoordinates();
+
+    if(faceMaterials && texCoords)
+    {
+        std::vector<unsigned char> moved(numVertices, 0);
+        for(size_t f = 0; f < numFaces; f++)
+        {
+            long t = materialTexture[faceMaterials[f]];
+            if(t < 0)
+            {
+                continue;
+            }
+
+            const Texture& tex = textures[t];
+            const Texture& page = pages[regions[t].page];
+            for(int j = 0; j < 3; j++)
+            {
+                size_t v = faces[3 * f + j];
+                if(moved[v])
+                {
+                    continue;
+                }
+                moved[v] = 1;
+
+                // v counts from the bottom row of the texture
+                float u = texCoords[2 * v];
+                float w = texCoords[2 * v + 1];
+                texCoords[2 * v] = (regions[t].x + u * tex.m_width) / page.m_width;
+                texCoords[2 * v + 1] = 1.0f - (regions[t].y + (1.0f - w) * tex.m_height) / page.m_height;
+            }
+        }
+    }
+
+    if(faceMaterials)
+    {
+        for(size_t f = 0; f < numFaces; f++)
+        {
+            faceMaterials[f] = materialMap[faceMaterials[f]];
+        }
+    }
+
+    auto clusterMaterials = buffer.getIndexChannel("cluster_material_indices");
+    if(clusterMaterials)
+    {
+        unsigned int* indices = clusterMaterials->dataPtr().get();
+        for(size_t c = 0; c < clusterMaterials->numElements(); c++)
+        {
+            indices[c] = materialMap[indices[c]];
+        }
+    }
+
+    AtlasStatistics stats = statistics(textures, pages);
+    materials = std::move(newMaterials);
+    textures = std::move(pages);
+    return stats;
+}
+
+AtlasStatistics TextureAtlas::statistics(const std::vector<Texture>& textures, const std::vector<Texture>& pages)
+{
+    AtlasStatistics stats;
+    stats.numTextures = textures.size();
+    stats.numPages = pages.size();
+    for(const Texture& t : textures)
+    {
+        stats.textureTexels += (size_t)t.m_width * t.m_height;
+    }
+    for(const Texture& p : pages)
+    {
+        stats.pageTexels += (size_t)p.m_width * p.m_height;
+    }
+    return stats;
+}
+
+} // namespace lvr2
@@ -0,0 +1,143 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+ /*
+ * TextureHash.cpp
+ */
+
+#include "lvr2/texture/TextureHash.hpp"
+
+#include <bitset>
+#include <cstdlib>
+
+namespace lvr2
+{
+
+TextureHash computeTextureHash(const Texture& texture)
+{
+    TextureHash result;
+    result.width = texture.m_width;
+    result.height = texture.m_height;
+
+    const size_t numTexels = (size_t)texture.m_width * texture.m_height;
+    const int channels = texture.m_numChannels;
+    if(numTexels == 0 || !texture.m_data || texture.m_numBytesPerChan != 1 || channels == 0)
+    {
+        return result;
+    }
+
+    // Area average of the luminance in a 9 x 8 grid and the mean color
+    double gray[8][9] = {};
+    size_t count[8][9] = {};
+    std::array<double, 3> colorSum = {0, 0, 0};
+
+    for(size_t y = 0; y < texture.m_height; y++)
+    {
+        size_t cy = y * 8 / texture.m_height;
+        for(size_t x = 0; x < texture.m_width; x++)
+        {
+            size_t cx = x * 9 / texture.m_width;
+            const unsigned char* texel = texture.m_data + (y * texture.m_width + x) * channels;
+
+            double r = texel[0];
+            double g = channels >= 3 ? texel[1] : r;
+            double b = channels >= 3 ? texel[2] : r;
+
+            gray[cy][cx] += 0.299 * r + 0.587 * g + 0.114 * b;
+            count[cy][cx]++;
+            colorSum[0] += r;
+            colorSum[1] += g;
+            colorSum[2] += b;
+        }
+    }
+
+    for(int c = 0; c < 3; c++)
+    {
+        result.meanColor[c] = (unsigned char)(colorSum[c] / numTexels + 0.5);
+    }
+
+    // Textures narrower than 9 texels leave some cells empty. Fill them
+    // with their left neighbour, so they do not produce random bits.
+    for(int y = 0; y < 8; y++)
+    {
+        for(int x = 0; x < 9; x++)
+        {
+            if(count[y][x])
+            {
+                gray[y][x] /= count[y][x];
+            }
+            else if(x > 0)
+            {
+                gray[y][x] = gray[y][x - 1];
+            }
+            else if(y > 0)
+            {
+                gray[y][x] = gray[y - 1][x];
+            }
+        }
+    }
+
+    // One bit per horizontal gradient. Small gradients count as flat, so
+    // that noise in uniform areas does not flip bits.
+    const double minGradient = 2.0;
+    for(int y = 0; y < 8; y++)
+    {
+        for(int x = 0; x < 8; x++)
+        {
+            result.hash <<= 1;
+            result.hash |= gray[y][x] + minGradient < gray[y][x + 1] ? 1 : 0;
+        }
+    }
+
+    return result;
+}
+
+int hashDistance(const TextureHash& a, const TextureHash& b)
+{
+    return (int)std::bitset<64>(a.hash ^ b.hash).count();
+}
+
+bool isDuplicate(const TextureHash& a, const TextureHash& b, int maxDistance, int maxColorDiff)
+{
+    if(a.width != b.width || a.height != b.height)
+    {
+        return false;
+    }
+
+    for(int c = 0; c < 3; c++)
+    {
+        if(std::abs((int)a.meanColor[c] - (int)b.meanColor[c]) > maxColorDiff)
+        {
+            return false;
+        }
+    }
+
+    return hashDistance(a, b) <= maxDistance;
+}
+
+} // namespace lvr2
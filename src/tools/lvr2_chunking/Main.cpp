@@ -120,7 +120,13 @@ int main(int argc, char** argv)
                 }
 
             }
-         lvr2::ChunkManager chunker(meshes, size, maxChunkOverlap, outputPath.string(), layers);
+         lvr2::ChunkManager chunker(meshes,
+                                    size,
+                                    maxChunkOverlap,
+                                    outputPath.string(),
+                                    layers,
+                                    options.getCacheSize(),
+                                    options.getNumLODs());
         }
     }
     return EXIT_SUCCESS;
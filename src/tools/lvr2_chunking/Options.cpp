@@ -34,6 +34,7 @@
 
 #include "Options.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace chunking
@@ -62,7 +63,8 @@ Options::Options(int argc, char** argv) : m_descr("Supported options")
         "y_max", value<float>()->default_value(10.0f), "bounding box maximum value in y-dimension")(
         "z_max", value<float>()->default_value(10.0f), "bounding box maximum value in z-dimension")(
         "cacheSize", value<int>()->default_value(200), "while loading the maximum number of chunks in RAM")(
-        "meshName", value<std::string>()->default_value(""), "group name of the mesh if the HDF5 contains multiple meshes");
+        "meshName", value<std::string>()->default_value(""), "group name of the mesh if the HDF5 contains multiple meshes")(
+        "numLODs", value<int>()->default_value(0), "number of simplified levels of detail that are built for every chunk");
 
     // Parse command line and generate variables map
     store(command_line_parser(argc, argv).options(m_descr).positional(m_posDescr).run(),
@@ -163,6 +165,10 @@ std::string Options::getMeshGroup() const
 {
     return m_variables["meshName"].as<std::string>();
 }
+size_t Options::getNumLODs() const
+{
+    return std::max(m_variables["numLODs"].as<int>(), 0);
+}
 
 Options::~Options()
 {
@@ -128,6 +128,10 @@ class Options
      * @brief   Returns the mesh group in the HDF5
      */
     std::string getMeshGroup() const;
+    /**
+     * @brief   Returns the number of simplified levels of detail per chunk
+     */
+    size_t getNumLODs() const;
 
 private:
     /// The internally used variable map
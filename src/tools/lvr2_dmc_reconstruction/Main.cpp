@@ -21,6 +21,9 @@
 #include "lvr2/reconstruction/FastReconstruction.hpp"
 
 #include "lvr2/config/lvropenmp.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <sys/resource.h>
 
 using namespace lvr2;
 
@@ -131,8 +134,14 @@ int main(int argc, char** argv)
 
     DMCReconstruction<Vec, FastBox<Vec>> dmc(surface, surface->getBoundingBox(), true, options.getMaxLevel(), options.getMaxError());
 
+    Timestamp reconstructionTime;
     dmc.getMesh(mesh);
 
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    cout << timestamp << "Reconstruction took " << reconstructionTime.getElapsedTimeInS() << " s, "
+         << "peak memory usage: " << usage.ru_maxrss / 1024.0 << " MiB" << endl;
+
     // Finalize mesh
     lvr2::SimpleFinalizer<Vec> finalize;
     auto meshBuffer = finalize.apply(mesh);
@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * Main.cpp
+ *
+ * Converts slam6d .frames files into the binary .bframes format and back.
+ */
+
+#include "lvr2/io/IOUtils.hpp"
+#include "lvr2/io/Timestamp.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace lvr2;
+
+using boost::filesystem::path;
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " [--text] <file|directory> ..." << std::endl;
+        std::cout << "Converts .frames files into the binary .bframes format. Directories are" << std::endl;
+        std::cout << "searched for .frames files. With --text, .bframes files are converted back." << std::endl;
+        return 0;
+    }
+
+    bool toText = false;
+    std::vector<path> inputs;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if (arg == "--text")
+        {
+            toText = true;
+        }
+        else
+        {
+            inputs.push_back(path(arg));
+        }
+    }
+
+    const std::string sourceExtension = toText ? ".bframes" : ".frames";
+    const std::string targetExtension = toText ? ".frames" : ".bframes";
+
+    std::vector<path> files;
+    for (const path& input : inputs)
+    {
+        if (boost::filesystem::is_directory(input))
+        {
+            for (boost::filesystem::directory_iterator it(input), end; it != end; ++it)
+            {
+                if (it->path().extension() == sourceExtension)
+                {
+                    files.push_back(it->path());
+                }
+            }
+        }
+        else if (boost::filesystem::is_regular_file(input))
+        {
+            files.push_back(input);
+        }
+        else
+        {
+            std::cout << timestamp << "Warning: " << input << " does not exist." << std::endl;
+        }
+    }
+
+    Timestamp ts;
+    size_t numFrames = 0;
+    size_t inputBytes = 0;
+    size_t outputBytes = 0;
+
+    // Every file is converted independently
+    #pragma omp parallel for schedule(dynamic) reduction(+:numFrames, inputBytes, outputBytes)
+    for (long i = 0; i < (long)files.size(); i++)
+    {
+        path target = files[i];
+        target.replace_extension(targetExtension);
+
+        numFrames += convertFrames(files[i], target);
+        inputBytes += boost::filesystem::file_size(files[i]);
+        outputBytes += boost::filesystem::file_size(target);
+    }
+
+    std::cout << timestamp << "Converted " << numFrames << " frames in " << files.size() << " files: "
+              << inputBytes << " bytes to " << outputBytes << " bytes in "
+              << ts.getElapsedTimeInS() << " s." << std::endl;
+
+    return 0;
+}
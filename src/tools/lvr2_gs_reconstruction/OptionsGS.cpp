@@ -28,6 +28,7 @@ namespace gs_reconstruction{
                 ("deleteLongEdgesFactor",value<int>(&m_deleteLongEdgesFactor)->default_value(10), "0 = no deleting, default: 10")
                 ("interior",value<bool>(&m_interior)->default_value(false), "false: reconstruct exterior, true: reconstruct interior")
                 ("balances",value<int>(&m_balances)->default_value(20), "Number of TumbleTree-Balances during the reconstruction. default: 20")
+                ("verbose",value<bool>(&m_verbose)->default_value(false), "print mesh and tumble tree statistics after the reconstruction, default: false")
                 ("kd", value<int>(&m_kd)->default_value(5), "Number of normals used for distance function evaluation")
                 ("ki", value<int>(&m_ki)->default_value(10), "Number of normals used in the normal interpolation process")
                 ("kn", value<int>(&m_kn)->default_value(10), "Size of k-neighborhood used for normal estimation")
@@ -100,6 +101,10 @@ namespace gs_reconstruction{
         return m_variables["balances"].as<int>();
     }
 
+    bool Options::isVerbose() const {
+        return m_variables["verbose"].as<bool>();
+    }
+
 
 
 
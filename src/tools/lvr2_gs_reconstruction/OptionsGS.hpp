@@ -86,6 +86,8 @@ class Options : public BaseOption
 
     int getNumBalances() const;
 
+    bool isVerbose() const;
+
     string getInputFileName() const;
 
     /*
@@ -116,6 +118,7 @@ class Options : public BaseOption
     int m_deleteLongEdgesFactor;
     bool m_interior;
     int m_balances;
+    bool m_verbose;
     /// The number of neighbors for distance function evaluation
     int m_kd;
 
@@ -149,6 +152,7 @@ inline ostream& operator<<(ostream& os, const Options& o)
     cout << "##### DeleteLongEdgesFactor: " << o.getDeleteLongEdgesFactor() << endl;
     cout << "##### Interior: " << o.isInterior() << endl;
     cout << "##### Balances: " << o.getNumBalances() << endl;
+    cout << "##### Verbose: " << o.isVerbose() << endl;
     cout << "##### PCM: " << o.getPcm() << endl;
     cout << "##### KD: " << o.getKd() << endl;
     cout << "##### KI: " << o.getKi() << endl;
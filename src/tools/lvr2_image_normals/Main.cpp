@@ -29,11 +29,144 @@
 
 
 #include "lvr2/io/ModelFactory.hpp"
+#include "lvr2/io/Timestamp.hpp"
 #include "lvr2/reconstruction/ModelToImage.hpp"
 #include "lvr2/reconstruction/PanoramaNormals.hpp"
 #include "Options.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
 using namespace lvr2;
 
+namespace
+{
+
+/// Creates a 360 degree scan of a box shaped room around the origin
+ModelPtr syntheticScan(size_t numPoints)
+{
+    const float halfSize[3] = {12.0f, 8.0f, 3.0f};
+
+    std::mt19937 rng(42);
+    std::normal_distribution<float> dir(0.0f, 1.0f);
+    std::uniform_real_distribution<float> noise(-0.005f, 0.005f);
+
+    floatArr points(new float[3 * numPoints]);
+    for(size_t i = 0; i < numPoints; i++)
+    {
+        float d[3] = {dir(rng), dir(rng), dir(rng)};
+        float len = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+
+        // Distance to the closest wall along the ray
+        float t = std::numeric_limits<float>::max();
+        for(int k = 0; k < 3; k++)
+        {
+            d[k] /= len;
+            if(std::abs(d[k]) > 1e-6f)
+            {
+                t = std::min(t, halfSize[k] / std::abs(d[k]));
+            }
+        }
+
+        t += noise(rng);
+        for(int k = 0; k < 3; k++)
+        {
+            points[3 * i + k] = t * d[k];
+        }
+    }
+
+    PointBufferPtr buffer(new PointBuffer);
+    buffer->setPointArray(points, numPoints);
+    return ModelPtr(new Model(buffer));
+}
+
+/// Runs the panorama projection and normal estimation and prints the run times
+void benchmark(ModelToImage& mti, const image_normals::Options& opt)
+{
+    size_t numPoints = mti.pointBuffer()->numPoints();
+
+    Timestamp ts;
+    ModelToImage::DepthListIndex index;
+    mti.computeDepthListIndex(index);
+    double indexTime = ts.getElapsedTimeInS();
+
+    size_t numPixels = (size_t)index.width * index.height;
+    size_t indexBytes = index.offsets.size() * sizeof(size_t)
+        + index.indices.size() * (sizeof(size_t) + sizeof(float));
+
+    ts.resetTimer();
+    ModelToImage::DepthListMatrix mat;
+    mti.computeDepthListMatrix(mat);
+    double matrixTime = ts.getElapsedTimeInS();
+
+    // Vector headers of all rows and pixels plus the point entries
+    size_t matrixBytes = numPixels * sizeof(vector<ModelToImage::PanoramaPoint>)
+        + index.height * sizeof(vector<vector<ModelToImage::PanoramaPoint> >)
+        + numPoints * sizeof(ModelToImage::PanoramaPoint);
+    mat = ModelToImage::DepthListMatrix();
+
+    ts.resetTimer();
+    ModelToImage::DepthImage img;
+    mti.computeDepthImage(img);
+    double imageTime = ts.getElapsedTimeInS();
+
+    ts.resetTimer();
+    PanoramaNormals normals(&mti);
+    PointBufferPtr buffer = normals.computeNormals(opt.regionWidth(), opt.regionHeight(), false);
+    double normalTime = ts.getElapsedTimeInS();
+
+    ts.resetTimer();
+    PointBufferPtr fastBuffer = normals.computeNormalsFast(opt.regionWidth(), opt.regionHeight());
+    double fastNormalTime = ts.getElapsedTimeInS();
+
+    // Compare the normals of both methods. computeNormals leaves the normals
+    // of points without a neighborhood undefined, so only points with a fast
+    // normal are compared.
+    floatArr n1 = buffer->getNormalArray();
+    floatArr n2 = fastBuffer->getNormalArray();
+    size_t numCompared = 0;
+    size_t numDeviating = 0;
+    double maxAngle = 0.0;
+    for(size_t i = 0; i < numPoints; i++)
+    {
+        const float* a = &n1[3 * i];
+        const float* b = &n2[3 * i];
+        if(b[0] == 0.0f && b[1] == 0.0f && b[2] == 0.0f)
+        {
+            continue;
+        }
+        double dot = std::min(1.0, std::abs((double)a[0] * b[0] + a[1] * b[1] + a[2] * b[2]));
+        double angle = std::acos(dot) * 180.0 / M_PI;
+        maxAngle = std::max(maxAngle, angle);
+        if(angle > 1.0)
+        {
+            numDeviating++;
+        }
+        numCompared++;
+    }
+
+    cout << endl;
+    cout << "##### Panorama benchmark #####" << endl;
+    cout << "Points\t\t\t: " << numPoints << endl;
+    cout << "Image\t\t\t: " << index.width << " x " << index.height << endl;
+    cout << "Depth list index\t: " << indexTime << " s, "
+         << numPoints / indexTime / 1e6 << " M points/s, "
+         << indexBytes / (1024.0 * 1024.0) << " MiB" << endl;
+    cout << "Depth list matrix\t: " << matrixTime << " s, at least "
+         << matrixBytes / (1024.0 * 1024.0) << " MiB" << endl;
+    cout << "Depth image\t\t: " << imageTime << " s" << endl;
+    cout << "Normals\t\t\t: " << normalTime << " s, "
+         << numPoints / normalTime / 1e6 << " M points/s" << endl;
+    cout << "Fast normals\t\t: " << fastNormalTime << " s, "
+         << numPoints / fastNormalTime / 1e6 << " M points/s" << endl;
+    cout << "Normal deviation\t: " << numDeviating << " of " << numCompared
+         << " normals differ by more than 1 degree, max " << maxAngle << " degrees" << endl;
+}
+
+} // namespace
+
 
 /**
  * @brief   Main entry point for the LSSR surface executable
@@ -43,7 +176,15 @@ int main(int argc, char** argv)
     image_normals::Options opt(argc, argv);
     cout << opt << endl;
 
-    ModelPtr model = ModelFactory::readModel(opt.inputFile());
+    ModelPtr model;
+    if(opt.syntheticPoints() > 0)
+    {
+        model = syntheticScan(opt.syntheticPoints());
+    }
+    else
+    {
+        model = ModelFactory::readModel(opt.inputFile());
+    }
 
     // Determine coordinate system
     ModelToImage::CoordinateSystem system = ModelToImage::NATIVE;
@@ -66,10 +207,24 @@ int main(int argc, char** argv)
                 opt.minV(), opt.maxV(),
                 opt.optimize(), system);
 
+    if(opt.syntheticPoints() > 0)
+    {
+        benchmark(mti, opt);
+        return 0;
+    }
+
     mti.writePGM(opt.imageFile(), 3000);
 
     PanoramaNormals normals(&mti);
-    PointBufferPtr buffer = normals.computeNormals(opt.regionWidth(), opt.regionHeight(), false);
+    PointBufferPtr buffer;
+    if(opt.fastNormals())
+    {
+        buffer = normals.computeNormalsFast(opt.regionWidth(), opt.regionHeight());
+    }
+    else
+    {
+        buffer = normals.computeNormals(opt.regionWidth(), opt.regionHeight(), false);
+    }
 
     ModelPtr out_model(new Model(buffer));
 
@@ -52,7 +52,9 @@ Options::Options(int argc, char** argv) : m_descr("Supported options")
     ("regionWidth,i",    value<int>(&m_width)->default_value(5),      "Width of the nearest neighbor region of a pixel for normal estimation.")
     ("regionHeight,j",   value<int>(&m_height)->default_value(5),     "Height of the nearest neighbor region of a pixel for normal estimation.")
     ("optimize,o",      "Optimize image aspect ratio.")
+    ("fastNormals",     "Use the sliding window normal estimation.")
     ("system,s",        value<string>(&m_system)->default_value("NATIVE"), "The coordinate system in which the points are stored. Use NATIVE to interpret the points as they are. Use SLAM6D for scans in 3dtk's coordinate system and UOS for scans that where taken with a tilting laser scanner at Osnabrueck University.")
+    ("synthetic",       value<size_t>(&m_synthetic)->default_value(0),  "Benchmark mode: Generate a synthetic 360 degree scan of a room with the given number of points instead of reading an input file and report the run times of the projection and normal estimation.")
 	;
 
     m_pdescr.add("inputFile", -1);
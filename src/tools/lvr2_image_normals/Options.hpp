@@ -139,11 +139,21 @@ public:
         return m_variables.count("optimize");
     }
 
+    bool    fastNormals() const
+    {
+        return m_variables.count("fastNormals");
+    }
+
     string    coordinateSystem() const
     {
         return m_variables["system"].as<string>();
     }
 
+    size_t    syntheticPoints() const
+    {
+        return m_variables["synthetic"].as<size_t>();
+    }
+
 private:
 
 	/// The internally used variable map
@@ -169,6 +179,7 @@ private:
     float       m_maxZimg;
     string      m_imageOut;
     string      m_system;
+    size_t      m_synthetic;
 };
 
 inline ostream& operator<<(ostream& os, const Options& o)
@@ -181,6 +192,7 @@ inline ostream& operator<<(ostream& os, const Options& o)
     os << "Z range (img)\t\t\t: " << o.minZimg() << " to " << o.maxZimg() << endl;
     os << "Optimize aspect\t\t\t: " << o.optimize() << endl;
     os << "Coordinate system\t\t: " << o.coordinateSystem() << endl;
+    os << "Fast normals\t\t\t: " << o.fastNormals() << endl;
     return os;
 }
 
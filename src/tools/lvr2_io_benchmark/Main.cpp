@@ -0,0 +1,295 @@
+#include "lvr2/io/LasIO.hpp"
+#include "lvr2/io/PLYIO.hpp"
+#include "lvr2/io/Timestamp.hpp"
+#include "lvr2/config/lvropenmp.hpp"
+
+#include <lasreader.hpp>
+#include <laswriter.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace lvr2;
+
+namespace
+{
+
+/// Reads the given PLY file and returns the elapsed time in seconds
+double timedRead(const std::string& filename, bool fast, ModelPtr& model)
+{
+    PLYIO io;
+    io.setFastBinaryRead(fast);
+
+    Timestamp ts;
+    model = io.read(filename);
+    return ts.getElapsedTimeInS();
+}
+
+template<typename T>
+bool compareArrays(const boost::shared_array<T>& a, const boost::shared_array<T>& b, size_t n)
+{
+    if (!a || !b)
+    {
+        return !a && !b;
+    }
+    return std::equal(a.get(), a.get() + n, b.get());
+}
+
+/// Compares the named channel of both buffers, a channel missing in both counts as equal
+template<typename T>
+bool compareChannels(PointBufferPtr a, PointBufferPtr b, const std::string& name)
+{
+    typename Channel<T>::Optional ca = a->getChannel<T>(name);
+    typename Channel<T>::Optional cb = b->getChannel<T>(name);
+    if (!ca || !cb)
+    {
+        return !ca && !cb;
+    }
+    if (ca->numElements() != cb->numElements() || ca->width() != cb->width())
+    {
+        return false;
+    }
+    return compareArrays(ca->dataPtr(), cb->dataPtr(), ca->numElements() * ca->width());
+}
+
+bool compareModels(ModelPtr a, ModelPtr b)
+{
+    if (!a || !b)
+    {
+        return false;
+    }
+
+    size_t wa, wb;
+    if (a->m_pointCloud && b->m_pointCloud)
+    {
+        size_t n = a->m_pointCloud->numPoints();
+        if (n != b->m_pointCloud->numPoints())
+        {
+            return false;
+        }
+
+        ucharArr ca = a->m_pointCloud->getColorArray(wa);
+        ucharArr cb = b->m_pointCloud->getColorArray(wb);
+        if (!compareArrays(a->m_pointCloud->getPointArray(), b->m_pointCloud->getPointArray(), 3 * n)
+            || !compareArrays(a->m_pointCloud->getNormalArray(), b->m_pointCloud->getNormalArray(), 3 * n)
+            || !compareArrays(ca, cb, wa * n)
+            || !compareChannels<float>(a->m_pointCloud, b->m_pointCloud, "intensities")
+            || !compareChannels<unsigned char>(a->m_pointCloud, b->m_pointCloud, "classifications")
+            || !compareChannels<double>(a->m_pointCloud, b->m_pointCloud, "gps_time"))
+        {
+            return false;
+        }
+    }
+
+    if (a->m_mesh && b->m_mesh)
+    {
+        size_t n = a->m_mesh->numVertices();
+        size_t f = a->m_mesh->numFaces();
+        if (n != b->m_mesh->numVertices() || f != b->m_mesh->numFaces())
+        {
+            return false;
+        }
+
+        ucharArr ca = a->m_mesh->getVertexColors(wa);
+        ucharArr cb = b->m_mesh->getVertexColors(wb);
+        if (!compareArrays(a->m_mesh->getVertices(), b->m_mesh->getVertices(), 3 * n)
+            || !compareArrays(a->m_mesh->getVertexNormals(), b->m_mesh->getVertexNormals(), 3 * n)
+            || !compareArrays(ca, cb, wa * n)
+            || !compareArrays(a->m_mesh->getFaceIndices(), b->m_mesh->getFaceIndices(), 3 * f))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Reads the given LAS file and returns the elapsed time in seconds
+double timedLasRead(const std::string& filename, int numThreads, ModelPtr& model)
+{
+    LasIO io;
+
+    Timestamp ts;
+    model = io.read(filename, numThreads);
+    return ts.getElapsedTimeInS();
+}
+
+/// Writes a LAS/LAZ file with random points, colors and GPS times
+bool writeSyntheticLas(const std::string& filename, size_t numPoints)
+{
+    LASheader header;
+    header.x_scale_factor = header.y_scale_factor = header.z_scale_factor = 0.001;
+    header.x_offset = header.y_offset = header.z_offset = 0.0;
+    header.point_data_format = 3;
+    header.point_data_record_length = 34;
+
+    LASpoint point;
+    point.init(&header, header.point_data_format, header.point_data_record_length, &header);
+
+    LASwriteOpener opener;
+    opener.set_file_name(filename.c_str());
+    LASwriter* writer = opener.open(&header);
+    if (!writer)
+    {
+        return false;
+    }
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord(-100.0, 100.0);
+    std::uniform_int_distribution<int> value(0, 65535);
+
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        point.set_x(coord(gen));
+        point.set_y(coord(gen));
+        point.set_z(coord(gen));
+        point.intensity = value(gen);
+        point.classification = i % 32;
+        point.gps_time = 0.001 * i;
+        point.rgb[0] = value(gen);
+        point.rgb[1] = value(gen);
+        point.rgb[2] = value(gen);
+        writer->write_point(&point);
+        writer->update_inventory(&point);
+    }
+
+    writer->update_header(&header, TRUE);
+    writer->close();
+    delete writer;
+    return true;
+}
+
+int benchmarkLas(const std::string& filename, int runs)
+{
+    int numThreads = OpenMPConfig::getNumThreads();
+
+    double serialTime = 0.0;
+    double parallelTime = 0.0;
+    ModelPtr serialModel;
+    ModelPtr parallelModel;
+
+    for (int i = 0; i < runs; i++)
+    {
+        serialTime += timedLasRead(filename, 1, serialModel);
+        parallelTime += timedLasRead(filename, numThreads, parallelModel);
+    }
+    serialTime /= runs;
+    parallelTime /= runs;
+
+    if (!serialModel || !serialModel->m_pointCloud)
+    {
+        std::cout << timestamp << "Unable to read " << filename << std::endl;
+        return -1;
+    }
+
+    size_t n = serialModel->m_pointCloud->numPoints();
+    std::cout << timestamp << "Points:           " << n << std::endl;
+    std::cout << timestamp << "Single thread:    " << serialTime << " s ("
+              << n / serialTime << " points/s)" << std::endl;
+    std::cout << timestamp << "Parallel reader:  " << parallelTime << " s (" << n / parallelTime << " points/s)" << std::endl;
+    std::cout << timestamp << "Threads:          " << numThreads << std::endl;
+    std::cout << timestamp << "Speedup:          " << serialTime / parallelTime << std::endl;
+
+    if (!compareModels(serialModel, parallelModel))
+    {
+        std::cout << timestamp << "Results differ!" << std::endl;
+        return -1;
+    }
+    std::cout << timestamp << "Results are identical." << std::endl;
+
+    return 0;
+}
+
+int benchmarkPly(const std::string& filename, int runs)
+{
+    double rplyTime = 0.0;
+    double fastTime = 0.0;
+    ModelPtr rplyModel;
+    ModelPtr fastModel;
+
+    for (int i = 0; i < runs; i++)
+    {
+        rplyTime += timedRead(filename, false, rplyModel);
+        fastTime += timedRead(filename, true, fastModel);
+    }
+    rplyTime /= runs;
+    fastTime /= runs;
+
+    if (!rplyModel)
+    {
+        std::cout << timestamp << "Unable to read " << filename << std::endl;
+        return -1;
+    }
+
+    size_t numElements = 0;
+    if (rplyModel->m_pointCloud)
+    {
+        numElements += rplyModel->m_pointCloud->numPoints();
+    }
+    if (rplyModel->m_mesh)
+    {
+        numElements += rplyModel->m_mesh->numVertices() + rplyModel->m_mesh->numFaces();
+    }
+
+    std::cout << timestamp << "Elements:         " << numElements << std::endl;
+    std::cout << timestamp << "RPly reader:      " << rplyTime << " s ("
+              << numElements / rplyTime << " elements/s)" << std::endl;
+    std::cout << timestamp << "Fast reader:      " << fastTime << " s ("
+              << numElements / fastTime << " elements/s)" << std::endl;
+    std::cout << timestamp << "Speedup:          " << rplyTime / fastTime << std::endl;
+
+    if (!compareModels(rplyModel, fastModel))
+    {
+        std::cout << timestamp << "Results differ!" << std::endl;
+        return -1;
+    }
+    std::cout << timestamp << "Results are identical." << std::endl;
+
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <file.ply|file.las|file.laz> [runs]" << std::endl;
+        std::cout << "       " << argv[0] << " --synthetic-las <file.las|file.laz> <numPoints> [runs]" << std::endl;
+        return 0;
+    }
+
+    std::string filename(argv[1]);
+    int runArg = 2;
+
+    if (filename == "--synthetic-las")
+    {
+        if (argc < 4)
+        {
+            std::cout << "Missing file name or number of points." << std::endl;
+            return -1;
+        }
+        filename = argv[2];
+        runArg = 4;
+
+        std::cout << timestamp << "Writing synthetic file " << filename << std::endl;
+        if (!writeSyntheticLas(filename, atol(argv[3])))
+        {
+            std::cout << timestamp << "Unable to write " << filename << std::endl;
+            return -1;
+        }
+    }
+
+    int runs = argc > runArg ? std::max(1, atoi(argv[runArg])) : 3;
+
+    std::string extension = boost::filesystem::path(filename).extension().string();
+    if (extension == ".las" || extension == ".laz")
+    {
+        return benchmarkLas(filename, runs);
+    }
+    return benchmarkPly(filename, runs);
+}
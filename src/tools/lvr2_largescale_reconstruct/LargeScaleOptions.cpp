@@ -109,6 +109,14 @@ Options::Options(int argc, char** argv) : BaseOption(argc, argv)
         "lineFusionThreshold,lft",
         value<float>(&m_lineFusionThreshold)->default_value(0.01),
         "(Line Fusion Threshold) Threshold for fusing line segments while tesselating.")(
+        "reductionVoxelSize",
+        value<float>(&m_reductionVoxelSize)->default_value(0),
+        "Voxel size of the voxel grid reduction of each chunk's points (0 = disabled)")(
+        "incremental",
+        "Fuse only the changed scans into the existing tsdf chunks of the chunk manager. Scans that are already fused are recomputed instead.")(
+        "remeshThreshold",
+        value<float>(&m_remeshThreshold)->default_value(0.1),
+        "Incremental mode: re-mesh only chunks with a tsdf change above this fraction of the voxel size.")(
         "generateTextures", "Generate textures during finalization.")(
         "textureAnalysis", "Enable texture analysis features for texture matchung.")(
         "texelSize",
@@ -171,7 +179,10 @@ Options::Options(int argc, char** argv) : BaseOption(argc, argv)
         "Max. Number of Points in a leaf (used to devide pointcloud)")(
         "outputFolder",
         value<string>(&m_outputFolderPath)->default_value(""),
-        "Output Folder Path")("useGPU", "Use GPU for normal estimation")(
+        "Output Folder Path")(
+        "report",
+        value<string>()->default_value(""),
+        "Write wall time, CPU time and peak memory of each processing stage to this file (.json or .csv)")("useGPU", "Use GPU for normal estimation")(
         "flipPoint", value<vector<float>>()->multitoken(), "Flippoint, used for GPU normal calculation, multitoken option: use it like this: --flipPoint x y z")(
         "lineReaderBuffer",
         value<size_t>(&m_lineReaderBuffer)->default_value(1024),
@@ -357,6 +368,14 @@ float Options::getTexelSize() const { return m_texelSize; }
 
 float Options::getLineFusionThreshold() const { return m_variables["lineFusionThreshold"].as<float>(); }
 
+float Options::getReductionVoxelSize() const { return m_variables["reductionVoxelSize"].as<float>(); }
+
+string Options::getReportFile() const { return m_variables["report"].as<string>(); }
+
+bool Options::incremental() const { return m_variables.count("incremental"); }
+
+float Options::getRemeshThreshold() const { return m_variables["remeshThreshold"].as<float>(); }
+
 string Options::getTexturePack() const { return m_variables["tp"].as<string>(); }
 
 unsigned int Options::getNumStatsColors() const { return m_variables["nsc"].as<unsigned int>(); }
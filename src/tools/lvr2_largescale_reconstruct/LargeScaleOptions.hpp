@@ -199,6 +199,24 @@ class Options : public lvr2::BaseOption
      */
     float getLineFusionThreshold() const;
 
+    /**
+     * @brief   Returns the voxel size of the voxel grid reduction of
+     *          the chunk points (0 = disabled)
+     */
+    float getReductionVoxelSize() const;
+
+    /**
+     * @brief   Returns whether the changed scans are fused into the existing
+     *          tsdf chunks instead of recomputing them
+     */
+    bool incremental() const;
+
+    /**
+     * @brief   Returns the tsdf change (fraction of the voxel size) above
+     *          which a chunk is re-meshed in incremental mode
+     */
+    float getRemeshThreshold() const;
+
     /*
      * Definition from here on are not used (anymore?)
      */
@@ -378,6 +396,12 @@ class Options : public lvr2::BaseOption
 
     string getOutputFolderPath() const;
 
+    /**
+     * @brief   Returns the name of the file the stage timings are written to
+     *          (empty if no report is requested)
+     */
+    string getReportFile() const;
+
     bool getUseNormals() const;
 
     size_t getVolumenSize() const;
@@ -450,6 +474,12 @@ class Options : public lvr2::BaseOption
     /// Threshold for line fusing when tesselating
     float m_lineFusionThreshold;
 
+    /// Voxel size of the voxel grid reduction of the chunk points
+    float m_reductionVoxelSize;
+
+    /// Min. tsdf change of a chunk for re-meshing in incremental mode
+    float m_remeshThreshold;
+
 
     /*
      * Definition from here on are not used (anymore?)
@@ -595,6 +625,19 @@ inline ostream& operator<<(ostream& os, const Options& o)
         cout << "##### Retesselate \t\t: YES" << endl;
         cout << "##### Line fusion threshold \t: " << o.getLineFusionThreshold() << endl;
     }
+    if (o.getReductionVoxelSize() > 0)
+    {
+        cout << "##### Reduction voxel size \t: " << o.getReductionVoxelSize() << endl;
+    }
+    if (!o.getReportFile().empty())
+    {
+        cout << "##### Stage report \t\t: " << o.getReportFile() << endl;
+    }
+    if (o.incremental())
+    {
+        cout << "##### Incremental fusion \t: YES" << endl;
+        cout << "##### Re-mesh threshold \t: " << o.getRemeshThreshold() << endl;
+    }
     if (o.saveFaceNormals())
     {
         cout << "##### Write Face Normals \t: YES" << endl;
@@ -39,6 +39,7 @@
 #include "lvr2/io/hdf5/HDF5FeatureBase.hpp"
 #include "lvr2/io/hdf5/ScanProjectIO.hpp"
 #include "lvr2/io/ScanIOUtils.hpp"
+#include "lvr2/io/StageTimer.hpp"
 
 using std::cout;
 using std::endl;
@@ -99,10 +100,13 @@ int main(int argc, char** argv)
                                       options.getCleanContourIterations(), options.getFillHoles(), options.optimizePlanes(),
                                       options.getNormalThreshold(), options.getPlaneIterations(), options.getMinPlaneSize(), options.getSmallRegionThreshold(),
                                       options.retesselate(), options.getLineFusionThreshold(), options.getBigMesh(), options.getDebugChunks(), options.useGPU());
+    lsr.setReductionVoxelSize(options.getReductionVoxelSize());
+    lsr.setIncremental(options.incremental(), options.getRemeshThreshold());
 
     
 
 
+    StageTimer loadStage("load scan project");
     ScanProjectEditMarkPtr project(new ScanProjectEditMark);
     std::shared_ptr<ChunkHashGrid> cm;
     BoundingBox<Vec> boundingBox;
@@ -176,7 +180,10 @@ int main(int argc, char** argv)
         cm = std::shared_ptr<ChunkHashGrid>(new ChunkHashGrid("chunked_mesh.h5", 50, boundingBox, options.getChunkSize()));
     }
 
+    loadStage.stop();
+
     BoundingBox<Vec> bb;
+    StageTimer reconstructionStage("reconstruction");
     // reconstruction with diffrent methods
     if(options.getPartMethod() == 1)
     {
@@ -186,16 +193,30 @@ int main(int argc, char** argv)
     {
         int x = lsr.mpiAndReconstruct(project);
     }
+    reconstructionStage.stop();
 
     // reconstruction of .ply for diffrent voxelSizes
-    if(options.getDebugChunks())
+    if(options.getDebugChunks() && bb.isValid())
     {
+        StageTimer debugStage("partial reconstruction");
 
         for (int i; i < options.getVoxelSizes().size(); i++) {
             lsr.getPartialReconstruct(bb, cm, options.getVoxelSizes()[i]);
         }
     }
 
+    if(!options.getReportFile().empty())
+    {
+        if(StageReport::instance().save(options.getReportFile()))
+        {
+            cout << "Saved stage report to " << options.getReportFile() << "." << endl;
+        }
+        else
+        {
+            cout << "Unable to write stage report to " << options.getReportFile() << "." << endl;
+        }
+    }
+
     cout << "Program end." << endl;
 
     return 0;
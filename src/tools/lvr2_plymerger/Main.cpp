@@ -30,15 +30,16 @@
 #include <rply.h>
 
 #include "lvr2/io/ModelFactory.hpp"
+#include "lvr2/io/ObjStreamWriter.hpp"
+#include "lvr2/io/PLYStreamWriter.hpp"
 #include "lvr2/io/Progress.hpp"
 
 #include <boost/filesystem.hpp>
 
 #include <iostream>
-#include <fstream>
+#include <memory>
 #include <tuple>
 
-using std::ofstream;
 using std::cout;
 using std::endl;
 using std::pair;
@@ -181,96 +182,6 @@ void parsePLYHeader(
 }
 
 
-void writePLYHeader(ofstream& outfile, size_t numPoints, bool writeColors, bool writeNormals)
-{
-    outfile << "ply" << endl;
-    outfile << "format binary_little_endian 1.0" << endl;
-    outfile << "element vertex " << numPoints << endl;
-    outfile << "property float x" << endl;
-    outfile << "property float y" << endl;
-    outfile << "property float z" << endl;
-    if(writeColors)
-    {
-        outfile << "property uchar red" << endl;
-        outfile << "property uchar green" << endl;
-        outfile << "property uchar blue" << endl;
-    }
-
-    if(writeNormals)
-    {
-        outfile << "property float nx" << endl;
-        outfile << "property float ny" << endl;
-        outfile << "property float nz" << endl;
-    }
-    outfile << "end_header" << endl;
-}
-
-void addToFile(ofstream& out, string filename)
-{
-    ModelPtr model = ModelFactory::readModel(filename);
-    PointBufferPtr pointBuffer = model->m_pointCloud;
-
-    size_t np, nn, nc;
-    size_t w_color;
-    np = pointBuffer->numPoints();
-    nc = nn = np;
-
-    floatArr points = pointBuffer->getPointArray();
-    ucharArr colors = pointBuffer->getColorArray(w_color);
-    floatArr normals = pointBuffer->getNormalArray();
-
-    // Determine size of single point
-    size_t buffer_size = 3 * sizeof(float);
-
-    if(colors)
-    {
-        buffer_size += w_color * sizeof(unsigned char);
-    }
-
-    if(normals)
-    {
-        buffer_size += 3 * sizeof(float);
-    }
-
-    char* buffer = new char[buffer_size];
-
-    for(size_t i = 0; i < np; i++)
-    {
-        char* ptr = &buffer[0];
-
-        // Write coordinates to buffer
-        *((float*)ptr) = points[3*i];
-        ptr += sizeof(float);
-        *((float*)ptr) = points[3*i+1];
-        ptr += sizeof(float);
-        *((float*)ptr) = points[3*i+2];
-
-        // Write colors to buffer
-        if(colors)
-        {
-            ptr += sizeof(float);
-            *((unsigned char*)ptr) = colors[3 * i];
-            ptr += sizeof(unsigned char);
-            *((unsigned char*)ptr) = colors[3 * i + 1];
-            ptr += sizeof(unsigned char);
-            *((unsigned char*)ptr) = colors[3 * i + 2];
-        }
-
-        if(normals)
-        {
-            ptr += sizeof(unsigned char);
-            *((float*)ptr) = normals[3*i];
-            ptr += sizeof(float);
-            *((float*)ptr) = normals[3*i+1];
-            ptr += sizeof(float);
-            *((float*)ptr) = normals[3*i+2];
-        }
-        out.write((const char*)buffer, buffer_size);
-    }
-
-    delete[] buffer;
-}
-
 /**
  * @brief   Main entry point for the LSSR surface executable
  */
@@ -354,40 +265,55 @@ int main(int argc, char** argv)
         std::cout << timestamp << options.inputDir() << " does not exist or is not a directory." << std::endl;
     }
 
-    string outfile_name = options.outputFile();
-    ofstream out;
-    out.open(outfile_name.c_str(), std::ios::binary);
-    writePLYHeader(out, totalNumPoints, mergeColors, mergeNormals);
+    StreamSchema schema;
+    schema.vertexColors = mergeColors;
+    schema.vertexNormals = mergeNormals;
+    schema.faces = options.mergeMeshes();
 
-    size_t maxChunkPoints = 1e7;
-    auto it = ply_file_names.begin();
+    if(options.mergeMeshes())
+    {
+        cout << timestamp << "Merging meshes." << endl;
+    }
+
+    // Write results incrementally, so that the merged data never has to
+    // be held in memory completely
+    string outfile_name = options.outputFile();
+    std::unique_ptr<StreamWriter> writer;
+    if(boost::filesystem::path(outfile_name).extension() == ".obj")
+    {
+        writer.reset(new ObjStreamWriter(outfile_name, schema));
+    }
+    else
+    {
+        writer.reset(new PLYStreamWriter(outfile_name, schema));
+    }
 
     PacmanProgressBar progress(ply_file_names.size(), "Merging...");
 
-    while(it != ply_file_names.end())
+    for(auto it: ply_file_names)
     {
-        size_t pointsInChunk = 0;
-        vector<string> filesInChunk;
-        do
+        ModelPtr model = ModelFactory::readModel(it.first);
+        if(model)
         {
-            filesInChunk.push_back(it->first);
-            pointsInChunk += it->second;
-            ++it;
+            if(options.mergeMeshes())
+            {
+                // Face indices are shifted by the number of previously
+                // written vertices
+                writer->addMesh(model->m_mesh);
+            }
+            else
+            {
+                writer->addPoints(model->m_pointCloud);
+            }
         }
-        while(it != ply_file_names.end() && pointsInChunk < maxChunkPoints);
+        ++progress;
+    }
 
+    // Patches the element counts in the header
+    writer->close();
 
-        for(auto chunkIt: filesInChunk)
-        {
-            addToFile(out, chunkIt);
-        }
-
-        for(size_t c = 0; c < filesInChunk.size(); c++)
-        {
-            ++progress;
-        }
-    }
+    cout << endl << timestamp << "Wrote " << writer->numVertices() << " vertices and "
+         << writer->numFaces() << " faces to " << outfile_name << "." << endl;
 
 	return 0;
 }
-
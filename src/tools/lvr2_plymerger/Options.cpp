@@ -46,6 +46,7 @@ Options::Options(int argc, char** argv) : m_descr("Supported options")
 		("help", "Produce help message")
         ("inputDir", value<string>()->default_value("./"), "A directory containg .ply files to merge.")
         ("outputFile", value<string>()->default_value("merged.ply"), "File with merge point cloud data.")
+        ("mesh", "Merge meshes instead of point clouds. Face indices are shifted accordingly.")
 
             ;
 
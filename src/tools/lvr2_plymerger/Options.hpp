@@ -70,6 +70,8 @@ public:
 
     string outputFile() const { return m_variables["outputFile"].as<string>();}
 
+    bool mergeMeshes() const { return m_variables.count("mesh");}
+
 private:
 
     /// The internally used variable map
@@ -0,0 +1,385 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Main.cpp
+ */
+
+#include "Options.hpp"
+
+#include "lvr2/algorithm/PointLODHierarchy.hpp"
+#include "lvr2/config/lvropenmp.hpp"
+#include "lvr2/geometry/BaseVector.hpp"
+#include "lvr2/io/HDF5IO.hpp"
+#include "lvr2/io/Timestamp.hpp"
+#include "lvr2/reconstruction/BigGrid.hpp"
+#include "lvr2/registration/TransformUtils.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+using namespace lvr2;
+
+using Vec = BaseVector<float>;
+
+namespace
+{
+
+/// Number of points that are passed to the builder at once
+const size_t BATCH_SIZE = 1000000;
+
+/// Calls f for every registered scan of a HDF5 file, loading one scan at a time
+template<typename F>
+void forEachScan(HDF5IO& hdf, F f)
+{
+    // Scan positions are numbered from 0 or 1, depending on the writer
+    size_t numScans = hdf.getRawScans(false).size();
+    size_t found = 0;
+    for (int nr = 0; found < numScans && nr <= (int)numScans; nr++)
+    {
+        ScanPtr scan = hdf.getSingleRawScan(nr, true);
+        if (scan->points)
+        {
+            found++;
+            transformPoints(scan->points->getPointArray().get(), scan->points->numPoints(), scan->registration);
+            f(scan->points);
+        }
+    }
+}
+
+bool buildFromHDF5(const std::string& filename, const std::string& directory, const PointLODBuilder::Options& options)
+{
+    HDF5IO hdf(filename, HighFive::File::ReadOnly);
+
+    // The scans are read twice to keep only one of them in memory
+    BoundingBox<Vec> bounds;
+    forEachScan(hdf, [&](PointBufferPtr points)
+    {
+        floatArr p = points->getPointArray();
+        for (size_t i = 0; i < points->numPoints(); i++)
+        {
+            bounds.expand(Vec(p[3 * i], p[3 * i + 1], p[3 * i + 2]));
+        }
+    });
+
+    PointLODBuilder builder(directory, bounds, options);
+    forEachScan(hdf, [&](PointBufferPtr points)
+    {
+        builder.addPoints(points);
+    });
+    return builder.finish();
+}
+
+bool buildFromBigGrid(const std::string& filename, const std::string& directory, const PointLODBuilder::Options& options, float voxelSize)
+{
+    BigGrid<Vec> grid({filename}, voxelSize, 1);
+    BoundingBox<Vec> bounds = grid.getBB();
+    PointLODBuilder builder(directory, bounds, options);
+
+    // Stream the grid in slabs along the x axis. The queried boxes contain whole
+    // voxels, so points outside of the slab are skipped.
+    size_t numSlabs = std::max<size_t>(1, 2 * grid.pointSize() / BATCH_SIZE);
+    float slab = bounds.getXSize() / numSlabs;
+    for (size_t s = 0; s < numSlabs; s++)
+    {
+        float minX = bounds.getMin().x + s * slab;
+        float maxX = s + 1 == numSlabs ? std::numeric_limits<float>::max() : minX + slab;
+
+        size_t n, numColors = 0;
+        floatArr points = grid.points(minX - voxelSize, bounds.getMin().y, bounds.getMin().z,
+                                      maxX + voxelSize, bounds.getMax().y, bounds.getMax().z, n);
+        ucharArr colors;
+        if (grid.hasColors())
+        {
+            colors = grid.colors(minX - voxelSize, bounds.getMin().y, bounds.getMin().z,
+                                 maxX + voxelSize, bounds.getMax().y, bounds.getMax().z, numColors);
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            if (points[3 * i] >= minX && points[3 * i] < maxX)
+            {
+                std::copy(points.get() + 3 * i, points.get() + 3 * i + 3, points.get() + 3 * kept);
+                if (colors && numColors == n)
+                {
+                    std::copy(colors.get() + 3 * i, colors.get() + 3 * i + 3, colors.get() + 3 * kept);
+                }
+                kept++;
+            }
+        }
+        builder.addPoints(points.get(), colors && numColors == n ? colors.get() : nullptr, kept, 3);
+    }
+    return builder.finish();
+}
+
+/// Streams points on a few noisy planes and a sphere into the builder
+bool buildSynthetic(size_t numPoints, const std::string& directory, const PointLODBuilder::Options& options)
+{
+    BoundingBox<Vec> bounds(Vec(-100, -100, -10), Vec(100, 100, 50));
+    PointLODBuilder builder(directory, bounds, options);
+
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> u(-100, 100);
+    std::normal_distribution<float> noise(0, 0.02);
+
+    std::vector<float> points;
+    std::vector<unsigned char> colors;
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        float x, y, z;
+        switch (i % 4)
+        {
+        case 0:     // ground
+            x = u(gen); y = u(gen); z = noise(gen);
+            break;
+        case 1:     // wall
+            x = u(gen); y = 50 + noise(gen); z = std::abs(u(gen)) * 0.4f;
+            break;
+        case 2:     // wall
+            x = -30 + noise(gen); y = u(gen); z = std::abs(u(gen)) * 0.4f;
+            break;
+        default:    // sphere
+        {
+            float a = u(gen) * M_PI / 100, b = u(gen) * M_PI / 200;
+            x = 20 + 10 * std::cos(a) * std::cos(b);
+            y = -20 + 10 * std::sin(a) * std::cos(b);
+            z = 10 + 10 * std::sin(b);
+        }
+        }
+        points.insert(points.end(), {x, y, z});
+        colors.insert(colors.end(), {(unsigned char)(i % 4 * 60), (unsigned char)(z * 5), 128});
+
+        if (points.size() == 3 * BATCH_SIZE || i + 1 == numPoints)
+        {
+            builder.addPoints(points.data(), colors.data(), points.size() / 3, 3);
+            points.clear();
+            colors.clear();
+        }
+    }
+    return builder.finish();
+}
+
+/// Column vector view projection matrix of a perspective camera
+Matrix4f viewProjection(const Vector3f& eye, const Vector3f& target, float fovY, float aspect, float near, float far)
+{
+    Vector3f f = (target - eye).normalized();
+    Vector3f up = std::abs(f.z()) > 0.99f ? Vector3f(0, 1, 0) : Vector3f(0, 0, 1);
+    Vector3f s = f.cross(up).normalized();
+    Vector3f u = s.cross(f);
+
+    Matrix4f view = Matrix4f::Identity();
+    view.block<1, 3>(0, 0) = s.transpose();
+    view.block<1, 3>(1, 0) = u.transpose();
+    view.block<1, 3>(2, 0) = -f.transpose();
+    view(0, 3) = -s.dot(eye);
+    view(1, 3) = -u.dot(eye);
+    view(2, 3) = f.dot(eye);
+
+    float t = 1.0f / std::tan(fovY / 2);
+    Matrix4f proj = Matrix4f::Zero();
+    proj(0, 0) = t / aspect;
+    proj(1, 1) = t;
+    proj(2, 2) = (far + near) / (near - far);
+    proj(2, 3) = 2 * far * near / (near - far);
+    proj(3, 2) = -1;
+
+    return proj * view;
+}
+
+/**
+ * Runs queries for random views and checks that:
+ *  - every selected node is visible and its parent was selected, too
+ *  - the point budget is respected
+ *  - an unlimited query returns exactly the visible nodes
+ */
+int queryBenchmark(const std::string& directory, size_t numQueries)
+{
+    PointLODHierarchy lod(directory);
+    if (!lod.isOpen())
+    {
+        return -1;
+    }
+
+    const std::vector<PointLODNode>& nodes = lod.nodes();
+    std::vector<int64_t> parent(nodes.size(), -1);
+    size_t total = 0;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        total += nodes[i].numPoints;
+        for (int c = 0; c < 8; c++)
+        {
+            if (nodes[i].children[c] >= 0)
+            {
+                parent[nodes[i].children[c]] = i;
+            }
+        }
+    }
+    std::cout << timestamp << "Hierarchy: " << nodes.size() << " nodes, " << total << " points" << std::endl;
+
+    const PointLODNode& root = nodes[lod.root()];
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> u(0, 1);
+    auto randomPoint = [&]()
+    {
+        return Vector3f(root.min[0] + u(gen) * root.size, root.min[1] + u(gen) * root.size, root.min[2] + u(gen) * root.size);
+    };
+
+    float fovY = 60 * M_PI / 180;
+    float factor = PointLODHierarchy::projectionFactor(1080, fovY);
+    size_t budget = 2000000;
+
+    double queryTime = 0, loadTime = 0;
+    size_t selectedNodes = 0, selectedPoints = 0, errors = 0;
+    for (size_t q = 0; q < numQueries; q++)
+    {
+        Vector3f eye = randomPoint();
+        double planes[24];
+        PointLODHierarchy::frustumPlanes(viewProjection(eye, randomPoint(), fovY, 16.0f / 9, 0.1f, 4 * root.size), planes);
+
+        Timestamp ts;
+        std::vector<size_t> selected = lod.query(planes, eye, factor, 1.5f, budget);
+        queryTime += ts.getElapsedTimeInS();
+
+        std::vector<bool> isSelected(nodes.size(), false);
+        size_t points = 0;
+        for (size_t i : selected)
+        {
+            isSelected[i] = true;
+            points += nodes[i].numPoints;
+        }
+        for (size_t i : selected)
+        {
+            if (!PointLODHierarchy::intersects(nodes[i], planes) || (parent[i] >= 0 && !isSelected[parent[i]]))
+            {
+                errors++;
+            }
+        }
+        if (points > budget)
+        {
+            errors++;
+        }
+
+        Timestamp tl;
+        PointBufferPtr buffer = lod.loadPoints(selected);
+        loadTime += tl.getElapsedTimeInS();
+        if (buffer->numPoints() != points)
+        {
+            errors++;
+        }
+
+        // Without error and point budget all visible nodes are selected
+        std::vector<size_t> all = lod.query(planes, eye, factor, 0, std::numeric_limits<size_t>::max());
+        size_t visible = 0;
+        std::vector<size_t> stack{lod.root()};
+        while (!stack.empty())
+        {
+            size_t i = stack.back();
+            stack.pop_back();
+            if (!PointLODHierarchy::intersects(nodes[i], planes))
+            {
+                continue;
+            }
+            visible++;
+            for (int c = 0; c < 8; c++)
+            {
+                if (nodes[i].children[c] >= 0)
+                {
+                    stack.push_back(nodes[i].children[c]);
+                }
+            }
+        }
+        if (all.size() != visible)
+        {
+            errors++;
+        }
+
+        selectedNodes += selected.size();
+        selectedPoints += points;
+    }
+
+    std::cout << timestamp << numQueries << " synthetic frustums:" << std::endl;
+    std::cout << timestamp << "  avg. nodes / points : " << selectedNodes / numQueries << " / " << selectedPoints / numQueries << std::endl;
+    std::cout << timestamp << "  avg. query time     : " << 1000 * queryTime / numQueries << " ms" << std::endl;
+    std::cout << timestamp << "  avg. load time      : " << 1000 * loadTime / numQueries << " ms" << std::endl;
+    std::cout << timestamp << "  failed checks       : " << errors << std::endl;
+
+    return errors == 0 ? 0 : -1;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    point_lod::Options options(argc, argv);
+    if (options.printUsage())
+    {
+        return 0;
+    }
+
+    std::cout << options << std::endl;
+
+    OpenMPConfig::setNumThreads(options.getNumThreads());
+
+    if (options.queryOnly())
+    {
+        return queryBenchmark(options.getOutputDir(), std::max(1, options.getNumQueries()));
+    }
+
+    PointLODBuilder::Options builderOptions;
+    builderOptions.maxPointsPerNode = std::max<size_t>(1, options.getMaxPointsPerNode());
+    builderOptions.chunkLevel = options.getChunkLevel();
+    builderOptions.chunkPointBudget = options.getChunkPointBudget();
+
+    Timestamp ts;
+    bool ok;
+    if (options.getNumSyntheticPoints() > 0)
+    {
+        ok = buildSynthetic(options.getNumSyntheticPoints(), options.getOutputDir(), builderOptions);
+    }
+    else if (boost::filesystem::path(options.getInputFileName()).extension() == ".h5")
+    {
+        ok = buildFromHDF5(options.getInputFileName(), options.getOutputDir(), builderOptions);
+    }
+    else
+    {
+        ok = buildFromBigGrid(options.getInputFileName(), options.getOutputDir(), builderOptions, options.getVoxelSize());
+    }
+
+    if (!ok)
+    {
+        std::cout << timestamp << "Unable to build hierarchy." << std::endl;
+        return -1;
+    }
+    std::cout << timestamp << "Built hierarchy in " << ts.getElapsedTimeInS() << " s" << std::endl;
+
+    return options.getNumSyntheticPoints() > 0 ? queryBenchmark(options.getOutputDir(), std::max(1, options.getNumQueries())) : 0;
+}
@@ -0,0 +1,130 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Options.cpp
+ */
+
+#include "Options.hpp"
+#include "lvr2/config/lvropenmp.hpp"
+
+namespace point_lod
+{
+
+using namespace boost::program_options;
+
+Options::Options(int argc, char** argv) : BaseOption(argc, argv)
+{
+    m_descr.add_options()
+        ("help", "Produce help message")
+        ("inputFile", value<vector<string>>(), "Input file name. A HDF5 file (.h5) with registered scans or a point cloud that is read with a BigGrid.")
+        ("outputDir,o", value<string>()->default_value("lod"), "Directory of the hierarchy")
+        ("synthetic", value<size_t>()->default_value(0), "Build the hierarchy from this many synthetic points instead of an input file and run the query benchmark on it")
+        ("query", "Only run the query benchmark on the hierarchy in the output directory")
+        ("queries", value<int>()->default_value(100), "Number of random views of the query benchmark")
+        ("maxPointsPerNode", value<size_t>()->default_value(20000), "Maximum number of points in a leaf")
+        ("chunkLevel", value<int>()->default_value(4), "Depth of the chunk grid, i.e. 2^chunkLevel chunks per axis. Increase it for dense clouds.")
+        ("chunkPointBudget", value<size_t>()->default_value(100000000), "Maximum number of points of the chunks that are built at the same time")
+        ("voxelSize", value<float>()->default_value(1.0f), "Voxel size of the BigGrid that reads a point cloud")
+        ("threads", value<int>()->default_value(lvr2::OpenMPConfig::getNumThreads()), "Number of threads")
+        ;
+    setup();
+}
+
+Options::~Options()
+{
+}
+
+bool Options::printUsage() const
+{
+    if (m_variables.count("help"))
+    {
+        cout << endl;
+        cout << m_descr << endl;
+        return true;
+    }
+    else if (!m_variables.count("inputFile") && !queryOnly() && getNumSyntheticPoints() == 0)
+    {
+        cout << "Error: You must specify an input file, --synthetic or --query." << endl;
+        cout << endl;
+        cout << m_descr << endl;
+        return true;
+    }
+    return false;
+}
+
+string Options::getInputFileName() const
+{
+    return (m_variables["inputFile"].as<vector<string>>())[0];
+}
+
+string Options::getOutputDir() const
+{
+    return (m_variables["outputDir"].as<string>());
+}
+
+size_t Options::getNumSyntheticPoints() const
+{
+    return (m_variables["synthetic"].as<size_t>());
+}
+
+bool Options::queryOnly() const
+{
+    return (m_variables.count("query"));
+}
+
+int Options::getNumQueries() const
+{
+    return (m_variables["queries"].as<int>());
+}
+
+size_t Options::getMaxPointsPerNode() const
+{
+    return (m_variables["maxPointsPerNode"].as<size_t>());
+}
+
+int Options::getChunkLevel() const
+{
+    return (m_variables["chunkLevel"].as<int>());
+}
+
+size_t Options::getChunkPointBudget() const
+{
+    return (m_variables["chunkPointBudget"].as<size_t>());
+}
+
+float Options::getVoxelSize() const
+{
+    return (m_variables["voxelSize"].as<float>());
+}
+
+int Options::getNumThreads() const
+{
+    return (m_variables["threads"].as<int>());
+}
+
+} // namespace point_lod
@@ -0,0 +1,119 @@
+/**
+ * Copyright (c) 2018, University Osnabrück
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in the
+ *       documentation and/or other materials provided with the distribution.
+ *     * Neither the name of the University Osnabrück nor the
+ *       names of its contributors may be used to endorse or promote products
+ *       derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL University Osnabrück BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Options.hpp
+ */
+
+#ifndef OPTIONS_POINT_LOD_H_
+#define OPTIONS_POINT_LOD_H_
+
+#include "lvr2/config/BaseOption.hpp"
+
+#include <boost/program_options.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using std::cout;
+using std::endl;
+using std::ostream;
+using std::string;
+using std::vector;
+
+using namespace lvr2;
+
+namespace point_lod
+{
+
+class Options : public BaseOption
+{
+  public:
+    Options(int argc, char** argv);
+    virtual ~Options();
+
+    /*
+     * prints the help message or an error if neither an input file, synthetic points nor a query
+     * benchmark are given
+     */
+    bool printUsage() const;
+
+    string getInputFileName() const;
+
+    /// Directory of the hierarchy
+    string getOutputDir() const;
+
+    /// Number of synthetic points to build a hierarchy from, 0 if an input file is used
+    size_t getNumSyntheticPoints() const;
+
+    /// True if only the query benchmark should be run on an existing hierarchy
+    bool queryOnly() const;
+
+    int getNumQueries() const;
+
+    size_t getMaxPointsPerNode() const;
+
+    int getChunkLevel() const;
+
+    size_t getChunkPointBudget() const;
+
+    float getVoxelSize() const;
+
+    int getNumThreads() const;
+};
+
+/// Output the Options - overloaded output Operator
+inline ostream& operator<<(ostream& os, const Options& o)
+{
+    if (o.queryOnly())
+    {
+        cout << "##### Query benchmark of: " << o.getOutputDir() << endl;
+        cout << "##### Queries: " << o.getNumQueries() << endl;
+        return os;
+    }
+
+    if (o.getNumSyntheticPoints() > 0)
+    {
+        cout << "##### Synthetic points: " << o.getNumSyntheticPoints() << endl;
+    }
+    else
+    {
+        cout << "##### InputFile-Name: " << o.getInputFileName() << endl;
+        cout << "##### Voxel size: " << o.getVoxelSize() << endl;
+    }
+    cout << "##### Output directory: " << o.getOutputDir() << endl;
+    cout << "##### Max points per node: " << o.getMaxPointsPerNode() << endl;
+    cout << "##### Chunk level: " << o.getChunkLevel() << endl;
+    cout << "##### Chunk point budget: " << o.getChunkPointBudget() << endl;
+    cout << "##### Threads: " << o.getNumThreads() << endl;
+
+    return os;
+}
+
+} // namespace point_lod
+
+#endif // OPTIONS_POINT_LOD_H_
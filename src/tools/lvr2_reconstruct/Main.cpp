@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <tuple>
 #include <stdlib.h>
 
@@ -51,6 +52,8 @@
 #include "lvr2/algorithm/ReductionAlgorithms.hpp"
 #include "lvr2/algorithm/Materializer.hpp"
 #include "lvr2/algorithm/Texturizer.hpp"
+#include "lvr2/algorithm/OutlierFilter.hpp"
+#include "lvr2/algorithm/VoxelGridReduction.hpp"
 //#include "lvr2/algorithm/ImageTexturizer.hpp"
 
 #include "lvr2/reconstruction/AdaptiveKSearchSurface.hpp"
@@ -67,6 +70,8 @@
 #include "lvr2/io/MeshBuffer.hpp"
 #include "lvr2/io/ModelFactory.hpp"
 #include "lvr2/io/PlutoMapIO.hpp"
+#include "lvr2/io/StageTimer.hpp"
+#include "lvr2/texture/TextureAtlas.hpp"
 #include "lvr2/util/Factories.hpp"
 #include "lvr2/algorithm/GeometryAlgorithms.hpp"
 #include "lvr2/algorithm/UtilAlgorithms.hpp"
@@ -99,6 +104,61 @@ using namespace lvr2;
 using Vec = BaseVector<float>;
 using PsSurface = lvr2::PointsetSurface<Vec>;
 
+template <typename BaseVecT>
+KNearestNeighbors filterOutliers(PointBufferPtr buffer, const reconstruct::Options& options, bool shareWithNormals)
+{
+    // One k-nearest-neighbor pass for all filters and, if requested, the
+    // first neighborhood of the adaptive normal estimation
+    size_t k = 1;
+    if(options.getSorK() > 0)
+    {
+        k = std::max(k, (size_t)options.getSorK() + 1);
+    }
+    if(options.getRorRadius() > 0)
+    {
+        k = std::max(k, (size_t)options.getRorMinNeighbors() + 1);
+    }
+    if(shareWithNormals)
+    {
+        k = std::max(k, (size_t)std::max(2 * options.getKn(), options.getKi()));
+    }
+
+    SearchTreePtr<BaseVecT> tree = getSearchTree<BaseVecT>(options.getPCM(), buffer);
+    if(!tree)
+    {
+        tree = getSearchTree<BaseVecT>("flann", buffer);
+    }
+
+    cout << timestamp << "Searching " << k << " nearest neighbors for outlier removal" << endl;
+    FloatChannel points = *buffer->getFloatChannel("points");
+    KNearestNeighbors neighbors = computeKNearestNeighbors<BaseVecT>(*tree, points, k);
+    tree.reset();
+
+    std::vector<unsigned char> keep(buffer->numPoints(), 1);
+    if(options.getSorK() > 0)
+    {
+        size_t outliers = statisticalOutlierFilter(neighbors, options.getSorK(), options.getSorStdDev(), keep);
+        cout << timestamp << "Statistical outlier removal: " << outliers << " outliers" << endl;
+    }
+    if(options.getRorRadius() > 0)
+    {
+        size_t outliers = radiusOutlierFilter(neighbors, options.getRorRadius(), options.getRorMinNeighbors(), keep);
+        cout << timestamp << "Radius outlier removal: " << outliers << " outliers" << endl;
+    }
+
+    size_t numPoints = buffer->numPoints();
+    size_t remaining = compactPointBuffer(buffer, keep);
+    cout << timestamp << "Removed " << numPoints - remaining << " of " << numPoints << " points" << endl;
+
+    if(!shareWithNormals)
+    {
+        return KNearestNeighbors();
+    }
+
+    neighbors.compact(keep);
+    return neighbors;
+}
+
 template <typename BaseVecT>
 PointsetSurfacePtr<BaseVecT> loadPointCloud(const reconstruct::Options& options)
 {
@@ -114,6 +174,36 @@ PointsetSurfacePtr<BaseVecT> loadPointCloud(const reconstruct::Options& options)
 
     PointBufferPtr buffer = model->m_pointCloud;
 
+    // Reduce the point cloud
+    if(options.getVoxelGridSize() > 0)
+    {
+        VoxelRepresentative representative;
+        try
+        {
+            representative = voxelRepresentativeFromString(options.getVoxelGridMode());
+        }
+        catch(const std::invalid_argument& e)
+        {
+            cout << timestamp << e.what() << endl;
+            return nullptr;
+        }
+
+        VoxelGridReduction reduction(options.getVoxelGridSize(), representative);
+        buffer = reduction.reduce(buffer);
+        model->m_pointCloud = buffer;
+        cout << timestamp << "Voxel grid reduction: " << reduction.numInputPoints() << " -> "
+             << reduction.numOutputPoints() << " points in " << reduction.seconds() << " s ("
+             << reduction.throughput() / 1e6 << " M points/s)" << endl;
+    }
+
+    // Remove outliers before the search tree of the surface is built
+    bool calcNormals = !buffer->hasNormals() || options.recalcNormals();
+    KNearestNeighbors neighbors;
+    if(options.getSorK() > 0 || options.getRorRadius() > 0)
+    {
+        neighbors = filterOutliers<BaseVecT>(buffer, options, calcNormals && !options.useGPU());
+    }
+
     // Create a point cloud manager
     string pcm_name = options.getPCM();
     PointsetSurfacePtr<Vec> surface;
@@ -162,7 +252,7 @@ PointsetSurfacePtr<BaseVecT> loadPointCloud(const reconstruct::Options& options)
     surface->setKn(options.getKn());
 
     // Calculate normals if necessary
-    if(!buffer->hasNormals() || options.recalcNormals())
+    if(calcNormals)
     {
         if(options.useGPU())
         {
@@ -192,7 +282,16 @@ PointsetSurfacePtr<BaseVecT> loadPointCloud(const reconstruct::Options& options)
         }
         else
         {
-            surface->calculateSurfaceNormals();
+            auto adaptiveSurface = std::dynamic_pointer_cast<AdaptiveKSearchSurface<BaseVecT>>(surface);
+            if(adaptiveSurface && neighbors.numPoints() > 0)
+            {
+                // reuse the neighborhoods of the outlier removal
+                adaptiveSurface->calculateSurfaceNormals(neighbors);
+            }
+            else
+            {
+                surface->calculateSurfaceNormals();
+            }
         }
     }
     else
@@ -314,12 +413,14 @@ int main(int argc, char** argv)
     // =======================================================================
     OpenMPConfig::setNumThreads(options.getNumThreads());
 
+    StageTimer loadStage("load point cloud");
     auto surface = loadPointCloud<Vec>(options);
     if (!surface)
     {
         cout << "Failed to create pointcloud. Exiting." << endl;
         return EXIT_FAILURE;
     }
+    loadStage.stop();
 
     // Save points and normals only
     if(options.savePointNormals())
@@ -334,12 +435,16 @@ int main(int argc, char** argv)
     // Create an empty mesh
     lvr2::HalfEdgeMesh<Vec> mesh;
 
+    StageTimer gridStage("grid");
     shared_ptr<GridBase> grid;
     unique_ptr<FastReconstructionBase<Vec>> reconstruction;
     std::tie(grid, reconstruction) = createGridAndReconstruction(options, surface);
+    gridStage.stop();
 
     // Reconstruct mesh
+    StageTimer meshStage("mesh generation");
     reconstruction->getMesh(mesh);
+    meshStage.stop();
 
     // Save grid to file
     if(options.saveGrid() && grid)
@@ -350,6 +455,7 @@ int main(int argc, char** argv)
     // =======================================================================
     // Optimize mesh
     // =======================================================================
+    StageTimer optimizeStage("mesh optimization");
     if(options.getDanglingArtifacts())
     {
         cout << timestamp << "Removing dangling artifacts" << endl;
@@ -415,10 +521,13 @@ int main(int argc, char** argv)
     {
         clusterBiMap = planarClusterGrowing(mesh, faceNormals, options.getNormalThreshold());
     }
+    optimizeStage.stop();
 
     // =======================================================================
     // Finalize mesh
     // =======================================================================
+    StageTimer finalizeStage("finalize");
+
     // Prepare color data for finalizing
     ClusterPainter painter(clusterBiMap);
     auto clusterColors = boost::optional<DenseClusterMap<Rgb8Color>>(painter.simpsons(mesh));
@@ -468,6 +577,10 @@ int main(int argc, char** argv)
         options.getTexMinClusterSize(),
         options.getTexMaxClusterSize()
     );
+    texturizer.setPointSplatting(options.splatTextures());
+
+    materializer.setFeatureExtraction(options.doTextureAnalysis());
+    materializer.setTextureDeduplication(options.getTextureDedupDistance());
 
     // When using textures ...
     if (options.generateTextures())
@@ -509,11 +622,26 @@ int main(int argc, char** argv)
     // When using textures ...
     if (options.generateTextures())
     {
+        if (options.getTextureAtlasSize() > 0)
+        {
+            // Replace the cluster textures by a few atlas pages. The pages
+            // are written together with the mesh.
+            TextureAtlas atlas(std::min(options.getTextureAtlasSize(), 65535));
+            AtlasStatistics stats = atlas.apply(*buffer);
+            cout << timestamp << "Packed " << stats.numTextures << " textures into "
+                 << stats.numPages << " atlas pages (utilisation "
+                 << 100.0 * stats.utilisation() << " %)" << endl;
+        }
+        else
+        {
+            materializer.saveTextures();
+        }
+
         // Set optioins to save them to disk
-        materializer.saveTextures();
         buffer->addIntAtomic(1, "mesh_save_textures");
         buffer->addIntAtomic(1, "mesh_texture_image_extension");
     }
+    finalizeStage.stop();
 
     // =======================================================================
     // Write all results (including the mesh) to file
@@ -528,11 +656,13 @@ int main(int argc, char** argv)
         cout << "REPAIR SAVING" << endl;
     }
 
+    StageTimer saveStage("save");
     for(const std::string& output_filename : options.getOutputFileNames())
     {
         cout << timestamp << "Saving mesh to "<< output_filename << "." << endl;
         ModelFactory::saveModel(m, output_filename);
     }
+    saveStage.stop();
 
     if (matResult.m_keypoints)
     {
@@ -541,6 +671,18 @@ int main(int argc, char** argv)
         //map_io.addTextureKeypointsMap(matResult.m_keypoints.get());
     }
 
+    if(!options.getReportFile().empty())
+    {
+        if(StageReport::instance().save(options.getReportFile()))
+        {
+            cout << timestamp << "Saved stage report to " << options.getReportFile() << "." << endl;
+        }
+        else
+        {
+            cout << timestamp << "Unable to write stage report to " << options.getReportFile() << "." << endl;
+        }
+    }
+
     cout << timestamp << "Program end." << endl;
 
     return 0;
@@ -81,6 +81,7 @@ Options::Options(int argc, char** argv)
         ("saveGrid,g", "Writes the generated grid to a file called 'fastgrid.grid. The result can be rendered with qviewer.")
         ("saveOriginalData,s", "Save the original points and the estimated normals together with the reconstruction into one file ('triangle_mesh.ply')")
         ("scanPoseFile", value<string>()->default_value(""), "ASCII file containing scan positions that can be used to flip normals")
+        ("report", value<string>()->default_value(""), "Write wall time, CPU time and peak memory of each processing stage to this file (.json or .csv)")
         ("kd", value<int>(&m_kd)->default_value(5), "Number of normals used for distance function evaluation")
         ("ki", value<int>(&m_ki)->default_value(10), "Number of normals used in the normal interpolation process")
         ("kn", value<int>(&m_kn)->default_value(10), "Size of k-neighborhood used for normal estimation")
@@ -92,8 +93,17 @@ Options::Options(int argc, char** argv)
         ("texMaxClusterSize", value<int>(&m_texMaxClusterSize)->default_value(0), "Maximum number of faces of a cluster to create a texture from (0 = no limit)")
         ("textureAnalysis", "Enable texture analysis features for texture matchung.")
         ("texelSize", value<float>(&m_texelSize)->default_value(1), "Texel size that determines texture resolution.")
+        ("textureAtlas", value<int>()->default_value(0), "Pack the generated textures into atlas pages of this size in texels (0 = one image per texture).")
+        ("textureDedup", value<int>()->default_value(-1), "Let clusters with near identical textures share one texture. The value is the maximum number of differing bits of their perceptual hashes (-1 = disabled).")
+        ("splatTextures", "Color texels by projecting the points onto the cluster planes and filling the holes instead of searching the nearest point for every texel.")
         ("classifier", value<string>(&m_classifier)->default_value("PlaneSimpsons"),"Classfier object used to color the mesh.")
         ("recalcNormals,r", "Always estimate normals, even if given in .ply file.")
+        ("voxelGridSize", value<float>(&m_voxelGridSize)->default_value(0), "Pre-filter: voxel size for voxel grid reduction (0 = disabled)")
+        ("voxelGridMode", value<string>(&m_voxelGridMode)->default_value("closest"), "Pre-filter: point kept per voxel (first, centroid or closest)")
+        ("sorK", value<int>(&m_sorK)->default_value(0), "Pre-filter: number of neighbors for statistical outlier removal (0 = disabled)")
+        ("sorStdDev", value<float>(&m_sorStdDev)->default_value(1.0), "Pre-filter: points with a mean neighbor distance above mean + sorStdDev * standard deviation are removed")
+        ("rorRadius", value<float>(&m_rorRadius)->default_value(0), "Pre-filter: radius for radius outlier removal (0 = disabled)")
+        ("rorMinNeighbors", value<int>(&m_rorMinNeighbors)->default_value(2), "Pre-filter: points with fewer neighbors within rorRadius are removed")
         ("threads", value<int>(&m_numThreads)->default_value( lvr2::OpenMPConfig::getNumThreads() ), "Number of threads")
         ("sft", value<float>(&m_sft)->default_value(0.9), "Sharp feature threshold when using sharp feature decomposition")
         ("sct", value<float>(&m_sct)->default_value(0.7), "Sharp corner threshold when using sharp feature decomposition")
@@ -154,6 +164,36 @@ int Options::getKn() const
     return m_variables["kn"].as<int>();
 }
 
+float Options::getVoxelGridSize() const
+{
+    return m_variables["voxelGridSize"].as<float>();
+}
+
+string Options::getVoxelGridMode() const
+{
+    return m_variables["voxelGridMode"].as<string>();
+}
+
+int Options::getSorK() const
+{
+    return m_variables["sorK"].as<int>();
+}
+
+float Options::getSorStdDev() const
+{
+    return m_variables["sorStdDev"].as<float>();
+}
+
+float Options::getRorRadius() const
+{
+    return m_variables["rorRadius"].as<float>();
+}
+
+int Options::getRorMinNeighbors() const
+{
+    return m_variables["rorMinNeighbors"].as<int>();
+}
+
 int Options::getIntersections() const
 {
     return m_variables["intersections"].as<int>();
@@ -199,6 +239,11 @@ string Options::getScanPoseFile() const
     return (m_variables["scanPoseFile"].as<string>());
 }
 
+string Options::getReportFile() const
+{
+    return (m_variables["report"].as<string>());
+}
+
 float Options::getEdgeCollapseReductionRatio() const
 {
     return (m_variables["reductionRatio"].as<float>());
@@ -250,7 +295,7 @@ bool Options::writeClassificationResult() const
 
 bool Options::doTextureAnalysis() const
 {
-    return m_variables.count("textureAnalyis");
+    return m_variables.count("textureAnalysis");
 }
 
 bool Options::filenameSet() const
@@ -464,6 +509,21 @@ vector<float> Options::getFlippoint() const
     return dest;
 }
 
+int Options::getTextureAtlasSize() const
+{
+    return m_variables["textureAtlas"].as<int>();
+}
+
+int Options::getTextureDedupDistance() const
+{
+    return m_variables["textureDedup"].as<int>();
+}
+
+bool Options::splatTextures() const
+{
+    return m_variables.count("splatTextures");
+}
+
 bool Options::texturesFromImages() const
 {
     return m_variables.count("texFromImages");
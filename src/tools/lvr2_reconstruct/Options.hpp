@@ -167,6 +167,42 @@ public:
      */
     int     getKd() const;
 
+    /**
+     * @brief   Returns the voxel size used for voxel grid reduction
+     *          (0 = disabled)
+     */
+    float   getVoxelGridSize() const;
+
+    /**
+     * @brief   Returns the point that is kept per voxel by the voxel
+     *          grid reduction (first, centroid or closest)
+     */
+    string  getVoxelGridMode() const;
+
+    /**
+     * @brief   Returns the number of neighbors used for statistical
+     *          outlier removal (0 = disabled)
+     */
+    int     getSorK() const;
+
+    /**
+     * @brief   Returns the standard deviation multiplier used for
+     *          statistical outlier removal
+     */
+    float   getSorStdDev() const;
+
+    /**
+     * @brief   Returns the radius used for radius outlier removal
+     *          (0 = disabled)
+     */
+    float   getRorRadius() const;
+
+    /**
+     * @brief   Returns the minimum number of neighbors within the
+     *          radius for radius outlier removal
+     */
+    int     getRorMinNeighbors() const;
+
     /**
       * @brief Return whether the mesh should be retesselated or not.
       */
@@ -207,6 +243,12 @@ public:
      */
     string  getScanPoseFile() const;
 
+    /**
+     * @brief   Returns the name of the file the stage timings are written to
+     *          (empty if no report is requested)
+     */
+    string  getReportFile() const;
+
     /**
      * @brief   Returns the number of intersections. If the return value
      *          is positive it will be used for reconstruction instead of
@@ -326,6 +368,24 @@ public:
 
     vector<float> getFlippoint() const;
 
+    /**
+     * @brief   Returns the size of the texture atlas pages, 0 if every
+     *          texture should be stored in an image of its own
+     */
+    int getTextureAtlasSize() const;
+
+    /**
+     * @brief   Returns the maximum hash distance of textures that are
+     *          shared between clusters, -1 if every cluster gets its own
+     */
+    int getTextureDedupDistance() const;
+
+    /**
+     * @brief   Returns true if texels should be colored by point splatting
+     *          instead of a nearest neighbour search per texel
+     */
+    bool splatTextures() const;
+
     bool texturesFromImages() const;
 
     string getProjectDir() const;
@@ -354,6 +414,24 @@ private:
     /// The number of neighbors for normal interpolation
     int                             m_ki;
 
+    /// The voxel size for voxel grid reduction
+    float                           m_voxelGridSize;
+
+    /// The point that is kept per voxel by the voxel grid reduction
+    string                          m_voxelGridMode;
+
+    /// The number of neighbors for statistical outlier removal
+    int                             m_sorK;
+
+    /// The standard deviation multiplier for statistical outlier removal
+    float                           m_sorStdDev;
+
+    /// The radius for radius outlier removal
+    float                           m_rorRadius;
+
+    /// The minimum number of neighbors for radius outlier removal
+    int                             m_rorMinNeighbors;
+
     /// The number of intersections used for reconstruction
     int                             m_intersections;
 
@@ -547,10 +625,26 @@ inline ostream& operator<<(ostream& os, const Options &o)
     {
         cout << "##### Recalc normals \t\t: YES" << endl;
     }
+    if(o.getVoxelGridSize() > 0)
+    {
+        cout << "##### Voxel grid size / mode \t: " << o.getVoxelGridSize() << " / " << o.getVoxelGridMode() << endl;
+    }
+    if(o.getSorK() > 0)
+    {
+        cout << "##### SOR k / std dev \t\t: " << o.getSorK() << " / " << o.getSorStdDev() << endl;
+    }
+    if(o.getRorRadius() > 0)
+    {
+        cout << "##### ROR radius / min nb \t: " << o.getRorRadius() << " / " << o.getRorMinNeighbors() << endl;
+    }
     if(o.savePointNormals())
     {
         cout << "##### Save points normals \t: YES" << endl;
     }
+    if(!o.getReportFile().empty())
+    {
+        cout << "##### Stage report \t\t: " << o.getReportFile() << endl;
+    }
     if(o.vertexColorsFromPointcloud())
     {
         cout << "##### Vertex colors: \t\t: YES" << endl;
@@ -561,6 +655,15 @@ inline ostream& operator<<(ostream& os, const Options &o)
         cout << "##### Texel size \t\t: " << o.getTexelSize() << endl;
         cout << "##### Texture Min#Cluster \t: " << o.getTexMinClusterSize() << endl;
         cout << "##### Texture Max#Cluster \t: " << o.getTexMaxClusterSize() << endl;
+        cout << "##### Texel coloring \t\t: " << (o.splatTextures() ? "point splatting" : "nearest neighbour") << endl;
+        if(o.getTextureAtlasSize() > 0)
+        {
+            cout << "##### Texture atlas size \t: " << o.getTextureAtlasSize() << endl;
+        }
+        if(o.getTextureDedupDistance() >= 0)
+        {
+            cout << "##### Texture dedup distance \t: " << o.getTextureDedupDistance() << endl;
+        }
 
         if(o.doTextureAnalysis())
         {
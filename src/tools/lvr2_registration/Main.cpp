@@ -102,6 +102,7 @@ int main(int argc, char** argv)
     bool write_pose = false;
     string output_pose_format;
     bool no_frames = false;
+    bool binary_frames = false;
     path output_dir;
 
     bool help;
@@ -130,12 +131,15 @@ int main(int argc, char** argv)
 
         ("pose-format", value<string>(&pose_format)->default_value(pose_format),
          "The File extension of the Pose files.\n"
-         "Currently supported are: pose, dat, frames.")
+         "Currently supported are: pose, dat, frames, bframes.")
 
         ("reduction,r", value<double>(&options.reduction)->default_value(options.reduction),
          "The Voxel size for Octree based reduction.\n"
          "-1 (default): No reduction.")
 
+        ("voxelGrid", bool_switch(&options.voxelGridReduction),
+         "Use a voxel grid instead of an Octree for the reduction.")
+
         ("min,m", value<double>(&options.minDistance)->default_value(options.minDistance),
          "Ignore all Points closer than <value> to the origin of the Scan.\n"
          "-1 (default): No filter.")
@@ -154,6 +158,9 @@ int main(int argc, char** argv)
         ("noFrames,F", bool_switch(&no_frames),
          "Don't write \".frames\" files.")
 
+        ("binaryFrames", bool_switch(&binary_frames),
+         "Write the frames in the compact binary \".bframes\" format instead of \".frames\".")
+
         ("writePose,w", value<string>(&output_pose_format)->implicit_value("<pose-format>"),
          "Write Poses to directory specified by --output.")
 
@@ -522,17 +529,22 @@ int main(int argc, char** argv)
         }
     }
 
-    for (int i = 0; i < count; i++)
+    if (!no_frames)
     {
-        auto& scan = scans[i];
-
-        if (!no_frames)
+        // Every scan writes its own file, so the frame dumps can be written in parallel
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < count; i++)
         {
-            file = dir / format_name(format, start + i);
-            file.replace_extension("frames");
+            path framesFile = dir / format_name(format, start + i);
+            framesFile.replace_extension(binary_frames ? "bframes" : "frames");
 
-            scan->writeFrames(file.string());
+            scans[i]->writeFrames(framesFile.string());
         }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        auto& scan = scans[i];
 
         if (write_pose)
         {
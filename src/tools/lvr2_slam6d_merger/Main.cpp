@@ -74,6 +74,17 @@ boost::filesystem::path getCorrespondingPath(const boost::filesystem::path& scan
     return boost::filesystem::path(ss.str());
 }
 
+/// Returns the text or binary frames file of the given scan, the text file if none exists
+boost::filesystem::path getFramesPath(const boost::filesystem::path& dir, const boost::filesystem::path& scan)
+{
+    boost::filesystem::path binary = dir / getCorrespondingPath(scan, ".bframes");
+    if(boost::filesystem::exists(binary))
+    {
+        return binary;
+    }
+    return dir / getCorrespondingPath(scan, ".frames");
+}
+
 
 
 } // namespace slam6dmerger
@@ -194,10 +205,10 @@ int main(int argc, char** argv)
         // -------->>>> FRAMES
 
         // Try to find frames file for current scan
-        path frames_in = inputDir / getCorrespondingPath(current_path, ".frames");
+        path frames_in = getFramesPath(inputDir, current_path);
 
         // Generate target path for frames file
-        sprintf(name_buffer, "scan%03d.frames", scan_counter);
+        sprintf(name_buffer, "scan%03d%s", scan_counter, frames_in.extension().c_str());
         path frames_out = outputDir / path(name_buffer);
 
         // Check for exisiting frames file
@@ -235,8 +246,17 @@ int main(int argc, char** argv)
         scan_counter++;
     }
 
-    for(auto current_path : merge_scans)
+    // The merged scans are independent of each other, so their registrations are
+    // transformed in parallel. Every iteration writes its own set of files.
+    const int first_merge_counter = scan_counter;
+
+    #pragma omp parallel for schedule(dynamic)
+    for(long m = 0; m < (long)merge_scans.size(); m++)
     {
+        const path& current_path = merge_scans[m];
+        const int scan_counter = first_merge_counter + m;
+        char name_buffer[256];
+
         // -------->>>> SCAN
         // Copy scan file
         sprintf(name_buffer, "scan%03d.3d", scan_counter);
@@ -258,10 +278,10 @@ int main(int argc, char** argv)
         // -------->>>> FRAMES
 
         // Try to find frames file for current scan
-        path frames_in = mergeDir / getCorrespondingPath(current_path, ".frames");
+        path frames_in = getFramesPath(mergeDir, current_path);
 
         // Generate target path for frames file
-        sprintf(name_buffer, "scan%03d.frames", scan_counter);
+        sprintf(name_buffer, "scan%03d%s", scan_counter, frames_in.extension().c_str());
         path frames_out = outputDir / path(name_buffer);
 
         // Check for exisiting frames file
@@ -310,9 +330,6 @@ int main(int argc, char** argv)
             writePose(pos, ang, pose_out);
 
         }
-
-
-        scan_counter++;
     }
 
     return 0;
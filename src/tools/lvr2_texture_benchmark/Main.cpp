@@ -0,0 +1,230 @@
+#include "lvr2/algorithm/Texturizer.hpp"
+#include "lvr2/geometry/BaseVector.hpp"
+#include "lvr2/geometry/BoundingRectangle.hpp"
+#include "lvr2/io/ModelFactory.hpp"
+#include "lvr2/io/Timestamp.hpp"
+#include "lvr2/reconstruction/AdaptiveKSearchSurface.hpp"
+#include "lvr2/texture/TextureAtlas.hpp"
+#include "lvr2/texture/TextureFactory.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <Eigen/Dense>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace lvr2;
+
+using Vec = BaseVector<float>;
+
+namespace
+{
+
+/// Creates a noisy, colored 20 x 20 plane with a smooth color gradient and a checker pattern
+PointBufferPtr syntheticCloud(size_t numPoints)
+{
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> u(-10, 10);
+    std::normal_distribution<float> noise(0, 0.01);
+
+    floatArr points(new float[3 * numPoints]);
+    ucharArr colors(new unsigned char[3 * numPoints]);
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        float x = u(gen), y = u(gen);
+        points[3 * i] = x;
+        points[3 * i + 1] = y;
+        points[3 * i + 2] = noise(gen);
+
+        bool checker = ((int)std::floor(x) + (int)std::floor(y)) & 1;
+        colors[3 * i] = (unsigned char)(12 * (x + 10));
+        colors[3 * i + 1] = (unsigned char)(12 * (y + 10));
+        colors[3 * i + 2] = checker ? 200 : 40;
+    }
+
+    PointBufferPtr buffer(new PointBuffer(points, numPoints));
+    buffer->setColorArray(colors, numPoints);
+    return buffer;
+}
+
+/// Fits a square of the given half size into the points around seed
+BoundingRectangle<float> fitRectangle(const PointsetSurface<Vec>& surface, const FloatChannel& points, size_t seed, float halfSize)
+{
+    std::vector<size_t> neighbors;
+    surface.searchTree()->radiusSearch(points[seed], halfSize, neighbors);
+
+    Eigen::Vector3f mean = Eigen::Vector3f::Zero();
+    for (size_t n : neighbors)
+    {
+        mean += Eigen::Vector3f(points[n][0], points[n][1], points[n][2]);
+    }
+    mean /= neighbors.size();
+
+    Eigen::Matrix3f cov = Eigen::Matrix3f::Zero();
+    for (size_t n : neighbors)
+    {
+        Eigen::Vector3f d = Eigen::Vector3f(points[n][0], points[n][1], points[n][2]) - mean;
+        cov += d * d.transpose();
+    }
+
+    // Eigenvalues are sorted in increasing order, the first vector is the normal
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> solver(cov);
+    Eigen::Matrix3f e = solver.eigenvectors();
+
+    Vec normal(e(0, 0), e(1, 0), e(2, 0));
+    Vec vec1(e(0, 2), e(1, 2), e(2, 2));
+    Vec vec2 = normal.cross(vec1);
+
+    return BoundingRectangle<float>(
+        Vec(mean[0], mean[1], mean[2]), vec1, vec2, Normal<float>(normal),
+        -halfSize, halfSize, -halfSize, halfSize);
+}
+
+/// Writes the textures as PNG images and returns the time needed to read them again
+double timedLoad(const std::vector<Texture>& textures, const std::string& prefix)
+{
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        TextureFactory::saveTexture(textures[i], prefix + std::to_string(i) + ".png");
+    }
+
+    Timestamp ts;
+    for (size_t i = 0; i < textures.size(); i++)
+    {
+        Texture t = TextureFactory::readTexture(prefix + std::to_string(i) + ".png");
+    }
+    return ts.getElapsedTimeInS();
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <cloud.ply|synthetic> [texelSize] [numRectangles] [rectangleSize] [numPoints] [atlasSize]" << std::endl;
+        std::cout << "Compares the nearest neighbour texel lookup of the Texturizer with point splatting" << std::endl;
+        std::cout << "and loading the textures as single images with loading them as atlas pages." << std::endl;
+        return 0;
+    }
+
+    std::string input(argv[1]);
+    float texelSize = argc > 2 ? atof(argv[2]) : 0.02f;
+    size_t numRectangles = argc > 3 ? std::max(1, atoi(argv[3])) : 20;
+    float rectangleSize = argc > 4 ? atof(argv[4]) : 2.0f;
+    int atlasSize = argc > 6 ? std::min(65535, std::max(1, atoi(argv[6]))) : 4096;
+
+    PointBufferPtr buffer;
+    if (input == "synthetic")
+    {
+        buffer = syntheticCloud(argc > 5 ? atol(argv[5]) : 2000000);
+    }
+    else
+    {
+        ModelPtr model = ModelFactory::readModel(input);
+        if (model && model->m_pointCloud)
+        {
+            buffer = model->m_pointCloud;
+        }
+    }
+
+    if (!buffer || !buffer->hasColors())
+    {
+        std::cout << timestamp << "Unable to load a colored point cloud from " << input << "." << std::endl;
+        return -1;
+    }
+
+    AdaptiveKSearchSurface<Vec> surface(buffer, "flann");
+    FloatChannel points = *buffer->getFloatChannel("points");
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<size_t> pick(0, buffer->numPoints() - 1);
+    std::vector<BoundingRectangle<float>> rectangles;
+    for (size_t i = 0; i < numRectangles; i++)
+    {
+        rectangles.push_back(fitRectangle(surface, points, pick(gen), rectangleSize / 2));
+    }
+
+    Texturizer<Vec> knn(texelSize, 0, 0);
+    Texturizer<Vec> splat(texelSize, 0, 0);
+    splat.setPointSplatting(true);
+
+    std::vector<TextureHandle> knnTextures, splatTextures;
+
+    Timestamp ts;
+    for (size_t i = 0; i < numRectangles; i++)
+    {
+        knnTextures.push_back(knn.generateTexture(i, surface, rectangles[i]));
+    }
+    double knnTime = ts.getElapsedTimeInS();
+
+    ts.resetTimer();
+    for (size_t i = 0; i < numRectangles; i++)
+    {
+        splatTextures.push_back(splat.generateTexture(i, surface, rectangles[i]));
+    }
+    double splatTime = ts.getElapsedTimeInS();
+
+    // Compare both results texel by texel
+    size_t numTexels = 0, equal = 0, close = 0;
+    double absError = 0;
+    for (size_t i = 0; i < numRectangles; i++)
+    {
+        Texture a = knn.getTexture(knnTextures[i]);
+        Texture b = splat.getTexture(splatTextures[i]);
+        size_t n = (size_t)a.m_width * a.m_height;
+        for (size_t t = 0; t < n; t++)
+        {
+            int maxDiff = 0;
+            for (int c = 0; c < 3; c++)
+            {
+                int d = std::abs((int)a.m_data[3 * t + c] - (int)b.m_data[3 * t + c]);
+                absError += d;
+                maxDiff = std::max(maxDiff, d);
+            }
+            equal += maxDiff == 0;
+            close += maxDiff <= 16;
+        }
+        numTexels += n;
+    }
+
+    std::cout << timestamp << numRectangles << " textures, " << numTexels << " texels of size " << texelSize << ":" << std::endl;
+    std::cout << timestamp << "  nearest neighbour : " << knnTime << " s, " << numTexels / knnTime << " texels/s" << std::endl;
+    std::cout << timestamp << "  point splatting   : " << splatTime << " s, " << numTexels / splatTime << " texels/s" << std::endl;
+    std::cout << timestamp << "  speedup           : " << knnTime / splatTime << std::endl;
+    std::cout << timestamp << "  mean abs. error   : " << absError / (3 * numTexels) << " per channel" << std::endl;
+    std::cout << timestamp << "  identical texels  : " << 100.0 * equal / numTexels << " %" << std::endl;
+    std::cout << timestamp << "  texels within 16  : " << 100.0 * close / numTexels << " %" << std::endl;
+
+    // Compare loading the single textures with loading them as atlas pages
+    std::vector<Texture> textures;
+    for (TextureHandle h : splatTextures)
+    {
+        textures.push_back(splat.getTexture(h));
+    }
+
+    std::vector<AtlasRegion> regions;
+    ts.resetTimer();
+    std::vector<Texture> pages = TextureAtlas(atlasSize).pack(textures, regions);
+    double packTime = ts.getElapsedTimeInS();
+    AtlasStatistics stats = TextureAtlas::statistics(textures, pages);
+
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(dir);
+
+    double singleTime = timedLoad(textures, (dir / "texture_").string());
+    double pageTime = timedLoad(pages, (dir / "page_").string());
+    boost::filesystem::remove_all(dir);
+
+    std::cout << timestamp << "Texture atlas with pages of " << atlasSize << " texels:" << std::endl;
+    std::cout << timestamp << "  textures / pages  : " << stats.numTextures << " / " << stats.numPages << std::endl;
+    std::cout << timestamp << "  utilisation       : " << 100.0 * stats.utilisation() << " %" << std::endl;
+    std::cout << timestamp << "  packing time      : " << packTime << " s" << std::endl;
+    std::cout << timestamp << "  load single / atlas : " << singleTime << " s / " << pageTime << " s" << std::endl;
+
+    return 0;
+}
@@ -39,6 +39,8 @@
 #include "lvr2/io/Model.hpp"
 #include "lvr2/io/ModelFactory.hpp"
 #include "lvr2/io/Timestamp.hpp"
+#include "lvr2/io/IOUtils.hpp"
+#include "lvr2/registration/TransformUtils.hpp"
 #include <iostream>
 #include <cmath>
 
@@ -94,22 +96,19 @@ int main(int argc, char **argv)
 
         mat = Matrix4<Vec>(Vec(x, y, z), Vec(r1, r2, r3));
       }
-      else //expect frames file instead
+      else //expect frames file instead, text or binary
       {
-        cout << timestamp << "Reading from .frames file" << endl;
-        float t[17];
-        ifstream in(options.getTransformFile().c_str());
-        while(in.good())
+        cout << timestamp << "Reading from frames file" << endl;
+        std::vector<Frame> frames = readFrames(options.getTransformFile());
+        if(frames.empty())
         {
-          in >>  t[0] >>  t[1] >>  t[2] >>  t[3] 
-             >>  t[4] >>  t[5] >>  t[6] >>  t[7]
-             >>  t[8] >>  t[9] >> t[10] >> t[11]
-             >> t[12] >> t[13] >> t[14] >> t[15]
-             >> t[16]; // we don't need this value but we need to skip it
+          cout << timestamp << "Warning: Load transform file: No frames found." << endl;
+          return -1;
         }
 
+        // Frames are stored in the same column major order as the matrix
         for(int i = 0; i < 16; ++i)
-          mat.set(i, t[i]);
+          mat.set(i, frames.back().first.data()[i]);
       }
     }
     else // read from s, r or t
@@ -148,25 +147,23 @@ int main(int argc, char **argv)
       mat = Matrix4<Vec>(Vec(x, y, z), Vec(r1, r2, r3));
     }
 
+    // Matrix4 stores the transposed coefficients of its Eigen representation.
+    // The uniform scale is applied after the transformation.
+    Transformd transform = mat.toEigenMatrix().transpose();
+    if(options.anyScaleX())
+    {
+      double scale = options.getScaleX();
+      transform.block<3, 4>(0, 0) *= scale;
+    }
+
     // Get point buffer
     if(model->m_pointCloud)
     {
-      PointBufferPtr p_buffer = model->m_pointCloud;
-
       cout << timestamp << "Using points" << endl;
       did_anything = true;
-      FloatChannelOptional points = p_buffer->getFloatChannel("points");
-       
+
       cout << mat;
-      for(size_t i = 0; i < points->numElements(); i++)
-      {
-        Vec v((*points)[i][0], (*points)[i][1], (*points)[i][2]);
-        v = mat * v;
-        v.x = options.anyScaleX() ? v[0] * options.getScaleX() : v[0];
-        v.y = options.anyScaleX() ? v[1] * options.getScaleX() : v[1];
-        v.z = options.anyScaleX() ? v[2] * options.getScaleX() : v[2];
-        (*points)[i] = v;
-      }
+      transformPointBuffer(model->m_pointCloud, transform);
     }
 
     // Get mesh buffer
@@ -176,16 +173,11 @@ int main(int argc, char **argv)
 
       cout << timestamp << "Using meshes" << endl;
       did_anything = true;
-      FloatChannelOptional points = m_buffer->getFloatChannel("vertices");
 
-      for(size_t i = 0; i < points->numElements(); i++)
+      transformPoints(m_buffer->getVertices().get(), m_buffer->numVertices(), transform);
+      if(m_buffer->hasVertexNormals())
       {
-        Vec v((*points)[i][0], (*points)[i][1], (*points)[i][2]);
-        v = mat * v;
-        v.x = options.anyScaleX() ? v[0] * options.getScaleX() : v[0];
-        v.y = options.anyScaleX() ? v[1] * options.getScaleX() : v[1];
-        v.z = options.anyScaleX() ? v[2] * options.getScaleX() : v[2];
-        (*points)[i] = v;
+        transformNormals(m_buffer->getVertexNormals().get(), m_buffer->numVertices(), transform);
       }
     }
 
@@ -64,6 +64,8 @@
 #include <vtkDataSetMapper.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkIdFilter.h>
+#include <vtkMatrix4x4.h>
+#include <algorithm>
 #include <set>
 
 namespace lvr2
@@ -97,6 +99,11 @@ LVRPickingInteractor::LVRPickingInteractor() :
     m_textActor->SetInput("Pick a point...");
     m_textActor->VisibilityOff();
 
+    m_selectedIndicesValid = false;
+    m_selectionWorkerRunning = false;
+    m_selectionGeneration = 0;
+    m_selectionNumPoints = 0;
+    connect(this, SIGNAL(selectionFinished()), this, SLOT(applySelection()), Qt::QueuedConnection);
 }
 
 
@@ -190,9 +197,35 @@ auto a =  points->GetPointData()->GetAbstractArray("OriginalIds");
         m_points = {};
         std::cout <<"point_set" << std::endl;
         m_points->DeepCopy(vertexFilter->GetOutput());*/
+        // Strokes on the previous points are meaningless now
+        cancelSelection();
+
         m_points = points;
         m_selectedPoints = std::vector<bool>(m_points->GetNumberOfPoints(), false);
         m_pointLabels = std::vector<uint16_t>(m_points->GetNumberOfPoints(), 0);
+        m_selectedIndices.clear();
+        m_selectedIndicesValid = true;
+
+        // Copy the coordinates here, the worker must not touch the VTK data
+        size_t numPoints = m_points->GetNumberOfPoints();
+        floatArr pointArr(new float[3 * numPoints]);
+        double point[3];
+        for (size_t i = 0; i < numPoints; i++)
+        {
+            m_points->GetPoint(i, point);
+            pointArr[3 * i] = point[0];
+            pointArr[3 * i + 1] = point[1];
+            pointArr[3 * i + 2] = point[2];
+        }
+
+        // The octree is built by the worker, strokes queued meanwhile wait for it
+        {
+            std::lock_guard<std::mutex> lock(m_selectionMutex);
+            m_selectionPoints = pointArr;
+            m_selectionNumPoints = numPoints;
+            m_selectionIndex.reset();
+        }
+        startSelectionWorker();
     }
 }
 
@@ -223,7 +256,11 @@ void LVRPickingInteractor::modeShooter()
 
 LVRPickingInteractor::~LVRPickingInteractor()
 {
-    // TODO Auto-generated destructor stub
+    cancelSelection();
+    if (m_selectionWorker.joinable())
+    {
+        m_selectionWorker.join();
+    }
 }
 
 
@@ -1761,27 +1798,6 @@ void LVRPickingInteractor::OnKeyRelease()
 
 }
 
-bool LVRPickingInteractor::isInside(std::vector<vtkVector2i>* polygon, int& pX, int& pY)
-{
-    int n = polygon->size();
-    if (n < 3) return false;
-
-    int i, j, c = 0;
-    for(i = 0, j = n -1; i < n ; j = i++)
-    {
-	auto& vert = polygon->at(j);
-	auto& vert_next = polygon->at(i);
-
-	if (((vert_next.GetY() > pY) != (vert.GetY() > pY)) &&
-		(pX < (vert.GetX() - vert_next.GetX()) * (pY - vert_next.GetY()) / (vert.GetY() - vert_next.GetY()) + vert_next.GetX()))
-	{
-	    c = !c;
-        }
-    }
-    return c;
-}
-
-
 void LVRPickingInteractor::calculateSelection(bool select)
 {
 
@@ -1793,85 +1809,219 @@ void LVRPickingInteractor::calculateSelection(bool select)
 	      return;
       }
 
-      if (m_labelActors.find(m_selectedLabel) != m_labelActors.end())
+      // Gather everything the worker needs from the renderer, VTK must not be
+      // accessed from the worker thread
+      SelectionRequest request;
+      vtkCamera* camera = this->CurrentRenderer->GetActiveCamera();
+      vtkMatrix4x4* matrix = camera->GetCompositeProjectionTransformMatrix(
+              this->CurrentRenderer->GetTiledAspectRatio(), -1, 1);
+      for (int i = 0; i < 4; i++)
       {
-      	this->CurrentRenderer->RemoveActor(m_labelActors[m_selectedLabel]);
+	  for (int j = 0; j < 4; j++)
+	  {
+	      request.viewProjection(i, j) = matrix->GetElement(i, j);
+	  }
       }
 
-      this->CurrentRenderer->RemoveActor(m_selectedActor);
-      m_selectedActor = vtkSmartPointer<vtkActor>::New();
-      m_selectedMapper = vtkSmartPointer<vtkDataSetMapper>::New();
-      m_selectedActor->SetMapper(m_selectedMapper);
-  
-      vtkPlanes* frustum = static_cast<vtkAreaPicker*>(this->GetInteractor()->GetPicker())->GetFrustum();
+      int* origin = this->CurrentRenderer->GetOrigin();
+      int* size = this->CurrentRenderer->GetSize();
+      request.viewport = {(double)origin[0], (double)origin[1], (double)size[0], (double)size[1]};
 
-      vtkSmartPointer<vtkExtractGeometry> extractGeometry =
-        vtkSmartPointer<vtkExtractGeometry>::New();
-      extractGeometry->SetImplicitFunction(frustum);
-#if VTK_MAJOR_VERSION <= 5
-      extractGeometry->SetInput(m_points);
-#else
-      extractGeometry->SetInputData(m_points);
-#endif
-      extractGeometry->Update();
+      for (auto& p : this->GetPolygonPoints())
+      {
+	  request.polygon.push_back(Vector2d(p.GetX(), p.GetY()));
+      }
+      request.select = select;
 
-      vtkSmartPointer<vtkVertexGlyphFilter> glyphFilter =
-        vtkSmartPointer<vtkVertexGlyphFilter>::New();
-      glyphFilter->SetInputConnection(extractGeometry->GetOutputPort());
-      glyphFilter->Update();
+      // Queue the stroke. A running worker picks it up when it is done with
+      // the previous ones, so the UI thread never waits for it.
+      {
+	  std::lock_guard<std::mutex> lock(m_selectionMutex);
+	  request.generation = m_selectionGeneration;
+	  m_selectionRequests.push_back(std::move(request));
+      }
+      startSelectionWorker();
+}
 
-      vtkPolyData* selected = glyphFilter->GetOutput();
-      
-      vtkIdTypeArray* ids = vtkIdTypeArray::SafeDownCast(selected->GetPointData()->GetArray("OriginalIds"));
-      m_selectedIds = vtkIdTypeArray::SafeDownCast(selected->GetPointData()->GetArray("OriginalIds"));
- 
-      //TODO Check if smart Pointer realy necassary
-      vtkSmartPointer<vtkCoordinate> coordinate = vtkSmartPointer<vtkCoordinate>::New();
-      coordinate->SetCoordinateSystemToWorld();
+void LVRPickingInteractor::startSelectionWorker()
+{
+      {
+	  std::lock_guard<std::mutex> lock(m_selectionMutex);
+	  if (m_selectionWorkerRunning)
+	  {
+	      return;
+	  }
+	  m_selectionWorkerRunning = true;
+      }
 
-      std::vector<vtkVector2i> polygonPoints = this->GetPolygonPoints();
-      std::vector<int> selectedPolyPoints;
-      selectedPolyPoints.resize(ids->GetNumberOfTuples());
+      // The previous worker has left its loop, so this join returns at once
+      if (m_selectionWorker.joinable())
+      {
+	  m_selectionWorker.join();
+      }
+      m_selectionWorker = std::thread(&LVRPickingInteractor::runSelectionWorker, this);
+}
 
-      for (vtkIdType i = 0; i < ids->GetNumberOfTuples(); i++)
+void LVRPickingInteractor::runSelectionWorker()
+{
+      while (true)
       {
-	auto selectedPoint = m_points->GetPoint(ids->GetValue(i));
-	coordinate->SetValue(selectedPoint[0], selectedPoint[1], selectedPoint[2]); 
-	int* displayCoord;
-	displayCoord = coordinate->GetComputedViewportValue(this->CurrentRenderer);
-	if (isInside(&polygonPoints, displayCoord[0], displayCoord[1]))
-	{
-		selectedPolyPoints.push_back(ids->GetValue(i));
-	}
+	  SelectionRequest request;
+	  std::shared_ptr<PolygonSelection> index;
+	  floatArr points;
+	  size_t numPoints = 0;
+	  size_t generation = 0;
+	  {
+	      std::lock_guard<std::mutex> lock(m_selectionMutex);
+	      index = m_selectionIndex;
+	      if (!index)
+	      {
+		  points = m_selectionPoints;
+		  numPoints = m_selectionNumPoints;
+		  generation = m_selectionGeneration;
+	      }
+	      else if (m_selectionRequests.empty())
+	      {
+		  m_selectionWorkerRunning = false;
+		  return;
+	      }
+	      else
+	      {
+		  request = std::move(m_selectionRequests.front());
+		  m_selectionRequests.pop_front();
+	      }
+	  }
+
+	  if (!index)
+	  {
+	      // Build the octree of new points before the first stroke on them
+	      index = std::make_shared<PolygonSelection>(points, numPoints);
+	      std::lock_guard<std::mutex> lock(m_selectionMutex);
+	      if (generation == m_selectionGeneration)
+	      {
+		  m_selectionIndex = index;
+	      }
+	      continue;
+	  }
+
+	  SelectionResult result;
+	  result.indices = index->select(request.viewProjection, request.viewport, request.polygon);
+	  result.select = request.select;
+
+	  {
+	      std::lock_guard<std::mutex> lock(m_selectionMutex);
+	      if (request.generation != m_selectionGeneration)
+	      {
+		  // Cancelled while we were busy
+		  continue;
+	      }
+	      m_selectionResults.push_back(std::move(result));
+	  }
+	  Q_EMIT selectionFinished();
       }
+}
 
-#if VTK_MAJOR_VERSION <= 5
-      m_selectedMapper->SetInput(selected);
-#else
-      m_selectedMapper->SetInputData(selected);
-#endif
-      m_selectedMapper->ScalarVisibilityOff();
+void LVRPickingInteractor::cancelSelection()
+{
+      std::lock_guard<std::mutex> lock(m_selectionMutex);
+      m_selectionGeneration++;
+      m_selectionRequests.clear();
+      m_selectionResults.clear();
+}
 
-      for(auto selectedPolyPoint : selectedPolyPoints)
+void LVRPickingInteractor::finishSelection()
+{
+      // Only the UI thread queues strokes, so the worker leaves its loop once
+      // it has computed the queued ones
+      if (m_selectionWorker.joinable())
       {
-		m_selectedPoints[selectedPolyPoint] = select;
+	  m_selectionWorker.join();
       }
+      applySelection();
+}
 
-      auto vertexFilter = vtkSmartPointer<vtkVertexGlyphFilter>::New();
-      auto selectedVtkPoints = vtkSmartPointer<vtkPoints>::New();
+void LVRPickingInteractor::applySelection()
+{
+      std::deque<SelectionResult> results;
+      {
+	  std::lock_guard<std::mutex> lock(m_selectionMutex);
+	  results.swap(m_selectionResults);
+      }
+      if (results.empty())
+      {
+	  return;
+      }
 
-      double point[3];
-      for (int i = 0; i < m_selectedPoints.size(); i++)
+      // The labelling functions overwrite m_selectedPoints as a whole, collect
+      // the selected indices again after they did
+      if (!m_selectedIndicesValid)
       {
+	  m_selectedIndices.clear();
+	  for (size_t i = 0; i < m_selectedPoints.size(); i++)
+	  {
 	      if (m_selectedPoints[i])
 	      {
-      		m_points->vtkDataSet::GetPoint(i, point);
-      		selectedVtkPoints->InsertNextPoint(point);
+		  m_selectedIndices.push_back(i);
 	      }
+	  }
+	  m_selectedIndicesValid = true;
       }
-      if (selectedPolyPoints.size() > 0)
+
+      // Only the points of the strokes are touched, the rest of the cloud is
+      // not iterated
+      for (auto& result : results)
       {
-	    m_modified = true;
+	  if (result.select)
+	  {
+	      for (auto idx : result.indices)
+	      {
+		  if (!m_selectedPoints[idx])
+		  {
+		      m_selectedPoints[idx] = true;
+		      m_selectedIndices.push_back(idx);
+		  }
+	      }
+	  }
+	  else
+	  {
+	      bool removed = false;
+	      for (auto idx : result.indices)
+	      {
+		  removed |= m_selectedPoints[idx];
+		  m_selectedPoints[idx] = false;
+	      }
+	      if (removed)
+	      {
+		  m_selectedIndices.erase(std::remove_if(m_selectedIndices.begin(), m_selectedIndices.end(),
+			      [this](unsigned int idx) { return !m_selectedPoints[idx]; }),
+			  m_selectedIndices.end());
+	      }
+	  }
+	  if (result.indices.size() > 0)
+	  {
+	      m_modified = true;
+	  }
+      }
+
+      if (m_labelActors.find(m_selectedLabel) != m_labelActors.end())
+      {
+      	this->CurrentRenderer->RemoveActor(m_labelActors[m_selectedLabel]);
+      }
+
+      this->CurrentRenderer->RemoveActor(m_selectedActor);
+      m_selectedActor = vtkSmartPointer<vtkActor>::New();
+      m_selectedMapper = vtkSmartPointer<vtkDataSetMapper>::New();
+      m_selectedActor->SetMapper(m_selectedMapper);
+
+      auto vertexFilter = vtkSmartPointer<vtkVertexGlyphFilter>::New();
+      auto selectedVtkPoints = vtkSmartPointer<vtkPoints>::New();
+      selectedVtkPoints->SetNumberOfPoints(m_selectedIndices.size());
+
+      double point[3];
+      for (size_t i = 0; i < m_selectedIndices.size(); i++)
+      {
+      	m_points->vtkDataSet::GetPoint(m_selectedIndices[i], point);
+      	selectedVtkPoints->SetPoint(i, point);
       }
 
       auto selectedVtkPoly = vtkSmartPointer<vtkPolyData>::New();
@@ -1972,6 +2122,9 @@ void LVRPickingInteractor::newLabel(QTreeWidgetItem* item)
 
 void LVRPickingInteractor::saveCurrentLabelSelection()
 {
+    // Strokes that are still being computed belong to the saved selection
+    finishSelection();
+
     int count = 0;
     std::set<uint16_t> modifiedActors;
     for (int i = 0; i < m_selectedPoints.size(); i++)
@@ -2024,6 +2177,8 @@ void LVRPickingInteractor::saveCurrentLabelSelection()
 
 void LVRPickingInteractor::discardChanges()
 {
+	    cancelSelection();
+
 	    //Undo Changes 
 	    m_renderer->RemoveActor(m_selectedActor);
 	    if(m_labelActors.find(m_selectedLabel) != m_labelActors.end())
@@ -2033,6 +2188,7 @@ void LVRPickingInteractor::discardChanges()
 			m_selectedPoints[i] = (m_pointLabels[i] == m_selectedLabel);
 
 		}
+		m_selectedIndicesValid = false;
 	        m_renderer->AddActor(m_labelActors[m_selectedLabel]);
       		this->GetInteractor()->GetRenderWindow()->Render();
    		this->HighlightProp(NULL);
@@ -2041,6 +2197,7 @@ void LVRPickingInteractor::discardChanges()
 	    {
 	       //Label has no selected points just reset selected and delete actor
 		std::fill(m_selectedPoints.begin(), m_selectedPoints.end(), 0);
+		m_selectedIndices.clear();
 	    	m_selectedActor = vtkSmartPointer<vtkActor>::New();
 	    }
 	    m_modified = false;
@@ -2069,6 +2226,7 @@ void LVRPickingInteractor::labelSelected(uint16_t newLabel)
 		}
 		
 	}
+	cancelSelection();
 	m_modified = false;
 	m_selectedLabel = newLabel;
 	//TODO ask if Changes should be safed
@@ -2079,6 +2237,7 @@ void LVRPickingInteractor::labelSelected(uint16_t newLabel)
 		m_selectedPoints[i] = (m_pointLabels[i] == newLabel);
 
 	}
+	m_selectedIndicesValid = false;
 }
 
 void LVRPickingInteractor::requestLabels()
@@ -49,8 +49,13 @@
 
 #include <boost/shared_array.hpp>
 
+#include <array>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include "LVRInteractorStylePolygonPick.hpp"
+#include "lvr2/algorithm/PolygonSelection.hpp"
 #include <map>
 
 namespace lvr2
@@ -152,6 +157,10 @@ Q_SIGNALS:
     void pointsLabeled(uint16_t, int);
     void responseLabels(std::vector<uint16_t>);
     void labelingStarted(bool);
+    void selectionFinished();
+
+private Q_SLOTS:
+    void applySelection();
 
 private:
 
@@ -222,8 +231,11 @@ private:
     void onMouseWheelForwardShooter();
 
     //Labeling
-    bool isInside(std::vector<vtkVector2i>* polygon, int& pX, int& pY);
     void calculateSelection(bool select);
+    void cancelSelection();
+    void runSelectionWorker();
+    void startSelectionWorker();
+    void finishSelection();
     void saveCurrentLabelSelection();
     void discardChanges();
     void updateActor(int);
@@ -266,6 +278,43 @@ private:
 
     std::map<uint16_t, QColor>	    m_labelColors;
 
+    /// A lasso stroke, captured in the UI thread
+    struct SelectionRequest
+    {
+        Transformd              viewProjection;
+        std::array<double, 4>   viewport;
+        std::vector<Vector2d>   polygon;
+        bool                    select;
+        size_t                  generation;
+    };
+
+    /// The points of a finished stroke
+    struct SelectionResult
+    {
+        std::vector<unsigned int> indices;
+        bool                      select;
+    };
+
+    /// Indices of all points set in m_selectedPoints
+    std::vector<unsigned int>       m_selectedIndices;
+    bool                            m_selectedIndicesValid;
+
+    /// Thread that computes the queued lasso selections
+    std::thread                     m_selectionWorker;
+
+    /// Guards the members below, which are shared with the selection worker
+    std::mutex                      m_selectionMutex;
+    std::deque<SelectionRequest>    m_selectionRequests;
+    std::deque<SelectionResult>     m_selectionResults;
+    bool                            m_selectionWorkerRunning;
+    /// Copy of the coordinates of the labeled points, made in setPoints
+    floatArr                        m_selectionPoints;
+    size_t                          m_selectionNumPoints;
+    /// Octree of m_selectionPoints, built by the worker
+    std::shared_ptr<PolygonSelection> m_selectionIndex;
+    /// Incremented to discard all requests and results that are in flight
+    size_t                          m_selectionGeneration;
+
 
 };
 